@@ -0,0 +1,95 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "floyd/include/floyd.h"
+#include "slash/include/testutil.h"
+
+using namespace floyd;
+uint64_t NowMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+int val_size = 128;
+int item_num = 100000;
+
+static void Report(const char* engine, const char* op, uint64_t cost) {
+  printf("%8s %10s %d items cost time microsecond(us) %lu, qps %lu\n",
+      engine, op, item_num, cost, item_num * 1000000UL / (cost == 0 ? 1 : cost));
+}
+
+// run the writes, reads and locks on a single node floyd
+static void Bench(const char* engine, StateMachineEngine state_machine_engine,
+    const std::vector<std::string>& keys, const std::vector<std::string>& vals) {
+  std::string path = std::string("./data_") + engine + "/";
+  Options op("127.0.0.1:8901", "127.0.0.1", 8901, path);
+  op.state_machine_engine = state_machine_engine;
+  Floyd* f;
+  slash::Status s = Floyd::Open(op, &f);
+  if (!s.ok()) {
+    printf("open %s floyd failed, %s\n", engine, s.ToString().c_str());
+    return;
+  }
+  while (!f->HasLeader()) {
+    printf("electing leader... sleep 2s\n");
+    sleep(2);
+  }
+
+  uint64_t st = NowMicros();
+  for (int i = 0; i < item_num; i++) {
+    f->Write(keys[i], vals[i]);
+  }
+  Report(engine, "write", NowMicros() - st);
+
+  std::string val;
+  st = NowMicros();
+  for (int i = 0; i < item_num; i++) {
+    f->Read(keys[i], &val);
+  }
+  Report(engine, "read", NowMicros() - st);
+
+  st = NowMicros();
+  for (int i = 0; i < item_num; i++) {
+    f->DirtyRead(keys[i], &val);
+  }
+  Report(engine, "dirty_read", NowMicros() - st);
+
+  st = NowMicros();
+  for (int i = 0; i < item_num; i++) {
+    f->TryLock(keys[i], "holder", 1000);
+    f->UnLock(keys[i], "holder");
+  }
+  Report(engine, "lock", NowMicros() - st);
+  delete f;
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc > 1) {
+    item_num = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    val_size = atoi(argv[2]);
+  }
+  printf("state machine bench item number %d value size %d\n", item_num, val_size);
+
+  std::vector<std::string> keys, vals;
+  for (int i = 0; i < item_num; i++) {
+    keys.push_back(slash::RandomString(32));
+    vals.push_back(slash::RandomString(val_size));
+  }
+  Bench("rocksdb", kRocksdbStateMachine, keys, vals);
+  Bench("memory", kMemoryStateMachine, keys, vals);
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+/**
+ * truncate_bench append item_num entries to a raft log, then measure
+ * truncating all of them from the tail, as a deposed leader does, and from
+ * the head, as a snapshot does, and the reads after each truncation
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "slash/include/env.h"
+
+#include "floyd/src/raft_log.h"
+#include "floyd/src/log_storage.h"
+#include "floyd/src/floyd.pb.h"
+#include "floyd/src/logger.h"
+
+using namespace floyd;
+uint64_t NowMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+int item_num = 1000000;
+int val_size = 100;
+// entries appended in one RaftLog::Append
+int batch_num = 1000;
+
+void AppendEntries(RaftLog* raft_log, uint64_t term) {
+  Entry entry;
+  entry.set_term(term);
+  entry.set_optype(Entry_OpType_kWrite);
+  entry.set_value(std::string(val_size, 'a'));
+  std::vector<Entry> entries(batch_num, entry);
+  std::vector<const Entry *> ptrs;
+  for (int i = 0; i < batch_num; i++) {
+    ptrs.push_back(&entries[i]);
+  }
+  uint64_t st = NowMicros();
+  for (int i = 0; i < item_num; i += batch_num) {
+    raft_log->Append(ptrs);
+  }
+  printf("append %d entries cost %lu us\n", item_num, NowMicros() - st);
+}
+
+// the reads after a truncation, which skip the deleted entries
+void ReadAfterTruncate(RaftLog* raft_log, uint64_t begin) {
+  std::vector<Entry> entries;
+  uint64_t st = NowMicros();
+  for (int i = 0; i < 1000; i++) {
+    raft_log->GetEntries(begin, begin + 100, 1024 * 1024, &entries);
+  }
+  printf("1000 GetEntries after truncation cost %lu us\n", NowMicros() - st);
+}
+
+int main(int argc, char * argv[])
+{
+  std::string path = "./data_truncate/";
+  if (argc > 1) {
+    item_num = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    val_size = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    path = argv[3];
+  }
+  printf("truncate bench item number %d value size %d path %s\n", item_num, val_size, path.c_str());
+
+  slash::DeleteDirIfExist(path);
+  slash::CreatePath(path);
+  Logger* logger;
+  if (NewLogger(path + "/LOG", &logger) != 0) {
+    return -1;
+  }
+  rocksdb::DB* db;
+  rocksdb::ColumnFamilyHandle* log_cf;
+  rocksdb::ColumnFamilyHandle* meta_cf;
+  slash::Status s = OpenLogAndMetaDB(path + "/log/", logger, &db, &log_cf, &meta_cf);
+  if (!s.ok()) {
+    printf("open db failed: %s\n", s.ToString().c_str());
+    return -1;
+  }
+  LogStorage* storage = new RocksdbLogStorage(db, log_cf, logger);
+  storage->Open();
+  // no cache, so the reads go to rocksdb
+  RaftLog* raft_log = new RaftLog(storage, logger, 0);
+
+  // a deposed leader drops all of its entries
+  AppendEntries(raft_log, 1);
+  uint64_t st = NowMicros();
+  raft_log->TruncateSuffix(1);
+  printf("TruncateSuffix %d entries cost %lu us\n", item_num, NowMicros() - st);
+
+  // the new leader's entries are written over the deleted range
+  AppendEntries(raft_log, 2);
+  ReadAfterTruncate(raft_log, item_num / 2);
+
+  // a snapshot drops all but the last entry
+  uint64_t last_index = raft_log->GetLastLogIndex();
+  st = NowMicros();
+  raft_log->TruncatePrefix(last_index - 1, 2);
+  printf("TruncatePrefix %lu entries cost %lu us\n", last_index - 1, NowMicros() - st);
+  ReadAfterTruncate(raft_log, last_index);
+
+  delete raft_log;
+  delete log_cf;
+  delete meta_cf;
+  delete db;
+  delete logger;
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+
+#include "floyd/include/floyd.h"
+#include "slash/include/testutil.h"
+
+using namespace floyd;
+uint64_t NowMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+Floyd *f1;
+int val_size = 128;
+int thread_num = 256;
+int item_num = 1000;
+std::atomic<uint64_t> total_latency(0);
+std::atomic<uint64_t> max_latency(0);
+std::atomic<int> failed(0);
+
+// every thread writes its own keys, so all the writers wait for the
+// apply of different entries at the same time
+void *fun(void *arg) {
+  int64_t id = reinterpret_cast<int64_t>(arg);
+  std::string val = slash::RandomString(val_size);
+  for (int j = 0; j < item_num; j++) {
+    std::string key = "key_" + std::to_string(id) + "_" + std::to_string(j);
+    uint64_t st = NowMicros();
+    slash::Status s = f1->Write(key, val);
+    uint64_t latency = NowMicros() - st;
+    if (!s.ok()) {
+      failed++;
+    }
+    total_latency += latency;
+    uint64_t max = max_latency.load();
+    while (latency > max && !max_latency.compare_exchange_weak(max, latency)) {
+    }
+  }
+  return NULL;
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc > 1) {
+    thread_num = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    val_size = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    item_num = atoi(argv[3]);
+  }
+
+  printf("write contention bench thread num %d value size %d item number per thread %d\n",
+      thread_num, val_size, item_num);
+
+  Options op1("127.0.0.1:8901", "127.0.0.1", 8901, "./data1/");
+  slash::Status s = Floyd::Open(op1, &f1);
+  printf("%s\n", s.ToString().c_str());
+  if (!s.ok()) {
+    return -1;
+  }
+
+  std::string msg;
+  while (1) {
+    if (f1->HasLeader()) {
+      f1->GetServerStatus(&msg);
+      printf("%s\n", msg.c_str());
+      break;
+    }
+    printf("electing leader... sleep 2s\n");
+    sleep(2);
+  }
+
+  pthread_t *pid = new pthread_t[thread_num];
+  uint64_t st = NowMicros(), ed;
+  for (int64_t i = 0; i < thread_num; i++) {
+    pthread_create(&pid[i], NULL, fun, reinterpret_cast<void*>(i));
+  }
+  for (int i = 0; i < thread_num; i++) {
+    pthread_join(pid[i], NULL);
+  }
+  ed = NowMicros();
+  uint64_t total = static_cast<uint64_t>(item_num) * thread_num;
+  printf("write_contention_bench writing %lu datas cost time microsecond(us) %lu, qps %lu, "
+      "avg latency(us) %lu, max latency(us) %lu, failed %d\n",
+      total, ed - st, total * 1000000 / (ed - st), total_latency.load() / total,
+      max_latency.load(), failed.load());
+
+  delete [] pid;
+  delete f1;
+  return 0;
+}
@@ -11,6 +11,8 @@
 
 namespace floyd {
 
+class StateMachine;
+
 // Logger Level
 enum {
   DEBUG_LEVEL = 0x01,
@@ -21,6 +23,33 @@ enum {
   NONE_LEVEL  = 0x06
 };
 
+// Raft log engine
+enum LogEngine {
+  // store every entry as a key in rocksdb
+  kRocksdbLog = 0,
+  // store entries in preallocated append only segment files
+  kSegmentLog = 1
+};
+
+// Built-in state machine, see StateMachine
+enum StateMachineEngine {
+  // store the keys in a rocksdb
+  kRocksdbStateMachine = 0,
+  // keep the keys in an in-memory hash table, which is made durable by
+  // the snapshots and the raft log after them
+  kMemoryStateMachine = 1
+};
+
+// Durability of the raft log
+enum LogSyncMode {
+  // leave the flush to os, the entries may be lost on power failure
+  kLogSyncNone = 0,
+  // the concurrent appends are written in one group with a single fsync
+  kLogSyncGroup = 1,
+  // one fsync for every append
+  kLogSyncEveryWrite = 2
+};
+
 struct Options {
   // cluster members
   // parsed from comma separated ip1:port1,ip2:port2...
@@ -30,9 +59,66 @@ struct Options {
   std::string path;
   uint64_t check_leader_us;
   uint64_t heartbeat_us;
+  // leader also sends a heartbeat carrying only the term and the commit
+  // index every light_heartbeat_us, on a connection of its own, so it never
+  // waits behind the AppendEntries of a lagging follower, and
+  // check_leader_us can be lowered to below a second, 0 to disable
+  uint64_t light_heartbeat_us;
   uint64_t append_entries_size_once;
   uint64_t append_entries_count_once;
+  // the AppendEntries sent to a peer without waiting for the responses,
+  // 1 to wait for the response of each one
+  int append_entries_window;
+  // tune the limits of one AppendEntries for each peer, between the min
+  // and the once limits, by the rpc latency, the apply lag of the follower
+  // and the rpc failures, false to always send up to the once limits
+  bool adaptive_batch;
+  uint64_t append_entries_size_min;
+  uint64_t append_entries_count_min;
+  // the batches shrink when they take longer than this to be acknowledged
+  uint64_t append_entries_target_rtt_us;
+  // or when the follower has more committed entries than this not applied
+  uint64_t append_entries_apply_lag_limit;
   bool single_mode;
+  LogEngine log_engine;
+  // the size of a segment file when log_engine is kSegmentLog
+  uint64_t log_segment_size;
+  LogSyncMode log_sync_mode;
+  // bytes of the recent log entries cached in memory, 0 to disable
+  uint64_t log_cache_size;
+  // take a snapshot of the state machine and drop the applied log entries
+  // when snapshot_entries entries have been applied since the last snapshot,
+  // or the log takes more than snapshot_log_size bytes, 0 to disable either
+  uint64_t snapshot_entries;
+  uint64_t snapshot_log_size;
+  // also take a snapshot every snapshot_interval_us if some entries have
+  // been applied since the last one, 0 to disable, it bounds the log
+  // applied again by kMemoryStateMachine after restart
+  uint64_t snapshot_interval_us;
+  // bytes of the snapshot sent to a lagging follower in one InstallSnapshot
+  uint64_t snapshot_chunk_size;
+
+  // the checksum of the entries read from the log storage is always
+  // checked, if lazy_checksum is true, the entries replicated from memory
+  // are sent without checksum, only a lagging follower catching up from the
+  // log storage checks what it receives
+  bool lazy_checksum;
+
+  // persist the commit index at most once every commit_index_persist_us,
+  // 0 to persist it on every advance, it can be rebuilt from the leader
+  // after restart, so it needn't be written on the hot path
+  uint64_t commit_index_persist_us;
+
+  // the committed entries are applied by apply_threads threads, partitioned
+  // by key, so the entries of one key are still applied in order, the
+  // membership changes are applied after all the entries before them
+  int apply_threads;
+
+  // the committed entries are applied to state_machine, which is not owned
+  // by floyd and must outlive it, NULL to use a rocksdb in path + "/db/"
+  StateMachine* state_machine;
+  // the built-in state machine used when state_machine is NULL
+  StateMachineEngine state_machine_engine;
 
   void SetMembers(const std::string& cluster_string);
 
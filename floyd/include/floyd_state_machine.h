@@ -0,0 +1,99 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_INCLUDE_FLOYD_STATE_MACHINE_H_
+#define FLOYD_INCLUDE_FLOYD_STATE_MACHINE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "slash/include/slash_status.h"
+
+namespace floyd {
+
+using slash::Status;
+
+/*
+ * StateMachineBatch is the writes of the committed entries applied in one
+ * round, the later write of a key overrides the former ones
+ */
+class StateMachineBatch {
+ public:
+  enum OpType {
+    kPut = 0,
+    kDelete = 1
+  };
+  struct Op {
+    OpType type;
+    std::string key;
+    std::string value;
+  };
+
+  StateMachineBatch();
+  ~StateMachineBatch();
+
+  void Put(const std::string& key, const std::string& value);
+  void Delete(const std::string& key);
+  void Clear();
+
+  // the latest write of key in the batch, NULL if key is not written
+  const Op* Find(const std::string& key) const;
+
+  const std::vector<Op>& ops() const { return ops_; }
+  size_t Count() const { return ops_.size(); }
+  // bytes of the keys and values
+  size_t DataSize() const { return data_size_; }
+
+ private:
+  std::vector<Op> ops_;
+  // key -> position of its latest write in ops_
+  std::unordered_map<std::string, size_t> latest_;
+  size_t data_size_;
+
+  // No copying allowed
+  StateMachineBatch(const StateMachineBatch&);
+  void operator=(const StateMachineBatch&);
+};
+
+/*
+ * StateMachine is where floyd applies the committed entries, the data,
+ * the locks and the membership are all stored as keys in it
+ *
+ * the default one is a rocksdb in options.path + "/db/", set
+ * Options::state_machine to use another one
+ */
+class StateMachine {
+ public:
+  StateMachine() { }
+  virtual ~StateMachine() { }
+
+  // apply all the writes in batch atomically, it is called by several
+  // threads at the same time with Options::apply_threads > 1, the batches
+  // of different threads never write the same key
+  virtual Status Apply(const StateMachineBatch& batch) = 0;
+  // NotFound if key doesn't exist
+  virtual Status Read(const std::string& key, std::string* value) = 0;
+  // write the current state as files in dir, dir doesn't exist and should
+  // be created, no Apply is called during Snapshot. The files are sent to
+  // the followers as they are, and the name SNAPSHOT_META is reserved
+  virtual Status Snapshot(const std::string& dir) = 0;
+  // replace the current state with the snapshot in dir
+  virtual Status Restore(const std::string& dir) = 0;
+  // false if the state is lost after restart, floyd restores it from the
+  // latest snapshot and applies the log after the snapshot again
+  virtual bool Durable() const { return true; }
+
+ private:
+  // No copying allowed
+  StateMachine(const StateMachine&);
+  void operator=(const StateMachine&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_INCLUDE_FLOYD_STATE_MACHINE_H_
@@ -0,0 +1,88 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/apply_waiters.h"
+
+#include "slash/include/env.h"
+
+namespace floyd {
+
+// the results kept for the commands which wait after their entries are
+// applied
+static const size_t kMaxResults = 65536;
+
+ApplyWaiters::ApplyWaiters()
+  : applied_index_(0) {
+}
+
+ApplyWaiters::~ApplyWaiters() {
+}
+
+bool ApplyWaiters::Wait(uint64_t index, uint32_t timeout_ms, Result* result) {
+  slash::MutexLock l(&mu_);
+  if (index <= applied_index_) {
+    *result = GetResult(index);
+    return true;
+  }
+  Waiter waiter(&mu_);
+  std::multimap<uint64_t, Waiter*>::iterator iter = waiters_.insert(std::make_pair(index, &waiter));
+  uint64_t deadline = slash::NowMicros() + timeout_ms * 1000ULL;
+  while (!waiter.done) {
+    uint64_t now = slash::NowMicros();
+    if (now >= deadline) {
+      break;
+    }
+    waiter.cond.TimedWait(static_cast<uint32_t>((deadline - now + 999) / 1000));
+  }
+  if (!waiter.done) {
+    waiters_.erase(iter);
+    return false;
+  }
+  *result = waiter.result;
+  return true;
+}
+
+void ApplyWaiters::Notify(uint64_t index, const Result& result) {
+  slash::MutexLock l(&mu_);
+  if (index != applied_index_ + 1) {
+    results_.clear();
+  }
+  applied_index_ = index;
+  results_.push_back(result);
+  if (results_.size() > kMaxResults) {
+    results_.pop_front();
+  }
+  WakeUp();
+}
+
+void ApplyWaiters::Reset(uint64_t index) {
+  slash::MutexLock l(&mu_);
+  results_.clear();
+  if (index > applied_index_) {
+    applied_index_ = index;
+  }
+  WakeUp();
+}
+
+ApplyWaiters::Result ApplyWaiters::GetResult(uint64_t index) {
+  if (index + results_.size() <= applied_index_) {
+    Result result;
+    result.status = Status::Incomplete("the result of the entry is not kept");
+    return result;
+  }
+  return results_[results_.size() - 1 - (applied_index_ - index)];
+}
+
+void ApplyWaiters::WakeUp() {
+  std::multimap<uint64_t, Waiter*>::iterator end = waiters_.upper_bound(applied_index_);
+  for (std::multimap<uint64_t, Waiter*>::iterator iter = waiters_.begin(); iter != end; ++iter) {
+    iter->second->done = true;
+    iter->second->result = GetResult(iter->first);
+    iter->second->cond.Signal();
+  }
+  waiters_.erase(waiters_.begin(), end);
+}
+
+}  // namespace floyd
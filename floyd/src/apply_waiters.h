@@ -0,0 +1,88 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_APPLY_WAITERS_H_
+#define FLOYD_SRC_APPLY_WAITERS_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <map>
+
+#include "slash/include/slash_mutex.h"
+#include "slash/include/slash_status.h"
+
+namespace floyd {
+
+using slash::Status;
+
+/*
+ * ApplyWaiters wakes the commands waiting for their log entries to be
+ * applied, every waiter has its own condition variable, so an apply
+ * round only wakes the waiters of the entries applied in it
+ *
+ * the results of the latest entries applied are kept, so a command which
+ * starts waiting after its entry is applied still gets the result
+ */
+class ApplyWaiters {
+ public:
+  // the outcome of applying the entry at an index
+  struct Result {
+    Result() : term(0) {}
+    // the term of the entry applied, a command whose entry is replaced by
+    // a new leader sees a different one
+    uint64_t term;
+    // the result of the command, such as whether a lock is taken
+    Status status;
+  };
+
+  ApplyWaiters();
+  ~ApplyWaiters();
+
+  /*
+   * wait until the entry at index is applied, return false if it is not
+   * applied in timeout_ms, result is of the entry applied at index, its
+   * status is Incomplete if the result is not known any more
+   */
+  bool Wait(uint64_t index, uint32_t timeout_ms, Result* result);
+  // the entry at index is applied with result, the entries are notified
+  // in the order of index
+  void Notify(uint64_t index, const Result& result);
+  /*
+   * the entries up to index are applied with the results unknown, such
+   * as when they are restored from a snapshot, wake the waiters of them
+   */
+  void Reset(uint64_t index);
+
+ private:
+  struct Waiter {
+    explicit Waiter(slash::Mutex* mu)
+      : done(false),
+        cond(mu) {}
+    bool done;
+    Result result;
+    slash::CondVar cond;
+  };
+
+  slash::Mutex mu_;
+  uint64_t applied_index_;
+  // the results of entries [applied_index_ - results_.size() + 1, applied_index_]
+  std::deque<Result> results_;
+  // an index may be waited again after the entry is replaced by the new leader
+  std::multimap<uint64_t, Waiter*> waiters_;
+
+  // the result of index, which is applied, called with mu_ held
+  Result GetResult(uint64_t index);
+  // wake the waiters up to applied_index_, called with mu_ held
+  void WakeUp();
+
+  // No copying allowed
+  ApplyWaiters(const ApplyWaiters&);
+  void operator=(const ApplyWaiters&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_APPLY_WAITERS_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/batch_controller.h"
+
+#include <algorithm>
+
+namespace floyd {
+
+BatchController::BatchController(const Options& options)
+  : adaptive_(options.adaptive_batch),
+    size_min_(std::max(std::min(options.append_entries_size_min, options.append_entries_size_once),
+          static_cast<uint64_t>(1))),
+    size_max_(std::max(options.append_entries_size_once, static_cast<uint64_t>(1))),
+    count_min_(std::max(std::min(options.append_entries_count_min, options.append_entries_count_once),
+          static_cast<uint64_t>(1))),
+    count_max_(std::max(options.append_entries_count_once, static_cast<uint64_t>(1))),
+    target_rtt_us_(options.append_entries_target_rtt_us),
+    apply_lag_limit_(options.append_entries_apply_lag_limit),
+    size_limit_(adaptive_ ? size_min_ : size_max_),
+    count_limit_(adaptive_ ? count_min_ : count_max_),
+    srtt_us_(0),
+    apply_lag_(0),
+    grows_(0),
+    shrinks_(0),
+    errors_(0),
+    decision_(kHold) {
+}
+
+void BatchController::OnSuccess(uint64_t num_entries, uint64_t rtt_us,
+    uint64_t apply_lag, bool full) {
+  apply_lag_ = apply_lag;
+  if (num_entries == 0) {
+    // a heartbeat says nothing about the cost of a batch
+    return;
+  }
+  // smoothed as tcp does, 1/8 of the new sample
+  srtt_us_ = srtt_us_ == 0 ? rtt_us : (srtt_us_ * 7 + rtt_us) / 8;
+  if (!adaptive_) {
+    return;
+  }
+  if (apply_lag_limit_ > 0 && apply_lag > apply_lag_limit_) {
+    Shrink(kShrinkApplyLag);
+  } else if (target_rtt_us_ > 0 && srtt_us_ > target_rtt_us_) {
+    Shrink(kShrinkRtt);
+  } else if (full && (target_rtt_us_ == 0 || srtt_us_ < target_rtt_us_ / 2)) {
+    // more entries are waiting, and there is room below the target
+    Grow();
+  } else {
+    decision_ = kHold;
+  }
+}
+
+void BatchController::OnError() {
+  errors_++;
+  if (adaptive_) {
+    Shrink(kShrinkError);
+  }
+}
+
+void BatchController::Grow() {
+  if (size_limit_ >= size_max_ && count_limit_ >= count_max_) {
+    decision_ = kHold;
+    return;
+  }
+  size_limit_ = std::min(size_limit_ * 2, size_max_);
+  count_limit_ = std::min(count_limit_ * 2, count_max_);
+  // the latency of the larger batches is measured from scratch
+  srtt_us_ = 0;
+  grows_++;
+  decision_ = kGrow;
+}
+
+void BatchController::Shrink(Decision decision) {
+  if (size_limit_ <= size_min_ && count_limit_ <= count_min_) {
+    // only the real changes are reported
+    decision_ = kHold;
+    return;
+  }
+  decision_ = decision;
+  size_limit_ = std::max(size_limit_ / 2, size_min_);
+  count_limit_ = std::max(count_limit_ / 2, count_min_);
+  srtt_us_ = 0;
+  shrinks_++;
+}
+
+const char* BatchController::DecisionName(Decision decision) {
+  switch (decision) {
+    case kGrow:
+      return "grow";
+    case kShrinkRtt:
+      return "shrink_rtt";
+    case kShrinkApplyLag:
+      return "shrink_apply_lag";
+    case kShrinkError:
+      return "shrink_error";
+    default:
+      return "hold";
+  }
+}
+
+}  // namespace floyd
@@ -0,0 +1,90 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_BATCH_CONTROLLER_H_
+#define FLOYD_SRC_BATCH_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "floyd/include/floyd_options.h"
+
+namespace floyd {
+
+/*
+ * BatchController decides how many entries and bytes a peer sends in one
+ * AppendEntries. With options.adaptive_batch, the limits start from
+ * append_entries_size_min and append_entries_count_min, they are doubled
+ * when a full batch is acknowledged quickly, and halved when the rpc
+ * latency exceeds append_entries_target_rtt_us, the follower falls more
+ * than append_entries_apply_lag_limit entries behind in applying, or the
+ * rpc fails, but never go beyond append_entries_size_once and
+ * append_entries_count_once. Without adaptive_batch, the limits are
+ * always the once limits.
+ *
+ * BatchController is not thread safe, Peer protects it with
+ * context_->global_mu
+ */
+class BatchController {
+ public:
+  // the last decision of the controller
+  enum Decision {
+    kHold = 0,
+    kGrow = 1,
+    kShrinkRtt = 2,
+    kShrinkApplyLag = 3,
+    kShrinkError = 4
+  };
+
+  explicit BatchController(const Options& options);
+
+  uint64_t size_limit() { return size_limit_; }
+  uint64_t count_limit() { return count_limit_; }
+
+  /*
+   * a batch of num_entries entries is acknowledged after rtt_us,
+   * apply_lag is the number of committed entries the follower has but not
+   * applied, full is true if the batch was cut by the limits
+   */
+  void OnSuccess(uint64_t num_entries, uint64_t rtt_us, uint64_t apply_lag, bool full);
+  // the rpc failed or timed out
+  void OnError();
+
+  uint64_t rtt_us() { return srtt_us_; }
+  uint64_t apply_lag() { return apply_lag_; }
+  uint64_t grows() { return grows_; }
+  uint64_t shrinks() { return shrinks_; }
+  uint64_t errors() { return errors_; }
+  Decision decision() { return decision_; }
+  static const char* DecisionName(Decision decision);
+
+ private:
+  void Grow();
+  void Shrink(Decision decision);
+
+  const bool adaptive_;
+  const uint64_t size_min_;
+  const uint64_t size_max_;
+  const uint64_t count_min_;
+  const uint64_t count_max_;
+  const uint64_t target_rtt_us_;
+  const uint64_t apply_lag_limit_;
+
+  uint64_t size_limit_;
+  uint64_t count_limit_;
+  // smoothed latency of the batches acknowledged, 0 before the first one
+  uint64_t srtt_us_;
+  uint64_t apply_lag_;
+  uint64_t grows_;
+  uint64_t shrinks_;
+  uint64_t errors_;
+  Decision decision_;
+
+  // No copying allowed
+  BatchController(const BatchController&);
+  void operator=(const BatchController&);
+};
+
+}  // namespace floyd
+#endif  // FLOYD_SRC_BATCH_CONTROLLER_H_
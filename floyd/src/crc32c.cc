@@ -0,0 +1,71 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/crc32c.h"
+
+#include <string.h>
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+namespace floyd {
+namespace crc32c {
+
+#ifndef __SSE4_2__
+
+// the reversed Castagnoli polynomial
+static const uint32_t kPoly = 0x82f63b78;
+
+struct Table {
+  uint32_t t[256];
+  Table() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? (c >> 1) ^ kPoly : c >> 1;
+      }
+      t[i] = c;
+    }
+  }
+};
+
+#endif
+
+#ifdef __SSE4_2__
+
+// the crc32 instruction takes 8 bytes at a time, one dependent stream
+// like this is bound by its latency of about 3 cycles
+uint32_t Extend(uint32_t crc, const char* data, size_t n) {
+  const char* p = data;
+  const char* end = data + n;
+  uint64_t c = crc ^ 0xffffffffu;
+  for (; p + 8 <= end; p += 8) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    c = _mm_crc32_u64(c, v);
+  }
+  uint32_t c32 = static_cast<uint32_t>(c);
+  for (; p < end; p++) {
+    c32 = _mm_crc32_u8(c32, static_cast<uint8_t>(*p));
+  }
+  return c32 ^ 0xffffffffu;
+}
+
+#else
+
+uint32_t Extend(uint32_t crc, const char* data, size_t n) {
+  static const Table table;
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  uint32_t c = crc ^ 0xffffffffu;
+  for (size_t i = 0; i < n; i++) {
+    c = table.t[(c ^ p[i]) & 0xff] ^ (c >> 8);
+  }
+  return c ^ 0xffffffffu;
+}
+
+#endif
+
+}  // namespace crc32c
+}  // namespace floyd
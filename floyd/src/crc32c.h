@@ -0,0 +1,26 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_CRC32C_H_
+#define FLOYD_SRC_CRC32C_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace floyd {
+namespace crc32c {
+
+// return the crc32c of concat(A, data[0, n-1]) where crc is the crc32c of A
+extern uint32_t Extend(uint32_t crc, const char* data, size_t n);
+
+// return the crc32c of data[0, n-1]
+inline uint32_t Value(const char* data, size_t n) {
+  return Extend(0, data, n);
+}
+
+}  // namespace crc32c
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_CRC32C_H_
@@ -0,0 +1,130 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/entry_cache.h"
+
+#include "floyd/src/entry_codec.h"
+#include "floyd/src/floyd.pb.h"
+
+namespace floyd {
+
+// the initial slots of the ring buffer, it is doubled when full
+static const size_t kInitSlots = 1024;
+
+EntryCache::EntryCache(uint64_t capacity)
+  : capacity_(capacity),
+    head_(0),
+    count_(0),
+    first_index_(0),
+    bytes_(0),
+    hits_(0),
+    misses_(0) {
+}
+
+EntryCache::~EntryCache() {
+  Clear();
+}
+
+void EntryCache::Append(uint64_t index, std::string* buf) {
+  if (capacity_ == 0) {
+    return;
+  }
+  if (count_ != 0 && index != LastIndex() + 1) {
+    Clear();
+  }
+  size_t size = buf->size();
+  if (size > capacity_) {
+    // we can't keep the cache continuous without this entry
+    Clear();
+    return;
+  }
+  while (count_ != 0 && bytes_ + size > capacity_) {
+    PopFront();
+  }
+  if (count_ == slots_.size()) {
+    Grow();
+  }
+  if (count_ == 0) {
+    first_index_ = index;
+  }
+  std::shared_ptr<std::string> shared(new std::string());
+  shared->swap(*buf);
+  SlotAt(count_).buf = shared;
+  count_++;
+  bytes_ += size;
+}
+
+bool EntryCache::Get(uint64_t index, Entry* entry, size_t* size, uint32_t* checksum) {
+  if (count_ == 0 || index < first_index_ || index > LastIndex()) {
+    misses_++;
+    return false;
+  }
+  Slot& slot = SlotAt(index - first_index_);
+  // the entry is checked when it is appended
+  if (!DecodeEntry(*slot.buf, entry, NULL, false).ok()) {
+    misses_++;
+    return false;
+  }
+  if (size != NULL) {
+    *size = slot.buf->size();
+  }
+  if (checksum != NULL) {
+    *checksum = CompactEntryChecksum(*slot.buf);
+  }
+  hits_++;
+  return true;
+}
+
+bool EntryCache::GetEncoded(uint64_t index, std::vector<std::shared_ptr<const std::string> >* bufs) {
+  if (count_ == 0 || index < first_index_ || index > LastIndex()) {
+    misses_++;
+    return false;
+  }
+  bufs->push_back(SlotAt(index - first_index_).buf);
+  hits_++;
+  return true;
+}
+
+void EntryCache::TruncateSuffix(uint64_t index) {
+  while (count_ != 0 && LastIndex() >= index) {
+    Slot& slot = SlotAt(count_ - 1);
+    bytes_ -= slot.buf->size();
+    slot.buf.reset();
+    count_--;
+  }
+}
+
+void EntryCache::TruncatePrefix(uint64_t index) {
+  while (count_ != 0 && first_index_ <= index) {
+    PopFront();
+  }
+}
+
+void EntryCache::Clear() {
+  while (count_ != 0) {
+    PopFront();
+  }
+  head_ = 0;
+}
+
+void EntryCache::PopFront() {
+  Slot& slot = SlotAt(0);
+  bytes_ -= slot.buf->size();
+  slot.buf.reset();
+  head_ = (head_ + 1) % slots_.size();
+  first_index_++;
+  count_--;
+}
+
+void EntryCache::Grow() {
+  std::vector<Slot> slots(slots_.empty() ? kInitSlots : slots_.size() * 2);
+  for (uint64_t i = 0; i < count_; i++) {
+    slots[i] = SlotAt(i);
+  }
+  slots_.swap(slots);
+  head_ = 0;
+}
+
+}  // namespace floyd
@@ -0,0 +1,88 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_ENTRY_CACHE_H_
+#define FLOYD_SRC_ENTRY_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace floyd {
+
+class Entry;
+
+/*
+ * EntryCache keeps the most recently appended entries in a ring buffer,
+ * the entries are kept in the compact format of entry_codec.h, so they
+ * are sent to the followers as they are, the cached entries are always
+ * continuous [FirstIndex(), LastIndex()], and the size of them is bounded
+ * by capacity bytes, the oldest entries are evicted when the budget is
+ * exceeded, a cached entry is never modified, so it is shared with the
+ * readers without being copied
+ *
+ * EntryCache is not thread safe, RaftLog protects it with lli_mutex_
+ */
+class EntryCache {
+ public:
+  // capacity 0 means the cache is disabled
+  explicit EntryCache(uint64_t capacity);
+  ~EntryCache();
+
+  // buf is an entry encoded by EncodeEntry, its content is taken by the
+  // cache, index must be LastIndex() + 1, otherwise the cache is reset to
+  // start from index
+  void Append(uint64_t index, std::string* buf);
+  // return false if index is not cached, size and checksum are of the
+  // encoded entry
+  bool Get(uint64_t index, Entry* entry, size_t* size = NULL, uint32_t* checksum = NULL);
+  // append the encoded entry to bufs, return false if index is not cached
+  bool GetEncoded(uint64_t index, std::vector<std::shared_ptr<const std::string> >* bufs);
+  // drop entries [index, LastIndex()]
+  void TruncateSuffix(uint64_t index);
+  // drop entries [FirstIndex(), index]
+  void TruncatePrefix(uint64_t index);
+  void Clear();
+
+  uint64_t FirstIndex() { return first_index_; }
+  uint64_t LastIndex() { return first_index_ + count_ - 1; }
+  uint64_t count() { return count_; }
+  uint64_t bytes() { return bytes_; }
+  uint64_t hits() { return hits_; }
+  uint64_t misses() { return misses_; }
+
+ private:
+  struct Slot {
+    std::shared_ptr<const std::string> buf;
+  };
+
+  const uint64_t capacity_;
+  // slots_[head_] is the entry of first_index_
+  std::vector<Slot> slots_;
+  size_t head_;
+  uint64_t count_;
+  uint64_t first_index_;
+  uint64_t bytes_;
+
+  // read by GetServerStatus without lli_mutex_
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+
+  Slot& SlotAt(uint64_t pos) { return slots_[(head_ + pos) % slots_.size()]; }
+  void PopFront();
+  void Grow();
+
+  // No copying allowed
+  EntryCache(const EntryCache&);
+  void operator=(const EntryCache&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_ENTRY_CACHE_H_
@@ -0,0 +1,222 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/entry_codec.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "floyd/src/crc32c.h"
+
+namespace floyd {
+
+// not a valid first byte of a serialized Entry, whose fields are all < 16
+static const char kEntryMagic = static_cast<char>(0xfe);
+static const char kEntryVersion = 1;
+
+static const size_t kCrcOffset = 4;
+static const size_t kTermOffset = 8;
+static const size_t kLeaseEndOffset = 16;
+static const size_t kLengthOffset = 24;
+
+static void PutFixed32(char* dst, uint32_t value) {
+  memcpy(dst, &value, sizeof(value));
+}
+
+static void PutFixed64(char* dst, uint64_t value) {
+  memcpy(dst, &value, sizeof(value));
+}
+
+static uint32_t GetFixed32(const char* src) {
+  uint32_t value;
+  memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+static uint64_t GetFixed64(const char* src) {
+  uint64_t value;
+  memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+static uint32_t EntryCrc(const char* data, size_t size) {
+  uint32_t crc = crc32c::Value(data, kCrcOffset);
+  return crc32c::Extend(crc, data + kTermOffset, size - kTermOffset);
+}
+
+// fill the header of entry except the crc32c
+static void EncodeHeader(const Entry& entry, const std::string* fields[4], char* p) {
+  p[0] = kEntryMagic;
+  p[1] = kEntryVersion;
+  p[2] = static_cast<char>(entry.optype());
+  p[3] = 0;
+  PutFixed64(p + kTermOffset, entry.term());
+  PutFixed64(p + kLeaseEndOffset, entry.lease_end());
+  for (int i = 0; i < 4; i++) {
+    PutFixed32(p + kLengthOffset + i * 4, fields[i]->size());
+  }
+}
+
+uint32_t EncodeEntry(const Entry& entry, std::string* dst) {
+  const std::string* fields[4] = {
+    &entry.key(), &entry.value(), &entry.holder(), &entry.server()
+  };
+  size_t offset = dst->size();
+  size_t size = kEntryHeaderSize;
+  for (int i = 0; i < 4; i++) {
+    size += fields[i]->size();
+  }
+  dst->resize(offset + size);
+  char* p = &(*dst)[offset];
+  EncodeHeader(entry, fields, p);
+  char* data = p + kEntryHeaderSize;
+  for (int i = 0; i < 4; i++) {
+    memcpy(data, fields[i]->data(), fields[i]->size());
+    data += fields[i]->size();
+  }
+  uint32_t crc = EntryCrc(p, size);
+  PutFixed32(p + kCrcOffset, crc);
+  return crc;
+}
+
+uint32_t EntryChecksum(const Entry& entry) {
+  const std::string* fields[4] = {
+    &entry.key(), &entry.value(), &entry.holder(), &entry.server()
+  };
+  char header[kEntryHeaderSize];
+  EncodeHeader(entry, fields, header);
+  uint32_t crc = EntryCrc(header, kEntryHeaderSize);
+  for (int i = 0; i < 4; i++) {
+    crc = crc32c::Extend(crc, fields[i]->data(), fields[i]->size());
+  }
+  return crc;
+}
+
+void EncodeChecksums(const std::vector<uint32_t>& checksums, std::string* dst) {
+  dst->resize(checksums.size() * sizeof(uint32_t));
+  for (size_t i = 0; i < checksums.size(); i++) {
+    PutFixed32(&(*dst)[i * sizeof(uint32_t)], checksums[i]);
+  }
+}
+
+Status VerifyEntries(const google::protobuf::RepeatedPtrField<Entry>& entries,
+    const std::string& checksums) {
+  if (checksums.size() != entries.size() * sizeof(uint32_t)) {
+    return Status::Corruption("checksums size mismatch");
+  }
+  for (int i = 0; i < entries.size(); i++) {
+    if (EntryChecksum(entries.Get(i)) != GetFixed32(checksums.data() + i * sizeof(uint32_t))) {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "entry %d checksum mismatch", i);
+      return Status::Corruption(buf);
+    }
+  }
+  return Status::OK();
+}
+
+bool IsCompactEntry(const rocksdb::Slice& buf) {
+  return !buf.empty() && buf[0] == kEntryMagic;
+}
+
+uint32_t CompactEntryChecksum(const rocksdb::Slice& buf) {
+  return GetFixed32(buf.data() + kCrcOffset);
+}
+
+Status DecodeEntry(const rocksdb::Slice& buf, Entry* entry, uint32_t* checksum,
+    bool verify_checksum) {
+  if (buf.empty() || buf[0] != kEntryMagic) {
+    if (!entry->ParseFromArray(buf.data(), buf.size())) {
+      return Status::Corruption("parse entry failed");
+    }
+    if (checksum != NULL) {
+      *checksum = EntryChecksum(*entry);
+    }
+    return Status::OK();
+  }
+  EntryView view;
+  Status s = view.Parse(buf, verify_checksum);
+  if (!s.ok()) {
+    return s;
+  }
+  entry->Clear();
+  entry->set_term(view.term());
+  entry->set_optype(view.optype());
+  if (view.lease_end() != 0) {
+    entry->set_lease_end(view.lease_end());
+  }
+  if (!view.key().empty()) {
+    entry->set_key(view.key().data(), view.key().size());
+  }
+  if (!view.value().empty()) {
+    entry->set_value(view.value().data(), view.value().size());
+  }
+  if (!view.holder().empty()) {
+    entry->set_holder(view.holder().data(), view.holder().size());
+  }
+  if (!view.server().empty()) {
+    entry->set_server(view.server().data(), view.server().size());
+  }
+  if (checksum != NULL) {
+    *checksum = GetFixed32(buf.data() + kCrcOffset);
+  }
+  return Status::OK();
+}
+
+EntryView::EntryView()
+  : term_(0),
+    optype_(Entry::kRead),
+    lease_end_(0) {
+}
+
+Status EntryView::Parse(const rocksdb::Slice& buf, bool verify_checksum) {
+  if (buf.empty() || buf[0] != kEntryMagic) {
+    if (!legacy_.ParseFromArray(buf.data(), buf.size())) {
+      return Status::Corruption("parse entry failed");
+    }
+    term_ = legacy_.term();
+    optype_ = legacy_.optype();
+    lease_end_ = legacy_.lease_end();
+    key_ = rocksdb::Slice(legacy_.key());
+    value_ = rocksdb::Slice(legacy_.value());
+    holder_ = rocksdb::Slice(legacy_.holder());
+    server_ = rocksdb::Slice(legacy_.server());
+    return Status::OK();
+  }
+
+  const char* p = buf.data();
+  if (buf.size() < kEntryHeaderSize) {
+    return Status::Corruption("entry header truncated");
+  }
+  if (p[1] != kEntryVersion) {
+    return Status::NotSupported("unknown entry version");
+  }
+  if (!Entry::OpType_IsValid(static_cast<uint8_t>(p[2]))) {
+    return Status::Corruption("invalid entry optype");
+  }
+  uint64_t size = kEntryHeaderSize;
+  uint32_t lens[4];
+  for (int i = 0; i < 4; i++) {
+    lens[i] = GetFixed32(p + kLengthOffset + i * 4);
+    size += lens[i];
+  }
+  if (size != buf.size()) {
+    return Status::Corruption("entry size mismatch");
+  }
+  if (verify_checksum && GetFixed32(p + kCrcOffset) != EntryCrc(p, size)) {
+    return Status::Corruption("entry checksum mismatch");
+  }
+  term_ = GetFixed64(p + kTermOffset);
+  optype_ = static_cast<Entry::OpType>(static_cast<uint8_t>(p[2]));
+  lease_end_ = GetFixed64(p + kLeaseEndOffset);
+  const char* data = p + kEntryHeaderSize;
+  rocksdb::Slice* fields[4] = { &key_, &value_, &holder_, &server_ };
+  for (int i = 0; i < 4; i++) {
+    *fields[i] = rocksdb::Slice(data, lens[i]);
+    data += lens[i];
+  }
+  return Status::OK();
+}
+
+}  // namespace floyd
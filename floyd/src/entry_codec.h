@@ -0,0 +1,104 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_ENTRY_CODEC_H_
+#define FLOYD_SRC_ENTRY_CODEC_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "slash/include/slash_status.h"
+
+#include "floyd/src/floyd.pb.h"
+
+namespace floyd {
+
+using slash::Status;
+
+/*
+ * the log entries are stored in a compact format with a fixed header, all
+ * the integers are little endian
+ *
+ *   0       1         2        3        4       8      16          24
+ *   +-------+---------+--------+--------+-------+------+-----------+
+ *   | magic | version | optype | unused | crc32c| term | lease_end |
+ *   +-------+---------+--------+--------+-------+------+-----------+
+ *   24        28          32           36           40
+ *   +---------+-----------+------------+------------+-----+-------+--------+--------+
+ *   | key_len | value_len | holder_len | server_len | key | value | holder | server |
+ *   +---------+-----------+------------+------------+-----+-------+--------+--------+
+ *
+ * crc32c covers the whole entry except the crc32c itself
+ * an entry written by the old floyd is a serialized protobuf Entry, which
+ * never starts with the magic byte, so both of them can be read
+ */
+static const size_t kEntryHeaderSize = 40;
+
+// encode entry to the end of dst, return the checksum of it
+extern uint32_t EncodeEntry(const Entry& entry, std::string* dst);
+
+// decode an entry in either format, the checksum is verified unless
+// verify_checksum is false, and returned in checksum if it is not NULL
+extern Status DecodeEntry(const rocksdb::Slice& buf, Entry* entry,
+    uint32_t* checksum = NULL, bool verify_checksum = true);
+
+// whether buf is in the compact format rather than a serialized Entry
+extern bool IsCompactEntry(const rocksdb::Slice& buf);
+
+// the checksum in the header of an entry in the compact format
+extern uint32_t CompactEntryChecksum(const rocksdb::Slice& buf);
+
+// the checksum of entry in the compact format, without encoding it
+extern uint32_t EntryChecksum(const Entry& entry);
+
+// encode the checksums of the entries sent in one AppendEntries
+extern void EncodeChecksums(const std::vector<uint32_t>& checksums, std::string* dst);
+
+// check the entries received against the checksums from EncodeChecksums
+extern Status VerifyEntries(const google::protobuf::RepeatedPtrField<Entry>& entries,
+    const std::string& checksums);
+
+/*
+ * EntryView reads the fields of an encoded entry in place, the strings
+ * are slices of the buffer, which should outlive the view
+ */
+class EntryView {
+ public:
+  EntryView();
+
+  // the checksum of the compact format is verified unless verify_checksum
+  // is false, the other fields are always checked
+  Status Parse(const rocksdb::Slice& buf, bool verify_checksum = true);
+
+  uint64_t term() const { return term_; }
+  Entry::OpType optype() const { return optype_; }
+  uint64_t lease_end() const { return lease_end_; }
+  const rocksdb::Slice& key() const { return key_; }
+  const rocksdb::Slice& value() const { return value_; }
+  const rocksdb::Slice& holder() const { return holder_; }
+  const rocksdb::Slice& server() const { return server_; }
+
+ private:
+  uint64_t term_;
+  Entry::OpType optype_;
+  uint64_t lease_end_;
+  rocksdb::Slice key_;
+  rocksdb::Slice value_;
+  rocksdb::Slice holder_;
+  rocksdb::Slice server_;
+  // the entry in protobuf format is parsed here, the slices point into it
+  Entry legacy_;
+
+  // No copying allowed
+  EntryView(const EntryView&);
+  void operator=(const EntryView&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_ENTRY_CODEC_H_
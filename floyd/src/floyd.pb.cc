@@ -48,6 +48,12 @@ const ::google::protobuf::internal::GeneratedMessageReflection*
 const ::google::protobuf::Descriptor* CmdRequest_ServerStatus_descriptor_ = NULL;
 const ::google::protobuf::internal::GeneratedMessageReflection*
   CmdRequest_ServerStatus_reflection_ = NULL;
+const ::google::protobuf::Descriptor* CmdRequest_InstallSnapshot_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  CmdRequest_InstallSnapshot_reflection_ = NULL;
+const ::google::protobuf::Descriptor* CmdRequest_LeaderHeartbeat_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  CmdRequest_LeaderHeartbeat_reflection_ = NULL;
 const ::google::protobuf::Descriptor* CmdResponse_descriptor_ = NULL;
 const ::google::protobuf::internal::GeneratedMessageReflection*
   CmdResponse_reflection_ = NULL;
@@ -63,6 +69,12 @@ const ::google::protobuf::internal::GeneratedMessageReflection*
 const ::google::protobuf::Descriptor* CmdResponse_ServerStatus_descriptor_ = NULL;
 const ::google::protobuf::internal::GeneratedMessageReflection*
   CmdResponse_ServerStatus_reflection_ = NULL;
+const ::google::protobuf::Descriptor* CmdResponse_InstallSnapshotResponse_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  CmdResponse_InstallSnapshotResponse_reflection_ = NULL;
+const ::google::protobuf::Descriptor* CmdResponse_LeaderHeartbeatResponse_descriptor_ = NULL;
+const ::google::protobuf::internal::GeneratedMessageReflection*
+  CmdResponse_LeaderHeartbeatResponse_reflection_ = NULL;
 const ::google::protobuf::Descriptor* Lock_descriptor_ = NULL;
 const ::google::protobuf::internal::GeneratedMessageReflection*
   Lock_reflection_ = NULL;
@@ -104,7 +116,7 @@ void protobuf_AssignDesc_floyd_2eproto() {
       sizeof(Entry));
   Entry_OpType_descriptor_ = Entry_descriptor_->enum_type(0);
   CmdRequest_descriptor_ = file->message_type(1);
-  static const int CmdRequest_offsets_[8] = {
+  static const int CmdRequest_offsets_[10] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, type_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, request_vote_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, append_entries_),
@@ -113,6 +125,8 @@ void protobuf_AssignDesc_floyd_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, add_server_request_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, remove_server_request_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, server_status_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, install_snapshot_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest, leader_heartbeat_),
   };
   CmdRequest_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -145,7 +159,7 @@ void protobuf_AssignDesc_floyd_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(CmdRequest_RequestVote));
   CmdRequest_AppendEntries_descriptor_ = CmdRequest_descriptor_->nested_type(1);
-  static const int CmdRequest_AppendEntries_offsets_[7] = {
+  static const int CmdRequest_AppendEntries_offsets_[10] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, term_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, ip_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, port_),
@@ -153,6 +167,9 @@ void protobuf_AssignDesc_floyd_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, prev_log_term_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, leader_commit_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, entries_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, checksums_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, raw_entries_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_AppendEntries, raw_entries_unchecked_),
   };
   CmdRequest_AppendEntries_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -246,8 +263,50 @@ void protobuf_AssignDesc_floyd_2eproto() {
       ::google::protobuf::DescriptorPool::generated_pool(),
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(CmdRequest_ServerStatus));
+  CmdRequest_InstallSnapshot_descriptor_ = CmdRequest_descriptor_->nested_type(7);
+  static const int CmdRequest_InstallSnapshot_offsets_[10] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, ip_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, port_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, last_included_index_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, last_included_term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, seq_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, filename_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, offset_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, data_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, done_),
+  };
+  CmdRequest_InstallSnapshot_reflection_ =
+    new ::google::protobuf::internal::GeneratedMessageReflection(
+      CmdRequest_InstallSnapshot_descriptor_,
+      CmdRequest_InstallSnapshot::default_instance_,
+      CmdRequest_InstallSnapshot_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, _has_bits_[0]),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_InstallSnapshot, _unknown_fields_),
+      -1,
+      ::google::protobuf::DescriptorPool::generated_pool(),
+      ::google::protobuf::MessageFactory::generated_factory(),
+      sizeof(CmdRequest_InstallSnapshot));
+  CmdRequest_LeaderHeartbeat_descriptor_ = CmdRequest_descriptor_->nested_type(8);
+  static const int CmdRequest_LeaderHeartbeat_offsets_[4] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, ip_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, port_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, leader_commit_),
+  };
+  CmdRequest_LeaderHeartbeat_reflection_ =
+    new ::google::protobuf::internal::GeneratedMessageReflection(
+      CmdRequest_LeaderHeartbeat_descriptor_,
+      CmdRequest_LeaderHeartbeat::default_instance_,
+      CmdRequest_LeaderHeartbeat_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, _has_bits_[0]),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdRequest_LeaderHeartbeat, _unknown_fields_),
+      -1,
+      ::google::protobuf::DescriptorPool::generated_pool(),
+      ::google::protobuf::MessageFactory::generated_factory(),
+      sizeof(CmdRequest_LeaderHeartbeat));
   CmdResponse_descriptor_ = file->message_type(2);
-  static const int CmdResponse_offsets_[8] = {
+  static const int CmdResponse_offsets_[10] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, type_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, code_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, request_vote_res_),
@@ -256,6 +315,8 @@ void protobuf_AssignDesc_floyd_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, kv_response_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, server_status_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, all_servers_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, install_snapshot_res_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse, leader_heartbeat_res_),
   };
   CmdResponse_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -285,10 +346,14 @@ void protobuf_AssignDesc_floyd_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(CmdResponse_RequestVoteResponse));
   CmdResponse_AppendEntriesResponse_descriptor_ = CmdResponse_descriptor_->nested_type(1);
-  static const int CmdResponse_AppendEntriesResponse_offsets_[3] = {
+  static const int CmdResponse_AppendEntriesResponse_offsets_[7] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, term_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, success_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, last_log_index_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, conflict_term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, conflict_index_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, last_applied_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_AppendEntriesResponse, match_index_),
   };
   CmdResponse_AppendEntriesResponse_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -340,6 +405,39 @@ void protobuf_AssignDesc_floyd_2eproto() {
       ::google::protobuf::DescriptorPool::generated_pool(),
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(CmdResponse_ServerStatus));
+  CmdResponse_InstallSnapshotResponse_descriptor_ = CmdResponse_descriptor_->nested_type(4);
+  static const int CmdResponse_InstallSnapshotResponse_offsets_[2] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_InstallSnapshotResponse, term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_InstallSnapshotResponse, success_),
+  };
+  CmdResponse_InstallSnapshotResponse_reflection_ =
+    new ::google::protobuf::internal::GeneratedMessageReflection(
+      CmdResponse_InstallSnapshotResponse_descriptor_,
+      CmdResponse_InstallSnapshotResponse::default_instance_,
+      CmdResponse_InstallSnapshotResponse_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_InstallSnapshotResponse, _has_bits_[0]),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_InstallSnapshotResponse, _unknown_fields_),
+      -1,
+      ::google::protobuf::DescriptorPool::generated_pool(),
+      ::google::protobuf::MessageFactory::generated_factory(),
+      sizeof(CmdResponse_InstallSnapshotResponse));
+  CmdResponse_LeaderHeartbeatResponse_descriptor_ = CmdResponse_descriptor_->nested_type(5);
+  static const int CmdResponse_LeaderHeartbeatResponse_offsets_[3] = {
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_LeaderHeartbeatResponse, term_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_LeaderHeartbeatResponse, success_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_LeaderHeartbeatResponse, last_applied_),
+  };
+  CmdResponse_LeaderHeartbeatResponse_reflection_ =
+    new ::google::protobuf::internal::GeneratedMessageReflection(
+      CmdResponse_LeaderHeartbeatResponse_descriptor_,
+      CmdResponse_LeaderHeartbeatResponse::default_instance_,
+      CmdResponse_LeaderHeartbeatResponse_offsets_,
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_LeaderHeartbeatResponse, _has_bits_[0]),
+      GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(CmdResponse_LeaderHeartbeatResponse, _unknown_fields_),
+      -1,
+      ::google::protobuf::DescriptorPool::generated_pool(),
+      ::google::protobuf::MessageFactory::generated_factory(),
+      sizeof(CmdResponse_LeaderHeartbeatResponse));
   Lock_descriptor_ = file->message_type(3);
   static const int Lock_offsets_[2] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Lock, holder_),
@@ -403,6 +501,10 @@ void protobuf_RegisterTypes(const ::std::string&) {
     CmdRequest_RemoveServerRequest_descriptor_, &CmdRequest_RemoveServerRequest::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
     CmdRequest_ServerStatus_descriptor_, &CmdRequest_ServerStatus::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+    CmdRequest_InstallSnapshot_descriptor_, &CmdRequest_InstallSnapshot::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+    CmdRequest_LeaderHeartbeat_descriptor_, &CmdRequest_LeaderHeartbeat::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
     CmdResponse_descriptor_, &CmdResponse::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
@@ -413,6 +515,10 @@ void protobuf_RegisterTypes(const ::std::string&) {
     CmdResponse_KvResponse_descriptor_, &CmdResponse_KvResponse::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
     CmdResponse_ServerStatus_descriptor_, &CmdResponse_ServerStatus::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+    CmdResponse_InstallSnapshotResponse_descriptor_, &CmdResponse_InstallSnapshotResponse::default_instance());
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
+    CmdResponse_LeaderHeartbeatResponse_descriptor_, &CmdResponse_LeaderHeartbeatResponse::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
     Lock_descriptor_, &Lock::default_instance());
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedMessage(
@@ -440,6 +546,10 @@ void protobuf_ShutdownFile_floyd_2eproto() {
   delete CmdRequest_RemoveServerRequest_reflection_;
   delete CmdRequest_ServerStatus::default_instance_;
   delete CmdRequest_ServerStatus_reflection_;
+  delete CmdRequest_InstallSnapshot::default_instance_;
+  delete CmdRequest_InstallSnapshot_reflection_;
+  delete CmdRequest_LeaderHeartbeat::default_instance_;
+  delete CmdRequest_LeaderHeartbeat_reflection_;
   delete CmdResponse::default_instance_;
   delete CmdResponse_reflection_;
   delete CmdResponse_RequestVoteResponse::default_instance_;
@@ -450,6 +560,10 @@ void protobuf_ShutdownFile_floyd_2eproto() {
   delete CmdResponse_KvResponse_reflection_;
   delete CmdResponse_ServerStatus::default_instance_;
   delete CmdResponse_ServerStatus_reflection_;
+  delete CmdResponse_InstallSnapshotResponse::default_instance_;
+  delete CmdResponse_InstallSnapshotResponse_reflection_;
+  delete CmdResponse_LeaderHeartbeatResponse::default_instance_;
+  delete CmdResponse_LeaderHeartbeatResponse_reflection_;
   delete Lock::default_instance_;
   delete Lock_reflection_;
   delete Membership::default_instance_;
@@ -470,7 +584,7 @@ void protobuf_AddDesc_floyd_2eproto() {
     "\"~\n\006OpType\022\t\n\005kRead\020\000\022\n\n\006kWrite\020\001\022\013\n\007kDe"
     "lete\020\002\022\014\n\010kTryLock\020\004\022\013\n\007kUnLock\020\005\022\016\n\nkAd"
     "dServer\020\006\022\021\n\rkRemoveServer\020\007\022\022\n\016kGetAllS"
-    "ervers\020\010\"\307\007\n\nCmdRequest\022\031\n\004type\030\001 \002(\0162\013."
+    "ervers\020\010\"\232\013\n\nCmdRequest\022\031\n\004type\030\001 \002(\0162\013."
     "floyd.Type\0223\n\014request_vote\030\002 \001(\0132\035.floyd"
     ".CmdRequest.RequestVote\0227\n\016append_entrie"
     "s\030\003 \001(\0132\037.floyd.CmdRequest.AppendEntries"
@@ -481,47 +595,69 @@ void protobuf_AddDesc_floyd_2eproto() {
     "equest\022D\n\025remove_server_request\030\010 \001(\0132%."
     "floyd.CmdRequest.RemoveServerRequest\0225\n\r"
     "server_status\030\006 \001(\0132\036.floyd.CmdRequest.S"
-    "erverStatus\032d\n\013RequestVote\022\014\n\004term\030\001 \002(\004"
-    "\022\n\n\002ip\030\002 \002(\014\022\014\n\004port\030\003 \002(\005\022\026\n\016last_log_i"
-    "ndex\030\004 \002(\004\022\025\n\rlast_log_term\030\005 \002(\004\032\234\001\n\rAp"
-    "pendEntries\022\014\n\004term\030\001 \002(\004\022\n\n\002ip\030\002 \002(\014\022\014\n"
-    "\004port\030\003 \002(\005\022\026\n\016prev_log_index\030\004 \002(\004\022\025\n\rp"
-    "rev_log_term\030\005 \002(\004\022\025\n\rleader_commit\030\006 \002("
-    "\004\022\035\n\007entries\030\007 \003(\0132\014.floyd.Entry\032\'\n\tKvRe"
-    "quest\022\013\n\003key\030\001 \002(\014\022\r\n\005value\030\002 \001(\014\032>\n\013Loc"
-    "kRequest\022\014\n\004name\030\001 \002(\014\022\016\n\006holder\030\002 \002(\014\022\021"
-    "\n\tlease_end\030\003 \001(\004\032&\n\020AddServerRequest\022\022\n"
-    "\nnew_server\030\001 \002(\014\032)\n\023RemoveServerRequest"
-    "\022\022\n\nold_server\030\001 \002(\014\032L\n\014ServerStatus\022\014\n\004"
-    "term\030\001 \002(\003\022\024\n\014commit_index\030\002 \002(\003\022\n\n\002ip\030\003"
-    " \001(\014\022\014\n\004port\030\004 \001(\005\"\370\005\n\013CmdResponse\022\031\n\004ty"
-    "pe\030\001 \002(\0162\013.floyd.Type\022\037\n\004code\030\002 \001(\0162\021.fl"
-    "oyd.StatusCode\022@\n\020request_vote_res\030\003 \001(\013"
-    "2&.floyd.CmdResponse.RequestVoteResponse"
-    "\022D\n\022append_entries_res\030\004 \001(\0132(.floyd.Cmd"
-    "Response.AppendEntriesResponse\022\013\n\003msg\030\005 "
-    "\001(\014\0222\n\013kv_response\030\006 \001(\0132\035.floyd.CmdResp"
-    "onse.KvResponse\0226\n\rserver_status\030\007 \001(\0132\037"
-    ".floyd.CmdResponse.ServerStatus\022&\n\013all_s"
-    "ervers\030\010 \001(\0132\021.floyd.Membership\0329\n\023Reque"
-    "stVoteResponse\022\014\n\004term\030\001 \002(\004\022\024\n\014vote_gra"
-    "nted\030\002 \002(\010\032N\n\025AppendEntriesResponse\022\014\n\004t"
-    "erm\030\001 \002(\004\022\017\n\007success\030\002 \002(\010\022\026\n\016last_log_i"
-    "ndex\030\003 \001(\004\032\033\n\nKvResponse\022\r\n\005value\030\001 \001(\014\032"
-    "\333\001\n\014ServerStatus\022\014\n\004term\030\001 \002(\004\022\024\n\014commit"
-    "_index\030\002 \002(\004\022\014\n\004role\030\003 \002(\014\022\021\n\tleader_ip\030"
-    "\004 \001(\014\022\023\n\013leader_port\030\005 \001(\005\022\024\n\014voted_for_"
-    "ip\030\006 \001(\014\022\026\n\016voted_for_port\030\007 \001(\005\022\025\n\rlast"
-    "_log_term\030\010 \001(\004\022\026\n\016last_log_index\030\t \001(\004\022"
-    "\024\n\014last_applied\030\n \001(\004\")\n\004Lock\022\016\n\006holder\030"
-    "\001 \002(\014\022\021\n\tlease_end\030\002 \002(\004\"\033\n\nMembership\022\r"
-    "\n\005nodes\030\001 \003(\014*\265\001\n\004Type\022\t\n\005kRead\020\000\022\n\n\006kWr"
-    "ite\020\001\022\013\n\007kDelete\020\003\022\014\n\010kTryLock\020\005\022\013\n\007kUnL"
-    "ock\020\006\022\016\n\nkAddServer\020\013\022\021\n\rkRemoveServer\020\014"
-    "\022\022\n\016kGetAllServers\020\r\022\020\n\014kRequestVote\020\010\022\022"
-    "\n\016kAppendEntries\020\t\022\021\n\rkServerStatus\020\n*=\n"
-    "\nStatusCode\022\007\n\003kOk\020\000\022\r\n\tkNotFound\020\001\022\n\n\006k"
-    "Error\020\002\022\013\n\007kLocked\020\003", 2340);
+    "erverStatus\022;\n\020install_snapshot\030\t \001(\0132!."
+    "floyd.CmdRequest.InstallSnapshot\022;\n\020lead"
+    "er_heartbeat\030\n \001(\0132!.floyd.CmdRequest.Le"
+    "aderHeartbeat\032d\n\013RequestVote\022\014\n\004term\030\001 \002"
+    "(\004\022\n\n\002ip\030\002 \002(\014\022\014\n\004port\030\003 \002(\005\022\026\n\016last_log"
+    "_index\030\004 \002(\004\022\025\n\rlast_log_term\030\005 \002(\004\032\343\001\n\r"
+    "AppendEntries\022\014\n\004term\030\001 \002(\004\022\n\n\002ip\030\002 \002(\014\022"
+    "\014\n\004port\030\003 \002(\005\022\026\n\016prev_log_index\030\004 \002(\004\022\025\n"
+    "\rprev_log_term\030\005 \002(\004\022\025\n\rleader_commit\030\006 "
+    "\002(\004\022\035\n\007entries\030\007 \003(\0132\014.floyd.Entry\022\021\n\tch"
+    "ecksums\030\010 \001(\014\022\023\n\013raw_entries\030\t \003(\014\022\035\n\025ra"
+    "w_entries_unchecked\030\n \001(\010\032\'\n\tKvRequest\022\013"
+    "\n\003key\030\001 \002(\014\022\r\n\005value\030\002 \001(\014\032>\n\013LockReques"
+    "t\022\014\n\004name\030\001 \002(\014\022\016\n\006holder\030\002 \002(\014\022\021\n\tlease"
+    "_end\030\003 \001(\004\032&\n\020AddServerRequest\022\022\n\nnew_se"
+    "rver\030\001 \002(\014\032)\n\023RemoveServerRequest\022\022\n\nold"
+    "_server\030\001 \002(\014\032L\n\014ServerStatus\022\014\n\004term\030\001 "
+    "\002(\003\022\024\n\014commit_index\030\002 \002(\003\022\n\n\002ip\030\003 \001(\014\022\014\n"
+    "\004port\030\004 \001(\005\032\275\001\n\017InstallSnapshot\022\014\n\004term\030"
+    "\001 \002(\004\022\n\n\002ip\030\002 \002(\014\022\014\n\004port\030\003 \002(\005\022\033\n\023last_"
+    "included_index\030\004 \002(\004\022\032\n\022last_included_te"
+    "rm\030\005 \002(\004\022\013\n\003seq\030\006 \002(\004\022\020\n\010filename\030\007 \002(\014\022"
+    "\016\n\006offset\030\010 \002(\004\022\014\n\004data\030\t \002(\014\022\014\n\004done\030\n "
+    "\002(\010\032P\n\017LeaderHeartbeat\022\014\n\004term\030\001 \002(\004\022\n\n\002"
+    "ip\030\002 \002(\014\022\014\n\004port\030\003 \002(\005\022\025\n\rleader_commit\030"
+    "\004 \002(\004\"\361\010\n\013CmdResponse\022\031\n\004type\030\001 \002(\0162\013.fl"
+    "oyd.Type\022\037\n\004code\030\002 \001(\0162\021.floyd.StatusCod"
+    "e\022@\n\020request_vote_res\030\003 \001(\0132&.floyd.CmdR"
+    "esponse.RequestVoteResponse\022D\n\022append_en"
+    "tries_res\030\004 \001(\0132(.floyd.CmdResponse.Appe"
+    "ndEntriesResponse\022\013\n\003msg\030\005 \001(\014\0222\n\013kv_res"
+    "ponse\030\006 \001(\0132\035.floyd.CmdResponse.KvRespon"
+    "se\0226\n\rserver_status\030\007 \001(\0132\037.floyd.CmdRes"
+    "ponse.ServerStatus\022&\n\013all_servers\030\010 \001(\0132"
+    "\021.floyd.Membership\022H\n\024install_snapshot_r"
+    "es\030\t \001(\0132*.floyd.CmdResponse.InstallSnap"
+    "shotResponse\022H\n\024leader_heartbeat_res\030\n \001"
+    "(\0132*.floyd.CmdResponse.LeaderHeartbeatRe"
+    "sponse\0329\n\023RequestVoteResponse\022\014\n\004term\030\001 "
+    "\002(\004\022\024\n\014vote_granted\030\002 \002(\010\032\250\001\n\025AppendEntr"
+    "iesResponse\022\014\n\004term\030\001 \002(\004\022\017\n\007success\030\002 \002"
+    "(\010\022\026\n\016last_log_index\030\003 \001(\004\022\025\n\rconflict_t"
+    "erm\030\004 \001(\004\022\026\n\016conflict_index\030\005 \001(\004\022\024\n\014las"
+    "t_applied\030\006 \001(\004\022\023\n\013match_index\030\007 \001(\004\032\033\n\n"
+    "KvResponse\022\r\n\005value\030\001 \001(\014\032\333\001\n\014ServerStat"
+    "us\022\014\n\004term\030\001 \002(\004\022\024\n\014commit_index\030\002 \002(\004\022\014"
+    "\n\004role\030\003 \002(\014\022\021\n\tleader_ip\030\004 \001(\014\022\023\n\013leade"
+    "r_port\030\005 \001(\005\022\024\n\014voted_for_ip\030\006 \001(\014\022\026\n\016vo"
+    "ted_for_port\030\007 \001(\005\022\025\n\rlast_log_term\030\010 \001("
+    "\004\022\026\n\016last_log_index\030\t \001(\004\022\024\n\014last_applie"
+    "d\030\n \001(\004\0328\n\027InstallSnapshotResponse\022\014\n\004te"
+    "rm\030\001 \002(\004\022\017\n\007success\030\002 \002(\010\032N\n\027LeaderHeart"
+    "beatResponse\022\014\n\004term\030\001 \002(\004\022\017\n\007success\030\002 "
+    "\002(\010\022\024\n\014last_applied\030\003 \001(\004\")\n\004Lock\022\016\n\006hol"
+    "der\030\001 \002(\014\022\021\n\tlease_end\030\002 \002(\004\"\033\n\nMembersh"
+    "ip\022\r\n\005nodes\030\001 \003(\014*\341\001\n\004Type\022\t\n\005kRead\020\000\022\n\n"
+    "\006kWrite\020\001\022\013\n\007kDelete\020\003\022\014\n\010kTryLock\020\005\022\013\n\007"
+    "kUnLock\020\006\022\016\n\nkAddServer\020\013\022\021\n\rkRemoveServ"
+    "er\020\014\022\022\n\016kGetAllServers\020\r\022\020\n\014kRequestVote"
+    "\020\010\022\022\n\016kAppendEntries\020\t\022\021\n\rkServerStatus\020"
+    "\n\022\024\n\020kInstallSnapshot\020\016\022\024\n\020kLeaderHeartb"
+    "eat\020\017*=\n\nStatusCode\022\007\n\003kOk\020\000\022\r\n\tkNotFoun"
+    "d\020\001\022\n\n\006kError\020\002\022\013\n\007kLocked\020\003", 3228);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "floyd.proto", &protobuf_RegisterTypes);
   Entry::default_instance_ = new Entry();
@@ -533,11 +669,15 @@ void protobuf_AddDesc_floyd_2eproto() {
   CmdRequest_AddServerRequest::default_instance_ = new CmdRequest_AddServerRequest();
   CmdRequest_RemoveServerRequest::default_instance_ = new CmdRequest_RemoveServerRequest();
   CmdRequest_ServerStatus::default_instance_ = new CmdRequest_ServerStatus();
+  CmdRequest_InstallSnapshot::default_instance_ = new CmdRequest_InstallSnapshot();
+  CmdRequest_LeaderHeartbeat::default_instance_ = new CmdRequest_LeaderHeartbeat();
   CmdResponse::default_instance_ = new CmdResponse();
   CmdResponse_RequestVoteResponse::default_instance_ = new CmdResponse_RequestVoteResponse();
   CmdResponse_AppendEntriesResponse::default_instance_ = new CmdResponse_AppendEntriesResponse();
   CmdResponse_KvResponse::default_instance_ = new CmdResponse_KvResponse();
   CmdResponse_ServerStatus::default_instance_ = new CmdResponse_ServerStatus();
+  CmdResponse_InstallSnapshotResponse::default_instance_ = new CmdResponse_InstallSnapshotResponse();
+  CmdResponse_LeaderHeartbeatResponse::default_instance_ = new CmdResponse_LeaderHeartbeatResponse();
   Lock::default_instance_ = new Lock();
   Membership::default_instance_ = new Membership();
   Entry::default_instance_->InitAsDefaultInstance();
@@ -549,11 +689,15 @@ void protobuf_AddDesc_floyd_2eproto() {
   CmdRequest_AddServerRequest::default_instance_->InitAsDefaultInstance();
   CmdRequest_RemoveServerRequest::default_instance_->InitAsDefaultInstance();
   CmdRequest_ServerStatus::default_instance_->InitAsDefaultInstance();
+  CmdRequest_InstallSnapshot::default_instance_->InitAsDefaultInstance();
+  CmdRequest_LeaderHeartbeat::default_instance_->InitAsDefaultInstance();
   CmdResponse::default_instance_->InitAsDefaultInstance();
   CmdResponse_RequestVoteResponse::default_instance_->InitAsDefaultInstance();
   CmdResponse_AppendEntriesResponse::default_instance_->InitAsDefaultInstance();
   CmdResponse_KvResponse::default_instance_->InitAsDefaultInstance();
   CmdResponse_ServerStatus::default_instance_->InitAsDefaultInstance();
+  CmdResponse_InstallSnapshotResponse::default_instance_->InitAsDefaultInstance();
+  CmdResponse_LeaderHeartbeatResponse::default_instance_->InitAsDefaultInstance();
   Lock::default_instance_->InitAsDefaultInstance();
   Membership::default_instance_->InitAsDefaultInstance();
   ::google::protobuf::internal::OnShutdown(&protobuf_ShutdownFile_floyd_2eproto);
@@ -582,6 +726,8 @@ bool Type_IsValid(int value) {
     case 11:
     case 12:
     case 13:
+    case 14:
+    case 15:
       return true;
     default:
       return false;
@@ -1521,6 +1667,9 @@ const int CmdRequest_AppendEntries::kPrevLogIndexFieldNumber;
 const int CmdRequest_AppendEntries::kPrevLogTermFieldNumber;
 const int CmdRequest_AppendEntries::kLeaderCommitFieldNumber;
 const int CmdRequest_AppendEntries::kEntriesFieldNumber;
+const int CmdRequest_AppendEntries::kChecksumsFieldNumber;
+const int CmdRequest_AppendEntries::kRawEntriesFieldNumber;
+const int CmdRequest_AppendEntries::kRawEntriesUncheckedFieldNumber;
 #endif  // !_MSC_VER
 
 CmdRequest_AppendEntries::CmdRequest_AppendEntries()
@@ -1545,6 +1694,8 @@ void CmdRequest_AppendEntries::SharedCtor() {
   prev_log_index_ = GOOGLE_ULONGLONG(0);
   prev_log_term_ = GOOGLE_ULONGLONG(0);
   leader_commit_ = GOOGLE_ULONGLONG(0);
+  checksums_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  raw_entries_unchecked_ = false;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -1556,6 +1707,9 @@ void CmdRequest_AppendEntries::SharedDtor() {
   if (ip_ != &::google::protobuf::internal::kEmptyString) {
     delete ip_;
   }
+  if (checksums_ != &::google::protobuf::internal::kEmptyString) {
+    delete checksums_;
+  }
   if (this != default_instance_) {
   }
 }
@@ -1593,8 +1747,17 @@ void CmdRequest_AppendEntries::Clear() {
     prev_log_index_ = GOOGLE_ULONGLONG(0);
     prev_log_term_ = GOOGLE_ULONGLONG(0);
     leader_commit_ = GOOGLE_ULONGLONG(0);
+    if (has_checksums()) {
+      if (checksums_ != &::google::protobuf::internal::kEmptyString) {
+        checksums_->clear();
+      }
+    }
+  }
+  if (_has_bits_[9 / 32] & (0xffu << (9 % 32))) {
+    raw_entries_unchecked_ = false;
   }
   entries_.Clear();
+  raw_entries_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
@@ -1709,6 +1872,51 @@ bool CmdRequest_AppendEntries::MergePartialFromCodedStream(
           goto handle_uninterpreted;
         }
         if (input->ExpectTag(58)) goto parse_entries;
+        if (input->ExpectTag(66)) goto parse_checksums;
+        break;
+      }
+
+      // optional bytes checksums = 8;
+      case 8: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_checksums:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_checksums()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(74)) goto parse_raw_entries;
+        break;
+      }
+
+      // repeated bytes raw_entries = 9;
+      case 9: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_raw_entries:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->add_raw_entries()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(74)) goto parse_raw_entries;
+        if (input->ExpectTag(80)) goto parse_raw_entries_unchecked;
+        break;
+      }
+
+      // optional bool raw_entries_unchecked = 10;
+      case 10: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_raw_entries_unchecked:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &raw_entries_unchecked_)));
+          set_has_raw_entries_unchecked();
+        } else {
+          goto handle_uninterpreted;
+        }
         if (input->ExpectAtEnd()) return true;
         break;
       }
@@ -1768,6 +1976,23 @@ void CmdRequest_AppendEntries::SerializeWithCachedSizes(
       7, this->entries(i), output);
   }
 
+  // optional bytes checksums = 8;
+  if (has_checksums()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      8, this->checksums(), output);
+  }
+
+  // repeated bytes raw_entries = 9;
+  for (int i = 0; i < this->raw_entries_size(); i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      9, this->raw_entries(i), output);
+  }
+
+  // optional bool raw_entries_unchecked = 10;
+  if (has_raw_entries_unchecked()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(10, this->raw_entries_unchecked(), output);
+  }
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -1815,6 +2040,24 @@ void CmdRequest_AppendEntries::SerializeWithCachedSizes(
         7, this->entries(i), target);
   }
 
+  // optional bytes checksums = 8;
+  if (has_checksums()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        8, this->checksums(), target);
+  }
+
+  // repeated bytes raw_entries = 9;
+  for (int i = 0; i < this->raw_entries_size(); i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteBytesToArray(9, this->raw_entries(i), target);
+  }
+
+  // optional bool raw_entries_unchecked = 10;
+  if (has_raw_entries_unchecked()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->raw_entries_unchecked(), target);
+  }
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -1868,6 +2111,20 @@ int CmdRequest_AppendEntries::ByteSize() const {
           this->leader_commit());
     }
 
+    // optional bytes checksums = 8;
+    if (has_checksums()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->checksums());
+    }
+
+  }
+  if (_has_bits_[9 / 32] & (0xffu << (9 % 32))) {
+    // optional bool raw_entries_unchecked = 10;
+    if (has_raw_entries_unchecked()) {
+      total_size += 1 + 1;
+    }
+
   }
   // repeated .floyd.Entry entries = 7;
   total_size += 1 * this->entries_size();
@@ -1877,6 +2134,13 @@ int CmdRequest_AppendEntries::ByteSize() const {
         this->entries(i));
   }
 
+  // repeated bytes raw_entries = 9;
+  total_size += 1 * this->raw_entries_size();
+  for (int i = 0; i < this->raw_entries_size(); i++) {
+    total_size += ::google::protobuf::internal::WireFormatLite::BytesSize(
+      this->raw_entries(i));
+  }
+
   if (!unknown_fields().empty()) {
     total_size +=
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
@@ -1903,6 +2167,7 @@ void CmdRequest_AppendEntries::MergeFrom(const ::google::protobuf::Message& from
 void CmdRequest_AppendEntries::MergeFrom(const CmdRequest_AppendEntries& from) {
   GOOGLE_CHECK_NE(&from, this);
   entries_.MergeFrom(from.entries_);
+  raw_entries_.MergeFrom(from.raw_entries_);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (from.has_term()) {
       set_term(from.term());
@@ -1922,6 +2187,14 @@ void CmdRequest_AppendEntries::MergeFrom(const CmdRequest_AppendEntries& from) {
     if (from.has_leader_commit()) {
       set_leader_commit(from.leader_commit());
     }
+    if (from.has_checksums()) {
+      set_checksums(from.checksums());
+    }
+  }
+  if (from._has_bits_[9 / 32] & (0xffu << (9 % 32))) {
+    if (from.has_raw_entries_unchecked()) {
+      set_raw_entries_unchecked(from.raw_entries_unchecked());
+    }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
@@ -1956,6 +2229,9 @@ void CmdRequest_AppendEntries::Swap(CmdRequest_AppendEntries* other) {
     std::swap(prev_log_term_, other->prev_log_term_);
     std::swap(leader_commit_, other->leader_commit_);
     entries_.Swap(&other->entries_);
+    std::swap(checksums_, other->checksums_);
+    raw_entries_.Swap(&other->raw_entries_);
+    std::swap(raw_entries_unchecked_, other->raw_entries_unchecked_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
@@ -3315,237 +3591,273 @@ void CmdRequest_ServerStatus::Swap(CmdRequest_ServerStatus* other) {
 // -------------------------------------------------------------------
 
 #ifndef _MSC_VER
-const int CmdRequest::kTypeFieldNumber;
-const int CmdRequest::kRequestVoteFieldNumber;
-const int CmdRequest::kAppendEntriesFieldNumber;
-const int CmdRequest::kKvRequestFieldNumber;
-const int CmdRequest::kLockRequestFieldNumber;
-const int CmdRequest::kAddServerRequestFieldNumber;
-const int CmdRequest::kRemoveServerRequestFieldNumber;
-const int CmdRequest::kServerStatusFieldNumber;
+const int CmdRequest_InstallSnapshot::kTermFieldNumber;
+const int CmdRequest_InstallSnapshot::kIpFieldNumber;
+const int CmdRequest_InstallSnapshot::kPortFieldNumber;
+const int CmdRequest_InstallSnapshot::kLastIncludedIndexFieldNumber;
+const int CmdRequest_InstallSnapshot::kLastIncludedTermFieldNumber;
+const int CmdRequest_InstallSnapshot::kSeqFieldNumber;
+const int CmdRequest_InstallSnapshot::kFilenameFieldNumber;
+const int CmdRequest_InstallSnapshot::kOffsetFieldNumber;
+const int CmdRequest_InstallSnapshot::kDataFieldNumber;
+const int CmdRequest_InstallSnapshot::kDoneFieldNumber;
 #endif  // !_MSC_VER
 
-CmdRequest::CmdRequest()
+CmdRequest_InstallSnapshot::CmdRequest_InstallSnapshot()
   : ::google::protobuf::Message() {
   SharedCtor();
 }
 
-void CmdRequest::InitAsDefaultInstance() {
-  request_vote_ = const_cast< ::floyd::CmdRequest_RequestVote*>(&::floyd::CmdRequest_RequestVote::default_instance());
-  append_entries_ = const_cast< ::floyd::CmdRequest_AppendEntries*>(&::floyd::CmdRequest_AppendEntries::default_instance());
-  kv_request_ = const_cast< ::floyd::CmdRequest_KvRequest*>(&::floyd::CmdRequest_KvRequest::default_instance());
-  lock_request_ = const_cast< ::floyd::CmdRequest_LockRequest*>(&::floyd::CmdRequest_LockRequest::default_instance());
-  add_server_request_ = const_cast< ::floyd::CmdRequest_AddServerRequest*>(&::floyd::CmdRequest_AddServerRequest::default_instance());
-  remove_server_request_ = const_cast< ::floyd::CmdRequest_RemoveServerRequest*>(&::floyd::CmdRequest_RemoveServerRequest::default_instance());
-  server_status_ = const_cast< ::floyd::CmdRequest_ServerStatus*>(&::floyd::CmdRequest_ServerStatus::default_instance());
+void CmdRequest_InstallSnapshot::InitAsDefaultInstance() {
 }
 
-CmdRequest::CmdRequest(const CmdRequest& from)
+CmdRequest_InstallSnapshot::CmdRequest_InstallSnapshot(const CmdRequest_InstallSnapshot& from)
   : ::google::protobuf::Message() {
   SharedCtor();
   MergeFrom(from);
 }
 
-void CmdRequest::SharedCtor() {
+void CmdRequest_InstallSnapshot::SharedCtor() {
   _cached_size_ = 0;
-  type_ = 0;
-  request_vote_ = NULL;
-  append_entries_ = NULL;
-  kv_request_ = NULL;
-  lock_request_ = NULL;
-  add_server_request_ = NULL;
-  remove_server_request_ = NULL;
-  server_status_ = NULL;
+  term_ = GOOGLE_ULONGLONG(0);
+  ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  port_ = 0;
+  last_included_index_ = GOOGLE_ULONGLONG(0);
+  last_included_term_ = GOOGLE_ULONGLONG(0);
+  seq_ = GOOGLE_ULONGLONG(0);
+  filename_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  offset_ = GOOGLE_ULONGLONG(0);
+  data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  done_ = false;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
-CmdRequest::~CmdRequest() {
+CmdRequest_InstallSnapshot::~CmdRequest_InstallSnapshot() {
   SharedDtor();
 }
 
-void CmdRequest::SharedDtor() {
+void CmdRequest_InstallSnapshot::SharedDtor() {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete ip_;
+  }
+  if (filename_ != &::google::protobuf::internal::kEmptyString) {
+    delete filename_;
+  }
+  if (data_ != &::google::protobuf::internal::kEmptyString) {
+    delete data_;
+  }
   if (this != default_instance_) {
-    delete request_vote_;
-    delete append_entries_;
-    delete kv_request_;
-    delete lock_request_;
-    delete add_server_request_;
-    delete remove_server_request_;
-    delete server_status_;
   }
 }
 
-void CmdRequest::SetCachedSize(int size) const {
+void CmdRequest_InstallSnapshot::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* CmdRequest::descriptor() {
+const ::google::protobuf::Descriptor* CmdRequest_InstallSnapshot::descriptor() {
   protobuf_AssignDescriptorsOnce();
-  return CmdRequest_descriptor_;
+  return CmdRequest_InstallSnapshot_descriptor_;
 }
 
-const CmdRequest& CmdRequest::default_instance() {
+const CmdRequest_InstallSnapshot& CmdRequest_InstallSnapshot::default_instance() {
   if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
   return *default_instance_;
 }
 
-CmdRequest* CmdRequest::default_instance_ = NULL;
+CmdRequest_InstallSnapshot* CmdRequest_InstallSnapshot::default_instance_ = NULL;
 
-CmdRequest* CmdRequest::New() const {
-  return new CmdRequest;
+CmdRequest_InstallSnapshot* CmdRequest_InstallSnapshot::New() const {
+  return new CmdRequest_InstallSnapshot;
 }
 
-void CmdRequest::Clear() {
+void CmdRequest_InstallSnapshot::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    type_ = 0;
-    if (has_request_vote()) {
-      if (request_vote_ != NULL) request_vote_->::floyd::CmdRequest_RequestVote::Clear();
-    }
-    if (has_append_entries()) {
-      if (append_entries_ != NULL) append_entries_->::floyd::CmdRequest_AppendEntries::Clear();
-    }
-    if (has_kv_request()) {
-      if (kv_request_ != NULL) kv_request_->::floyd::CmdRequest_KvRequest::Clear();
-    }
-    if (has_lock_request()) {
-      if (lock_request_ != NULL) lock_request_->::floyd::CmdRequest_LockRequest::Clear();
-    }
-    if (has_add_server_request()) {
-      if (add_server_request_ != NULL) add_server_request_->::floyd::CmdRequest_AddServerRequest::Clear();
+    term_ = GOOGLE_ULONGLONG(0);
+    if (has_ip()) {
+      if (ip_ != &::google::protobuf::internal::kEmptyString) {
+        ip_->clear();
+      }
     }
-    if (has_remove_server_request()) {
-      if (remove_server_request_ != NULL) remove_server_request_->::floyd::CmdRequest_RemoveServerRequest::Clear();
+    port_ = 0;
+    last_included_index_ = GOOGLE_ULONGLONG(0);
+    last_included_term_ = GOOGLE_ULONGLONG(0);
+    seq_ = GOOGLE_ULONGLONG(0);
+    if (has_filename()) {
+      if (filename_ != &::google::protobuf::internal::kEmptyString) {
+        filename_->clear();
+      }
     }
-    if (has_server_status()) {
-      if (server_status_ != NULL) server_status_->::floyd::CmdRequest_ServerStatus::Clear();
+    offset_ = GOOGLE_ULONGLONG(0);
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (has_data()) {
+      if (data_ != &::google::protobuf::internal::kEmptyString) {
+        data_->clear();
+      }
     }
+    done_ = false;
   }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
 
-bool CmdRequest::MergePartialFromCodedStream(
+bool CmdRequest_InstallSnapshot::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!(EXPRESSION)) return false
   ::google::protobuf::uint32 tag;
   while ((tag = input->ReadTag()) != 0) {
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // required .floyd.Type type = 1;
+      // required uint64 term = 1;
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-          int value;
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   int, ::google::protobuf::internal::WireFormatLite::TYPE_ENUM>(
-                 input, &value)));
-          if (::floyd::Type_IsValid(value)) {
-            set_type(static_cast< ::floyd::Type >(value));
-          } else {
-            mutable_unknown_fields()->AddVarint(1, value);
-          }
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &term_)));
+          set_has_term();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(18)) goto parse_request_vote;
+        if (input->ExpectTag(18)) goto parse_ip;
         break;
       }
 
-      // optional .floyd.CmdRequest.RequestVote request_vote = 2;
+      // required bytes ip = 2;
       case 2: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_request_vote:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_request_vote()));
+         parse_ip:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_ip()));
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(26)) goto parse_append_entries;
+        if (input->ExpectTag(24)) goto parse_port;
         break;
       }
 
-      // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
+      // required int32 port = 3;
       case 3: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_append_entries:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_append_entries()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_port:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &port_)));
+          set_has_port();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(34)) goto parse_kv_request;
+        if (input->ExpectTag(32)) goto parse_last_included_index;
         break;
       }
 
-      // optional .floyd.CmdRequest.KvRequest kv_request = 4;
+      // required uint64 last_included_index = 4;
       case 4: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_kv_request:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_kv_request()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_included_index:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_included_index_)));
+          set_has_last_included_index();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(42)) goto parse_lock_request;
+        if (input->ExpectTag(40)) goto parse_last_included_term;
         break;
       }
 
-      // optional .floyd.CmdRequest.LockRequest lock_request = 5;
+      // required uint64 last_included_term = 5;
       case 5: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_lock_request:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_lock_request()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_included_term:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_included_term_)));
+          set_has_last_included_term();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(50)) goto parse_server_status;
+        if (input->ExpectTag(48)) goto parse_seq;
         break;
       }
 
-      // optional .floyd.CmdRequest.ServerStatus server_status = 6;
+      // required uint64 seq = 6;
       case 6: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_server_status:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_server_status()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_seq:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &seq_)));
+          set_has_seq();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(58)) goto parse_add_server_request;
+        if (input->ExpectTag(58)) goto parse_filename;
         break;
       }
 
-      // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
+      // required bytes filename = 7;
       case 7: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_add_server_request:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_add_server_request()));
+         parse_filename:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_filename()));
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(66)) goto parse_remove_server_request;
+        if (input->ExpectTag(64)) goto parse_offset;
         break;
       }
 
-      // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
+      // required uint64 offset = 8;
       case 8: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_remove_server_request:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_remove_server_request()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_offset:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &offset_)));
+          set_has_offset();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectAtEnd()) return true;
+        if (input->ExpectTag(74)) goto parse_data;
+        break;
+      }
+
+      // required bytes data = 9;
+      case 9: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_data:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_data()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(80)) goto parse_done;
+        break;
+      }
+
+      // required bool done = 10;
+      case 10: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_done:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &done_)));
+          set_has_done();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
         break;
       }
 
@@ -3565,54 +3877,59 @@ bool CmdRequest::MergePartialFromCodedStream(
 #undef DO_
 }
 
-void CmdRequest::SerializeWithCachedSizes(
+void CmdRequest_InstallSnapshot::SerializeWithCachedSizes(
     ::google::protobuf::io::CodedOutputStream* output) const {
-  // required .floyd.Type type = 1;
-  if (has_type()) {
-    ::google::protobuf::internal::WireFormatLite::WriteEnum(
-      1, this->type(), output);
+  // required uint64 term = 1;
+  if (has_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
   }
 
-  // optional .floyd.CmdRequest.RequestVote request_vote = 2;
-  if (has_request_vote()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      2, this->request_vote(), output);
+  // required bytes ip = 2;
+  if (has_ip()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      2, this->ip(), output);
   }
 
-  // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
-  if (has_append_entries()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      3, this->append_entries(), output);
+  // required int32 port = 3;
+  if (has_port()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(3, this->port(), output);
   }
 
-  // optional .floyd.CmdRequest.KvRequest kv_request = 4;
-  if (has_kv_request()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      4, this->kv_request(), output);
+  // required uint64 last_included_index = 4;
+  if (has_last_included_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(4, this->last_included_index(), output);
   }
 
-  // optional .floyd.CmdRequest.LockRequest lock_request = 5;
-  if (has_lock_request()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      5, this->lock_request(), output);
+  // required uint64 last_included_term = 5;
+  if (has_last_included_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(5, this->last_included_term(), output);
   }
 
-  // optional .floyd.CmdRequest.ServerStatus server_status = 6;
-  if (has_server_status()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      6, this->server_status(), output);
+  // required uint64 seq = 6;
+  if (has_seq()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(6, this->seq(), output);
   }
 
-  // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
-  if (has_add_server_request()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      7, this->add_server_request(), output);
+  // required bytes filename = 7;
+  if (has_filename()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      7, this->filename(), output);
   }
 
-  // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
-  if (has_remove_server_request()) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      8, this->remove_server_request(), output);
+  // required uint64 offset = 8;
+  if (has_offset()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(8, this->offset(), output);
+  }
+
+  // required bytes data = 9;
+  if (has_data()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      9, this->data(), output);
+  }
+
+  // required bool done = 10;
+  if (has_done()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(10, this->done(), output);
   }
 
   if (!unknown_fields().empty()) {
@@ -3621,61 +3938,62 @@ void CmdRequest::SerializeWithCachedSizes(
   }
 }
 
-::google::protobuf::uint8* CmdRequest::SerializeWithCachedSizesToArray(
+::google::protobuf::uint8* CmdRequest_InstallSnapshot::SerializeWithCachedSizesToArray(
     ::google::protobuf::uint8* target) const {
-  // required .floyd.Type type = 1;
-  if (has_type()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
-      1, this->type(), target);
+  // required uint64 term = 1;
+  if (has_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
   }
 
-  // optional .floyd.CmdRequest.RequestVote request_vote = 2;
-  if (has_request_vote()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        2, this->request_vote(), target);
+  // required bytes ip = 2;
+  if (has_ip()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        2, this->ip(), target);
   }
 
-  // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
-  if (has_append_entries()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        3, this->append_entries(), target);
+  // required int32 port = 3;
+  if (has_port()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(3, this->port(), target);
   }
 
-  // optional .floyd.CmdRequest.KvRequest kv_request = 4;
-  if (has_kv_request()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        4, this->kv_request(), target);
+  // required uint64 last_included_index = 4;
+  if (has_last_included_index()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(4, this->last_included_index(), target);
   }
 
-  // optional .floyd.CmdRequest.LockRequest lock_request = 5;
-  if (has_lock_request()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        5, this->lock_request(), target);
+  // required uint64 last_included_term = 5;
+  if (has_last_included_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(5, this->last_included_term(), target);
   }
 
-  // optional .floyd.CmdRequest.ServerStatus server_status = 6;
-  if (has_server_status()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        6, this->server_status(), target);
+  // required uint64 seq = 6;
+  if (has_seq()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(6, this->seq(), target);
   }
 
-  // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
-  if (has_add_server_request()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        7, this->add_server_request(), target);
+  // required bytes filename = 7;
+  if (has_filename()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        7, this->filename(), target);
   }
 
-  // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
-  if (has_remove_server_request()) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      WriteMessageNoVirtualToArray(
-        8, this->remove_server_request(), target);
+  // required uint64 offset = 8;
+  if (has_offset()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(8, this->offset(), target);
+  }
+
+  // required bytes data = 9;
+  if (has_data()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        9, this->data(), target);
+  }
+
+  // required bool done = 10;
+  if (has_done()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->done(), target);
   }
 
   if (!unknown_fields().empty()) {
@@ -3685,63 +4003,78 @@ void CmdRequest::SerializeWithCachedSizes(
   return target;
 }
 
-int CmdRequest::ByteSize() const {
+int CmdRequest_InstallSnapshot::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    // required .floyd.Type type = 1;
-    if (has_type()) {
+    // required uint64 term = 1;
+    if (has_term()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::EnumSize(this->type());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->term());
     }
 
-    // optional .floyd.CmdRequest.RequestVote request_vote = 2;
-    if (has_request_vote()) {
+    // required bytes ip = 2;
+    if (has_ip()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->request_vote());
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->ip());
     }
 
-    // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
-    if (has_append_entries()) {
+    // required int32 port = 3;
+    if (has_port()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->append_entries());
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->port());
     }
 
-    // optional .floyd.CmdRequest.KvRequest kv_request = 4;
-    if (has_kv_request()) {
+    // required uint64 last_included_index = 4;
+    if (has_last_included_index()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->kv_request());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_included_index());
     }
 
-    // optional .floyd.CmdRequest.LockRequest lock_request = 5;
-    if (has_lock_request()) {
+    // required uint64 last_included_term = 5;
+    if (has_last_included_term()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->lock_request());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_included_term());
     }
 
-    // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
-    if (has_add_server_request()) {
+    // required uint64 seq = 6;
+    if (has_seq()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->add_server_request());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->seq());
     }
 
-    // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
-    if (has_remove_server_request()) {
+    // required bytes filename = 7;
+    if (has_filename()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->remove_server_request());
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->filename());
     }
 
-    // optional .floyd.CmdRequest.ServerStatus server_status = 6;
-    if (has_server_status()) {
+    // required uint64 offset = 8;
+    if (has_offset()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          this->server_status());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->offset());
+    }
+
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    // required bytes data = 9;
+    if (has_data()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->data());
+    }
+
+    // required bool done = 10;
+    if (has_done()) {
+      total_size += 1 + 1;
     }
 
   }
@@ -3756,10 +4089,10 @@ int CmdRequest::ByteSize() const {
   return total_size;
 }
 
-void CmdRequest::MergeFrom(const ::google::protobuf::Message& from) {
+void CmdRequest_InstallSnapshot::MergeFrom(const ::google::protobuf::Message& from) {
   GOOGLE_CHECK_NE(&from, this);
-  const CmdRequest* source =
-    ::google::protobuf::internal::dynamic_cast_if_available<const CmdRequest*>(
+  const CmdRequest_InstallSnapshot* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdRequest_InstallSnapshot*>(
       &from);
   if (source == NULL) {
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
@@ -3768,169 +4101,171 @@ void CmdRequest::MergeFrom(const ::google::protobuf::Message& from) {
   }
 }
 
-void CmdRequest::MergeFrom(const CmdRequest& from) {
+void CmdRequest_InstallSnapshot::MergeFrom(const CmdRequest_InstallSnapshot& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    if (from.has_type()) {
-      set_type(from.type());
+    if (from.has_term()) {
+      set_term(from.term());
     }
-    if (from.has_request_vote()) {
-      mutable_request_vote()->::floyd::CmdRequest_RequestVote::MergeFrom(from.request_vote());
+    if (from.has_ip()) {
+      set_ip(from.ip());
     }
-    if (from.has_append_entries()) {
-      mutable_append_entries()->::floyd::CmdRequest_AppendEntries::MergeFrom(from.append_entries());
+    if (from.has_port()) {
+      set_port(from.port());
     }
-    if (from.has_kv_request()) {
-      mutable_kv_request()->::floyd::CmdRequest_KvRequest::MergeFrom(from.kv_request());
+    if (from.has_last_included_index()) {
+      set_last_included_index(from.last_included_index());
     }
-    if (from.has_lock_request()) {
-      mutable_lock_request()->::floyd::CmdRequest_LockRequest::MergeFrom(from.lock_request());
+    if (from.has_last_included_term()) {
+      set_last_included_term(from.last_included_term());
     }
-    if (from.has_add_server_request()) {
-      mutable_add_server_request()->::floyd::CmdRequest_AddServerRequest::MergeFrom(from.add_server_request());
+    if (from.has_seq()) {
+      set_seq(from.seq());
     }
-    if (from.has_remove_server_request()) {
-      mutable_remove_server_request()->::floyd::CmdRequest_RemoveServerRequest::MergeFrom(from.remove_server_request());
+    if (from.has_filename()) {
+      set_filename(from.filename());
     }
-    if (from.has_server_status()) {
-      mutable_server_status()->::floyd::CmdRequest_ServerStatus::MergeFrom(from.server_status());
+    if (from.has_offset()) {
+      set_offset(from.offset());
+    }
+  }
+  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (from.has_data()) {
+      set_data(from.data());
+    }
+    if (from.has_done()) {
+      set_done(from.done());
     }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
-void CmdRequest::CopyFrom(const ::google::protobuf::Message& from) {
+void CmdRequest_InstallSnapshot::CopyFrom(const ::google::protobuf::Message& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void CmdRequest::CopyFrom(const CmdRequest& from) {
+void CmdRequest_InstallSnapshot::CopyFrom(const CmdRequest_InstallSnapshot& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool CmdRequest::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000001) != 0x00000001) return false;
+bool CmdRequest_InstallSnapshot::IsInitialized() const {
+  if ((_has_bits_[0] & 0x000003ff) != 0x000003ff) return false;
 
-  if (has_request_vote()) {
-    if (!this->request_vote().IsInitialized()) return false;
-  }
-  if (has_append_entries()) {
-    if (!this->append_entries().IsInitialized()) return false;
-  }
-  if (has_kv_request()) {
-    if (!this->kv_request().IsInitialized()) return false;
-  }
-  if (has_lock_request()) {
-    if (!this->lock_request().IsInitialized()) return false;
-  }
-  if (has_add_server_request()) {
-    if (!this->add_server_request().IsInitialized()) return false;
-  }
-  if (has_remove_server_request()) {
-    if (!this->remove_server_request().IsInitialized()) return false;
-  }
-  if (has_server_status()) {
-    if (!this->server_status().IsInitialized()) return false;
-  }
   return true;
 }
 
-void CmdRequest::Swap(CmdRequest* other) {
+void CmdRequest_InstallSnapshot::Swap(CmdRequest_InstallSnapshot* other) {
   if (other != this) {
-    std::swap(type_, other->type_);
-    std::swap(request_vote_, other->request_vote_);
-    std::swap(append_entries_, other->append_entries_);
-    std::swap(kv_request_, other->kv_request_);
-    std::swap(lock_request_, other->lock_request_);
-    std::swap(add_server_request_, other->add_server_request_);
-    std::swap(remove_server_request_, other->remove_server_request_);
-    std::swap(server_status_, other->server_status_);
+    std::swap(term_, other->term_);
+    std::swap(ip_, other->ip_);
+    std::swap(port_, other->port_);
+    std::swap(last_included_index_, other->last_included_index_);
+    std::swap(last_included_term_, other->last_included_term_);
+    std::swap(seq_, other->seq_);
+    std::swap(filename_, other->filename_);
+    std::swap(offset_, other->offset_);
+    std::swap(data_, other->data_);
+    std::swap(done_, other->done_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
   }
 }
 
-::google::protobuf::Metadata CmdRequest::GetMetadata() const {
+::google::protobuf::Metadata CmdRequest_InstallSnapshot::GetMetadata() const {
   protobuf_AssignDescriptorsOnce();
   ::google::protobuf::Metadata metadata;
-  metadata.descriptor = CmdRequest_descriptor_;
-  metadata.reflection = CmdRequest_reflection_;
+  metadata.descriptor = CmdRequest_InstallSnapshot_descriptor_;
+  metadata.reflection = CmdRequest_InstallSnapshot_reflection_;
   return metadata;
 }
 
 
-// ===================================================================
+// -------------------------------------------------------------------
 
 #ifndef _MSC_VER
-const int CmdResponse_RequestVoteResponse::kTermFieldNumber;
-const int CmdResponse_RequestVoteResponse::kVoteGrantedFieldNumber;
+const int CmdRequest_LeaderHeartbeat::kTermFieldNumber;
+const int CmdRequest_LeaderHeartbeat::kIpFieldNumber;
+const int CmdRequest_LeaderHeartbeat::kPortFieldNumber;
+const int CmdRequest_LeaderHeartbeat::kLeaderCommitFieldNumber;
 #endif  // !_MSC_VER
 
-CmdResponse_RequestVoteResponse::CmdResponse_RequestVoteResponse()
+CmdRequest_LeaderHeartbeat::CmdRequest_LeaderHeartbeat()
   : ::google::protobuf::Message() {
   SharedCtor();
 }
 
-void CmdResponse_RequestVoteResponse::InitAsDefaultInstance() {
+void CmdRequest_LeaderHeartbeat::InitAsDefaultInstance() {
 }
 
-CmdResponse_RequestVoteResponse::CmdResponse_RequestVoteResponse(const CmdResponse_RequestVoteResponse& from)
+CmdRequest_LeaderHeartbeat::CmdRequest_LeaderHeartbeat(const CmdRequest_LeaderHeartbeat& from)
   : ::google::protobuf::Message() {
   SharedCtor();
   MergeFrom(from);
 }
 
-void CmdResponse_RequestVoteResponse::SharedCtor() {
+void CmdRequest_LeaderHeartbeat::SharedCtor() {
   _cached_size_ = 0;
   term_ = GOOGLE_ULONGLONG(0);
-  vote_granted_ = false;
+  ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  port_ = 0;
+  leader_commit_ = GOOGLE_ULONGLONG(0);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
-CmdResponse_RequestVoteResponse::~CmdResponse_RequestVoteResponse() {
+CmdRequest_LeaderHeartbeat::~CmdRequest_LeaderHeartbeat() {
   SharedDtor();
 }
 
-void CmdResponse_RequestVoteResponse::SharedDtor() {
+void CmdRequest_LeaderHeartbeat::SharedDtor() {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete ip_;
+  }
   if (this != default_instance_) {
   }
 }
 
-void CmdResponse_RequestVoteResponse::SetCachedSize(int size) const {
+void CmdRequest_LeaderHeartbeat::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* CmdResponse_RequestVoteResponse::descriptor() {
+const ::google::protobuf::Descriptor* CmdRequest_LeaderHeartbeat::descriptor() {
   protobuf_AssignDescriptorsOnce();
-  return CmdResponse_RequestVoteResponse_descriptor_;
+  return CmdRequest_LeaderHeartbeat_descriptor_;
 }
 
-const CmdResponse_RequestVoteResponse& CmdResponse_RequestVoteResponse::default_instance() {
+const CmdRequest_LeaderHeartbeat& CmdRequest_LeaderHeartbeat::default_instance() {
   if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
   return *default_instance_;
 }
 
-CmdResponse_RequestVoteResponse* CmdResponse_RequestVoteResponse::default_instance_ = NULL;
+CmdRequest_LeaderHeartbeat* CmdRequest_LeaderHeartbeat::default_instance_ = NULL;
 
-CmdResponse_RequestVoteResponse* CmdResponse_RequestVoteResponse::New() const {
-  return new CmdResponse_RequestVoteResponse;
+CmdRequest_LeaderHeartbeat* CmdRequest_LeaderHeartbeat::New() const {
+  return new CmdRequest_LeaderHeartbeat;
 }
 
-void CmdResponse_RequestVoteResponse::Clear() {
+void CmdRequest_LeaderHeartbeat::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     term_ = GOOGLE_ULONGLONG(0);
-    vote_granted_ = false;
+    if (has_ip()) {
+      if (ip_ != &::google::protobuf::internal::kEmptyString) {
+        ip_->clear();
+      }
+    }
+    port_ = 0;
+    leader_commit_ = GOOGLE_ULONGLONG(0);
   }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
 
-bool CmdResponse_RequestVoteResponse::MergePartialFromCodedStream(
+bool CmdRequest_LeaderHeartbeat::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!(EXPRESSION)) return false
   ::google::protobuf::uint32 tag;
@@ -3947,19 +4282,49 @@ bool CmdResponse_RequestVoteResponse::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(16)) goto parse_vote_granted;
+        if (input->ExpectTag(18)) goto parse_ip;
         break;
       }
 
-      // required bool vote_granted = 2;
+      // required bytes ip = 2;
       case 2: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_ip:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_ip()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(24)) goto parse_port;
+        break;
+      }
+
+      // required int32 port = 3;
+      case 3: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_vote_granted:
+         parse_port:
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
-                 input, &vote_granted_)));
-          set_has_vote_granted();
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &port_)));
+          set_has_port();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(32)) goto parse_leader_commit;
+        break;
+      }
+
+      // required uint64 leader_commit = 4;
+      case 4: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_leader_commit:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &leader_commit_)));
+          set_has_leader_commit();
         } else {
           goto handle_uninterpreted;
         }
@@ -3983,16 +4348,27 @@ bool CmdResponse_RequestVoteResponse::MergePartialFromCodedStream(
 #undef DO_
 }
 
-void CmdResponse_RequestVoteResponse::SerializeWithCachedSizes(
+void CmdRequest_LeaderHeartbeat::SerializeWithCachedSizes(
     ::google::protobuf::io::CodedOutputStream* output) const {
   // required uint64 term = 1;
   if (has_term()) {
     ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
   }
 
-  // required bool vote_granted = 2;
-  if (has_vote_granted()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->vote_granted(), output);
+  // required bytes ip = 2;
+  if (has_ip()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      2, this->ip(), output);
+  }
+
+  // required int32 port = 3;
+  if (has_port()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(3, this->port(), output);
+  }
+
+  // required uint64 leader_commit = 4;
+  if (has_leader_commit()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(4, this->leader_commit(), output);
   }
 
   if (!unknown_fields().empty()) {
@@ -4001,16 +4377,28 @@ void CmdResponse_RequestVoteResponse::SerializeWithCachedSizes(
   }
 }
 
-::google::protobuf::uint8* CmdResponse_RequestVoteResponse::SerializeWithCachedSizesToArray(
+::google::protobuf::uint8* CmdRequest_LeaderHeartbeat::SerializeWithCachedSizesToArray(
     ::google::protobuf::uint8* target) const {
   // required uint64 term = 1;
   if (has_term()) {
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
   }
 
-  // required bool vote_granted = 2;
-  if (has_vote_granted()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->vote_granted(), target);
+  // required bytes ip = 2;
+  if (has_ip()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        2, this->ip(), target);
+  }
+
+  // required int32 port = 3;
+  if (has_port()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(3, this->port(), target);
+  }
+
+  // required uint64 leader_commit = 4;
+  if (has_leader_commit()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(4, this->leader_commit(), target);
   }
 
   if (!unknown_fields().empty()) {
@@ -4020,7 +4408,7 @@ void CmdResponse_RequestVoteResponse::SerializeWithCachedSizes(
   return target;
 }
 
-int CmdResponse_RequestVoteResponse::ByteSize() const {
+int CmdRequest_LeaderHeartbeat::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -4031,9 +4419,25 @@ int CmdResponse_RequestVoteResponse::ByteSize() const {
           this->term());
     }
 
-    // required bool vote_granted = 2;
-    if (has_vote_granted()) {
-      total_size += 1 + 1;
+    // required bytes ip = 2;
+    if (has_ip()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->ip());
+    }
+
+    // required int32 port = 3;
+    if (has_port()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->port());
+    }
+
+    // required uint64 leader_commit = 4;
+    if (has_leader_commit()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->leader_commit());
     }
 
   }
@@ -4048,10 +4452,10 @@ int CmdResponse_RequestVoteResponse::ByteSize() const {
   return total_size;
 }
 
-void CmdResponse_RequestVoteResponse::MergeFrom(const ::google::protobuf::Message& from) {
+void CmdRequest_LeaderHeartbeat::MergeFrom(const ::google::protobuf::Message& from) {
   GOOGLE_CHECK_NE(&from, this);
-  const CmdResponse_RequestVoteResponse* source =
-    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_RequestVoteResponse*>(
+  const CmdRequest_LeaderHeartbeat* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdRequest_LeaderHeartbeat*>(
       &from);
   if (source == NULL) {
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
@@ -4060,52 +4464,60 @@ void CmdResponse_RequestVoteResponse::MergeFrom(const ::google::protobuf::Messag
   }
 }
 
-void CmdResponse_RequestVoteResponse::MergeFrom(const CmdResponse_RequestVoteResponse& from) {
+void CmdRequest_LeaderHeartbeat::MergeFrom(const CmdRequest_LeaderHeartbeat& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (from.has_term()) {
       set_term(from.term());
     }
-    if (from.has_vote_granted()) {
-      set_vote_granted(from.vote_granted());
+    if (from.has_ip()) {
+      set_ip(from.ip());
+    }
+    if (from.has_port()) {
+      set_port(from.port());
+    }
+    if (from.has_leader_commit()) {
+      set_leader_commit(from.leader_commit());
     }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
-void CmdResponse_RequestVoteResponse::CopyFrom(const ::google::protobuf::Message& from) {
+void CmdRequest_LeaderHeartbeat::CopyFrom(const ::google::protobuf::Message& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void CmdResponse_RequestVoteResponse::CopyFrom(const CmdResponse_RequestVoteResponse& from) {
+void CmdRequest_LeaderHeartbeat::CopyFrom(const CmdRequest_LeaderHeartbeat& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool CmdResponse_RequestVoteResponse::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
+bool CmdRequest_LeaderHeartbeat::IsInitialized() const {
+  if ((_has_bits_[0] & 0x0000000f) != 0x0000000f) return false;
 
   return true;
 }
 
-void CmdResponse_RequestVoteResponse::Swap(CmdResponse_RequestVoteResponse* other) {
+void CmdRequest_LeaderHeartbeat::Swap(CmdRequest_LeaderHeartbeat* other) {
   if (other != this) {
     std::swap(term_, other->term_);
-    std::swap(vote_granted_, other->vote_granted_);
+    std::swap(ip_, other->ip_);
+    std::swap(port_, other->port_);
+    std::swap(leader_commit_, other->leader_commit_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
   }
 }
 
-::google::protobuf::Metadata CmdResponse_RequestVoteResponse::GetMetadata() const {
+::google::protobuf::Metadata CmdRequest_LeaderHeartbeat::GetMetadata() const {
   protobuf_AssignDescriptorsOnce();
   ::google::protobuf::Metadata metadata;
-  metadata.descriptor = CmdResponse_RequestVoteResponse_descriptor_;
-  metadata.reflection = CmdResponse_RequestVoteResponse_reflection_;
+  metadata.descriptor = CmdRequest_LeaderHeartbeat_descriptor_;
+  metadata.reflection = CmdRequest_LeaderHeartbeat_reflection_;
   return metadata;
 }
 
@@ -4113,112 +4525,1809 @@ void CmdResponse_RequestVoteResponse::Swap(CmdResponse_RequestVoteResponse* othe
 // -------------------------------------------------------------------
 
 #ifndef _MSC_VER
-const int CmdResponse_AppendEntriesResponse::kTermFieldNumber;
-const int CmdResponse_AppendEntriesResponse::kSuccessFieldNumber;
-const int CmdResponse_AppendEntriesResponse::kLastLogIndexFieldNumber;
+const int CmdRequest::kTypeFieldNumber;
+const int CmdRequest::kRequestVoteFieldNumber;
+const int CmdRequest::kAppendEntriesFieldNumber;
+const int CmdRequest::kKvRequestFieldNumber;
+const int CmdRequest::kLockRequestFieldNumber;
+const int CmdRequest::kAddServerRequestFieldNumber;
+const int CmdRequest::kRemoveServerRequestFieldNumber;
+const int CmdRequest::kServerStatusFieldNumber;
+const int CmdRequest::kInstallSnapshotFieldNumber;
+const int CmdRequest::kLeaderHeartbeatFieldNumber;
 #endif  // !_MSC_VER
 
-CmdResponse_AppendEntriesResponse::CmdResponse_AppendEntriesResponse()
+CmdRequest::CmdRequest()
   : ::google::protobuf::Message() {
   SharedCtor();
 }
 
-void CmdResponse_AppendEntriesResponse::InitAsDefaultInstance() {
+void CmdRequest::InitAsDefaultInstance() {
+  request_vote_ = const_cast< ::floyd::CmdRequest_RequestVote*>(&::floyd::CmdRequest_RequestVote::default_instance());
+  append_entries_ = const_cast< ::floyd::CmdRequest_AppendEntries*>(&::floyd::CmdRequest_AppendEntries::default_instance());
+  kv_request_ = const_cast< ::floyd::CmdRequest_KvRequest*>(&::floyd::CmdRequest_KvRequest::default_instance());
+  lock_request_ = const_cast< ::floyd::CmdRequest_LockRequest*>(&::floyd::CmdRequest_LockRequest::default_instance());
+  add_server_request_ = const_cast< ::floyd::CmdRequest_AddServerRequest*>(&::floyd::CmdRequest_AddServerRequest::default_instance());
+  remove_server_request_ = const_cast< ::floyd::CmdRequest_RemoveServerRequest*>(&::floyd::CmdRequest_RemoveServerRequest::default_instance());
+  server_status_ = const_cast< ::floyd::CmdRequest_ServerStatus*>(&::floyd::CmdRequest_ServerStatus::default_instance());
+  install_snapshot_ = const_cast< ::floyd::CmdRequest_InstallSnapshot*>(&::floyd::CmdRequest_InstallSnapshot::default_instance());
+  leader_heartbeat_ = const_cast< ::floyd::CmdRequest_LeaderHeartbeat*>(&::floyd::CmdRequest_LeaderHeartbeat::default_instance());
 }
 
-CmdResponse_AppendEntriesResponse::CmdResponse_AppendEntriesResponse(const CmdResponse_AppendEntriesResponse& from)
+CmdRequest::CmdRequest(const CmdRequest& from)
   : ::google::protobuf::Message() {
   SharedCtor();
   MergeFrom(from);
 }
 
-void CmdResponse_AppendEntriesResponse::SharedCtor() {
+void CmdRequest::SharedCtor() {
   _cached_size_ = 0;
-  term_ = GOOGLE_ULONGLONG(0);
-  success_ = false;
-  last_log_index_ = GOOGLE_ULONGLONG(0);
+  type_ = 0;
+  request_vote_ = NULL;
+  append_entries_ = NULL;
+  kv_request_ = NULL;
+  lock_request_ = NULL;
+  add_server_request_ = NULL;
+  remove_server_request_ = NULL;
+  server_status_ = NULL;
+  install_snapshot_ = NULL;
+  leader_heartbeat_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
-CmdResponse_AppendEntriesResponse::~CmdResponse_AppendEntriesResponse() {
+CmdRequest::~CmdRequest() {
   SharedDtor();
 }
 
-void CmdResponse_AppendEntriesResponse::SharedDtor() {
+void CmdRequest::SharedDtor() {
   if (this != default_instance_) {
+    delete request_vote_;
+    delete append_entries_;
+    delete kv_request_;
+    delete lock_request_;
+    delete add_server_request_;
+    delete remove_server_request_;
+    delete server_status_;
+    delete install_snapshot_;
+    delete leader_heartbeat_;
   }
 }
 
-void CmdResponse_AppendEntriesResponse::SetCachedSize(int size) const {
+void CmdRequest::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* CmdResponse_AppendEntriesResponse::descriptor() {
+const ::google::protobuf::Descriptor* CmdRequest::descriptor() {
   protobuf_AssignDescriptorsOnce();
-  return CmdResponse_AppendEntriesResponse_descriptor_;
+  return CmdRequest_descriptor_;
 }
 
-const CmdResponse_AppendEntriesResponse& CmdResponse_AppendEntriesResponse::default_instance() {
+const CmdRequest& CmdRequest::default_instance() {
   if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
   return *default_instance_;
 }
 
-CmdResponse_AppendEntriesResponse* CmdResponse_AppendEntriesResponse::default_instance_ = NULL;
+CmdRequest* CmdRequest::default_instance_ = NULL;
 
-CmdResponse_AppendEntriesResponse* CmdResponse_AppendEntriesResponse::New() const {
-  return new CmdResponse_AppendEntriesResponse;
+CmdRequest* CmdRequest::New() const {
+  return new CmdRequest;
 }
 
-void CmdResponse_AppendEntriesResponse::Clear() {
+void CmdRequest::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    term_ = GOOGLE_ULONGLONG(0);
-    success_ = false;
-    last_log_index_ = GOOGLE_ULONGLONG(0);
+    type_ = 0;
+    if (has_request_vote()) {
+      if (request_vote_ != NULL) request_vote_->::floyd::CmdRequest_RequestVote::Clear();
+    }
+    if (has_append_entries()) {
+      if (append_entries_ != NULL) append_entries_->::floyd::CmdRequest_AppendEntries::Clear();
+    }
+    if (has_kv_request()) {
+      if (kv_request_ != NULL) kv_request_->::floyd::CmdRequest_KvRequest::Clear();
+    }
+    if (has_lock_request()) {
+      if (lock_request_ != NULL) lock_request_->::floyd::CmdRequest_LockRequest::Clear();
+    }
+    if (has_add_server_request()) {
+      if (add_server_request_ != NULL) add_server_request_->::floyd::CmdRequest_AddServerRequest::Clear();
+    }
+    if (has_remove_server_request()) {
+      if (remove_server_request_ != NULL) remove_server_request_->::floyd::CmdRequest_RemoveServerRequest::Clear();
+    }
+    if (has_server_status()) {
+      if (server_status_ != NULL) server_status_->::floyd::CmdRequest_ServerStatus::Clear();
+    }
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (has_install_snapshot()) {
+      if (install_snapshot_ != NULL) install_snapshot_->::floyd::CmdRequest_InstallSnapshot::Clear();
+    }
+    if (has_leader_heartbeat()) {
+      if (leader_heartbeat_ != NULL) leader_heartbeat_->::floyd::CmdRequest_LeaderHeartbeat::Clear();
+    }
   }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
 
-bool CmdResponse_AppendEntriesResponse::MergePartialFromCodedStream(
+bool CmdRequest::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!(EXPRESSION)) return false
   ::google::protobuf::uint32 tag;
   while ((tag = input->ReadTag()) != 0) {
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // required uint64 term = 1;
+      // required .floyd.Type type = 1;
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+          int value;
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                   int, ::google::protobuf::internal::WireFormatLite::TYPE_ENUM>(
+                 input, &value)));
+          if (::floyd::Type_IsValid(value)) {
+            set_type(static_cast< ::floyd::Type >(value));
+          } else {
+            mutable_unknown_fields()->AddVarint(1, value);
+          }
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(18)) goto parse_request_vote;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.RequestVote request_vote = 2;
+      case 2: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_request_vote:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_request_vote()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(26)) goto parse_append_entries;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
+      case 3: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_append_entries:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_append_entries()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(34)) goto parse_kv_request;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.KvRequest kv_request = 4;
+      case 4: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_kv_request:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_kv_request()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(42)) goto parse_lock_request;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.LockRequest lock_request = 5;
+      case 5: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_lock_request:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_lock_request()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(50)) goto parse_server_status;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.ServerStatus server_status = 6;
+      case 6: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_server_status:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_server_status()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(58)) goto parse_add_server_request;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
+      case 7: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_add_server_request:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_add_server_request()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(66)) goto parse_remove_server_request;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
+      case 8: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_remove_server_request:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_remove_server_request()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(74)) goto parse_install_snapshot;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+      case 9: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_install_snapshot:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_install_snapshot()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(82)) goto parse_leader_heartbeat;
+        break;
+      }
+
+      // optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+      case 10: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_leader_heartbeat:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_leader_heartbeat()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
+        break;
+      }
+
+      default: {
+      handle_uninterpreted:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+  return true;
+#undef DO_
+}
+
+void CmdRequest::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // required .floyd.Type type = 1;
+  if (has_type()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnum(
+      1, this->type(), output);
+  }
+
+  // optional .floyd.CmdRequest.RequestVote request_vote = 2;
+  if (has_request_vote()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      2, this->request_vote(), output);
+  }
+
+  // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
+  if (has_append_entries()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      3, this->append_entries(), output);
+  }
+
+  // optional .floyd.CmdRequest.KvRequest kv_request = 4;
+  if (has_kv_request()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      4, this->kv_request(), output);
+  }
+
+  // optional .floyd.CmdRequest.LockRequest lock_request = 5;
+  if (has_lock_request()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      5, this->lock_request(), output);
+  }
+
+  // optional .floyd.CmdRequest.ServerStatus server_status = 6;
+  if (has_server_status()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      6, this->server_status(), output);
+  }
+
+  // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
+  if (has_add_server_request()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      7, this->add_server_request(), output);
+  }
+
+  // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
+  if (has_remove_server_request()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      8, this->remove_server_request(), output);
+  }
+
+  // optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+  if (has_install_snapshot()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      9, this->install_snapshot(), output);
+  }
+
+  // optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+  if (has_leader_heartbeat()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      10, this->leader_heartbeat(), output);
+  }
+
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+}
+
+::google::protobuf::uint8* CmdRequest::SerializeWithCachedSizesToArray(
+    ::google::protobuf::uint8* target) const {
+  // required .floyd.Type type = 1;
+  if (has_type()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+      1, this->type(), target);
+  }
+
+  // optional .floyd.CmdRequest.RequestVote request_vote = 2;
+  if (has_request_vote()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        2, this->request_vote(), target);
+  }
+
+  // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
+  if (has_append_entries()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        3, this->append_entries(), target);
+  }
+
+  // optional .floyd.CmdRequest.KvRequest kv_request = 4;
+  if (has_kv_request()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        4, this->kv_request(), target);
+  }
+
+  // optional .floyd.CmdRequest.LockRequest lock_request = 5;
+  if (has_lock_request()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        5, this->lock_request(), target);
+  }
+
+  // optional .floyd.CmdRequest.ServerStatus server_status = 6;
+  if (has_server_status()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        6, this->server_status(), target);
+  }
+
+  // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
+  if (has_add_server_request()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        7, this->add_server_request(), target);
+  }
+
+  // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
+  if (has_remove_server_request()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        8, this->remove_server_request(), target);
+  }
+
+  // optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+  if (has_install_snapshot()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        9, this->install_snapshot(), target);
+  }
+
+  // optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+  if (has_leader_heartbeat()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        10, this->leader_heartbeat(), target);
+  }
+
+  if (!unknown_fields().empty()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  return target;
+}
+
+int CmdRequest::ByteSize() const {
+  int total_size = 0;
+
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    // required .floyd.Type type = 1;
+    if (has_type()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::EnumSize(this->type());
+    }
+
+    // optional .floyd.CmdRequest.RequestVote request_vote = 2;
+    if (has_request_vote()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->request_vote());
+    }
+
+    // optional .floyd.CmdRequest.AppendEntries append_entries = 3;
+    if (has_append_entries()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->append_entries());
+    }
+
+    // optional .floyd.CmdRequest.KvRequest kv_request = 4;
+    if (has_kv_request()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->kv_request());
+    }
+
+    // optional .floyd.CmdRequest.LockRequest lock_request = 5;
+    if (has_lock_request()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->lock_request());
+    }
+
+    // optional .floyd.CmdRequest.AddServerRequest add_server_request = 7;
+    if (has_add_server_request()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->add_server_request());
+    }
+
+    // optional .floyd.CmdRequest.RemoveServerRequest remove_server_request = 8;
+    if (has_remove_server_request()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->remove_server_request());
+    }
+
+    // optional .floyd.CmdRequest.ServerStatus server_status = 6;
+    if (has_server_status()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->server_status());
+    }
+
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    // optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+    if (has_install_snapshot()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->install_snapshot());
+    }
+
+    // optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+    if (has_leader_heartbeat()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->leader_heartbeat());
+    }
+
+  }
+  if (!unknown_fields().empty()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void CmdRequest::MergeFrom(const ::google::protobuf::Message& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  const CmdRequest* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdRequest*>(
+      &from);
+  if (source == NULL) {
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+    MergeFrom(*source);
+  }
+}
+
+void CmdRequest::MergeFrom(const CmdRequest& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    if (from.has_type()) {
+      set_type(from.type());
+    }
+    if (from.has_request_vote()) {
+      mutable_request_vote()->::floyd::CmdRequest_RequestVote::MergeFrom(from.request_vote());
+    }
+    if (from.has_append_entries()) {
+      mutable_append_entries()->::floyd::CmdRequest_AppendEntries::MergeFrom(from.append_entries());
+    }
+    if (from.has_kv_request()) {
+      mutable_kv_request()->::floyd::CmdRequest_KvRequest::MergeFrom(from.kv_request());
+    }
+    if (from.has_lock_request()) {
+      mutable_lock_request()->::floyd::CmdRequest_LockRequest::MergeFrom(from.lock_request());
+    }
+    if (from.has_add_server_request()) {
+      mutable_add_server_request()->::floyd::CmdRequest_AddServerRequest::MergeFrom(from.add_server_request());
+    }
+    if (from.has_remove_server_request()) {
+      mutable_remove_server_request()->::floyd::CmdRequest_RemoveServerRequest::MergeFrom(from.remove_server_request());
+    }
+    if (from.has_server_status()) {
+      mutable_server_status()->::floyd::CmdRequest_ServerStatus::MergeFrom(from.server_status());
+    }
+  }
+  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (from.has_install_snapshot()) {
+      mutable_install_snapshot()->::floyd::CmdRequest_InstallSnapshot::MergeFrom(from.install_snapshot());
+    }
+    if (from.has_leader_heartbeat()) {
+      mutable_leader_heartbeat()->::floyd::CmdRequest_LeaderHeartbeat::MergeFrom(from.leader_heartbeat());
+    }
+  }
+  mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+}
+
+void CmdRequest::CopyFrom(const ::google::protobuf::Message& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void CmdRequest::CopyFrom(const CmdRequest& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool CmdRequest::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000001) != 0x00000001) return false;
+
+  if (has_request_vote()) {
+    if (!this->request_vote().IsInitialized()) return false;
+  }
+  if (has_append_entries()) {
+    if (!this->append_entries().IsInitialized()) return false;
+  }
+  if (has_kv_request()) {
+    if (!this->kv_request().IsInitialized()) return false;
+  }
+  if (has_lock_request()) {
+    if (!this->lock_request().IsInitialized()) return false;
+  }
+  if (has_add_server_request()) {
+    if (!this->add_server_request().IsInitialized()) return false;
+  }
+  if (has_remove_server_request()) {
+    if (!this->remove_server_request().IsInitialized()) return false;
+  }
+  if (has_server_status()) {
+    if (!this->server_status().IsInitialized()) return false;
+  }
+  if (has_install_snapshot()) {
+    if (!this->install_snapshot().IsInitialized()) return false;
+  }
+  if (has_leader_heartbeat()) {
+    if (!this->leader_heartbeat().IsInitialized()) return false;
+  }
+  return true;
+}
+
+void CmdRequest::Swap(CmdRequest* other) {
+  if (other != this) {
+    std::swap(type_, other->type_);
+    std::swap(request_vote_, other->request_vote_);
+    std::swap(append_entries_, other->append_entries_);
+    std::swap(kv_request_, other->kv_request_);
+    std::swap(lock_request_, other->lock_request_);
+    std::swap(add_server_request_, other->add_server_request_);
+    std::swap(remove_server_request_, other->remove_server_request_);
+    std::swap(server_status_, other->server_status_);
+    std::swap(install_snapshot_, other->install_snapshot_);
+    std::swap(leader_heartbeat_, other->leader_heartbeat_);
+    std::swap(_has_bits_[0], other->_has_bits_[0]);
+    _unknown_fields_.Swap(&other->_unknown_fields_);
+    std::swap(_cached_size_, other->_cached_size_);
+  }
+}
+
+::google::protobuf::Metadata CmdRequest::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = CmdRequest_descriptor_;
+  metadata.reflection = CmdRequest_reflection_;
+  return metadata;
+}
+
+
+// ===================================================================
+
+#ifndef _MSC_VER
+const int CmdResponse_RequestVoteResponse::kTermFieldNumber;
+const int CmdResponse_RequestVoteResponse::kVoteGrantedFieldNumber;
+#endif  // !_MSC_VER
+
+CmdResponse_RequestVoteResponse::CmdResponse_RequestVoteResponse()
+  : ::google::protobuf::Message() {
+  SharedCtor();
+}
+
+void CmdResponse_RequestVoteResponse::InitAsDefaultInstance() {
+}
+
+CmdResponse_RequestVoteResponse::CmdResponse_RequestVoteResponse(const CmdResponse_RequestVoteResponse& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  MergeFrom(from);
+}
+
+void CmdResponse_RequestVoteResponse::SharedCtor() {
+  _cached_size_ = 0;
+  term_ = GOOGLE_ULONGLONG(0);
+  vote_granted_ = false;
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+CmdResponse_RequestVoteResponse::~CmdResponse_RequestVoteResponse() {
+  SharedDtor();
+}
+
+void CmdResponse_RequestVoteResponse::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void CmdResponse_RequestVoteResponse::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* CmdResponse_RequestVoteResponse::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return CmdResponse_RequestVoteResponse_descriptor_;
+}
+
+const CmdResponse_RequestVoteResponse& CmdResponse_RequestVoteResponse::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
+  return *default_instance_;
+}
+
+CmdResponse_RequestVoteResponse* CmdResponse_RequestVoteResponse::default_instance_ = NULL;
+
+CmdResponse_RequestVoteResponse* CmdResponse_RequestVoteResponse::New() const {
+  return new CmdResponse_RequestVoteResponse;
+}
+
+void CmdResponse_RequestVoteResponse::Clear() {
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    term_ = GOOGLE_ULONGLONG(0);
+    vote_granted_ = false;
+  }
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  mutable_unknown_fields()->Clear();
+}
+
+bool CmdResponse_RequestVoteResponse::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!(EXPRESSION)) return false
+  ::google::protobuf::uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required uint64 term = 1;
+      case 1: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &term_)));
+          set_has_term();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(16)) goto parse_vote_granted;
+        break;
+      }
+
+      // required bool vote_granted = 2;
+      case 2: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_vote_granted:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &vote_granted_)));
+          set_has_vote_granted();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
+        break;
+      }
+
+      default: {
+      handle_uninterpreted:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+  return true;
+#undef DO_
+}
+
+void CmdResponse_RequestVoteResponse::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
+  }
+
+  // required bool vote_granted = 2;
+  if (has_vote_granted()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->vote_granted(), output);
+  }
+
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+}
+
+::google::protobuf::uint8* CmdResponse_RequestVoteResponse::SerializeWithCachedSizesToArray(
+    ::google::protobuf::uint8* target) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
+  }
+
+  // required bool vote_granted = 2;
+  if (has_vote_granted()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->vote_granted(), target);
+  }
+
+  if (!unknown_fields().empty()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  return target;
+}
+
+int CmdResponse_RequestVoteResponse::ByteSize() const {
+  int total_size = 0;
+
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    // required uint64 term = 1;
+    if (has_term()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->term());
+    }
+
+    // required bool vote_granted = 2;
+    if (has_vote_granted()) {
+      total_size += 1 + 1;
+    }
+
+  }
+  if (!unknown_fields().empty()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void CmdResponse_RequestVoteResponse::MergeFrom(const ::google::protobuf::Message& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  const CmdResponse_RequestVoteResponse* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_RequestVoteResponse*>(
+      &from);
+  if (source == NULL) {
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+    MergeFrom(*source);
+  }
+}
+
+void CmdResponse_RequestVoteResponse::MergeFrom(const CmdResponse_RequestVoteResponse& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    if (from.has_term()) {
+      set_term(from.term());
+    }
+    if (from.has_vote_granted()) {
+      set_vote_granted(from.vote_granted());
+    }
+  }
+  mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+}
+
+void CmdResponse_RequestVoteResponse::CopyFrom(const ::google::protobuf::Message& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void CmdResponse_RequestVoteResponse::CopyFrom(const CmdResponse_RequestVoteResponse& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool CmdResponse_RequestVoteResponse::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
+
+  return true;
+}
+
+void CmdResponse_RequestVoteResponse::Swap(CmdResponse_RequestVoteResponse* other) {
+  if (other != this) {
+    std::swap(term_, other->term_);
+    std::swap(vote_granted_, other->vote_granted_);
+    std::swap(_has_bits_[0], other->_has_bits_[0]);
+    _unknown_fields_.Swap(&other->_unknown_fields_);
+    std::swap(_cached_size_, other->_cached_size_);
+  }
+}
+
+::google::protobuf::Metadata CmdResponse_RequestVoteResponse::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = CmdResponse_RequestVoteResponse_descriptor_;
+  metadata.reflection = CmdResponse_RequestVoteResponse_reflection_;
+  return metadata;
+}
+
+
+// -------------------------------------------------------------------
+
+#ifndef _MSC_VER
+const int CmdResponse_AppendEntriesResponse::kTermFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kSuccessFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kLastLogIndexFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kConflictTermFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kConflictIndexFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kLastAppliedFieldNumber;
+const int CmdResponse_AppendEntriesResponse::kMatchIndexFieldNumber;
+#endif  // !_MSC_VER
+
+CmdResponse_AppendEntriesResponse::CmdResponse_AppendEntriesResponse()
+  : ::google::protobuf::Message() {
+  SharedCtor();
+}
+
+void CmdResponse_AppendEntriesResponse::InitAsDefaultInstance() {
+}
+
+CmdResponse_AppendEntriesResponse::CmdResponse_AppendEntriesResponse(const CmdResponse_AppendEntriesResponse& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  MergeFrom(from);
+}
+
+void CmdResponse_AppendEntriesResponse::SharedCtor() {
+  _cached_size_ = 0;
+  term_ = GOOGLE_ULONGLONG(0);
+  success_ = false;
+  last_log_index_ = GOOGLE_ULONGLONG(0);
+  conflict_term_ = GOOGLE_ULONGLONG(0);
+  conflict_index_ = GOOGLE_ULONGLONG(0);
+  last_applied_ = GOOGLE_ULONGLONG(0);
+  match_index_ = GOOGLE_ULONGLONG(0);
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+CmdResponse_AppendEntriesResponse::~CmdResponse_AppendEntriesResponse() {
+  SharedDtor();
+}
+
+void CmdResponse_AppendEntriesResponse::SharedDtor() {
+  if (this != default_instance_) {
+  }
+}
+
+void CmdResponse_AppendEntriesResponse::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* CmdResponse_AppendEntriesResponse::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return CmdResponse_AppendEntriesResponse_descriptor_;
+}
+
+const CmdResponse_AppendEntriesResponse& CmdResponse_AppendEntriesResponse::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
+  return *default_instance_;
+}
+
+CmdResponse_AppendEntriesResponse* CmdResponse_AppendEntriesResponse::default_instance_ = NULL;
+
+CmdResponse_AppendEntriesResponse* CmdResponse_AppendEntriesResponse::New() const {
+  return new CmdResponse_AppendEntriesResponse;
+}
+
+void CmdResponse_AppendEntriesResponse::Clear() {
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    term_ = GOOGLE_ULONGLONG(0);
+    success_ = false;
+    last_log_index_ = GOOGLE_ULONGLONG(0);
+    conflict_term_ = GOOGLE_ULONGLONG(0);
+    conflict_index_ = GOOGLE_ULONGLONG(0);
+    last_applied_ = GOOGLE_ULONGLONG(0);
+    match_index_ = GOOGLE_ULONGLONG(0);
+  }
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  mutable_unknown_fields()->Clear();
+}
+
+bool CmdResponse_AppendEntriesResponse::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!(EXPRESSION)) return false
+  ::google::protobuf::uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required uint64 term = 1;
+      case 1: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &term_)));
+          set_has_term();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(16)) goto parse_success;
+        break;
+      }
+
+      // required bool success = 2;
+      case 2: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_success:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &success_)));
+          set_has_success();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(24)) goto parse_last_log_index;
+        break;
+      }
+
+      // optional uint64 last_log_index = 3;
+      case 3: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_log_index:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_log_index_)));
+          set_has_last_log_index();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(32)) goto parse_conflict_term;
+        break;
+      }
+
+      // optional uint64 conflict_term = 4;
+      case 4: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_conflict_term:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &conflict_term_)));
+          set_has_conflict_term();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(40)) goto parse_conflict_index;
+        break;
+      }
+
+      // optional uint64 conflict_index = 5;
+      case 5: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_conflict_index:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &conflict_index_)));
+          set_has_conflict_index();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(48)) goto parse_last_applied;
+        break;
+      }
+
+      // optional uint64 last_applied = 6;
+      case 6: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_applied:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_applied_)));
+          set_has_last_applied();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(56)) goto parse_match_index;
+        break;
+      }
+
+      // optional uint64 match_index = 7;
+      case 7: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_match_index:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &match_index_)));
+          set_has_match_index();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
+        break;
+      }
+
+      default: {
+      handle_uninterpreted:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+  return true;
+#undef DO_
+}
+
+void CmdResponse_AppendEntriesResponse::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
+  }
+
+  // required bool success = 2;
+  if (has_success()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->success(), output);
+  }
+
+  // optional uint64 last_log_index = 3;
+  if (has_last_log_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(3, this->last_log_index(), output);
+  }
+
+  // optional uint64 conflict_term = 4;
+  if (has_conflict_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(4, this->conflict_term(), output);
+  }
+
+  // optional uint64 conflict_index = 5;
+  if (has_conflict_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(5, this->conflict_index(), output);
+  }
+
+  // optional uint64 last_applied = 6;
+  if (has_last_applied()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(6, this->last_applied(), output);
+  }
+
+  // optional uint64 match_index = 7;
+  if (has_match_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(7, this->match_index(), output);
+  }
+
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+}
+
+::google::protobuf::uint8* CmdResponse_AppendEntriesResponse::SerializeWithCachedSizesToArray(
+    ::google::protobuf::uint8* target) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
+  }
+
+  // required bool success = 2;
+  if (has_success()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->success(), target);
+  }
+
+  // optional uint64 last_log_index = 3;
+  if (has_last_log_index()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(3, this->last_log_index(), target);
+  }
+
+  // optional uint64 conflict_term = 4;
+  if (has_conflict_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(4, this->conflict_term(), target);
+  }
+
+  // optional uint64 conflict_index = 5;
+  if (has_conflict_index()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(5, this->conflict_index(), target);
+  }
+
+  // optional uint64 last_applied = 6;
+  if (has_last_applied()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(6, this->last_applied(), target);
+  }
+
+  // optional uint64 match_index = 7;
+  if (has_match_index()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(7, this->match_index(), target);
+  }
+
+  if (!unknown_fields().empty()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  return target;
+}
+
+int CmdResponse_AppendEntriesResponse::ByteSize() const {
+  int total_size = 0;
+
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    // required uint64 term = 1;
+    if (has_term()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->term());
+    }
+
+    // required bool success = 2;
+    if (has_success()) {
+      total_size += 1 + 1;
+    }
+
+    // optional uint64 last_log_index = 3;
+    if (has_last_log_index()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_log_index());
+    }
+
+    // optional uint64 conflict_term = 4;
+    if (has_conflict_term()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->conflict_term());
+    }
+
+    // optional uint64 conflict_index = 5;
+    if (has_conflict_index()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->conflict_index());
+    }
+
+    // optional uint64 last_applied = 6;
+    if (has_last_applied()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_applied());
+    }
+
+    // optional uint64 match_index = 7;
+    if (has_match_index()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->match_index());
+    }
+
+  }
+  if (!unknown_fields().empty()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void CmdResponse_AppendEntriesResponse::MergeFrom(const ::google::protobuf::Message& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  const CmdResponse_AppendEntriesResponse* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_AppendEntriesResponse*>(
+      &from);
+  if (source == NULL) {
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+    MergeFrom(*source);
+  }
+}
+
+void CmdResponse_AppendEntriesResponse::MergeFrom(const CmdResponse_AppendEntriesResponse& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    if (from.has_term()) {
+      set_term(from.term());
+    }
+    if (from.has_success()) {
+      set_success(from.success());
+    }
+    if (from.has_last_log_index()) {
+      set_last_log_index(from.last_log_index());
+    }
+    if (from.has_conflict_term()) {
+      set_conflict_term(from.conflict_term());
+    }
+    if (from.has_conflict_index()) {
+      set_conflict_index(from.conflict_index());
+    }
+    if (from.has_last_applied()) {
+      set_last_applied(from.last_applied());
+    }
+    if (from.has_match_index()) {
+      set_match_index(from.match_index());
+    }
+  }
+  mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+}
+
+void CmdResponse_AppendEntriesResponse::CopyFrom(const ::google::protobuf::Message& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void CmdResponse_AppendEntriesResponse::CopyFrom(const CmdResponse_AppendEntriesResponse& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool CmdResponse_AppendEntriesResponse::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
+
+  return true;
+}
+
+void CmdResponse_AppendEntriesResponse::Swap(CmdResponse_AppendEntriesResponse* other) {
+  if (other != this) {
+    std::swap(term_, other->term_);
+    std::swap(success_, other->success_);
+    std::swap(last_log_index_, other->last_log_index_);
+    std::swap(conflict_term_, other->conflict_term_);
+    std::swap(conflict_index_, other->conflict_index_);
+    std::swap(last_applied_, other->last_applied_);
+    std::swap(match_index_, other->match_index_);
+    std::swap(_has_bits_[0], other->_has_bits_[0]);
+    _unknown_fields_.Swap(&other->_unknown_fields_);
+    std::swap(_cached_size_, other->_cached_size_);
+  }
+}
+
+::google::protobuf::Metadata CmdResponse_AppendEntriesResponse::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = CmdResponse_AppendEntriesResponse_descriptor_;
+  metadata.reflection = CmdResponse_AppendEntriesResponse_reflection_;
+  return metadata;
+}
+
+
+// -------------------------------------------------------------------
+
+#ifndef _MSC_VER
+const int CmdResponse_KvResponse::kValueFieldNumber;
+#endif  // !_MSC_VER
+
+CmdResponse_KvResponse::CmdResponse_KvResponse()
+  : ::google::protobuf::Message() {
+  SharedCtor();
+}
+
+void CmdResponse_KvResponse::InitAsDefaultInstance() {
+}
+
+CmdResponse_KvResponse::CmdResponse_KvResponse(const CmdResponse_KvResponse& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  MergeFrom(from);
+}
+
+void CmdResponse_KvResponse::SharedCtor() {
+  _cached_size_ = 0;
+  value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+CmdResponse_KvResponse::~CmdResponse_KvResponse() {
+  SharedDtor();
+}
+
+void CmdResponse_KvResponse::SharedDtor() {
+  if (value_ != &::google::protobuf::internal::kEmptyString) {
+    delete value_;
+  }
+  if (this != default_instance_) {
+  }
+}
+
+void CmdResponse_KvResponse::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* CmdResponse_KvResponse::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return CmdResponse_KvResponse_descriptor_;
+}
+
+const CmdResponse_KvResponse& CmdResponse_KvResponse::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
+  return *default_instance_;
+}
+
+CmdResponse_KvResponse* CmdResponse_KvResponse::default_instance_ = NULL;
+
+CmdResponse_KvResponse* CmdResponse_KvResponse::New() const {
+  return new CmdResponse_KvResponse;
+}
+
+void CmdResponse_KvResponse::Clear() {
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    if (has_value()) {
+      if (value_ != &::google::protobuf::internal::kEmptyString) {
+        value_->clear();
+      }
+    }
+  }
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  mutable_unknown_fields()->Clear();
+}
+
+bool CmdResponse_KvResponse::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!(EXPRESSION)) return false
+  ::google::protobuf::uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // optional bytes value = 1;
+      case 1: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_value()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
+        break;
+      }
+
+      default: {
+      handle_uninterpreted:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+  return true;
+#undef DO_
+}
+
+void CmdResponse_KvResponse::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // optional bytes value = 1;
+  if (has_value()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      1, this->value(), output);
+  }
+
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        unknown_fields(), output);
+  }
+}
+
+::google::protobuf::uint8* CmdResponse_KvResponse::SerializeWithCachedSizesToArray(
+    ::google::protobuf::uint8* target) const {
+  // optional bytes value = 1;
+  if (has_value()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        1, this->value(), target);
+  }
+
+  if (!unknown_fields().empty()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        unknown_fields(), target);
+  }
+  return target;
+}
+
+int CmdResponse_KvResponse::ByteSize() const {
+  int total_size = 0;
+
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    // optional bytes value = 1;
+    if (has_value()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->value());
+    }
+
+  }
+  if (!unknown_fields().empty()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        unknown_fields());
+  }
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void CmdResponse_KvResponse::MergeFrom(const ::google::protobuf::Message& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  const CmdResponse_KvResponse* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_KvResponse*>(
+      &from);
+  if (source == NULL) {
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+    MergeFrom(*source);
+  }
+}
+
+void CmdResponse_KvResponse::MergeFrom(const CmdResponse_KvResponse& from) {
+  GOOGLE_CHECK_NE(&from, this);
+  if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    if (from.has_value()) {
+      set_value(from.value());
+    }
+  }
+  mutable_unknown_fields()->MergeFrom(from.unknown_fields());
+}
+
+void CmdResponse_KvResponse::CopyFrom(const ::google::protobuf::Message& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void CmdResponse_KvResponse::CopyFrom(const CmdResponse_KvResponse& from) {
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool CmdResponse_KvResponse::IsInitialized() const {
+
+  return true;
+}
+
+void CmdResponse_KvResponse::Swap(CmdResponse_KvResponse* other) {
+  if (other != this) {
+    std::swap(value_, other->value_);
+    std::swap(_has_bits_[0], other->_has_bits_[0]);
+    _unknown_fields_.Swap(&other->_unknown_fields_);
+    std::swap(_cached_size_, other->_cached_size_);
+  }
+}
+
+::google::protobuf::Metadata CmdResponse_KvResponse::GetMetadata() const {
+  protobuf_AssignDescriptorsOnce();
+  ::google::protobuf::Metadata metadata;
+  metadata.descriptor = CmdResponse_KvResponse_descriptor_;
+  metadata.reflection = CmdResponse_KvResponse_reflection_;
+  return metadata;
+}
+
+
+// -------------------------------------------------------------------
+
+#ifndef _MSC_VER
+const int CmdResponse_ServerStatus::kTermFieldNumber;
+const int CmdResponse_ServerStatus::kCommitIndexFieldNumber;
+const int CmdResponse_ServerStatus::kRoleFieldNumber;
+const int CmdResponse_ServerStatus::kLeaderIpFieldNumber;
+const int CmdResponse_ServerStatus::kLeaderPortFieldNumber;
+const int CmdResponse_ServerStatus::kVotedForIpFieldNumber;
+const int CmdResponse_ServerStatus::kVotedForPortFieldNumber;
+const int CmdResponse_ServerStatus::kLastLogTermFieldNumber;
+const int CmdResponse_ServerStatus::kLastLogIndexFieldNumber;
+const int CmdResponse_ServerStatus::kLastAppliedFieldNumber;
+#endif  // !_MSC_VER
+
+CmdResponse_ServerStatus::CmdResponse_ServerStatus()
+  : ::google::protobuf::Message() {
+  SharedCtor();
+}
+
+void CmdResponse_ServerStatus::InitAsDefaultInstance() {
+}
+
+CmdResponse_ServerStatus::CmdResponse_ServerStatus(const CmdResponse_ServerStatus& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  MergeFrom(from);
+}
+
+void CmdResponse_ServerStatus::SharedCtor() {
+  _cached_size_ = 0;
+  term_ = GOOGLE_ULONGLONG(0);
+  commit_index_ = GOOGLE_ULONGLONG(0);
+  role_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  leader_ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  leader_port_ = 0;
+  voted_for_ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  voted_for_port_ = 0;
+  last_log_term_ = GOOGLE_ULONGLONG(0);
+  last_log_index_ = GOOGLE_ULONGLONG(0);
+  last_applied_ = GOOGLE_ULONGLONG(0);
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+}
+
+CmdResponse_ServerStatus::~CmdResponse_ServerStatus() {
+  SharedDtor();
+}
+
+void CmdResponse_ServerStatus::SharedDtor() {
+  if (role_ != &::google::protobuf::internal::kEmptyString) {
+    delete role_;
+  }
+  if (leader_ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete leader_ip_;
+  }
+  if (voted_for_ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete voted_for_ip_;
+  }
+  if (this != default_instance_) {
+  }
+}
+
+void CmdResponse_ServerStatus::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* CmdResponse_ServerStatus::descriptor() {
+  protobuf_AssignDescriptorsOnce();
+  return CmdResponse_ServerStatus_descriptor_;
+}
+
+const CmdResponse_ServerStatus& CmdResponse_ServerStatus::default_instance() {
+  if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
+  return *default_instance_;
+}
+
+CmdResponse_ServerStatus* CmdResponse_ServerStatus::default_instance_ = NULL;
+
+CmdResponse_ServerStatus* CmdResponse_ServerStatus::New() const {
+  return new CmdResponse_ServerStatus;
+}
+
+void CmdResponse_ServerStatus::Clear() {
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    term_ = GOOGLE_ULONGLONG(0);
+    commit_index_ = GOOGLE_ULONGLONG(0);
+    if (has_role()) {
+      if (role_ != &::google::protobuf::internal::kEmptyString) {
+        role_->clear();
+      }
+    }
+    if (has_leader_ip()) {
+      if (leader_ip_ != &::google::protobuf::internal::kEmptyString) {
+        leader_ip_->clear();
+      }
+    }
+    leader_port_ = 0;
+    if (has_voted_for_ip()) {
+      if (voted_for_ip_ != &::google::protobuf::internal::kEmptyString) {
+        voted_for_ip_->clear();
+      }
+    }
+    voted_for_port_ = 0;
+    last_log_term_ = GOOGLE_ULONGLONG(0);
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    last_log_index_ = GOOGLE_ULONGLONG(0);
+    last_applied_ = GOOGLE_ULONGLONG(0);
+  }
+  ::memset(_has_bits_, 0, sizeof(_has_bits_));
+  mutable_unknown_fields()->Clear();
+}
+
+bool CmdResponse_ServerStatus::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!(EXPRESSION)) return false
+  ::google::protobuf::uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required uint64 term = 1;
+      case 1: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
                  input, &term_)));
           set_has_term();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(16)) goto parse_success;
+        if (input->ExpectTag(16)) goto parse_commit_index;
         break;
       }
 
-      // required bool success = 2;
+      // required uint64 commit_index = 2;
       case 2: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_success:
+         parse_commit_index:
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
-                 input, &success_)));
-          set_has_success();
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &commit_index_)));
+          set_has_commit_index();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(24)) goto parse_last_log_index;
+        if (input->ExpectTag(26)) goto parse_role;
         break;
       }
 
-      // optional uint64 last_log_index = 3;
+      // required bytes role = 3;
       case 3: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_role:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_role()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(34)) goto parse_leader_ip;
+        break;
+      }
+
+      // optional bytes leader_ip = 4;
+      case 4: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_leader_ip:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_leader_ip()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(40)) goto parse_leader_port;
+        break;
+      }
+
+      // optional int32 leader_port = 5;
+      case 5: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_leader_port:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &leader_port_)));
+          set_has_leader_port();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(50)) goto parse_voted_for_ip;
+        break;
+      }
+
+      // optional bytes voted_for_ip = 6;
+      case 6: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_voted_for_ip:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_voted_for_ip()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(56)) goto parse_voted_for_port;
+        break;
+      }
+
+      // optional int32 voted_for_port = 7;
+      case 7: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_voted_for_port:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &voted_for_port_)));
+          set_has_voted_for_port();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(64)) goto parse_last_log_term;
+        break;
+      }
+
+      // optional uint64 last_log_term = 8;
+      case 8: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_log_term:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_log_term_)));
+          set_has_last_log_term();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(72)) goto parse_last_log_index;
+        break;
+      }
+
+      // optional uint64 last_log_index = 9;
+      case 9: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
          parse_last_log_index:
@@ -4229,6 +6338,22 @@ bool CmdResponse_AppendEntriesResponse::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
+        if (input->ExpectTag(80)) goto parse_last_applied;
+        break;
+      }
+
+      // optional uint64 last_applied = 10;
+      case 10: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_last_applied:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_applied_)));
+          set_has_last_applied();
+        } else {
+          goto handle_uninterpreted;
+        }
         if (input->ExpectAtEnd()) return true;
         break;
       }
@@ -4249,44 +6374,123 @@ bool CmdResponse_AppendEntriesResponse::MergePartialFromCodedStream(
 #undef DO_
 }
 
-void CmdResponse_AppendEntriesResponse::SerializeWithCachedSizes(
+void CmdResponse_ServerStatus::SerializeWithCachedSizes(
     ::google::protobuf::io::CodedOutputStream* output) const {
   // required uint64 term = 1;
   if (has_term()) {
     ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
   }
 
-  // required bool success = 2;
-  if (has_success()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->success(), output);
+  // required uint64 commit_index = 2;
+  if (has_commit_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(2, this->commit_index(), output);
   }
 
-  // optional uint64 last_log_index = 3;
+  // required bytes role = 3;
+  if (has_role()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      3, this->role(), output);
+  }
+
+  // optional bytes leader_ip = 4;
+  if (has_leader_ip()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      4, this->leader_ip(), output);
+  }
+
+  // optional int32 leader_port = 5;
+  if (has_leader_port()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(5, this->leader_port(), output);
+  }
+
+  // optional bytes voted_for_ip = 6;
+  if (has_voted_for_ip()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+      6, this->voted_for_ip(), output);
+  }
+
+  // optional int32 voted_for_port = 7;
+  if (has_voted_for_port()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(7, this->voted_for_port(), output);
+  }
+
+  // optional uint64 last_log_term = 8;
+  if (has_last_log_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(8, this->last_log_term(), output);
+  }
+
+  // optional uint64 last_log_index = 9;
   if (has_last_log_index()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(3, this->last_log_index(), output);
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(9, this->last_log_index(), output);
+  }
+
+  // optional uint64 last_applied = 10;
+  if (has_last_applied()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(10, this->last_applied(), output);
   }
 
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
   }
-}
+}
+
+::google::protobuf::uint8* CmdResponse_ServerStatus::SerializeWithCachedSizesToArray(
+    ::google::protobuf::uint8* target) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
+  }
+
+  // required uint64 commit_index = 2;
+  if (has_commit_index()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(2, this->commit_index(), target);
+  }
+
+  // required bytes role = 3;
+  if (has_role()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        3, this->role(), target);
+  }
+
+  // optional bytes leader_ip = 4;
+  if (has_leader_ip()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        4, this->leader_ip(), target);
+  }
+
+  // optional int32 leader_port = 5;
+  if (has_leader_port()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(5, this->leader_port(), target);
+  }
+
+  // optional bytes voted_for_ip = 6;
+  if (has_voted_for_ip()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        6, this->voted_for_ip(), target);
+  }
 
-::google::protobuf::uint8* CmdResponse_AppendEntriesResponse::SerializeWithCachedSizesToArray(
-    ::google::protobuf::uint8* target) const {
-  // required uint64 term = 1;
-  if (has_term()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
+  // optional int32 voted_for_port = 7;
+  if (has_voted_for_port()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(7, this->voted_for_port(), target);
   }
 
-  // required bool success = 2;
-  if (has_success()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->success(), target);
+  // optional uint64 last_log_term = 8;
+  if (has_last_log_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(8, this->last_log_term(), target);
   }
 
-  // optional uint64 last_log_index = 3;
+  // optional uint64 last_log_index = 9;
   if (has_last_log_index()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(3, this->last_log_index(), target);
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(9, this->last_log_index(), target);
+  }
+
+  // optional uint64 last_applied = 10;
+  if (has_last_applied()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(10, this->last_applied(), target);
   }
 
   if (!unknown_fields().empty()) {
@@ -4296,7 +6500,7 @@ void CmdResponse_AppendEntriesResponse::SerializeWithCachedSizes(
   return target;
 }
 
-int CmdResponse_AppendEntriesResponse::ByteSize() const {
+int CmdResponse_ServerStatus::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -4307,18 +6511,71 @@ int CmdResponse_AppendEntriesResponse::ByteSize() const {
           this->term());
     }
 
-    // required bool success = 2;
-    if (has_success()) {
-      total_size += 1 + 1;
+    // required uint64 commit_index = 2;
+    if (has_commit_index()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->commit_index());
     }
 
-    // optional uint64 last_log_index = 3;
+    // required bytes role = 3;
+    if (has_role()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->role());
+    }
+
+    // optional bytes leader_ip = 4;
+    if (has_leader_ip()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->leader_ip());
+    }
+
+    // optional int32 leader_port = 5;
+    if (has_leader_port()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->leader_port());
+    }
+
+    // optional bytes voted_for_ip = 6;
+    if (has_voted_for_ip()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->voted_for_ip());
+    }
+
+    // optional int32 voted_for_port = 7;
+    if (has_voted_for_port()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->voted_for_port());
+    }
+
+    // optional uint64 last_log_term = 8;
+    if (has_last_log_term()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_log_term());
+    }
+
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    // optional uint64 last_log_index = 9;
     if (has_last_log_index()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::UInt64Size(
           this->last_log_index());
     }
 
+    // optional uint64 last_applied = 10;
+    if (has_last_applied()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->last_applied());
+    }
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -4331,10 +6588,10 @@ int CmdResponse_AppendEntriesResponse::ByteSize() const {
   return total_size;
 }
 
-void CmdResponse_AppendEntriesResponse::MergeFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_ServerStatus::MergeFrom(const ::google::protobuf::Message& from) {
   GOOGLE_CHECK_NE(&from, this);
-  const CmdResponse_AppendEntriesResponse* source =
-    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_AppendEntriesResponse*>(
+  const CmdResponse_ServerStatus* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_ServerStatus*>(
       &from);
   if (source == NULL) {
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
@@ -4343,56 +6600,86 @@ void CmdResponse_AppendEntriesResponse::MergeFrom(const ::google::protobuf::Mess
   }
 }
 
-void CmdResponse_AppendEntriesResponse::MergeFrom(const CmdResponse_AppendEntriesResponse& from) {
+void CmdResponse_ServerStatus::MergeFrom(const CmdResponse_ServerStatus& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (from.has_term()) {
       set_term(from.term());
     }
-    if (from.has_success()) {
-      set_success(from.success());
+    if (from.has_commit_index()) {
+      set_commit_index(from.commit_index());
+    }
+    if (from.has_role()) {
+      set_role(from.role());
+    }
+    if (from.has_leader_ip()) {
+      set_leader_ip(from.leader_ip());
+    }
+    if (from.has_leader_port()) {
+      set_leader_port(from.leader_port());
+    }
+    if (from.has_voted_for_ip()) {
+      set_voted_for_ip(from.voted_for_ip());
+    }
+    if (from.has_voted_for_port()) {
+      set_voted_for_port(from.voted_for_port());
+    }
+    if (from.has_last_log_term()) {
+      set_last_log_term(from.last_log_term());
     }
+  }
+  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
     if (from.has_last_log_index()) {
       set_last_log_index(from.last_log_index());
     }
+    if (from.has_last_applied()) {
+      set_last_applied(from.last_applied());
+    }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
-void CmdResponse_AppendEntriesResponse::CopyFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_ServerStatus::CopyFrom(const ::google::protobuf::Message& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void CmdResponse_AppendEntriesResponse::CopyFrom(const CmdResponse_AppendEntriesResponse& from) {
+void CmdResponse_ServerStatus::CopyFrom(const CmdResponse_ServerStatus& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool CmdResponse_AppendEntriesResponse::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
+bool CmdResponse_ServerStatus::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000007) != 0x00000007) return false;
 
   return true;
 }
 
-void CmdResponse_AppendEntriesResponse::Swap(CmdResponse_AppendEntriesResponse* other) {
+void CmdResponse_ServerStatus::Swap(CmdResponse_ServerStatus* other) {
   if (other != this) {
     std::swap(term_, other->term_);
-    std::swap(success_, other->success_);
+    std::swap(commit_index_, other->commit_index_);
+    std::swap(role_, other->role_);
+    std::swap(leader_ip_, other->leader_ip_);
+    std::swap(leader_port_, other->leader_port_);
+    std::swap(voted_for_ip_, other->voted_for_ip_);
+    std::swap(voted_for_port_, other->voted_for_port_);
+    std::swap(last_log_term_, other->last_log_term_);
     std::swap(last_log_index_, other->last_log_index_);
+    std::swap(last_applied_, other->last_applied_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
   }
 }
 
-::google::protobuf::Metadata CmdResponse_AppendEntriesResponse::GetMetadata() const {
+::google::protobuf::Metadata CmdResponse_ServerStatus::GetMetadata() const {
   protobuf_AssignDescriptorsOnce();
   ::google::protobuf::Metadata metadata;
-  metadata.descriptor = CmdResponse_AppendEntriesResponse_descriptor_;
-  metadata.reflection = CmdResponse_AppendEntriesResponse_reflection_;
+  metadata.descriptor = CmdResponse_ServerStatus_descriptor_;
+  metadata.reflection = CmdResponse_ServerStatus_reflection_;
   return metadata;
 }
 
@@ -4400,86 +6687,100 @@ void CmdResponse_AppendEntriesResponse::Swap(CmdResponse_AppendEntriesResponse*
 // -------------------------------------------------------------------
 
 #ifndef _MSC_VER
-const int CmdResponse_KvResponse::kValueFieldNumber;
+const int CmdResponse_InstallSnapshotResponse::kTermFieldNumber;
+const int CmdResponse_InstallSnapshotResponse::kSuccessFieldNumber;
 #endif  // !_MSC_VER
 
-CmdResponse_KvResponse::CmdResponse_KvResponse()
+CmdResponse_InstallSnapshotResponse::CmdResponse_InstallSnapshotResponse()
   : ::google::protobuf::Message() {
   SharedCtor();
 }
 
-void CmdResponse_KvResponse::InitAsDefaultInstance() {
+void CmdResponse_InstallSnapshotResponse::InitAsDefaultInstance() {
 }
 
-CmdResponse_KvResponse::CmdResponse_KvResponse(const CmdResponse_KvResponse& from)
+CmdResponse_InstallSnapshotResponse::CmdResponse_InstallSnapshotResponse(const CmdResponse_InstallSnapshotResponse& from)
   : ::google::protobuf::Message() {
   SharedCtor();
   MergeFrom(from);
 }
 
-void CmdResponse_KvResponse::SharedCtor() {
+void CmdResponse_InstallSnapshotResponse::SharedCtor() {
   _cached_size_ = 0;
-  value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  term_ = GOOGLE_ULONGLONG(0);
+  success_ = false;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
-CmdResponse_KvResponse::~CmdResponse_KvResponse() {
+CmdResponse_InstallSnapshotResponse::~CmdResponse_InstallSnapshotResponse() {
   SharedDtor();
 }
 
-void CmdResponse_KvResponse::SharedDtor() {
-  if (value_ != &::google::protobuf::internal::kEmptyString) {
-    delete value_;
-  }
+void CmdResponse_InstallSnapshotResponse::SharedDtor() {
   if (this != default_instance_) {
   }
 }
 
-void CmdResponse_KvResponse::SetCachedSize(int size) const {
+void CmdResponse_InstallSnapshotResponse::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* CmdResponse_KvResponse::descriptor() {
+const ::google::protobuf::Descriptor* CmdResponse_InstallSnapshotResponse::descriptor() {
   protobuf_AssignDescriptorsOnce();
-  return CmdResponse_KvResponse_descriptor_;
+  return CmdResponse_InstallSnapshotResponse_descriptor_;
 }
 
-const CmdResponse_KvResponse& CmdResponse_KvResponse::default_instance() {
+const CmdResponse_InstallSnapshotResponse& CmdResponse_InstallSnapshotResponse::default_instance() {
   if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
   return *default_instance_;
 }
 
-CmdResponse_KvResponse* CmdResponse_KvResponse::default_instance_ = NULL;
+CmdResponse_InstallSnapshotResponse* CmdResponse_InstallSnapshotResponse::default_instance_ = NULL;
 
-CmdResponse_KvResponse* CmdResponse_KvResponse::New() const {
-  return new CmdResponse_KvResponse;
+CmdResponse_InstallSnapshotResponse* CmdResponse_InstallSnapshotResponse::New() const {
+  return new CmdResponse_InstallSnapshotResponse;
 }
 
-void CmdResponse_KvResponse::Clear() {
+void CmdResponse_InstallSnapshotResponse::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    if (has_value()) {
-      if (value_ != &::google::protobuf::internal::kEmptyString) {
-        value_->clear();
-      }
-    }
+    term_ = GOOGLE_ULONGLONG(0);
+    success_ = false;
   }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
 
-bool CmdResponse_KvResponse::MergePartialFromCodedStream(
+bool CmdResponse_InstallSnapshotResponse::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!(EXPRESSION)) return false
   ::google::protobuf::uint32 tag;
   while ((tag = input->ReadTag()) != 0) {
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // optional bytes value = 1;
+      // required uint64 term = 1;
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
-                input, this->mutable_value()));
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &term_)));
+          set_has_term();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(16)) goto parse_success;
+        break;
+      }
+
+      // required bool success = 2;
+      case 2: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_success:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &success_)));
+          set_has_success();
         } else {
           goto handle_uninterpreted;
         }
@@ -4503,12 +6804,16 @@ bool CmdResponse_KvResponse::MergePartialFromCodedStream(
 #undef DO_
 }
 
-void CmdResponse_KvResponse::SerializeWithCachedSizes(
+void CmdResponse_InstallSnapshotResponse::SerializeWithCachedSizes(
     ::google::protobuf::io::CodedOutputStream* output) const {
-  // optional bytes value = 1;
-  if (has_value()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBytes(
-      1, this->value(), output);
+  // required uint64 term = 1;
+  if (has_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
+  }
+
+  // required bool success = 2;
+  if (has_success()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->success(), output);
   }
 
   if (!unknown_fields().empty()) {
@@ -4517,13 +6822,16 @@ void CmdResponse_KvResponse::SerializeWithCachedSizes(
   }
 }
 
-::google::protobuf::uint8* CmdResponse_KvResponse::SerializeWithCachedSizesToArray(
+::google::protobuf::uint8* CmdResponse_InstallSnapshotResponse::SerializeWithCachedSizesToArray(
     ::google::protobuf::uint8* target) const {
-  // optional bytes value = 1;
-  if (has_value()) {
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
-        1, this->value(), target);
+  // required uint64 term = 1;
+  if (has_term()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
+  }
+
+  // required bool success = 2;
+  if (has_success()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->success(), target);
   }
 
   if (!unknown_fields().empty()) {
@@ -4533,15 +6841,20 @@ void CmdResponse_KvResponse::SerializeWithCachedSizes(
   return target;
 }
 
-int CmdResponse_KvResponse::ByteSize() const {
+int CmdResponse_InstallSnapshotResponse::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    // optional bytes value = 1;
-    if (has_value()) {
+    // required uint64 term = 1;
+    if (has_term()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::BytesSize(
-          this->value());
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->term());
+    }
+
+    // required bool success = 2;
+    if (has_success()) {
+      total_size += 1 + 1;
     }
 
   }
@@ -4556,10 +6869,10 @@ int CmdResponse_KvResponse::ByteSize() const {
   return total_size;
 }
 
-void CmdResponse_KvResponse::MergeFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_InstallSnapshotResponse::MergeFrom(const ::google::protobuf::Message& from) {
   GOOGLE_CHECK_NE(&from, this);
-  const CmdResponse_KvResponse* source =
-    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_KvResponse*>(
+  const CmdResponse_InstallSnapshotResponse* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_InstallSnapshotResponse*>(
       &from);
   if (source == NULL) {
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
@@ -4568,47 +6881,52 @@ void CmdResponse_KvResponse::MergeFrom(const ::google::protobuf::Message& from)
   }
 }
 
-void CmdResponse_KvResponse::MergeFrom(const CmdResponse_KvResponse& from) {
+void CmdResponse_InstallSnapshotResponse::MergeFrom(const CmdResponse_InstallSnapshotResponse& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    if (from.has_value()) {
-      set_value(from.value());
+    if (from.has_term()) {
+      set_term(from.term());
+    }
+    if (from.has_success()) {
+      set_success(from.success());
     }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
-void CmdResponse_KvResponse::CopyFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_InstallSnapshotResponse::CopyFrom(const ::google::protobuf::Message& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void CmdResponse_KvResponse::CopyFrom(const CmdResponse_KvResponse& from) {
+void CmdResponse_InstallSnapshotResponse::CopyFrom(const CmdResponse_InstallSnapshotResponse& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool CmdResponse_KvResponse::IsInitialized() const {
+bool CmdResponse_InstallSnapshotResponse::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
 
   return true;
 }
 
-void CmdResponse_KvResponse::Swap(CmdResponse_KvResponse* other) {
+void CmdResponse_InstallSnapshotResponse::Swap(CmdResponse_InstallSnapshotResponse* other) {
   if (other != this) {
-    std::swap(value_, other->value_);
+    std::swap(term_, other->term_);
+    std::swap(success_, other->success_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
   }
 }
 
-::google::protobuf::Metadata CmdResponse_KvResponse::GetMetadata() const {
+::google::protobuf::Metadata CmdResponse_InstallSnapshotResponse::GetMetadata() const {
   protobuf_AssignDescriptorsOnce();
   ::google::protobuf::Metadata metadata;
-  metadata.descriptor = CmdResponse_KvResponse_descriptor_;
-  metadata.reflection = CmdResponse_KvResponse_reflection_;
+  metadata.descriptor = CmdResponse_InstallSnapshotResponse_descriptor_;
+  metadata.reflection = CmdResponse_InstallSnapshotResponse_reflection_;
   return metadata;
 }
 
@@ -4616,118 +6934,74 @@ void CmdResponse_KvResponse::Swap(CmdResponse_KvResponse* other) {
 // -------------------------------------------------------------------
 
 #ifndef _MSC_VER
-const int CmdResponse_ServerStatus::kTermFieldNumber;
-const int CmdResponse_ServerStatus::kCommitIndexFieldNumber;
-const int CmdResponse_ServerStatus::kRoleFieldNumber;
-const int CmdResponse_ServerStatus::kLeaderIpFieldNumber;
-const int CmdResponse_ServerStatus::kLeaderPortFieldNumber;
-const int CmdResponse_ServerStatus::kVotedForIpFieldNumber;
-const int CmdResponse_ServerStatus::kVotedForPortFieldNumber;
-const int CmdResponse_ServerStatus::kLastLogTermFieldNumber;
-const int CmdResponse_ServerStatus::kLastLogIndexFieldNumber;
-const int CmdResponse_ServerStatus::kLastAppliedFieldNumber;
+const int CmdResponse_LeaderHeartbeatResponse::kTermFieldNumber;
+const int CmdResponse_LeaderHeartbeatResponse::kSuccessFieldNumber;
+const int CmdResponse_LeaderHeartbeatResponse::kLastAppliedFieldNumber;
 #endif  // !_MSC_VER
 
-CmdResponse_ServerStatus::CmdResponse_ServerStatus()
+CmdResponse_LeaderHeartbeatResponse::CmdResponse_LeaderHeartbeatResponse()
   : ::google::protobuf::Message() {
   SharedCtor();
 }
 
-void CmdResponse_ServerStatus::InitAsDefaultInstance() {
+void CmdResponse_LeaderHeartbeatResponse::InitAsDefaultInstance() {
 }
 
-CmdResponse_ServerStatus::CmdResponse_ServerStatus(const CmdResponse_ServerStatus& from)
+CmdResponse_LeaderHeartbeatResponse::CmdResponse_LeaderHeartbeatResponse(const CmdResponse_LeaderHeartbeatResponse& from)
   : ::google::protobuf::Message() {
   SharedCtor();
   MergeFrom(from);
 }
 
-void CmdResponse_ServerStatus::SharedCtor() {
+void CmdResponse_LeaderHeartbeatResponse::SharedCtor() {
   _cached_size_ = 0;
   term_ = GOOGLE_ULONGLONG(0);
-  commit_index_ = GOOGLE_ULONGLONG(0);
-  role_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
-  leader_ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
-  leader_port_ = 0;
-  voted_for_ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
-  voted_for_port_ = 0;
-  last_log_term_ = GOOGLE_ULONGLONG(0);
-  last_log_index_ = GOOGLE_ULONGLONG(0);
+  success_ = false;
   last_applied_ = GOOGLE_ULONGLONG(0);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
-CmdResponse_ServerStatus::~CmdResponse_ServerStatus() {
+CmdResponse_LeaderHeartbeatResponse::~CmdResponse_LeaderHeartbeatResponse() {
   SharedDtor();
 }
 
-void CmdResponse_ServerStatus::SharedDtor() {
-  if (role_ != &::google::protobuf::internal::kEmptyString) {
-    delete role_;
-  }
-  if (leader_ip_ != &::google::protobuf::internal::kEmptyString) {
-    delete leader_ip_;
-  }
-  if (voted_for_ip_ != &::google::protobuf::internal::kEmptyString) {
-    delete voted_for_ip_;
-  }
+void CmdResponse_LeaderHeartbeatResponse::SharedDtor() {
   if (this != default_instance_) {
   }
 }
 
-void CmdResponse_ServerStatus::SetCachedSize(int size) const {
+void CmdResponse_LeaderHeartbeatResponse::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* CmdResponse_ServerStatus::descriptor() {
+const ::google::protobuf::Descriptor* CmdResponse_LeaderHeartbeatResponse::descriptor() {
   protobuf_AssignDescriptorsOnce();
-  return CmdResponse_ServerStatus_descriptor_;
+  return CmdResponse_LeaderHeartbeatResponse_descriptor_;
 }
 
-const CmdResponse_ServerStatus& CmdResponse_ServerStatus::default_instance() {
+const CmdResponse_LeaderHeartbeatResponse& CmdResponse_LeaderHeartbeatResponse::default_instance() {
   if (default_instance_ == NULL) protobuf_AddDesc_floyd_2eproto();
   return *default_instance_;
 }
 
-CmdResponse_ServerStatus* CmdResponse_ServerStatus::default_instance_ = NULL;
+CmdResponse_LeaderHeartbeatResponse* CmdResponse_LeaderHeartbeatResponse::default_instance_ = NULL;
 
-CmdResponse_ServerStatus* CmdResponse_ServerStatus::New() const {
-  return new CmdResponse_ServerStatus;
+CmdResponse_LeaderHeartbeatResponse* CmdResponse_LeaderHeartbeatResponse::New() const {
+  return new CmdResponse_LeaderHeartbeatResponse;
 }
 
-void CmdResponse_ServerStatus::Clear() {
+void CmdResponse_LeaderHeartbeatResponse::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     term_ = GOOGLE_ULONGLONG(0);
-    commit_index_ = GOOGLE_ULONGLONG(0);
-    if (has_role()) {
-      if (role_ != &::google::protobuf::internal::kEmptyString) {
-        role_->clear();
-      }
-    }
-    if (has_leader_ip()) {
-      if (leader_ip_ != &::google::protobuf::internal::kEmptyString) {
-        leader_ip_->clear();
-      }
-    }
-    leader_port_ = 0;
-    if (has_voted_for_ip()) {
-      if (voted_for_ip_ != &::google::protobuf::internal::kEmptyString) {
-        voted_for_ip_->clear();
-      }
-    }
-    voted_for_port_ = 0;
-    last_log_term_ = GOOGLE_ULONGLONG(0);
-  }
-  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
-    last_log_index_ = GOOGLE_ULONGLONG(0);
+    success_ = false;
     last_applied_ = GOOGLE_ULONGLONG(0);
   }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
 
-bool CmdResponse_ServerStatus::MergePartialFromCodedStream(
+bool CmdResponse_LeaderHeartbeatResponse::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!(EXPRESSION)) return false
   ::google::protobuf::uint32 tag;
@@ -4744,217 +7018,73 @@ bool CmdResponse_ServerStatus::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(16)) goto parse_commit_index;
+        if (input->ExpectTag(16)) goto parse_success;
         break;
       }
 
-      // required uint64 commit_index = 2;
+      // required bool success = 2;
       case 2: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_commit_index:
+         parse_success:
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
-                 input, &commit_index_)));
-          set_has_commit_index();
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &success_)));
+          set_has_success();
         } else {
           goto handle_uninterpreted;
         }
-        if (input->ExpectTag(26)) goto parse_role;
+        if (input->ExpectTag(24)) goto parse_last_applied;
         break;
       }
 
-      // required bytes role = 3;
+      // optional uint64 last_applied = 3;
       case 3: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_role:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
-                input, this->mutable_role()));
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(34)) goto parse_leader_ip;
-        break;
-      }
-
-      // optional bytes leader_ip = 4;
-      case 4: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_leader_ip:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
-                input, this->mutable_leader_ip()));
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(40)) goto parse_leader_port;
-        break;
-      }
-
-      // optional int32 leader_port = 5;
-      case 5: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_leader_port:
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
-                 input, &leader_port_)));
-          set_has_leader_port();
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(50)) goto parse_voted_for_ip;
-        break;
-      }
-
-      // optional bytes voted_for_ip = 6;
-      case 6: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-         parse_voted_for_ip:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
-                input, this->mutable_voted_for_ip()));
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(56)) goto parse_voted_for_port;
-        break;
-      }
-
-      // optional int32 voted_for_port = 7;
-      case 7: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_voted_for_port:
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
-                 input, &voted_for_port_)));
-          set_has_voted_for_port();
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(64)) goto parse_last_log_term;
-        break;
-      }
-
-      // optional uint64 last_log_term = 8;
-      case 8: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_last_log_term:
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
-                 input, &last_log_term_)));
-          set_has_last_log_term();
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(72)) goto parse_last_log_index;
-        break;
-      }
-
-      // optional uint64 last_log_index = 9;
-      case 9: {
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
-         parse_last_log_index:
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
-                 input, &last_log_index_)));
-          set_has_last_log_index();
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectTag(80)) goto parse_last_applied;
-        break;
-      }
-
-      // optional uint64 last_applied = 10;
-      case 10: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
          parse_last_applied:
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
-                 input, &last_applied_)));
-          set_has_last_applied();
-        } else {
-          goto handle_uninterpreted;
-        }
-        if (input->ExpectAtEnd()) return true;
-        break;
-      }
-
-      default: {
-      handle_uninterpreted:
-        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
-          return true;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, mutable_unknown_fields()));
-        break;
-      }
-    }
-  }
-  return true;
-#undef DO_
-}
-
-void CmdResponse_ServerStatus::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // required uint64 term = 1;
-  if (has_term()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
-  }
-
-  // required uint64 commit_index = 2;
-  if (has_commit_index()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(2, this->commit_index(), output);
-  }
-
-  // required bytes role = 3;
-  if (has_role()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBytes(
-      3, this->role(), output);
-  }
-
-  // optional bytes leader_ip = 4;
-  if (has_leader_ip()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBytes(
-      4, this->leader_ip(), output);
-  }
-
-  // optional int32 leader_port = 5;
-  if (has_leader_port()) {
-    ::google::protobuf::internal::WireFormatLite::WriteInt32(5, this->leader_port(), output);
-  }
-
-  // optional bytes voted_for_ip = 6;
-  if (has_voted_for_ip()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBytes(
-      6, this->voted_for_ip(), output);
-  }
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &last_applied_)));
+          set_has_last_applied();
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectAtEnd()) return true;
+        break;
+      }
 
-  // optional int32 voted_for_port = 7;
-  if (has_voted_for_port()) {
-    ::google::protobuf::internal::WireFormatLite::WriteInt32(7, this->voted_for_port(), output);
+      default: {
+      handle_uninterpreted:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, mutable_unknown_fields()));
+        break;
+      }
+    }
   }
+  return true;
+#undef DO_
+}
 
-  // optional uint64 last_log_term = 8;
-  if (has_last_log_term()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(8, this->last_log_term(), output);
+void CmdResponse_LeaderHeartbeatResponse::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // required uint64 term = 1;
+  if (has_term()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(1, this->term(), output);
   }
 
-  // optional uint64 last_log_index = 9;
-  if (has_last_log_index()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(9, this->last_log_index(), output);
+  // required bool success = 2;
+  if (has_success()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(2, this->success(), output);
   }
 
-  // optional uint64 last_applied = 10;
+  // optional uint64 last_applied = 3;
   if (has_last_applied()) {
-    ::google::protobuf::internal::WireFormatLite::WriteUInt64(10, this->last_applied(), output);
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(3, this->last_applied(), output);
   }
 
   if (!unknown_fields().empty()) {
@@ -4963,62 +7093,21 @@ void CmdResponse_ServerStatus::SerializeWithCachedSizes(
   }
 }
 
-::google::protobuf::uint8* CmdResponse_ServerStatus::SerializeWithCachedSizesToArray(
+::google::protobuf::uint8* CmdResponse_LeaderHeartbeatResponse::SerializeWithCachedSizesToArray(
     ::google::protobuf::uint8* target) const {
   // required uint64 term = 1;
   if (has_term()) {
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(1, this->term(), target);
   }
 
-  // required uint64 commit_index = 2;
-  if (has_commit_index()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(2, this->commit_index(), target);
-  }
-
-  // required bytes role = 3;
-  if (has_role()) {
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
-        3, this->role(), target);
-  }
-
-  // optional bytes leader_ip = 4;
-  if (has_leader_ip()) {
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
-        4, this->leader_ip(), target);
-  }
-
-  // optional int32 leader_port = 5;
-  if (has_leader_port()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(5, this->leader_port(), target);
-  }
-
-  // optional bytes voted_for_ip = 6;
-  if (has_voted_for_ip()) {
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
-        6, this->voted_for_ip(), target);
-  }
-
-  // optional int32 voted_for_port = 7;
-  if (has_voted_for_port()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(7, this->voted_for_port(), target);
-  }
-
-  // optional uint64 last_log_term = 8;
-  if (has_last_log_term()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(8, this->last_log_term(), target);
-  }
-
-  // optional uint64 last_log_index = 9;
-  if (has_last_log_index()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(9, this->last_log_index(), target);
+  // required bool success = 2;
+  if (has_success()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->success(), target);
   }
 
-  // optional uint64 last_applied = 10;
+  // optional uint64 last_applied = 3;
   if (has_last_applied()) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(10, this->last_applied(), target);
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(3, this->last_applied(), target);
   }
 
   if (!unknown_fields().empty()) {
@@ -5028,7 +7117,7 @@ void CmdResponse_ServerStatus::SerializeWithCachedSizes(
   return target;
 }
 
-int CmdResponse_ServerStatus::ByteSize() const {
+int CmdResponse_LeaderHeartbeatResponse::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -5039,65 +7128,12 @@ int CmdResponse_ServerStatus::ByteSize() const {
           this->term());
     }
 
-    // required uint64 commit_index = 2;
-    if (has_commit_index()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::UInt64Size(
-          this->commit_index());
-    }
-
-    // required bytes role = 3;
-    if (has_role()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::BytesSize(
-          this->role());
-    }
-
-    // optional bytes leader_ip = 4;
-    if (has_leader_ip()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::BytesSize(
-          this->leader_ip());
-    }
-
-    // optional int32 leader_port = 5;
-    if (has_leader_port()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::Int32Size(
-          this->leader_port());
-    }
-
-    // optional bytes voted_for_ip = 6;
-    if (has_voted_for_ip()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::BytesSize(
-          this->voted_for_ip());
-    }
-
-    // optional int32 voted_for_port = 7;
-    if (has_voted_for_port()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::Int32Size(
-          this->voted_for_port());
-    }
-
-    // optional uint64 last_log_term = 8;
-    if (has_last_log_term()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::UInt64Size(
-          this->last_log_term());
-    }
-
-  }
-  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
-    // optional uint64 last_log_index = 9;
-    if (has_last_log_index()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::UInt64Size(
-          this->last_log_index());
+    // required bool success = 2;
+    if (has_success()) {
+      total_size += 1 + 1;
     }
 
-    // optional uint64 last_applied = 10;
+    // optional uint64 last_applied = 3;
     if (has_last_applied()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::UInt64Size(
@@ -5116,10 +7152,10 @@ int CmdResponse_ServerStatus::ByteSize() const {
   return total_size;
 }
 
-void CmdResponse_ServerStatus::MergeFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_LeaderHeartbeatResponse::MergeFrom(const ::google::protobuf::Message& from) {
   GOOGLE_CHECK_NE(&from, this);
-  const CmdResponse_ServerStatus* source =
-    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_ServerStatus*>(
+  const CmdResponse_LeaderHeartbeatResponse* source =
+    ::google::protobuf::internal::dynamic_cast_if_available<const CmdResponse_LeaderHeartbeatResponse*>(
       &from);
   if (source == NULL) {
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
@@ -5128,37 +7164,14 @@ void CmdResponse_ServerStatus::MergeFrom(const ::google::protobuf::Message& from
   }
 }
 
-void CmdResponse_ServerStatus::MergeFrom(const CmdResponse_ServerStatus& from) {
+void CmdResponse_LeaderHeartbeatResponse::MergeFrom(const CmdResponse_LeaderHeartbeatResponse& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (from.has_term()) {
       set_term(from.term());
     }
-    if (from.has_commit_index()) {
-      set_commit_index(from.commit_index());
-    }
-    if (from.has_role()) {
-      set_role(from.role());
-    }
-    if (from.has_leader_ip()) {
-      set_leader_ip(from.leader_ip());
-    }
-    if (from.has_leader_port()) {
-      set_leader_port(from.leader_port());
-    }
-    if (from.has_voted_for_ip()) {
-      set_voted_for_ip(from.voted_for_ip());
-    }
-    if (from.has_voted_for_port()) {
-      set_voted_for_port(from.voted_for_port());
-    }
-    if (from.has_last_log_term()) {
-      set_last_log_term(from.last_log_term());
-    }
-  }
-  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
-    if (from.has_last_log_index()) {
-      set_last_log_index(from.last_log_index());
+    if (from.has_success()) {
+      set_success(from.success());
     }
     if (from.has_last_applied()) {
       set_last_applied(from.last_applied());
@@ -5167,35 +7180,28 @@ void CmdResponse_ServerStatus::MergeFrom(const CmdResponse_ServerStatus& from) {
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
-void CmdResponse_ServerStatus::CopyFrom(const ::google::protobuf::Message& from) {
+void CmdResponse_LeaderHeartbeatResponse::CopyFrom(const ::google::protobuf::Message& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void CmdResponse_ServerStatus::CopyFrom(const CmdResponse_ServerStatus& from) {
+void CmdResponse_LeaderHeartbeatResponse::CopyFrom(const CmdResponse_LeaderHeartbeatResponse& from) {
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool CmdResponse_ServerStatus::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000007) != 0x00000007) return false;
+bool CmdResponse_LeaderHeartbeatResponse::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000003) != 0x00000003) return false;
 
   return true;
 }
 
-void CmdResponse_ServerStatus::Swap(CmdResponse_ServerStatus* other) {
+void CmdResponse_LeaderHeartbeatResponse::Swap(CmdResponse_LeaderHeartbeatResponse* other) {
   if (other != this) {
     std::swap(term_, other->term_);
-    std::swap(commit_index_, other->commit_index_);
-    std::swap(role_, other->role_);
-    std::swap(leader_ip_, other->leader_ip_);
-    std::swap(leader_port_, other->leader_port_);
-    std::swap(voted_for_ip_, other->voted_for_ip_);
-    std::swap(voted_for_port_, other->voted_for_port_);
-    std::swap(last_log_term_, other->last_log_term_);
-    std::swap(last_log_index_, other->last_log_index_);
+    std::swap(success_, other->success_);
     std::swap(last_applied_, other->last_applied_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -5203,11 +7209,11 @@ void CmdResponse_ServerStatus::Swap(CmdResponse_ServerStatus* other) {
   }
 }
 
-::google::protobuf::Metadata CmdResponse_ServerStatus::GetMetadata() const {
+::google::protobuf::Metadata CmdResponse_LeaderHeartbeatResponse::GetMetadata() const {
   protobuf_AssignDescriptorsOnce();
   ::google::protobuf::Metadata metadata;
-  metadata.descriptor = CmdResponse_ServerStatus_descriptor_;
-  metadata.reflection = CmdResponse_ServerStatus_reflection_;
+  metadata.descriptor = CmdResponse_LeaderHeartbeatResponse_descriptor_;
+  metadata.reflection = CmdResponse_LeaderHeartbeatResponse_reflection_;
   return metadata;
 }
 
@@ -5223,6 +7229,8 @@ const int CmdResponse::kMsgFieldNumber;
 const int CmdResponse::kKvResponseFieldNumber;
 const int CmdResponse::kServerStatusFieldNumber;
 const int CmdResponse::kAllServersFieldNumber;
+const int CmdResponse::kInstallSnapshotResFieldNumber;
+const int CmdResponse::kLeaderHeartbeatResFieldNumber;
 #endif  // !_MSC_VER
 
 CmdResponse::CmdResponse()
@@ -5236,6 +7244,8 @@ void CmdResponse::InitAsDefaultInstance() {
   kv_response_ = const_cast< ::floyd::CmdResponse_KvResponse*>(&::floyd::CmdResponse_KvResponse::default_instance());
   server_status_ = const_cast< ::floyd::CmdResponse_ServerStatus*>(&::floyd::CmdResponse_ServerStatus::default_instance());
   all_servers_ = const_cast< ::floyd::Membership*>(&::floyd::Membership::default_instance());
+  install_snapshot_res_ = const_cast< ::floyd::CmdResponse_InstallSnapshotResponse*>(&::floyd::CmdResponse_InstallSnapshotResponse::default_instance());
+  leader_heartbeat_res_ = const_cast< ::floyd::CmdResponse_LeaderHeartbeatResponse*>(&::floyd::CmdResponse_LeaderHeartbeatResponse::default_instance());
 }
 
 CmdResponse::CmdResponse(const CmdResponse& from)
@@ -5254,6 +7264,8 @@ void CmdResponse::SharedCtor() {
   kv_response_ = NULL;
   server_status_ = NULL;
   all_servers_ = NULL;
+  install_snapshot_res_ = NULL;
+  leader_heartbeat_res_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -5271,6 +7283,8 @@ void CmdResponse::SharedDtor() {
     delete kv_response_;
     delete server_status_;
     delete all_servers_;
+    delete install_snapshot_res_;
+    delete leader_heartbeat_res_;
   }
 }
 
@@ -5320,6 +7334,14 @@ void CmdResponse::Clear() {
       if (all_servers_ != NULL) all_servers_->::floyd::Membership::Clear();
     }
   }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (has_install_snapshot_res()) {
+      if (install_snapshot_res_ != NULL) install_snapshot_res_->::floyd::CmdResponse_InstallSnapshotResponse::Clear();
+    }
+    if (has_leader_heartbeat_res()) {
+      if (leader_heartbeat_res_ != NULL) leader_heartbeat_res_->::floyd::CmdResponse_LeaderHeartbeatResponse::Clear();
+    }
+  }
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
 }
@@ -5451,6 +7473,34 @@ bool CmdResponse::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
+        if (input->ExpectTag(74)) goto parse_install_snapshot_res;
+        break;
+      }
+
+      // optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+      case 9: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_install_snapshot_res:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_install_snapshot_res()));
+        } else {
+          goto handle_uninterpreted;
+        }
+        if (input->ExpectTag(82)) goto parse_leader_heartbeat_res;
+        break;
+      }
+
+      // optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+      case 10: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+         parse_leader_heartbeat_res:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_leader_heartbeat_res()));
+        } else {
+          goto handle_uninterpreted;
+        }
         if (input->ExpectAtEnd()) return true;
         break;
       }
@@ -5521,6 +7571,18 @@ void CmdResponse::SerializeWithCachedSizes(
       8, this->all_servers(), output);
   }
 
+  // optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+  if (has_install_snapshot_res()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      9, this->install_snapshot_res(), output);
+  }
+
+  // optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+  if (has_leader_heartbeat_res()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      10, this->leader_heartbeat_res(), output);
+  }
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -5583,6 +7645,20 @@ void CmdResponse::SerializeWithCachedSizes(
         8, this->all_servers(), target);
   }
 
+  // optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+  if (has_install_snapshot_res()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        9, this->install_snapshot_res(), target);
+  }
+
+  // optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+  if (has_leader_heartbeat_res()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualToArray(
+        10, this->leader_heartbeat_res(), target);
+  }
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -5648,6 +7724,22 @@ int CmdResponse::ByteSize() const {
           this->all_servers());
     }
 
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    // optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+    if (has_install_snapshot_res()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->install_snapshot_res());
+    }
+
+    // optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+    if (has_leader_heartbeat_res()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          this->leader_heartbeat_res());
+    }
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -5700,6 +7792,14 @@ void CmdResponse::MergeFrom(const CmdResponse& from) {
       mutable_all_servers()->::floyd::Membership::MergeFrom(from.all_servers());
     }
   }
+  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (from.has_install_snapshot_res()) {
+      mutable_install_snapshot_res()->::floyd::CmdResponse_InstallSnapshotResponse::MergeFrom(from.install_snapshot_res());
+    }
+    if (from.has_leader_heartbeat_res()) {
+      mutable_leader_heartbeat_res()->::floyd::CmdResponse_LeaderHeartbeatResponse::MergeFrom(from.leader_heartbeat_res());
+    }
+  }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
@@ -5727,6 +7827,12 @@ bool CmdResponse::IsInitialized() const {
   if (has_server_status()) {
     if (!this->server_status().IsInitialized()) return false;
   }
+  if (has_install_snapshot_res()) {
+    if (!this->install_snapshot_res().IsInitialized()) return false;
+  }
+  if (has_leader_heartbeat_res()) {
+    if (!this->leader_heartbeat_res().IsInitialized()) return false;
+  }
   return true;
 }
 
@@ -5740,6 +7846,8 @@ void CmdResponse::Swap(CmdResponse* other) {
     std::swap(kv_response_, other->kv_response_);
     std::swap(server_status_, other->server_status_);
     std::swap(all_servers_, other->all_servers_);
+    std::swap(install_snapshot_res_, other->install_snapshot_res_);
+    std::swap(leader_heartbeat_res_, other->leader_heartbeat_res_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
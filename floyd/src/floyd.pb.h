@@ -43,11 +43,15 @@ class CmdRequest_LockRequest;
 class CmdRequest_AddServerRequest;
 class CmdRequest_RemoveServerRequest;
 class CmdRequest_ServerStatus;
+class CmdRequest_InstallSnapshot;
+class CmdRequest_LeaderHeartbeat;
 class CmdResponse;
 class CmdResponse_RequestVoteResponse;
 class CmdResponse_AppendEntriesResponse;
 class CmdResponse_KvResponse;
 class CmdResponse_ServerStatus;
+class CmdResponse_InstallSnapshotResponse;
+class CmdResponse_LeaderHeartbeatResponse;
 class Lock;
 class Membership;
 
@@ -87,11 +91,13 @@ enum Type {
   kGetAllServers = 13,
   kRequestVote = 8,
   kAppendEntries = 9,
-  kServerStatus = 10
+  kServerStatus = 10,
+  kInstallSnapshot = 14,
+  kLeaderHeartbeat = 15
 };
 bool Type_IsValid(int value);
 const Type Type_MIN = kRead;
-const Type Type_MAX = kGetAllServers;
+const Type Type_MAX = kLeaderHeartbeat;
 const int Type_ARRAYSIZE = Type_MAX + 1;
 
 const ::google::protobuf::EnumDescriptor* Type_descriptor();
@@ -559,6 +565,41 @@ class CmdRequest_AppendEntries : public ::google::protobuf::Message {
   inline ::google::protobuf::RepeatedPtrField< ::floyd::Entry >*
       mutable_entries();
 
+  // optional bytes checksums = 8;
+  inline bool has_checksums() const;
+  inline void clear_checksums();
+  static const int kChecksumsFieldNumber = 8;
+  inline const ::std::string& checksums() const;
+  inline void set_checksums(const ::std::string& value);
+  inline void set_checksums(const char* value);
+  inline void set_checksums(const void* value, size_t size);
+  inline ::std::string* mutable_checksums();
+  inline ::std::string* release_checksums();
+  inline void set_allocated_checksums(::std::string* checksums);
+
+  // repeated bytes raw_entries = 9;
+  inline int raw_entries_size() const;
+  inline void clear_raw_entries();
+  static const int kRawEntriesFieldNumber = 9;
+  inline const ::std::string& raw_entries(int index) const;
+  inline ::std::string* mutable_raw_entries(int index);
+  inline void set_raw_entries(int index, const ::std::string& value);
+  inline void set_raw_entries(int index, const char* value);
+  inline void set_raw_entries(int index, const void* value, size_t size);
+  inline ::std::string* add_raw_entries();
+  inline void add_raw_entries(const ::std::string& value);
+  inline void add_raw_entries(const char* value);
+  inline void add_raw_entries(const void* value, size_t size);
+  inline const ::google::protobuf::RepeatedPtrField< ::std::string>& raw_entries() const;
+  inline ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_raw_entries();
+
+  // optional bool raw_entries_unchecked = 10;
+  inline bool has_raw_entries_unchecked() const;
+  inline void clear_raw_entries_unchecked();
+  static const int kRawEntriesUncheckedFieldNumber = 10;
+  inline bool raw_entries_unchecked() const;
+  inline void set_raw_entries_unchecked(bool value);
+
   // @@protoc_insertion_point(class_scope:floyd.CmdRequest.AppendEntries)
  private:
   inline void set_has_term();
@@ -573,6 +614,10 @@ class CmdRequest_AppendEntries : public ::google::protobuf::Message {
   inline void clear_has_prev_log_term();
   inline void set_has_leader_commit();
   inline void clear_has_leader_commit();
+  inline void set_has_checksums();
+  inline void clear_has_checksums();
+  inline void set_has_raw_entries_unchecked();
+  inline void clear_has_raw_entries_unchecked();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -581,11 +626,14 @@ class CmdRequest_AppendEntries : public ::google::protobuf::Message {
   ::google::protobuf::uint64 prev_log_index_;
   ::google::protobuf::uint64 prev_log_term_;
   ::google::protobuf::uint64 leader_commit_;
-  ::google::protobuf::RepeatedPtrField< ::floyd::Entry > entries_;
   ::google::protobuf::int32 port_;
+  bool raw_entries_unchecked_;
+  ::google::protobuf::RepeatedPtrField< ::floyd::Entry > entries_;
+  ::std::string* checksums_;
+  ::google::protobuf::RepeatedPtrField< ::std::string> raw_entries_;
 
   mutable int _cached_size_;
-  ::google::protobuf::uint32 _has_bits_[(7 + 31) / 32];
+  ::google::protobuf::uint32 _has_bits_[(10 + 31) / 32];
 
   friend void  protobuf_AddDesc_floyd_2eproto();
   friend void protobuf_AssignDesc_floyd_2eproto();
@@ -1101,6 +1149,310 @@ class CmdRequest_ServerStatus : public ::google::protobuf::Message {
 };
 // -------------------------------------------------------------------
 
+class CmdRequest_InstallSnapshot : public ::google::protobuf::Message {
+ public:
+  CmdRequest_InstallSnapshot();
+  virtual ~CmdRequest_InstallSnapshot();
+
+  CmdRequest_InstallSnapshot(const CmdRequest_InstallSnapshot& from);
+
+  inline CmdRequest_InstallSnapshot& operator=(const CmdRequest_InstallSnapshot& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CmdRequest_InstallSnapshot& default_instance();
+
+  void Swap(CmdRequest_InstallSnapshot* other);
+
+  // implements Message ----------------------------------------------
+
+  CmdRequest_InstallSnapshot* New() const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CmdRequest_InstallSnapshot& from);
+  void MergeFrom(const CmdRequest_InstallSnapshot& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // required uint64 term = 1;
+  inline bool has_term() const;
+  inline void clear_term();
+  static const int kTermFieldNumber = 1;
+  inline ::google::protobuf::uint64 term() const;
+  inline void set_term(::google::protobuf::uint64 value);
+
+  // required bytes ip = 2;
+  inline bool has_ip() const;
+  inline void clear_ip();
+  static const int kIpFieldNumber = 2;
+  inline const ::std::string& ip() const;
+  inline void set_ip(const ::std::string& value);
+  inline void set_ip(const char* value);
+  inline void set_ip(const void* value, size_t size);
+  inline ::std::string* mutable_ip();
+  inline ::std::string* release_ip();
+  inline void set_allocated_ip(::std::string* ip);
+
+  // required int32 port = 3;
+  inline bool has_port() const;
+  inline void clear_port();
+  static const int kPortFieldNumber = 3;
+  inline ::google::protobuf::int32 port() const;
+  inline void set_port(::google::protobuf::int32 value);
+
+  // required uint64 last_included_index = 4;
+  inline bool has_last_included_index() const;
+  inline void clear_last_included_index();
+  static const int kLastIncludedIndexFieldNumber = 4;
+  inline ::google::protobuf::uint64 last_included_index() const;
+  inline void set_last_included_index(::google::protobuf::uint64 value);
+
+  // required uint64 last_included_term = 5;
+  inline bool has_last_included_term() const;
+  inline void clear_last_included_term();
+  static const int kLastIncludedTermFieldNumber = 5;
+  inline ::google::protobuf::uint64 last_included_term() const;
+  inline void set_last_included_term(::google::protobuf::uint64 value);
+
+  // required uint64 seq = 6;
+  inline bool has_seq() const;
+  inline void clear_seq();
+  static const int kSeqFieldNumber = 6;
+  inline ::google::protobuf::uint64 seq() const;
+  inline void set_seq(::google::protobuf::uint64 value);
+
+  // required bytes filename = 7;
+  inline bool has_filename() const;
+  inline void clear_filename();
+  static const int kFilenameFieldNumber = 7;
+  inline const ::std::string& filename() const;
+  inline void set_filename(const ::std::string& value);
+  inline void set_filename(const char* value);
+  inline void set_filename(const void* value, size_t size);
+  inline ::std::string* mutable_filename();
+  inline ::std::string* release_filename();
+  inline void set_allocated_filename(::std::string* filename);
+
+  // required uint64 offset = 8;
+  inline bool has_offset() const;
+  inline void clear_offset();
+  static const int kOffsetFieldNumber = 8;
+  inline ::google::protobuf::uint64 offset() const;
+  inline void set_offset(::google::protobuf::uint64 value);
+
+  // required bytes data = 9;
+  inline bool has_data() const;
+  inline void clear_data();
+  static const int kDataFieldNumber = 9;
+  inline const ::std::string& data() const;
+  inline void set_data(const ::std::string& value);
+  inline void set_data(const char* value);
+  inline void set_data(const void* value, size_t size);
+  inline ::std::string* mutable_data();
+  inline ::std::string* release_data();
+  inline void set_allocated_data(::std::string* data);
+
+  // required bool done = 10;
+  inline bool has_done() const;
+  inline void clear_done();
+  static const int kDoneFieldNumber = 10;
+  inline bool done() const;
+  inline void set_done(bool value);
+
+  // @@protoc_insertion_point(class_scope:floyd.CmdRequest.InstallSnapshot)
+ private:
+  inline void set_has_term();
+  inline void clear_has_term();
+  inline void set_has_ip();
+  inline void clear_has_ip();
+  inline void set_has_port();
+  inline void clear_has_port();
+  inline void set_has_last_included_index();
+  inline void clear_has_last_included_index();
+  inline void set_has_last_included_term();
+  inline void clear_has_last_included_term();
+  inline void set_has_seq();
+  inline void clear_has_seq();
+  inline void set_has_filename();
+  inline void clear_has_filename();
+  inline void set_has_offset();
+  inline void clear_has_offset();
+  inline void set_has_data();
+  inline void clear_has_data();
+  inline void set_has_done();
+  inline void clear_has_done();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::uint64 term_;
+  ::std::string* ip_;
+  ::google::protobuf::uint64 last_included_index_;
+  ::google::protobuf::uint64 last_included_term_;
+  ::google::protobuf::uint64 seq_;
+  ::google::protobuf::int32 port_;
+  bool done_;
+  ::std::string* filename_;
+  ::google::protobuf::uint64 offset_;
+  ::std::string* data_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(10 + 31) / 32];
+
+  friend void  protobuf_AddDesc_floyd_2eproto();
+  friend void protobuf_AssignDesc_floyd_2eproto();
+  friend void protobuf_ShutdownFile_floyd_2eproto();
+
+  void InitAsDefaultInstance();
+  static CmdRequest_InstallSnapshot* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class CmdRequest_LeaderHeartbeat : public ::google::protobuf::Message {
+ public:
+  CmdRequest_LeaderHeartbeat();
+  virtual ~CmdRequest_LeaderHeartbeat();
+
+  CmdRequest_LeaderHeartbeat(const CmdRequest_LeaderHeartbeat& from);
+
+  inline CmdRequest_LeaderHeartbeat& operator=(const CmdRequest_LeaderHeartbeat& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CmdRequest_LeaderHeartbeat& default_instance();
+
+  void Swap(CmdRequest_LeaderHeartbeat* other);
+
+  // implements Message ----------------------------------------------
+
+  CmdRequest_LeaderHeartbeat* New() const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CmdRequest_LeaderHeartbeat& from);
+  void MergeFrom(const CmdRequest_LeaderHeartbeat& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // required uint64 term = 1;
+  inline bool has_term() const;
+  inline void clear_term();
+  static const int kTermFieldNumber = 1;
+  inline ::google::protobuf::uint64 term() const;
+  inline void set_term(::google::protobuf::uint64 value);
+
+  // required bytes ip = 2;
+  inline bool has_ip() const;
+  inline void clear_ip();
+  static const int kIpFieldNumber = 2;
+  inline const ::std::string& ip() const;
+  inline void set_ip(const ::std::string& value);
+  inline void set_ip(const char* value);
+  inline void set_ip(const void* value, size_t size);
+  inline ::std::string* mutable_ip();
+  inline ::std::string* release_ip();
+  inline void set_allocated_ip(::std::string* ip);
+
+  // required int32 port = 3;
+  inline bool has_port() const;
+  inline void clear_port();
+  static const int kPortFieldNumber = 3;
+  inline ::google::protobuf::int32 port() const;
+  inline void set_port(::google::protobuf::int32 value);
+
+  // required uint64 leader_commit = 4;
+  inline bool has_leader_commit() const;
+  inline void clear_leader_commit();
+  static const int kLeaderCommitFieldNumber = 4;
+  inline ::google::protobuf::uint64 leader_commit() const;
+  inline void set_leader_commit(::google::protobuf::uint64 value);
+
+  // @@protoc_insertion_point(class_scope:floyd.CmdRequest.LeaderHeartbeat)
+ private:
+  inline void set_has_term();
+  inline void clear_has_term();
+  inline void set_has_ip();
+  inline void clear_has_ip();
+  inline void set_has_port();
+  inline void clear_has_port();
+  inline void set_has_leader_commit();
+  inline void clear_has_leader_commit();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::uint64 term_;
+  ::std::string* ip_;
+  ::google::protobuf::uint64 leader_commit_;
+  ::google::protobuf::int32 port_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(4 + 31) / 32];
+
+  friend void  protobuf_AddDesc_floyd_2eproto();
+  friend void protobuf_AssignDesc_floyd_2eproto();
+  friend void protobuf_ShutdownFile_floyd_2eproto();
+
+  void InitAsDefaultInstance();
+  static CmdRequest_LeaderHeartbeat* default_instance_;
+};
+// -------------------------------------------------------------------
+
 class CmdRequest : public ::google::protobuf::Message {
  public:
   CmdRequest();
@@ -1160,6 +1512,8 @@ class CmdRequest : public ::google::protobuf::Message {
   typedef CmdRequest_AddServerRequest AddServerRequest;
   typedef CmdRequest_RemoveServerRequest RemoveServerRequest;
   typedef CmdRequest_ServerStatus ServerStatus;
+  typedef CmdRequest_InstallSnapshot InstallSnapshot;
+  typedef CmdRequest_LeaderHeartbeat LeaderHeartbeat;
 
   // accessors -------------------------------------------------------
 
@@ -1233,6 +1587,24 @@ class CmdRequest : public ::google::protobuf::Message {
   inline ::floyd::CmdRequest_ServerStatus* release_server_status();
   inline void set_allocated_server_status(::floyd::CmdRequest_ServerStatus* server_status);
 
+  // optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+  inline bool has_install_snapshot() const;
+  inline void clear_install_snapshot();
+  static const int kInstallSnapshotFieldNumber = 9;
+  inline const ::floyd::CmdRequest_InstallSnapshot& install_snapshot() const;
+  inline ::floyd::CmdRequest_InstallSnapshot* mutable_install_snapshot();
+  inline ::floyd::CmdRequest_InstallSnapshot* release_install_snapshot();
+  inline void set_allocated_install_snapshot(::floyd::CmdRequest_InstallSnapshot* install_snapshot);
+
+  // optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+  inline bool has_leader_heartbeat() const;
+  inline void clear_leader_heartbeat();
+  static const int kLeaderHeartbeatFieldNumber = 10;
+  inline const ::floyd::CmdRequest_LeaderHeartbeat& leader_heartbeat() const;
+  inline ::floyd::CmdRequest_LeaderHeartbeat* mutable_leader_heartbeat();
+  inline ::floyd::CmdRequest_LeaderHeartbeat* release_leader_heartbeat();
+  inline void set_allocated_leader_heartbeat(::floyd::CmdRequest_LeaderHeartbeat* leader_heartbeat);
+
   // @@protoc_insertion_point(class_scope:floyd.CmdRequest)
  private:
   inline void set_has_type();
@@ -1251,6 +1623,10 @@ class CmdRequest : public ::google::protobuf::Message {
   inline void clear_has_remove_server_request();
   inline void set_has_server_status();
   inline void clear_has_server_status();
+  inline void set_has_install_snapshot();
+  inline void clear_has_install_snapshot();
+  inline void set_has_leader_heartbeat();
+  inline void clear_has_leader_heartbeat();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -1261,10 +1637,12 @@ class CmdRequest : public ::google::protobuf::Message {
   ::floyd::CmdRequest_AddServerRequest* add_server_request_;
   ::floyd::CmdRequest_RemoveServerRequest* remove_server_request_;
   ::floyd::CmdRequest_ServerStatus* server_status_;
+  ::floyd::CmdRequest_InstallSnapshot* install_snapshot_;
+  ::floyd::CmdRequest_LeaderHeartbeat* leader_heartbeat_;
   int type_;
 
   mutable int _cached_size_;
-  ::google::protobuf::uint32 _has_bits_[(8 + 31) / 32];
+  ::google::protobuf::uint32 _has_bits_[(10 + 31) / 32];
 
   friend void  protobuf_AddDesc_floyd_2eproto();
   friend void protobuf_AssignDesc_floyd_2eproto();
@@ -1442,6 +1820,34 @@ class CmdResponse_AppendEntriesResponse : public ::google::protobuf::Message {
   inline ::google::protobuf::uint64 last_log_index() const;
   inline void set_last_log_index(::google::protobuf::uint64 value);
 
+  // optional uint64 conflict_term = 4;
+  inline bool has_conflict_term() const;
+  inline void clear_conflict_term();
+  static const int kConflictTermFieldNumber = 4;
+  inline ::google::protobuf::uint64 conflict_term() const;
+  inline void set_conflict_term(::google::protobuf::uint64 value);
+
+  // optional uint64 conflict_index = 5;
+  inline bool has_conflict_index() const;
+  inline void clear_conflict_index();
+  static const int kConflictIndexFieldNumber = 5;
+  inline ::google::protobuf::uint64 conflict_index() const;
+  inline void set_conflict_index(::google::protobuf::uint64 value);
+
+  // optional uint64 last_applied = 6;
+  inline bool has_last_applied() const;
+  inline void clear_last_applied();
+  static const int kLastAppliedFieldNumber = 6;
+  inline ::google::protobuf::uint64 last_applied() const;
+  inline void set_last_applied(::google::protobuf::uint64 value);
+
+  // optional uint64 match_index = 7;
+  inline bool has_match_index() const;
+  inline void clear_match_index();
+  static const int kMatchIndexFieldNumber = 7;
+  inline ::google::protobuf::uint64 match_index() const;
+  inline void set_match_index(::google::protobuf::uint64 value);
+
   // @@protoc_insertion_point(class_scope:floyd.CmdResponse.AppendEntriesResponse)
  private:
   inline void set_has_term();
@@ -1450,15 +1856,27 @@ class CmdResponse_AppendEntriesResponse : public ::google::protobuf::Message {
   inline void clear_has_success();
   inline void set_has_last_log_index();
   inline void clear_has_last_log_index();
+  inline void set_has_conflict_term();
+  inline void clear_has_conflict_term();
+  inline void set_has_conflict_index();
+  inline void clear_has_conflict_index();
+  inline void set_has_last_applied();
+  inline void clear_has_last_applied();
+  inline void set_has_match_index();
+  inline void clear_has_match_index();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
   ::google::protobuf::uint64 term_;
   ::google::protobuf::uint64 last_log_index_;
+  ::google::protobuf::uint64 conflict_term_;
+  ::google::protobuf::uint64 conflict_index_;
+  ::google::protobuf::uint64 last_applied_;
+  ::google::protobuf::uint64 match_index_;
   bool success_;
 
   mutable int _cached_size_;
-  ::google::protobuf::uint32 _has_bits_[(3 + 31) / 32];
+  ::google::protobuf::uint32 _has_bits_[(7 + 31) / 32];
 
   friend void  protobuf_AddDesc_floyd_2eproto();
   friend void protobuf_AssignDesc_floyd_2eproto();
@@ -1743,14 +2161,14 @@ class CmdResponse_ServerStatus : public ::google::protobuf::Message {
 };
 // -------------------------------------------------------------------
 
-class CmdResponse : public ::google::protobuf::Message {
+class CmdResponse_InstallSnapshotResponse : public ::google::protobuf::Message {
  public:
-  CmdResponse();
-  virtual ~CmdResponse();
+  CmdResponse_InstallSnapshotResponse();
+  virtual ~CmdResponse_InstallSnapshotResponse();
 
-  CmdResponse(const CmdResponse& from);
+  CmdResponse_InstallSnapshotResponse(const CmdResponse_InstallSnapshotResponse& from);
 
-  inline CmdResponse& operator=(const CmdResponse& from) {
+  inline CmdResponse_InstallSnapshotResponse& operator=(const CmdResponse_InstallSnapshotResponse& from) {
     CopyFrom(from);
     return *this;
   }
@@ -1764,17 +2182,17 @@ class CmdResponse : public ::google::protobuf::Message {
   }
 
   static const ::google::protobuf::Descriptor* descriptor();
-  static const CmdResponse& default_instance();
+  static const CmdResponse_InstallSnapshotResponse& default_instance();
 
-  void Swap(CmdResponse* other);
+  void Swap(CmdResponse_InstallSnapshotResponse* other);
 
   // implements Message ----------------------------------------------
 
-  CmdResponse* New() const;
+  CmdResponse_InstallSnapshotResponse* New() const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
-  void CopyFrom(const CmdResponse& from);
-  void MergeFrom(const CmdResponse& from);
+  void CopyFrom(const CmdResponse_InstallSnapshotResponse& from);
+  void MergeFrom(const CmdResponse_InstallSnapshotResponse& from);
   void Clear();
   bool IsInitialized() const;
 
@@ -1795,28 +2213,224 @@ class CmdResponse : public ::google::protobuf::Message {
 
   // nested types ----------------------------------------------------
 
-  typedef CmdResponse_RequestVoteResponse RequestVoteResponse;
-  typedef CmdResponse_AppendEntriesResponse AppendEntriesResponse;
-  typedef CmdResponse_KvResponse KvResponse;
-  typedef CmdResponse_ServerStatus ServerStatus;
-
   // accessors -------------------------------------------------------
 
-  // required .floyd.Type type = 1;
-  inline bool has_type() const;
-  inline void clear_type();
-  static const int kTypeFieldNumber = 1;
-  inline ::floyd::Type type() const;
-  inline void set_type(::floyd::Type value);
+  // required uint64 term = 1;
+  inline bool has_term() const;
+  inline void clear_term();
+  static const int kTermFieldNumber = 1;
+  inline ::google::protobuf::uint64 term() const;
+  inline void set_term(::google::protobuf::uint64 value);
 
-  // optional .floyd.StatusCode code = 2;
-  inline bool has_code() const;
-  inline void clear_code();
-  static const int kCodeFieldNumber = 2;
-  inline ::floyd::StatusCode code() const;
-  inline void set_code(::floyd::StatusCode value);
+  // required bool success = 2;
+  inline bool has_success() const;
+  inline void clear_success();
+  static const int kSuccessFieldNumber = 2;
+  inline bool success() const;
+  inline void set_success(bool value);
 
-  // optional .floyd.CmdResponse.RequestVoteResponse request_vote_res = 3;
+  // @@protoc_insertion_point(class_scope:floyd.CmdResponse.InstallSnapshotResponse)
+ private:
+  inline void set_has_term();
+  inline void clear_has_term();
+  inline void set_has_success();
+  inline void clear_has_success();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::uint64 term_;
+  bool success_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(2 + 31) / 32];
+
+  friend void  protobuf_AddDesc_floyd_2eproto();
+  friend void protobuf_AssignDesc_floyd_2eproto();
+  friend void protobuf_ShutdownFile_floyd_2eproto();
+
+  void InitAsDefaultInstance();
+  static CmdResponse_InstallSnapshotResponse* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class CmdResponse_LeaderHeartbeatResponse : public ::google::protobuf::Message {
+ public:
+  CmdResponse_LeaderHeartbeatResponse();
+  virtual ~CmdResponse_LeaderHeartbeatResponse();
+
+  CmdResponse_LeaderHeartbeatResponse(const CmdResponse_LeaderHeartbeatResponse& from);
+
+  inline CmdResponse_LeaderHeartbeatResponse& operator=(const CmdResponse_LeaderHeartbeatResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CmdResponse_LeaderHeartbeatResponse& default_instance();
+
+  void Swap(CmdResponse_LeaderHeartbeatResponse* other);
+
+  // implements Message ----------------------------------------------
+
+  CmdResponse_LeaderHeartbeatResponse* New() const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CmdResponse_LeaderHeartbeatResponse& from);
+  void MergeFrom(const CmdResponse_LeaderHeartbeatResponse& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // required uint64 term = 1;
+  inline bool has_term() const;
+  inline void clear_term();
+  static const int kTermFieldNumber = 1;
+  inline ::google::protobuf::uint64 term() const;
+  inline void set_term(::google::protobuf::uint64 value);
+
+  // required bool success = 2;
+  inline bool has_success() const;
+  inline void clear_success();
+  static const int kSuccessFieldNumber = 2;
+  inline bool success() const;
+  inline void set_success(bool value);
+
+  // optional uint64 last_applied = 3;
+  inline bool has_last_applied() const;
+  inline void clear_last_applied();
+  static const int kLastAppliedFieldNumber = 3;
+  inline ::google::protobuf::uint64 last_applied() const;
+  inline void set_last_applied(::google::protobuf::uint64 value);
+
+  // @@protoc_insertion_point(class_scope:floyd.CmdResponse.LeaderHeartbeatResponse)
+ private:
+  inline void set_has_term();
+  inline void clear_has_term();
+  inline void set_has_success();
+  inline void clear_has_success();
+  inline void set_has_last_applied();
+  inline void clear_has_last_applied();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::uint64 term_;
+  ::google::protobuf::uint64 last_applied_;
+  bool success_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(3 + 31) / 32];
+
+  friend void  protobuf_AddDesc_floyd_2eproto();
+  friend void protobuf_AssignDesc_floyd_2eproto();
+  friend void protobuf_ShutdownFile_floyd_2eproto();
+
+  void InitAsDefaultInstance();
+  static CmdResponse_LeaderHeartbeatResponse* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class CmdResponse : public ::google::protobuf::Message {
+ public:
+  CmdResponse();
+  virtual ~CmdResponse();
+
+  CmdResponse(const CmdResponse& from);
+
+  inline CmdResponse& operator=(const CmdResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CmdResponse& default_instance();
+
+  void Swap(CmdResponse* other);
+
+  // implements Message ----------------------------------------------
+
+  CmdResponse* New() const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CmdResponse& from);
+  void MergeFrom(const CmdResponse& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  typedef CmdResponse_RequestVoteResponse RequestVoteResponse;
+  typedef CmdResponse_AppendEntriesResponse AppendEntriesResponse;
+  typedef CmdResponse_KvResponse KvResponse;
+  typedef CmdResponse_ServerStatus ServerStatus;
+  typedef CmdResponse_InstallSnapshotResponse InstallSnapshotResponse;
+  typedef CmdResponse_LeaderHeartbeatResponse LeaderHeartbeatResponse;
+
+  // accessors -------------------------------------------------------
+
+  // required .floyd.Type type = 1;
+  inline bool has_type() const;
+  inline void clear_type();
+  static const int kTypeFieldNumber = 1;
+  inline ::floyd::Type type() const;
+  inline void set_type(::floyd::Type value);
+
+  // optional .floyd.StatusCode code = 2;
+  inline bool has_code() const;
+  inline void clear_code();
+  static const int kCodeFieldNumber = 2;
+  inline ::floyd::StatusCode code() const;
+  inline void set_code(::floyd::StatusCode value);
+
+  // optional .floyd.CmdResponse.RequestVoteResponse request_vote_res = 3;
   inline bool has_request_vote_res() const;
   inline void clear_request_vote_res();
   static const int kRequestVoteResFieldNumber = 3;
@@ -1873,6 +2487,24 @@ class CmdResponse : public ::google::protobuf::Message {
   inline ::floyd::Membership* release_all_servers();
   inline void set_allocated_all_servers(::floyd::Membership* all_servers);
 
+  // optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+  inline bool has_install_snapshot_res() const;
+  inline void clear_install_snapshot_res();
+  static const int kInstallSnapshotResFieldNumber = 9;
+  inline const ::floyd::CmdResponse_InstallSnapshotResponse& install_snapshot_res() const;
+  inline ::floyd::CmdResponse_InstallSnapshotResponse* mutable_install_snapshot_res();
+  inline ::floyd::CmdResponse_InstallSnapshotResponse* release_install_snapshot_res();
+  inline void set_allocated_install_snapshot_res(::floyd::CmdResponse_InstallSnapshotResponse* install_snapshot_res);
+
+  // optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+  inline bool has_leader_heartbeat_res() const;
+  inline void clear_leader_heartbeat_res();
+  static const int kLeaderHeartbeatResFieldNumber = 10;
+  inline const ::floyd::CmdResponse_LeaderHeartbeatResponse& leader_heartbeat_res() const;
+  inline ::floyd::CmdResponse_LeaderHeartbeatResponse* mutable_leader_heartbeat_res();
+  inline ::floyd::CmdResponse_LeaderHeartbeatResponse* release_leader_heartbeat_res();
+  inline void set_allocated_leader_heartbeat_res(::floyd::CmdResponse_LeaderHeartbeatResponse* leader_heartbeat_res);
+
   // @@protoc_insertion_point(class_scope:floyd.CmdResponse)
  private:
   inline void set_has_type();
@@ -1891,6 +2523,10 @@ class CmdResponse : public ::google::protobuf::Message {
   inline void clear_has_server_status();
   inline void set_has_all_servers();
   inline void clear_has_all_servers();
+  inline void set_has_install_snapshot_res();
+  inline void clear_has_install_snapshot_res();
+  inline void set_has_leader_heartbeat_res();
+  inline void clear_has_leader_heartbeat_res();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -1902,9 +2538,11 @@ class CmdResponse : public ::google::protobuf::Message {
   ::floyd::CmdResponse_KvResponse* kv_response_;
   ::floyd::CmdResponse_ServerStatus* server_status_;
   ::floyd::Membership* all_servers_;
+  ::floyd::CmdResponse_InstallSnapshotResponse* install_snapshot_res_;
+  ::floyd::CmdResponse_LeaderHeartbeatResponse* leader_heartbeat_res_;
 
   mutable int _cached_size_;
-  ::google::protobuf::uint32 _has_bits_[(8 + 31) / 32];
+  ::google::protobuf::uint32 _has_bits_[(10 + 31) / 32];
 
   friend void  protobuf_AddDesc_floyd_2eproto();
   friend void protobuf_AssignDesc_floyd_2eproto();
@@ -2824,6 +3462,142 @@ CmdRequest_AppendEntries::mutable_entries() {
   return &entries_;
 }
 
+// optional bytes checksums = 8;
+inline bool CmdRequest_AppendEntries::has_checksums() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void CmdRequest_AppendEntries::set_has_checksums() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void CmdRequest_AppendEntries::clear_has_checksums() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void CmdRequest_AppendEntries::clear_checksums() {
+  if (checksums_ != &::google::protobuf::internal::kEmptyString) {
+    checksums_->clear();
+  }
+  clear_has_checksums();
+}
+inline const ::std::string& CmdRequest_AppendEntries::checksums() const {
+  return *checksums_;
+}
+inline void CmdRequest_AppendEntries::set_checksums(const ::std::string& value) {
+  set_has_checksums();
+  if (checksums_ == &::google::protobuf::internal::kEmptyString) {
+    checksums_ = new ::std::string;
+  }
+  checksums_->assign(value);
+}
+inline void CmdRequest_AppendEntries::set_checksums(const char* value) {
+  set_has_checksums();
+  if (checksums_ == &::google::protobuf::internal::kEmptyString) {
+    checksums_ = new ::std::string;
+  }
+  checksums_->assign(value);
+}
+inline void CmdRequest_AppendEntries::set_checksums(const void* value, size_t size) {
+  set_has_checksums();
+  if (checksums_ == &::google::protobuf::internal::kEmptyString) {
+    checksums_ = new ::std::string;
+  }
+  checksums_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_AppendEntries::mutable_checksums() {
+  set_has_checksums();
+  if (checksums_ == &::google::protobuf::internal::kEmptyString) {
+    checksums_ = new ::std::string;
+  }
+  return checksums_;
+}
+inline ::std::string* CmdRequest_AppendEntries::release_checksums() {
+  clear_has_checksums();
+  if (checksums_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = checksums_;
+    checksums_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void CmdRequest_AppendEntries::set_allocated_checksums(::std::string* checksums) {
+  if (checksums_ != &::google::protobuf::internal::kEmptyString) {
+    delete checksums_;
+  }
+  if (checksums) {
+    set_has_checksums();
+    checksums_ = checksums;
+  } else {
+    clear_has_checksums();
+    checksums_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// repeated bytes raw_entries = 9;
+inline int CmdRequest_AppendEntries::raw_entries_size() const {
+  return raw_entries_.size();
+}
+inline void CmdRequest_AppendEntries::clear_raw_entries() {
+  raw_entries_.Clear();
+}
+inline const ::std::string& CmdRequest_AppendEntries::raw_entries(int index) const {
+  return raw_entries_.Get(index);
+}
+inline ::std::string* CmdRequest_AppendEntries::mutable_raw_entries(int index) {
+  return raw_entries_.Mutable(index);
+}
+inline void CmdRequest_AppendEntries::set_raw_entries(int index, const ::std::string& value) {
+  raw_entries_.Mutable(index)->assign(value);
+}
+inline void CmdRequest_AppendEntries::set_raw_entries(int index, const char* value) {
+  raw_entries_.Mutable(index)->assign(value);
+}
+inline void CmdRequest_AppendEntries::set_raw_entries(int index, const void* value, size_t size) {
+  raw_entries_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_AppendEntries::add_raw_entries() {
+  return raw_entries_.Add();
+}
+inline void CmdRequest_AppendEntries::add_raw_entries(const ::std::string& value) {
+  raw_entries_.Add()->assign(value);
+}
+inline void CmdRequest_AppendEntries::add_raw_entries(const char* value) {
+  raw_entries_.Add()->assign(value);
+}
+inline void CmdRequest_AppendEntries::add_raw_entries(const void* value, size_t size) {
+  raw_entries_.Add()->assign(reinterpret_cast<const char*>(value), size);
+}
+inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
+CmdRequest_AppendEntries::raw_entries() const {
+  return raw_entries_;
+}
+inline ::google::protobuf::RepeatedPtrField< ::std::string>*
+CmdRequest_AppendEntries::mutable_raw_entries() {
+  return &raw_entries_;
+}
+
+// optional bool raw_entries_unchecked = 10;
+inline bool CmdRequest_AppendEntries::has_raw_entries_unchecked() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void CmdRequest_AppendEntries::set_has_raw_entries_unchecked() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void CmdRequest_AppendEntries::clear_has_raw_entries_unchecked() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void CmdRequest_AppendEntries::clear_raw_entries_unchecked() {
+  raw_entries_unchecked_ = false;
+  clear_has_raw_entries_unchecked();
+}
+inline bool CmdRequest_AppendEntries::raw_entries_unchecked() const {
+  return raw_entries_unchecked_;
+}
+inline void CmdRequest_AppendEntries::set_raw_entries_unchecked(bool value) {
+  set_has_raw_entries_unchecked();
+  raw_entries_unchecked_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // CmdRequest_KvRequest
@@ -3300,84 +4074,570 @@ inline void CmdRequest_ServerStatus::clear_term() {
   term_ = GOOGLE_LONGLONG(0);
   clear_has_term();
 }
-inline ::google::protobuf::int64 CmdRequest_ServerStatus::term() const {
+inline ::google::protobuf::int64 CmdRequest_ServerStatus::term() const {
+  return term_;
+}
+inline void CmdRequest_ServerStatus::set_term(::google::protobuf::int64 value) {
+  set_has_term();
+  term_ = value;
+}
+
+// required int64 commit_index = 2;
+inline bool CmdRequest_ServerStatus::has_commit_index() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void CmdRequest_ServerStatus::set_has_commit_index() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void CmdRequest_ServerStatus::clear_has_commit_index() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void CmdRequest_ServerStatus::clear_commit_index() {
+  commit_index_ = GOOGLE_LONGLONG(0);
+  clear_has_commit_index();
+}
+inline ::google::protobuf::int64 CmdRequest_ServerStatus::commit_index() const {
+  return commit_index_;
+}
+inline void CmdRequest_ServerStatus::set_commit_index(::google::protobuf::int64 value) {
+  set_has_commit_index();
+  commit_index_ = value;
+}
+
+// optional bytes ip = 3;
+inline bool CmdRequest_ServerStatus::has_ip() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void CmdRequest_ServerStatus::set_has_ip() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void CmdRequest_ServerStatus::clear_has_ip() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void CmdRequest_ServerStatus::clear_ip() {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    ip_->clear();
+  }
+  clear_has_ip();
+}
+inline const ::std::string& CmdRequest_ServerStatus::ip() const {
+  return *ip_;
+}
+inline void CmdRequest_ServerStatus::set_ip(const ::std::string& value) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(value);
+}
+inline void CmdRequest_ServerStatus::set_ip(const char* value) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(value);
+}
+inline void CmdRequest_ServerStatus::set_ip(const void* value, size_t size) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_ServerStatus::mutable_ip() {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  return ip_;
+}
+inline ::std::string* CmdRequest_ServerStatus::release_ip() {
+  clear_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = ip_;
+    ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void CmdRequest_ServerStatus::set_allocated_ip(::std::string* ip) {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete ip_;
+  }
+  if (ip) {
+    set_has_ip();
+    ip_ = ip;
+  } else {
+    clear_has_ip();
+    ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// optional int32 port = 4;
+inline bool CmdRequest_ServerStatus::has_port() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void CmdRequest_ServerStatus::set_has_port() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void CmdRequest_ServerStatus::clear_has_port() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void CmdRequest_ServerStatus::clear_port() {
+  port_ = 0;
+  clear_has_port();
+}
+inline ::google::protobuf::int32 CmdRequest_ServerStatus::port() const {
+  return port_;
+}
+inline void CmdRequest_ServerStatus::set_port(::google::protobuf::int32 value) {
+  set_has_port();
+  port_ = value;
+}
+
+// -------------------------------------------------------------------
+
+// CmdRequest_InstallSnapshot
+
+// required uint64 term = 1;
+inline bool CmdRequest_InstallSnapshot::has_term() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_term() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_term() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void CmdRequest_InstallSnapshot::clear_term() {
+  term_ = GOOGLE_ULONGLONG(0);
+  clear_has_term();
+}
+inline ::google::protobuf::uint64 CmdRequest_InstallSnapshot::term() const {
+  return term_;
+}
+inline void CmdRequest_InstallSnapshot::set_term(::google::protobuf::uint64 value) {
+  set_has_term();
+  term_ = value;
+}
+
+// required bytes ip = 2;
+inline bool CmdRequest_InstallSnapshot::has_ip() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_ip() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_ip() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void CmdRequest_InstallSnapshot::clear_ip() {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    ip_->clear();
+  }
+  clear_has_ip();
+}
+inline const ::std::string& CmdRequest_InstallSnapshot::ip() const {
+  return *ip_;
+}
+inline void CmdRequest_InstallSnapshot::set_ip(const ::std::string& value) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_ip(const char* value) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_ip(const void* value, size_t size) {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  ip_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_InstallSnapshot::mutable_ip() {
+  set_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    ip_ = new ::std::string;
+  }
+  return ip_;
+}
+inline ::std::string* CmdRequest_InstallSnapshot::release_ip() {
+  clear_has_ip();
+  if (ip_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = ip_;
+    ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void CmdRequest_InstallSnapshot::set_allocated_ip(::std::string* ip) {
+  if (ip_ != &::google::protobuf::internal::kEmptyString) {
+    delete ip_;
+  }
+  if (ip) {
+    set_has_ip();
+    ip_ = ip;
+  } else {
+    clear_has_ip();
+    ip_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// required int32 port = 3;
+inline bool CmdRequest_InstallSnapshot::has_port() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_port() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_port() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void CmdRequest_InstallSnapshot::clear_port() {
+  port_ = 0;
+  clear_has_port();
+}
+inline ::google::protobuf::int32 CmdRequest_InstallSnapshot::port() const {
+  return port_;
+}
+inline void CmdRequest_InstallSnapshot::set_port(::google::protobuf::int32 value) {
+  set_has_port();
+  port_ = value;
+}
+
+// required uint64 last_included_index = 4;
+inline bool CmdRequest_InstallSnapshot::has_last_included_index() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_last_included_index() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_last_included_index() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void CmdRequest_InstallSnapshot::clear_last_included_index() {
+  last_included_index_ = GOOGLE_ULONGLONG(0);
+  clear_has_last_included_index();
+}
+inline ::google::protobuf::uint64 CmdRequest_InstallSnapshot::last_included_index() const {
+  return last_included_index_;
+}
+inline void CmdRequest_InstallSnapshot::set_last_included_index(::google::protobuf::uint64 value) {
+  set_has_last_included_index();
+  last_included_index_ = value;
+}
+
+// required uint64 last_included_term = 5;
+inline bool CmdRequest_InstallSnapshot::has_last_included_term() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_last_included_term() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_last_included_term() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void CmdRequest_InstallSnapshot::clear_last_included_term() {
+  last_included_term_ = GOOGLE_ULONGLONG(0);
+  clear_has_last_included_term();
+}
+inline ::google::protobuf::uint64 CmdRequest_InstallSnapshot::last_included_term() const {
+  return last_included_term_;
+}
+inline void CmdRequest_InstallSnapshot::set_last_included_term(::google::protobuf::uint64 value) {
+  set_has_last_included_term();
+  last_included_term_ = value;
+}
+
+// required uint64 seq = 6;
+inline bool CmdRequest_InstallSnapshot::has_seq() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_seq() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_seq() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void CmdRequest_InstallSnapshot::clear_seq() {
+  seq_ = GOOGLE_ULONGLONG(0);
+  clear_has_seq();
+}
+inline ::google::protobuf::uint64 CmdRequest_InstallSnapshot::seq() const {
+  return seq_;
+}
+inline void CmdRequest_InstallSnapshot::set_seq(::google::protobuf::uint64 value) {
+  set_has_seq();
+  seq_ = value;
+}
+
+// required bytes filename = 7;
+inline bool CmdRequest_InstallSnapshot::has_filename() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_filename() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_filename() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void CmdRequest_InstallSnapshot::clear_filename() {
+  if (filename_ != &::google::protobuf::internal::kEmptyString) {
+    filename_->clear();
+  }
+  clear_has_filename();
+}
+inline const ::std::string& CmdRequest_InstallSnapshot::filename() const {
+  return *filename_;
+}
+inline void CmdRequest_InstallSnapshot::set_filename(const ::std::string& value) {
+  set_has_filename();
+  if (filename_ == &::google::protobuf::internal::kEmptyString) {
+    filename_ = new ::std::string;
+  }
+  filename_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_filename(const char* value) {
+  set_has_filename();
+  if (filename_ == &::google::protobuf::internal::kEmptyString) {
+    filename_ = new ::std::string;
+  }
+  filename_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_filename(const void* value, size_t size) {
+  set_has_filename();
+  if (filename_ == &::google::protobuf::internal::kEmptyString) {
+    filename_ = new ::std::string;
+  }
+  filename_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_InstallSnapshot::mutable_filename() {
+  set_has_filename();
+  if (filename_ == &::google::protobuf::internal::kEmptyString) {
+    filename_ = new ::std::string;
+  }
+  return filename_;
+}
+inline ::std::string* CmdRequest_InstallSnapshot::release_filename() {
+  clear_has_filename();
+  if (filename_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = filename_;
+    filename_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void CmdRequest_InstallSnapshot::set_allocated_filename(::std::string* filename) {
+  if (filename_ != &::google::protobuf::internal::kEmptyString) {
+    delete filename_;
+  }
+  if (filename) {
+    set_has_filename();
+    filename_ = filename;
+  } else {
+    clear_has_filename();
+    filename_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// required uint64 offset = 8;
+inline bool CmdRequest_InstallSnapshot::has_offset() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_offset() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_offset() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void CmdRequest_InstallSnapshot::clear_offset() {
+  offset_ = GOOGLE_ULONGLONG(0);
+  clear_has_offset();
+}
+inline ::google::protobuf::uint64 CmdRequest_InstallSnapshot::offset() const {
+  return offset_;
+}
+inline void CmdRequest_InstallSnapshot::set_offset(::google::protobuf::uint64 value) {
+  set_has_offset();
+  offset_ = value;
+}
+
+// required bytes data = 9;
+inline bool CmdRequest_InstallSnapshot::has_data() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_data() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_data() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void CmdRequest_InstallSnapshot::clear_data() {
+  if (data_ != &::google::protobuf::internal::kEmptyString) {
+    data_->clear();
+  }
+  clear_has_data();
+}
+inline const ::std::string& CmdRequest_InstallSnapshot::data() const {
+  return *data_;
+}
+inline void CmdRequest_InstallSnapshot::set_data(const ::std::string& value) {
+  set_has_data();
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    data_ = new ::std::string;
+  }
+  data_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_data(const char* value) {
+  set_has_data();
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    data_ = new ::std::string;
+  }
+  data_->assign(value);
+}
+inline void CmdRequest_InstallSnapshot::set_data(const void* value, size_t size) {
+  set_has_data();
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    data_ = new ::std::string;
+  }
+  data_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* CmdRequest_InstallSnapshot::mutable_data() {
+  set_has_data();
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    data_ = new ::std::string;
+  }
+  return data_;
+}
+inline ::std::string* CmdRequest_InstallSnapshot::release_data() {
+  clear_has_data();
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = data_;
+    data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void CmdRequest_InstallSnapshot::set_allocated_data(::std::string* data) {
+  if (data_ != &::google::protobuf::internal::kEmptyString) {
+    delete data_;
+  }
+  if (data) {
+    set_has_data();
+    data_ = data;
+  } else {
+    clear_has_data();
+    data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// required bool done = 10;
+inline bool CmdRequest_InstallSnapshot::has_done() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void CmdRequest_InstallSnapshot::set_has_done() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void CmdRequest_InstallSnapshot::clear_has_done() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void CmdRequest_InstallSnapshot::clear_done() {
+  done_ = false;
+  clear_has_done();
+}
+inline bool CmdRequest_InstallSnapshot::done() const {
+  return done_;
+}
+inline void CmdRequest_InstallSnapshot::set_done(bool value) {
+  set_has_done();
+  done_ = value;
+}
+
+// -------------------------------------------------------------------
+
+// CmdRequest_LeaderHeartbeat
+
+// required uint64 term = 1;
+inline bool CmdRequest_LeaderHeartbeat::has_term() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void CmdRequest_LeaderHeartbeat::set_has_term() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void CmdRequest_LeaderHeartbeat::clear_has_term() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void CmdRequest_LeaderHeartbeat::clear_term() {
+  term_ = GOOGLE_ULONGLONG(0);
+  clear_has_term();
+}
+inline ::google::protobuf::uint64 CmdRequest_LeaderHeartbeat::term() const {
   return term_;
 }
-inline void CmdRequest_ServerStatus::set_term(::google::protobuf::int64 value) {
+inline void CmdRequest_LeaderHeartbeat::set_term(::google::protobuf::uint64 value) {
   set_has_term();
   term_ = value;
 }
 
-// required int64 commit_index = 2;
-inline bool CmdRequest_ServerStatus::has_commit_index() const {
+// required bytes ip = 2;
+inline bool CmdRequest_LeaderHeartbeat::has_ip() const {
   return (_has_bits_[0] & 0x00000002u) != 0;
 }
-inline void CmdRequest_ServerStatus::set_has_commit_index() {
+inline void CmdRequest_LeaderHeartbeat::set_has_ip() {
   _has_bits_[0] |= 0x00000002u;
 }
-inline void CmdRequest_ServerStatus::clear_has_commit_index() {
+inline void CmdRequest_LeaderHeartbeat::clear_has_ip() {
   _has_bits_[0] &= ~0x00000002u;
 }
-inline void CmdRequest_ServerStatus::clear_commit_index() {
-  commit_index_ = GOOGLE_LONGLONG(0);
-  clear_has_commit_index();
-}
-inline ::google::protobuf::int64 CmdRequest_ServerStatus::commit_index() const {
-  return commit_index_;
-}
-inline void CmdRequest_ServerStatus::set_commit_index(::google::protobuf::int64 value) {
-  set_has_commit_index();
-  commit_index_ = value;
-}
-
-// optional bytes ip = 3;
-inline bool CmdRequest_ServerStatus::has_ip() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
-}
-inline void CmdRequest_ServerStatus::set_has_ip() {
-  _has_bits_[0] |= 0x00000004u;
-}
-inline void CmdRequest_ServerStatus::clear_has_ip() {
-  _has_bits_[0] &= ~0x00000004u;
-}
-inline void CmdRequest_ServerStatus::clear_ip() {
+inline void CmdRequest_LeaderHeartbeat::clear_ip() {
   if (ip_ != &::google::protobuf::internal::kEmptyString) {
     ip_->clear();
   }
   clear_has_ip();
 }
-inline const ::std::string& CmdRequest_ServerStatus::ip() const {
+inline const ::std::string& CmdRequest_LeaderHeartbeat::ip() const {
   return *ip_;
 }
-inline void CmdRequest_ServerStatus::set_ip(const ::std::string& value) {
+inline void CmdRequest_LeaderHeartbeat::set_ip(const ::std::string& value) {
   set_has_ip();
   if (ip_ == &::google::protobuf::internal::kEmptyString) {
     ip_ = new ::std::string;
   }
   ip_->assign(value);
 }
-inline void CmdRequest_ServerStatus::set_ip(const char* value) {
+inline void CmdRequest_LeaderHeartbeat::set_ip(const char* value) {
   set_has_ip();
   if (ip_ == &::google::protobuf::internal::kEmptyString) {
     ip_ = new ::std::string;
   }
   ip_->assign(value);
 }
-inline void CmdRequest_ServerStatus::set_ip(const void* value, size_t size) {
+inline void CmdRequest_LeaderHeartbeat::set_ip(const void* value, size_t size) {
   set_has_ip();
   if (ip_ == &::google::protobuf::internal::kEmptyString) {
     ip_ = new ::std::string;
   }
   ip_->assign(reinterpret_cast<const char*>(value), size);
 }
-inline ::std::string* CmdRequest_ServerStatus::mutable_ip() {
+inline ::std::string* CmdRequest_LeaderHeartbeat::mutable_ip() {
   set_has_ip();
   if (ip_ == &::google::protobuf::internal::kEmptyString) {
     ip_ = new ::std::string;
   }
   return ip_;
 }
-inline ::std::string* CmdRequest_ServerStatus::release_ip() {
+inline ::std::string* CmdRequest_LeaderHeartbeat::release_ip() {
   clear_has_ip();
   if (ip_ == &::google::protobuf::internal::kEmptyString) {
     return NULL;
@@ -3387,7 +4647,7 @@ inline ::std::string* CmdRequest_ServerStatus::release_ip() {
     return temp;
   }
 }
-inline void CmdRequest_ServerStatus::set_allocated_ip(::std::string* ip) {
+inline void CmdRequest_LeaderHeartbeat::set_allocated_ip(::std::string* ip) {
   if (ip_ != &::google::protobuf::internal::kEmptyString) {
     delete ip_;
   }
@@ -3400,28 +4660,50 @@ inline void CmdRequest_ServerStatus::set_allocated_ip(::std::string* ip) {
   }
 }
 
-// optional int32 port = 4;
-inline bool CmdRequest_ServerStatus::has_port() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
+// required int32 port = 3;
+inline bool CmdRequest_LeaderHeartbeat::has_port() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
 }
-inline void CmdRequest_ServerStatus::set_has_port() {
-  _has_bits_[0] |= 0x00000008u;
+inline void CmdRequest_LeaderHeartbeat::set_has_port() {
+  _has_bits_[0] |= 0x00000004u;
 }
-inline void CmdRequest_ServerStatus::clear_has_port() {
-  _has_bits_[0] &= ~0x00000008u;
+inline void CmdRequest_LeaderHeartbeat::clear_has_port() {
+  _has_bits_[0] &= ~0x00000004u;
 }
-inline void CmdRequest_ServerStatus::clear_port() {
+inline void CmdRequest_LeaderHeartbeat::clear_port() {
   port_ = 0;
   clear_has_port();
 }
-inline ::google::protobuf::int32 CmdRequest_ServerStatus::port() const {
+inline ::google::protobuf::int32 CmdRequest_LeaderHeartbeat::port() const {
   return port_;
 }
-inline void CmdRequest_ServerStatus::set_port(::google::protobuf::int32 value) {
+inline void CmdRequest_LeaderHeartbeat::set_port(::google::protobuf::int32 value) {
   set_has_port();
   port_ = value;
 }
 
+// required uint64 leader_commit = 4;
+inline bool CmdRequest_LeaderHeartbeat::has_leader_commit() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void CmdRequest_LeaderHeartbeat::set_has_leader_commit() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void CmdRequest_LeaderHeartbeat::clear_has_leader_commit() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void CmdRequest_LeaderHeartbeat::clear_leader_commit() {
+  leader_commit_ = GOOGLE_ULONGLONG(0);
+  clear_has_leader_commit();
+}
+inline ::google::protobuf::uint64 CmdRequest_LeaderHeartbeat::leader_commit() const {
+  return leader_commit_;
+}
+inline void CmdRequest_LeaderHeartbeat::set_leader_commit(::google::protobuf::uint64 value) {
+  set_has_leader_commit();
+  leader_commit_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // CmdRequest
@@ -3715,6 +4997,82 @@ inline void CmdRequest::set_allocated_server_status(::floyd::CmdRequest_ServerSt
   }
 }
 
+// optional .floyd.CmdRequest.InstallSnapshot install_snapshot = 9;
+inline bool CmdRequest::has_install_snapshot() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void CmdRequest::set_has_install_snapshot() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void CmdRequest::clear_has_install_snapshot() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void CmdRequest::clear_install_snapshot() {
+  if (install_snapshot_ != NULL) install_snapshot_->::floyd::CmdRequest_InstallSnapshot::Clear();
+  clear_has_install_snapshot();
+}
+inline const ::floyd::CmdRequest_InstallSnapshot& CmdRequest::install_snapshot() const {
+  return install_snapshot_ != NULL ? *install_snapshot_ : *default_instance_->install_snapshot_;
+}
+inline ::floyd::CmdRequest_InstallSnapshot* CmdRequest::mutable_install_snapshot() {
+  set_has_install_snapshot();
+  if (install_snapshot_ == NULL) install_snapshot_ = new ::floyd::CmdRequest_InstallSnapshot;
+  return install_snapshot_;
+}
+inline ::floyd::CmdRequest_InstallSnapshot* CmdRequest::release_install_snapshot() {
+  clear_has_install_snapshot();
+  ::floyd::CmdRequest_InstallSnapshot* temp = install_snapshot_;
+  install_snapshot_ = NULL;
+  return temp;
+}
+inline void CmdRequest::set_allocated_install_snapshot(::floyd::CmdRequest_InstallSnapshot* install_snapshot) {
+  delete install_snapshot_;
+  install_snapshot_ = install_snapshot;
+  if (install_snapshot) {
+    set_has_install_snapshot();
+  } else {
+    clear_has_install_snapshot();
+  }
+}
+
+// optional .floyd.CmdRequest.LeaderHeartbeat leader_heartbeat = 10;
+inline bool CmdRequest::has_leader_heartbeat() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void CmdRequest::set_has_leader_heartbeat() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void CmdRequest::clear_has_leader_heartbeat() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void CmdRequest::clear_leader_heartbeat() {
+  if (leader_heartbeat_ != NULL) leader_heartbeat_->::floyd::CmdRequest_LeaderHeartbeat::Clear();
+  clear_has_leader_heartbeat();
+}
+inline const ::floyd::CmdRequest_LeaderHeartbeat& CmdRequest::leader_heartbeat() const {
+  return leader_heartbeat_ != NULL ? *leader_heartbeat_ : *default_instance_->leader_heartbeat_;
+}
+inline ::floyd::CmdRequest_LeaderHeartbeat* CmdRequest::mutable_leader_heartbeat() {
+  set_has_leader_heartbeat();
+  if (leader_heartbeat_ == NULL) leader_heartbeat_ = new ::floyd::CmdRequest_LeaderHeartbeat;
+  return leader_heartbeat_;
+}
+inline ::floyd::CmdRequest_LeaderHeartbeat* CmdRequest::release_leader_heartbeat() {
+  clear_has_leader_heartbeat();
+  ::floyd::CmdRequest_LeaderHeartbeat* temp = leader_heartbeat_;
+  leader_heartbeat_ = NULL;
+  return temp;
+}
+inline void CmdRequest::set_allocated_leader_heartbeat(::floyd::CmdRequest_LeaderHeartbeat* leader_heartbeat) {
+  delete leader_heartbeat_;
+  leader_heartbeat_ = leader_heartbeat;
+  if (leader_heartbeat) {
+    set_has_leader_heartbeat();
+  } else {
+    clear_has_leader_heartbeat();
+  }
+}
+
 // -------------------------------------------------------------------
 
 // CmdResponse_RequestVoteResponse
@@ -3833,6 +5191,94 @@ inline void CmdResponse_AppendEntriesResponse::set_last_log_index(::google::prot
   last_log_index_ = value;
 }
 
+// optional uint64 conflict_term = 4;
+inline bool CmdResponse_AppendEntriesResponse::has_conflict_term() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void CmdResponse_AppendEntriesResponse::set_has_conflict_term() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_has_conflict_term() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_conflict_term() {
+  conflict_term_ = GOOGLE_ULONGLONG(0);
+  clear_has_conflict_term();
+}
+inline ::google::protobuf::uint64 CmdResponse_AppendEntriesResponse::conflict_term() const {
+  return conflict_term_;
+}
+inline void CmdResponse_AppendEntriesResponse::set_conflict_term(::google::protobuf::uint64 value) {
+  set_has_conflict_term();
+  conflict_term_ = value;
+}
+
+// optional uint64 conflict_index = 5;
+inline bool CmdResponse_AppendEntriesResponse::has_conflict_index() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void CmdResponse_AppendEntriesResponse::set_has_conflict_index() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_has_conflict_index() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_conflict_index() {
+  conflict_index_ = GOOGLE_ULONGLONG(0);
+  clear_has_conflict_index();
+}
+inline ::google::protobuf::uint64 CmdResponse_AppendEntriesResponse::conflict_index() const {
+  return conflict_index_;
+}
+inline void CmdResponse_AppendEntriesResponse::set_conflict_index(::google::protobuf::uint64 value) {
+  set_has_conflict_index();
+  conflict_index_ = value;
+}
+
+// optional uint64 last_applied = 6;
+inline bool CmdResponse_AppendEntriesResponse::has_last_applied() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void CmdResponse_AppendEntriesResponse::set_has_last_applied() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_has_last_applied() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_last_applied() {
+  last_applied_ = GOOGLE_ULONGLONG(0);
+  clear_has_last_applied();
+}
+inline ::google::protobuf::uint64 CmdResponse_AppendEntriesResponse::last_applied() const {
+  return last_applied_;
+}
+inline void CmdResponse_AppendEntriesResponse::set_last_applied(::google::protobuf::uint64 value) {
+  set_has_last_applied();
+  last_applied_ = value;
+}
+
+// optional uint64 match_index = 7;
+inline bool CmdResponse_AppendEntriesResponse::has_match_index() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void CmdResponse_AppendEntriesResponse::set_has_match_index() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_has_match_index() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void CmdResponse_AppendEntriesResponse::clear_match_index() {
+  match_index_ = GOOGLE_ULONGLONG(0);
+  clear_has_match_index();
+}
+inline ::google::protobuf::uint64 CmdResponse_AppendEntriesResponse::match_index() const {
+  return match_index_;
+}
+inline void CmdResponse_AppendEntriesResponse::set_match_index(::google::protobuf::uint64 value) {
+  set_has_match_index();
+  match_index_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // CmdResponse_KvResponse
@@ -4277,6 +5723,124 @@ inline void CmdResponse_ServerStatus::set_last_applied(::google::protobuf::uint6
 
 // -------------------------------------------------------------------
 
+// CmdResponse_InstallSnapshotResponse
+
+// required uint64 term = 1;
+inline bool CmdResponse_InstallSnapshotResponse::has_term() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void CmdResponse_InstallSnapshotResponse::set_has_term() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void CmdResponse_InstallSnapshotResponse::clear_has_term() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void CmdResponse_InstallSnapshotResponse::clear_term() {
+  term_ = GOOGLE_ULONGLONG(0);
+  clear_has_term();
+}
+inline ::google::protobuf::uint64 CmdResponse_InstallSnapshotResponse::term() const {
+  return term_;
+}
+inline void CmdResponse_InstallSnapshotResponse::set_term(::google::protobuf::uint64 value) {
+  set_has_term();
+  term_ = value;
+}
+
+// required bool success = 2;
+inline bool CmdResponse_InstallSnapshotResponse::has_success() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void CmdResponse_InstallSnapshotResponse::set_has_success() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void CmdResponse_InstallSnapshotResponse::clear_has_success() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void CmdResponse_InstallSnapshotResponse::clear_success() {
+  success_ = false;
+  clear_has_success();
+}
+inline bool CmdResponse_InstallSnapshotResponse::success() const {
+  return success_;
+}
+inline void CmdResponse_InstallSnapshotResponse::set_success(bool value) {
+  set_has_success();
+  success_ = value;
+}
+
+// -------------------------------------------------------------------
+
+// CmdResponse_LeaderHeartbeatResponse
+
+// required uint64 term = 1;
+inline bool CmdResponse_LeaderHeartbeatResponse::has_term() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_has_term() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_has_term() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_term() {
+  term_ = GOOGLE_ULONGLONG(0);
+  clear_has_term();
+}
+inline ::google::protobuf::uint64 CmdResponse_LeaderHeartbeatResponse::term() const {
+  return term_;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_term(::google::protobuf::uint64 value) {
+  set_has_term();
+  term_ = value;
+}
+
+// required bool success = 2;
+inline bool CmdResponse_LeaderHeartbeatResponse::has_success() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_has_success() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_has_success() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_success() {
+  success_ = false;
+  clear_has_success();
+}
+inline bool CmdResponse_LeaderHeartbeatResponse::success() const {
+  return success_;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_success(bool value) {
+  set_has_success();
+  success_ = value;
+}
+
+// optional uint64 last_applied = 3;
+inline bool CmdResponse_LeaderHeartbeatResponse::has_last_applied() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_has_last_applied() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_has_last_applied() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::clear_last_applied() {
+  last_applied_ = GOOGLE_ULONGLONG(0);
+  clear_has_last_applied();
+}
+inline ::google::protobuf::uint64 CmdResponse_LeaderHeartbeatResponse::last_applied() const {
+  return last_applied_;
+}
+inline void CmdResponse_LeaderHeartbeatResponse::set_last_applied(::google::protobuf::uint64 value) {
+  set_has_last_applied();
+  last_applied_ = value;
+}
+
+// -------------------------------------------------------------------
+
 // CmdResponse
 
 // required .floyd.Type type = 1;
@@ -4585,6 +6149,82 @@ inline void CmdResponse::set_allocated_all_servers(::floyd::Membership* all_serv
   }
 }
 
+// optional .floyd.CmdResponse.InstallSnapshotResponse install_snapshot_res = 9;
+inline bool CmdResponse::has_install_snapshot_res() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void CmdResponse::set_has_install_snapshot_res() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void CmdResponse::clear_has_install_snapshot_res() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void CmdResponse::clear_install_snapshot_res() {
+  if (install_snapshot_res_ != NULL) install_snapshot_res_->::floyd::CmdResponse_InstallSnapshotResponse::Clear();
+  clear_has_install_snapshot_res();
+}
+inline const ::floyd::CmdResponse_InstallSnapshotResponse& CmdResponse::install_snapshot_res() const {
+  return install_snapshot_res_ != NULL ? *install_snapshot_res_ : *default_instance_->install_snapshot_res_;
+}
+inline ::floyd::CmdResponse_InstallSnapshotResponse* CmdResponse::mutable_install_snapshot_res() {
+  set_has_install_snapshot_res();
+  if (install_snapshot_res_ == NULL) install_snapshot_res_ = new ::floyd::CmdResponse_InstallSnapshotResponse;
+  return install_snapshot_res_;
+}
+inline ::floyd::CmdResponse_InstallSnapshotResponse* CmdResponse::release_install_snapshot_res() {
+  clear_has_install_snapshot_res();
+  ::floyd::CmdResponse_InstallSnapshotResponse* temp = install_snapshot_res_;
+  install_snapshot_res_ = NULL;
+  return temp;
+}
+inline void CmdResponse::set_allocated_install_snapshot_res(::floyd::CmdResponse_InstallSnapshotResponse* install_snapshot_res) {
+  delete install_snapshot_res_;
+  install_snapshot_res_ = install_snapshot_res;
+  if (install_snapshot_res) {
+    set_has_install_snapshot_res();
+  } else {
+    clear_has_install_snapshot_res();
+  }
+}
+
+// optional .floyd.CmdResponse.LeaderHeartbeatResponse leader_heartbeat_res = 10;
+inline bool CmdResponse::has_leader_heartbeat_res() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void CmdResponse::set_has_leader_heartbeat_res() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void CmdResponse::clear_has_leader_heartbeat_res() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void CmdResponse::clear_leader_heartbeat_res() {
+  if (leader_heartbeat_res_ != NULL) leader_heartbeat_res_->::floyd::CmdResponse_LeaderHeartbeatResponse::Clear();
+  clear_has_leader_heartbeat_res();
+}
+inline const ::floyd::CmdResponse_LeaderHeartbeatResponse& CmdResponse::leader_heartbeat_res() const {
+  return leader_heartbeat_res_ != NULL ? *leader_heartbeat_res_ : *default_instance_->leader_heartbeat_res_;
+}
+inline ::floyd::CmdResponse_LeaderHeartbeatResponse* CmdResponse::mutable_leader_heartbeat_res() {
+  set_has_leader_heartbeat_res();
+  if (leader_heartbeat_res_ == NULL) leader_heartbeat_res_ = new ::floyd::CmdResponse_LeaderHeartbeatResponse;
+  return leader_heartbeat_res_;
+}
+inline ::floyd::CmdResponse_LeaderHeartbeatResponse* CmdResponse::release_leader_heartbeat_res() {
+  clear_has_leader_heartbeat_res();
+  ::floyd::CmdResponse_LeaderHeartbeatResponse* temp = leader_heartbeat_res_;
+  leader_heartbeat_res_ = NULL;
+  return temp;
+}
+inline void CmdResponse::set_allocated_leader_heartbeat_res(::floyd::CmdResponse_LeaderHeartbeatResponse* leader_heartbeat_res) {
+  delete leader_heartbeat_res_;
+  leader_heartbeat_res_ = leader_heartbeat_res;
+  if (leader_heartbeat_res) {
+    set_has_leader_heartbeat_res();
+  } else {
+    clear_has_leader_heartbeat_res();
+  }
+}
+
 // -------------------------------------------------------------------
 
 // Lock
@@ -8,7 +8,10 @@
 #include <google/protobuf/text_format.h>
 
 #include <unistd.h>
+#include <functional>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "slash/include/xdebug.h"
 #include "slash/include/env.h"
@@ -17,32 +20,70 @@
 #include "floyd/src/floyd.pb.h"
 #include "floyd/src/raft_meta.h"
 #include "floyd/src/raft_log.h"
+#include "floyd/src/raft_snapshot.h"
 #include "floyd/src/floyd_impl.h"
 
 namespace floyd {
 
-FloydApply::FloydApply(FloydContext* context, rocksdb::DB* db, RaftMeta* raft_meta,
-    RaftLog* raft_log, FloydImpl* impl, Logger* info_log)
+// the entries read from raft log at one time when applying
+static const uint64_t kApplyReadBytes = 4 * 1024 * 1024;
+// the bytes of the entries applied to db in one write
+static const uint64_t kApplyBatchBytes = 4 * 1024 * 1024;
+// the min entries between two snapshots triggered by the log size
+static const uint64_t kSnapshotMinEntries = 10000;
+
+FloydApply::FloydApply(FloydContext* context, StateMachine* state_machine, RaftMeta* raft_meta,
+    RaftLog* raft_log, RaftSnapshot* snapshot, FloydImpl* impl, Logger* info_log)
   : bg_thread_(1024 * 1024 * 1024),
     context_(context),
-    db_(db),
+    state_machine_(state_machine),
     raft_meta_(raft_meta),
     raft_log_(raft_log),
+    snapshot_(snapshot),
     impl_(impl),
-    info_log_(info_log) {
+    info_log_(info_log),
+    partition_cond_(&partition_mu_),
+    pending_partitions_(0),
+    retry_index_(0),
+    last_snapshot_us_(slash::NowMicros()) {
+  if (context_->options.apply_threads > 1) {
+    for (int i = 0; i < context_->options.apply_threads; i++) {
+      ApplyPartition* partition = new ApplyPartition();
+      partition->apply = this;
+      partition->thread = new pink::BGThread(1024 * 1024 * 1024);
+      partitions_.push_back(partition);
+    }
+  }
 }
 
 FloydApply::~FloydApply() {
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    delete partitions_[i]->thread;
+    delete partitions_[i];
+  }
 }
 
 int FloydApply::Start() {
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    partitions_[i]->thread->set_thread_name("A:" + std::to_string(impl_->GetLocalPort())
+        + ":" + std::to_string(i));
+    int ret = partitions_[i]->thread->StartThread();
+    if (ret != 0) {
+      return ret;
+    }
+  }
   bg_thread_.set_thread_name("A:" + std::to_string(impl_->GetLocalPort()));
   bg_thread_.Schedule(ApplyStateMachineWrapper, this);
   return bg_thread_.StartThread();
 }
 
 int FloydApply::Stop() {
-  return bg_thread_.StopThread();
+  // bg_thread_ may be waiting for the partitions, stop it first
+  int ret = bg_thread_.StopThread();
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    partitions_[i]->thread->StopThread();
+  }
+  return ret;
 }
 
 void FloydApply::ScheduleApply() {
@@ -61,60 +102,356 @@ void FloydApply::ApplyStateMachineWrapper(void* arg) {
 
 void FloydApply::ApplyStateMachine() {
   uint64_t last_applied = context_->last_applied;
+  if (last_applied < raft_log_->GetSnapshotIndex() && !RestoreSnapshot(&last_applied)) {
+    usleep(1000000);
+    ScheduleApply();  // try once more
+    return;
+  }
   // Apply as more entry as possible
   uint64_t commit_index;
   commit_index = context_->commit_index;
 
   LOGV(DEBUG_LEVEL, info_log_, "FloydApply::ApplyStateMachine: last_applied: %lu, commit_index: %lu",
             last_applied, commit_index);
-  Entry log_entry;
   if (last_applied >= commit_index) {
     return;
   }
-  // TODO: use batch commit to optimization
-  while (last_applied < commit_index) {
-    last_applied++;
-    raft_log_->GetEntry(last_applied, &log_entry);
-    // TODO: we need change the s type
-    // since the Apply may not operate rocksdb
-    rocksdb::Status s = Apply(log_entry);
-    if (!s.ok()) {
-      LOGV(WARN_LEVEL, info_log_, "FloydApply::ApplyStateMachine: Apply log entry failed, at: %d, error: %s",
-          last_applied, s.ToString().c_str());
+  // the entries are applied in batches, the next entry may read the keys
+  // written by the former ones in the same batch, such as the locks
+  StateMachineBatch batch;
+  std::vector<Entry> entries;
+  // the results of entries [last_applied + 1, batch_last], the waiters get
+  // them after the batch is written
+  std::vector<ApplyWaiters::Result> results;
+  uint64_t batch_last = last_applied;
+  while (batch_last < commit_index) {
+    if (raft_log_->GetEntries(batch_last + 1, commit_index, kApplyReadBytes, &entries) != 0) {
+      LOGV(WARN_LEVEL, info_log_, "FloydApply::ApplyStateMachine: Get log entry failed, at: %lu",
+          batch_last + 1);
       usleep(1000000);
       ScheduleApply();  // try once more
       return;
     }
+    if (!partitions_.empty()) {
+      // the membership changes are barriers, the entries between them are
+      // applied in parallel
+      size_t begin = 0;
+      while (begin < entries.size()) {
+        size_t end = begin;
+        while (end < entries.size()
+            && entries[end].optype() != Entry_OpType_kAddServer
+            && entries[end].optype() != Entry_OpType_kRemoveServer) {
+          end++;
+        }
+        if (end > begin) {
+          if (!ApplyPartitioned(entries, begin, end, batch_last + begin + 1, &results)) {
+            usleep(1000000);
+            ScheduleApply();  // try once more
+            return;
+          }
+          AdvanceLastApplied(batch_last + end, &results);
+        }
+        if (end < entries.size()) {
+          ApplyWaiters::Result result;
+          result.term = entries[end].term();
+          Status s = Apply(entries[end], &batch, &result.status);
+          results.push_back(result);
+          if (!s.ok() || !WriteApplyBatch(&batch, batch_last + end + 1, &results)) {
+            LOGV(WARN_LEVEL, info_log_, "FloydApply::ApplyStateMachine: Apply membership entry failed, at: %lu, "
+                "error: %s", batch_last + end + 1, s.ToString().c_str());
+            batch.Clear();
+            usleep(1000000);
+            ScheduleApply();  // try once more
+            return;
+          }
+          UpdatePeers(entries[end]);
+          end++;
+        }
+        begin = end;
+      }
+      batch_last += entries.size();
+      last_applied = batch_last;
+      continue;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+      ApplyWaiters::Result result;
+      result.term = entries[i].term();
+      Status s = Apply(entries[i], &batch, &result.status);
+      if (!s.ok()) {
+        // the entries in batch are applied again
+        LOGV(WARN_LEVEL, info_log_, "FloydApply::ApplyStateMachine: Apply log entry failed, at: %lu, error: %s",
+            batch_last + 1, s.ToString().c_str());
+        usleep(1000000);
+        ScheduleApply();  // try once more
+        return;
+      }
+      results.push_back(result);
+      batch_last++;
+      // the peers follow a membership change only after it is written
+      bool membership = entries[i].optype() == Entry_OpType_kAddServer
+        || entries[i].optype() == Entry_OpType_kRemoveServer;
+      if (batch_last == commit_index || batch.DataSize() >= kApplyBatchBytes || membership) {
+        if (!WriteApplyBatch(&batch, batch_last, &results)) {
+          usleep(1000000);
+          ScheduleApply();  // try once more
+          return;
+        }
+        last_applied = batch_last;
+        if (membership) {
+          UpdatePeers(entries[i]);
+        }
+      }
+    }
+  }
+
+  MaybeSnapshot(last_applied);
+}
+
+bool FloydApply::WriteApplyBatch(StateMachineBatch* batch, uint64_t last_applied,
+    std::vector<ApplyWaiters::Result>* results) {
+  Status s = state_machine_->Apply(*batch);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::WriteApplyBatch: write %lu keys to %lu failed, error: %s",
+        batch->Count(), last_applied, s.ToString().c_str());
+    return false;
   }
-  context_->apply_mu.Lock();
+  batch->Clear();
+  AdvanceLastApplied(last_applied, results);
+  return true;
+}
+
+void FloydApply::AdvanceLastApplied(uint64_t last_applied,
+    std::vector<ApplyWaiters::Result>* results) {
   context_->last_applied = last_applied;
   raft_meta_->SetLastApplied(last_applied);
-  context_->apply_mu.Unlock();
-  context_->apply_cond.SignalAll();
+  if (results == NULL) {
+    context_->apply_waiters.Reset(last_applied);
+    return;
+  }
+  uint64_t index = last_applied - results->size();
+  for (size_t i = 0; i < results->size(); i++) {
+    context_->apply_waiters.Notify(++index, (*results)[i]);
+  }
+  results->clear();
+}
+
+void FloydApply::ApplyPartitionWrapper(void* arg) {
+  ApplyPartition* partition = reinterpret_cast<ApplyPartition*>(arg);
+  partition->apply->ApplyPartitionEntries(partition);
+}
+
+void FloydApply::ApplyPartitionEntries(ApplyPartition* partition) {
+  StateMachineBatch batch;
+  Status s;
+  partition->results.resize(partition->entries.size());
+  for (size_t i = 0; i < partition->entries.size() && s.ok(); i++) {
+    s = Apply(*partition->entries[i], &batch, &partition->results[i]);
+  }
+  if (s.ok()) {
+    s = state_machine_->Apply(batch);
+  }
+  partition->status = s;
+  slash::MutexLock l(&partition_mu_);
+  if (--pending_partitions_ == 0) {
+    partition_cond_.Signal();
+  }
+}
+
+bool FloydApply::ApplyPartitioned(const std::vector<Entry>& entries, size_t begin, size_t end,
+    uint64_t first_index, std::vector<ApplyWaiters::Result>* results) {
+  // the entries written by the succeeded partitions of the last try are
+  // skipped, they are not idempotent, such as TryLock
+  size_t count = end - begin;
+  std::vector<bool> applied(count, false);
+  std::vector<ApplyWaiters::Result> range_results(count);
+  if (retry_index_ == first_index) {
+    for (size_t k = 0; k < count && k < retry_applied_.size(); k++) {
+      applied[k] = retry_applied_[k];
+      range_results[k] = retry_results_[k];
+    }
+  }
+
+  std::hash<std::string> hash;
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    partitions_[i]->entries.clear();
+  }
+  for (size_t i = begin; i < end; i++) {
+    if (!applied[i - begin]) {
+      partitions_[hash(entries[i].key()) % partitions_.size()]->entries.push_back(&entries[i]);
+    }
+  }
+  {
+  slash::MutexLock l(&partition_mu_);
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    if (!partitions_[i]->entries.empty()) {
+      pending_partitions_++;
+      partitions_[i]->thread->Schedule(ApplyPartitionWrapper, partitions_[i]);
+    }
+  }
+  while (pending_partitions_ > 0) {
+    partition_cond_.Wait();
+  }
+  }
+
+  // a failed partition writes nothing, since its entries are written in
+  // one batch
+  bool ok = true;
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    if (partitions_[i]->entries.empty()) {
+      continue;
+    }
+    if (!partitions_[i]->status.ok()) {
+      LOGV(WARN_LEVEL, info_log_, "FloydApply::ApplyPartitioned: partition %zu apply %zu entries failed, "
+          "error: %s", i, partitions_[i]->entries.size(), partitions_[i]->status.ToString().c_str());
+      ok = false;
+      continue;
+    }
+    for (size_t j = 0; j < partitions_[i]->entries.size(); j++) {
+      const Entry* entry = partitions_[i]->entries[j];
+      size_t k = entry - &entries[begin];
+      applied[k] = true;
+      range_results[k].term = entry->term();
+      range_results[k].status = partitions_[i]->results[j];
+    }
+  }
+  if (!ok) {
+    // only the entries of the failed partitions are applied on retry
+    if (retry_index_ != first_index) {
+      retry_index_ = first_index;
+      retry_applied_.clear();
+      retry_results_.clear();
+    }
+    if (retry_applied_.size() < count) {
+      retry_applied_.resize(count, false);
+      retry_results_.resize(count);
+    }
+    for (size_t k = 0; k < count; k++) {
+      retry_applied_[k] = applied[k];
+      retry_results_[k] = range_results[k];
+    }
+    return false;
+  }
+  ClearRetry();
+  results->insert(results->end(), range_results.begin(), range_results.end());
+  return true;
+}
+
+void FloydApply::ClearRetry() {
+  retry_index_ = 0;
+  retry_applied_.clear();
+  retry_results_.clear();
 }
 
-rocksdb::Status FloydApply::Apply(const Entry& entry) {
-  rocksdb::Status ret;
+void FloydApply::MaybeSnapshot(uint64_t last_applied) {
+  const Options& options = context_->options;
+  uint64_t snapshot_index = raft_log_->GetSnapshotIndex();
+  if (last_applied <= snapshot_index) {
+    return;
+  }
+  uint64_t entries = last_applied - snapshot_index;
+  // rocksdb reclaims the space of the deleted entries lazily, so we need
+  // some new entries before another snapshot triggered by the log size
+  if (!(options.snapshot_entries != 0 && entries >= options.snapshot_entries)
+      && !(options.snapshot_log_size != 0 && entries >= kSnapshotMinEntries
+        && raft_log_->ApproximateBytes() >= options.snapshot_log_size)
+      && !(options.snapshot_interval_us != 0
+        && slash::NowMicros() - last_snapshot_us_ >= options.snapshot_interval_us)) {
+    return;
+  }
+
+  uint64_t term = raft_log_->GetTerm(last_applied);
+  std::string members;
+  Status ret = state_machine_->Read(kMemberConfigKey, &members);
+  if (!ret.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::MaybeSnapshot: get membership failed, error: %s",
+        ret.ToString().c_str());
+    return;
+  }
+  Status s = snapshot_->Create(state_machine_, last_applied, term, members);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::MaybeSnapshot: create snapshot at %lu failed, error: %s",
+        last_applied, s.ToString().c_str());
+    return;
+  }
+  last_snapshot_us_ = slash::NowMicros();
+  // the log is kept until the meta points to the snapshot
+  s = raft_meta_->SetSnapshotMeta(last_applied, term, members);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::MaybeSnapshot: update snapshot meta to (%lu, %lu) failed, error: %s",
+        last_applied, term, s.ToString().c_str());
+    return;
+  }
+  if (raft_log_->TruncatePrefix(last_applied, term) != 0) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::MaybeSnapshot: truncate log prefix to %lu failed", last_applied);
+    return;
+  }
+  LOGV(INFO_LEVEL, info_log_, "FloydApply::MaybeSnapshot: snapshot at (%lu, %lu), drop %lu log entries",
+      last_applied, term, entries);
+}
+
+bool FloydApply::RestoreSnapshot(uint64_t* last_applied) {
+  uint64_t index, term;
+  std::string value;
+  Status s = snapshot_->Restore(state_machine_, &index, &term, &value);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::RestoreSnapshot: restore from snapshot failed, error: %s",
+        s.ToString().c_str());
+    return false;
+  }
+  // the results of the entries in the snapshot are unknown
+  ClearRetry();
+  AdvanceLastApplied(index, NULL);
+  *last_applied = index;
+
+  Membership members;
+  if (!members.ParseFromString(value)) {
+    LOGV(WARN_LEVEL, info_log_, "FloydApply::RestoreSnapshot: parse membership failed");
+    return true;
+  }
+  std::set<std::string> servers(members.nodes().begin(), members.nodes().end());
+  std::set<std::string> old_servers;
+  {
+  slash::MutexLock l(&context_->global_mu);
+  old_servers = context_->members;
+  }
+  for (const auto& server : old_servers) {
+    if (servers.find(server) == servers.end()) {
+      impl_->RemoveOutPeer(server);
+    }
+  }
+  for (const auto& server : servers) {
+    if (old_servers.find(server) == old_servers.end()) {
+      impl_->AddNewPeer(server);
+    }
+  }
+  LOGV(INFO_LEVEL, info_log_, "FloydApply::RestoreSnapshot: restore from snapshot (%lu, %lu), %d members",
+      index, term, members.nodes_size());
+  return true;
+}
+
+Status FloydApply::Apply(const Entry& entry, StateMachineBatch* batch, Status* result) {
+  Status ret;
   Lock lock;
   std::string val;
   // be careful:
   // we need to return the ret carefully
   // the FloydApply::ApplyStateMachine need use the ret to judge
-  // whether consume this successfully
+  // whether consume this successfully, while result is what the command
+  // gets
+  *result = Status::OK();
   switch (entry.optype()) {
     case Entry_OpType_kWrite:
-      ret = db_->Put(rocksdb::WriteOptions(), entry.key(), entry.value());
-      LOGV(DEBUG_LEVEL, info_log_, "FloydApply::Apply %s, key(%s)",
-          ret.ToString().c_str(), entry.key().c_str());
+      batch->Put(entry.key(), entry.value());
+      LOGV(DEBUG_LEVEL, info_log_, "FloydApply::Apply Write key(%s)", entry.key().c_str());
       break;
     case Entry_OpType_kDelete:
-      ret = db_->Delete(rocksdb::WriteOptions(), entry.key());
+      batch->Delete(entry.key());
       break;
     case Entry_OpType_kRead:
-      ret = rocksdb::Status::OK();
+      ret = Status::OK();
       break;
     case Entry_OpType_kTryLock:
-      ret = db_->Get(rocksdb::ReadOptions(), entry.key(), &val);
+      ret = Get(*batch, entry.key(), &val);
       if (ret.ok()) {
         lock.ParseFromString(val);
         if (lock.lease_end() < slash::NowMicros()) {
@@ -124,87 +461,102 @@ rocksdb::Status FloydApply::Apply(const Entry& entry) {
           lock.set_holder(entry.holder());
           lock.set_lease_end(entry.lease_end());
           lock.SerializeToString(&val);
-          ret = db_->Put(rocksdb::WriteOptions(), entry.key(), val);
-        } else {
-          ret = rocksdb::Status::OK();
+          batch->Put(entry.key(), val);
+        } else if (lock.holder() != entry.holder() || lock.lease_end() != entry.lease_end()) {
+          *result = Status::Busy("locked by " + lock.holder());
         }
+        ret = Status::OK();
       } else if (ret.IsNotFound()) {
         lock.set_holder(entry.holder());
         lock.set_lease_end(entry.lease_end());
         lock.SerializeToString(&val);
-        ret = db_->Put(rocksdb::WriteOptions(), entry.key(), val);
+        batch->Put(entry.key(), val);
+        ret = Status::OK();
       } else {
         LOGV(WARN_LEVEL, info_log_, "FloydImpl::Apply Trylock Error operate db error, name %s holder %s",
             entry.key().c_str(), entry.holder().c_str());
       }
       break;
     case Entry_OpType_kUnLock:
-      ret = db_->Get(rocksdb::ReadOptions(), entry.key(), &val);
+      ret = Get(*batch, entry.key(), &val);
       if (ret.ok()) {
         lock.ParseFromString(val);
         if (lock.holder() != entry.holder()) {
           LOGV(INFO_LEVEL, info_log_, "FloydApply::Apply Warning UnLock an lock holded by other, name %s holder %s, origin holder %s",
               entry.key().c_str(), entry.holder().c_str(), lock.holder().c_str());
+          *result = Status::Busy("locked by " + lock.holder());
         } else if (lock.lease_end() < slash::NowMicros()) {
-          LOGV(INFO_LEVEL, info_log_, "FloydImpl::Apply UnLock an lock which is expired, name %s holder %s",
+          LOGV(INFO_LEVEL, info_log_, "FloydApply::Apply UnLock an lock which is expired, name %s holder %s, origin holder %s",
               entry.key().c_str(), entry.holder().c_str(), lock.holder().c_str());
+          *result = Status::Busy("expired");
         } else {
-          ret = db_->Delete(rocksdb::WriteOptions(), entry.key());
+          batch->Delete(entry.key());
         }
       } else if (ret.IsNotFound()) {
         LOGV(INFO_LEVEL, info_log_, "FloydApply::Apply Warning UnLock an dosen't exist lock, name %s holder %s",
             entry.key().c_str(), entry.holder().c_str());
-        ret = rocksdb::Status::OK();
+        ret = Status::OK();
       } else {
         LOGV(WARN_LEVEL, info_log_, "FloydApply::Apply UnLock Error, operate db error, name %s holder %s",
             entry.key().c_str(), entry.holder().c_str());
       }
       break;
     case Entry_OpType_kAddServer:
-      ret = MembershipChange(entry.server(), true);
-      if (ret.ok()) {
-        context_->members.insert(entry.server());
-        impl_->AddNewPeer(entry.server());
-      }
+      ret = MembershipChange(entry.server(), true, batch);
       LOGV(INFO_LEVEL, info_log_, "FloydApply::Apply Add server %s to cluster",
           entry.server().c_str());
       break;
     case Entry_OpType_kRemoveServer:
-      ret = MembershipChange(entry.server(), false);
-      if (ret.ok()) {
-        context_->members.erase(entry.server());
-        impl_->RemoveOutPeer(entry.server());
-      }
+      ret = MembershipChange(entry.server(), false, batch);
       LOGV(INFO_LEVEL, info_log_, "FloydApply::Apply Remove server %s to cluster",
           entry.server().c_str());
       break;
     case Entry_OpType_kGetAllServers:
-      ret = rocksdb::Status::OK();
+      ret = Status::OK();
       break;
     default:
-      ret = rocksdb::Status::Corruption("Unknown entry type");
+      ret = Status::Corruption("Unknown entry type");
   }
   return ret;
 }
 
-rocksdb::Status FloydApply::MembershipChange(const std::string& ip_port,
-    bool add) {
+void FloydApply::UpdatePeers(const Entry& entry) {
+  if (entry.optype() == Entry_OpType_kAddServer) {
+    impl_->AddNewPeer(entry.server());
+  } else {
+    impl_->RemoveOutPeer(entry.server());
+  }
+}
+
+Status FloydApply::Get(const StateMachineBatch& batch, const std::string& key,
+    std::string* value) {
+  const StateMachineBatch::Op* op = batch.Find(key);
+  if (op == NULL) {
+    return state_machine_->Read(key, value);
+  } else if (op->type == StateMachineBatch::kDelete) {
+    return Status::NotFound(key);
+  }
+  *value = op->value;
+  return Status::OK();
+}
+
+Status FloydApply::MembershipChange(const std::string& ip_port,
+    bool add, StateMachineBatch* batch) {
   std::string value;
   Membership members;
-  rocksdb::Status ret = db_->Get(rocksdb::ReadOptions(),
-      kMemberConfigKey, &value);
+  Status ret = Get(*batch, kMemberConfigKey, &value);
   if (!ret.ok()) {
     return ret;
   }
 
   if(!members.ParseFromString(value)) {
-    return rocksdb::Status::Corruption("Parse failed");
+    return Status::Corruption("Parse failed");
   }
   int count = members.nodes_size();
   for (int i = 0; i < count; i++) {
     if (members.nodes(i) == ip_port) {
       if (add) {
-        return rocksdb::Status::OK();  // Already in
+        return Status::OK();  // Already in
       }
       // Remove Server
       if (i != count - 1) {
@@ -220,9 +572,10 @@ rocksdb::Status FloydApply::MembershipChange(const std::string& ip_port,
   }
 
   if (!members.SerializeToString(&value)) {
-    return rocksdb::Status::Corruption("Serialize failed");
+    return Status::Corruption("Serialize failed");
   }
-  return db_->Put(rocksdb::WriteOptions(), kMemberConfigKey, value);
+  batch->Put(kMemberConfigKey, value);
+  return Status::OK();
 }
 
 } // namespace floyd
@@ -6,8 +6,12 @@
 #ifndef FLOYD_SRC_FLOYD_APPLY_H_
 #define FLOYD_SRC_FLOYD_APPLY_H_
 
+#include <vector>
+
+#include "floyd/include/floyd_state_machine.h"
 #include "floyd/src/floyd_context.h"
 
+#include "slash/include/slash_mutex.h"
 #include "slash/include/slash_status.h"
 #include "pink/include/bg_thread.h"
 
@@ -17,13 +21,14 @@ using slash::Status;
 
 class RaftMeta;
 class RaftLog;
+class RaftSnapshot;
 class Logger;
 class FloydImpl;
 
 class FloydApply {
  public:
-  FloydApply(FloydContext* context, rocksdb::DB* db, RaftMeta* raft_meta,
-      RaftLog* raft_log, FloydImpl* impl_, Logger* info_log); 
+  FloydApply(FloydContext* context, StateMachine* state_machine, RaftMeta* raft_meta,
+      RaftLog* raft_log, RaftSnapshot* snapshot, FloydImpl* impl_, Logger* info_log);
   virtual ~FloydApply();
   int Start();
   int Stop();
@@ -32,18 +37,83 @@ class FloydApply {
  private:
   pink::BGThread bg_thread_;
   FloydContext* const context_;
-  rocksdb::DB* const db_;
+  StateMachine* const state_machine_;
   /*
    * we will store the increasing id in raft_meta_
    */
   RaftMeta* const raft_meta_;
   RaftLog* const raft_log_;
+  RaftSnapshot* const snapshot_;
   FloydImpl* const impl_;
   Logger* const info_log_;
+
+  /*
+   * with options.apply_threads > 1, the entries between two membership
+   * changes are partitioned by key and applied on the partition threads,
+   * bg_thread_ waits for all of them before advancing last_applied
+   */
+  struct ApplyPartition {
+    FloydApply* apply;
+    pink::BGThread* thread;
+    std::vector<const Entry*> entries;
+    // the result of every entry for the waiters
+    std::vector<Status> results;
+    Status status;
+  };
+  std::vector<ApplyPartition*> partitions_;
+  slash::Mutex partition_mu_;
+  slash::CondVar partition_cond_;
+  int pending_partitions_;
+  /*
+   * when some partitions fail, the entries from retry_index_ that the
+   * others have written and their results, only used in bg_thread_
+   */
+  uint64_t retry_index_;
+  std::vector<bool> retry_applied_;
+  std::vector<ApplyWaiters::Result> retry_results_;
+  // when the last snapshot is taken, only used in bg_thread_
+  uint64_t last_snapshot_us_;
+
   static void ApplyStateMachineWrapper(void* arg);
   void ApplyStateMachine();
-  rocksdb::Status Apply(const Entry& log_entry);
-  rocksdb::Status MembershipChange(const std::string& ip_port, bool add);
+  static void ApplyPartitionWrapper(void* arg);
+  void ApplyPartitionEntries(ApplyPartition* partition);
+  // apply entries[begin, end), which start at log index first_index, on the
+  // partition threads and wait for them, the results of them are appended
+  // to results
+  bool ApplyPartitioned(const std::vector<Entry>& entries, size_t begin, size_t end,
+      uint64_t first_index, std::vector<ApplyWaiters::Result>* results);
+  void ClearRetry();
+  // apply log_entry to batch, which is written to state_machine_ by
+  // WriteApplyBatch, result is what the command of log_entry gets
+  Status Apply(const Entry& log_entry, StateMachineBatch* batch, Status* result);
+  Status MembershipChange(const std::string& ip_port, bool add,
+      StateMachineBatch* batch);
+  // add or remove the peer of the membership change entry, after the entry
+  // is written to state_machine_
+  void UpdatePeers(const Entry& entry);
+  // read key from the writes in batch first, then from state_machine_
+  Status Get(const StateMachineBatch& batch, const std::string& key, std::string* value);
+  // write the entries up to last_applied in batch to state_machine_
+  bool WriteApplyBatch(StateMachineBatch* batch, uint64_t last_applied,
+      std::vector<ApplyWaiters::Result>* results);
+  /*
+   * results are of the entries applied up to last_applied, their waiters
+   * are woken with them, NULL if the results are unknown
+   */
+  void AdvanceLastApplied(uint64_t last_applied, std::vector<ApplyWaiters::Result>* results);
+  /*
+   * take a snapshot of state_machine_ and drop the log entries in it when
+   * the thresholds in options are reached, only called in the apply thread,
+   * so state_machine_ is not modified during the snapshot
+   */
+  void MaybeSnapshot(uint64_t last_applied);
+  /*
+   * the entries after last applied are dropped with the snapshot installed
+   * from leader, replace state_machine_ with the snapshot and update the
+   * membership
+   */
+  bool RestoreSnapshot(uint64_t* last_applied);
 
 
   FloydApply(const FloydApply&);
@@ -40,6 +40,9 @@ static std::string CmdType(const CmdRequest& cmd) {
     case Type::kServerStatus:
       ret = "ServerStatus";
       break;
+    case Type::kLeaderHeartbeat:
+      ret = "LeaderHeartbeat";
+      break;
     default:
       ret = "UnknownCmd";
   }
@@ -75,7 +78,7 @@ Status ClientPool::SendAndRecv(const std::string& server, const CmdRequest& req,
     if (req.type() == kAppendEntries) {
       LOGV(WARN_LEVEL, info_log_, "ClientPool::SendAndRecv Server Connect to %s failed, error reason: %s"
           " Request type %s prev_log_index %lu prev_log_term %lu leader_commit %lu "
-          "append entries size %d at term %d", server.c_str(), ret.ToString().c_str(),
+          "append entries size %d at term %lu", server.c_str(), ret.ToString().c_str(),
           CmdType(req).c_str(), req.append_entries().prev_log_index(), req.append_entries().prev_log_term(),
           req.append_entries().leader_commit(), req.append_entries().entries().size(), req.append_entries().term());
     } else {
@@ -92,7 +95,7 @@ Status ClientPool::SendAndRecv(const std::string& server, const CmdRequest& req,
     if (req.type() == kAppendEntries) {
       LOGV(WARN_LEVEL, info_log_, "ClientPool::SendAndRecv Server Send to %s failed, error reason: %s"
           " Request type %s prev_log_index %lu prev_log_term %lu leader_commit %lu "
-          "append entries size %d at term %d", server.c_str(), ret.ToString().c_str(),
+          "append entries size %d at term %lu", server.c_str(), ret.ToString().c_str(),
           CmdType(req).c_str(), req.append_entries().prev_log_index(), req.append_entries().prev_log_term(),
           req.append_entries().leader_commit(), req.append_entries().entries().size(), req.append_entries().term());
     } else {
@@ -109,7 +112,7 @@ Status ClientPool::SendAndRecv(const std::string& server, const CmdRequest& req,
     if (req.type() == kAppendEntries) {
       LOGV(WARN_LEVEL, info_log_, "ClientPool::SendAndRecv Server Recv to %s failed, error reason: %s"
           " Request type %s prev_log_index %lu prev_log_term %lu leader_commit %lu "
-          "append entries size %d at term %d", server.c_str(), ret.ToString().c_str(),
+          "append entries size %d at term %lu", server.c_str(), ret.ToString().c_str(),
           CmdType(req).c_str(), req.append_entries().prev_log_index(), req.append_entries().prev_log_term(),
           req.append_entries().leader_commit(), req.append_entries().entries().size(), req.append_entries().term());
     } else {
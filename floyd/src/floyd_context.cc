@@ -7,6 +7,8 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "slash/include/env.h"
 #include "slash/include/xdebug.h"
 
@@ -20,8 +22,10 @@ void FloydContext::RecoverInit(RaftMeta *raft_meta) {
   current_term = raft_meta->GetCurrentTerm();
   voted_for_ip = raft_meta->GetVotedForIp();
   voted_for_port = raft_meta->GetVotedForPort();
-  commit_index = raft_meta->GetCommitIndex();
   last_applied = raft_meta->GetLastApplied();
+  // the commit index may be persisted lazily
+  commit_index = std::max(raft_meta->GetCommitIndex(), last_applied.load());
+  apply_waiters.Reset(last_applied);
   role = Role::kFollower;
 }
 
@@ -36,6 +40,7 @@ void FloydContext::BecomeFollower(uint64_t new_term,
   current_term = new_term;
   leader_ip = _leader_ip;
   leader_port = _leader_port;
+  leader_match_index = 0;
   role = Role::kFollower;
 }
 
@@ -47,10 +52,12 @@ void FloydContext::BecomeCandidate() {
   voted_for_ip = options.local_ip;
   voted_for_port = options.local_port;
   vote_quorum = 1;
+  leader_match_index = 0;
 }
 
 void FloydContext::BecomeLeader() {
   role = Role::kLeader;
+  commit_times.clear();
   leader_ip = options.local_ip;
   leader_port = options.local_port;
 }
@@ -8,11 +8,14 @@
 
 #include <pthread.h>
 
+#include <deque>
 #include <string>
 #include <set>
+#include <utility>
 
 #include "floyd/include/floyd_options.h"
 #include "floyd/src/raft_log.h"
+#include "floyd/src/apply_waiters.h"
 
 #include "slash/include/slash_status.h"
 #include "slash/include/slash_mutex.h"
@@ -41,9 +44,9 @@ struct FloydContext {
       leader_port(0),
       vote_quorum(0),
       commit_index(0),
+      leader_match_index(0),
       last_applied(0),
-      last_op_time(0),
-      apply_cond(&apply_mu) {}
+      last_op_time(0) {}
 
   void RecoverInit(RaftMeta *raft);
   void BecomeFollower(uint64_t new_iterm,
@@ -63,16 +66,22 @@ struct FloydContext {
   uint32_t vote_quorum;
 
   uint64_t commit_index;
+  // my log up to leader_match_index is known to be the same with the log
+  // of current leader, the commit index in a LeaderHeartbeat is capped by it
+  uint64_t leader_match_index;
   std::atomic<uint64_t> last_applied;
   uint64_t last_op_time;
+  // when leader, the recent commit indexes and the time they are reached,
+  // for the latency until the followers apply them
+  std::deque<std::pair<uint64_t, uint64_t> > commit_times;
 
   std::set<std::string> members;
 
   // mutex protect commit_index
   // used in floyd_apply thread and floyd_peer thread
   slash::Mutex global_mu;
-  slash::Mutex apply_mu;
-  slash::CondVar apply_cond;
+  // the commands waiting for their entries to be applied
+  ApplyWaiters apply_waiters;
 };
 
 } // namespace floyd
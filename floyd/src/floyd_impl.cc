@@ -17,15 +17,20 @@
 #include "slash/include/slash_mutex.h"
 
 #include "floyd/src/floyd_context.h"
+#include "floyd/src/entry_codec.h"
 #include "floyd/src/floyd_apply.h"
 #include "floyd/src/floyd_worker.h"
 #include "floyd/src/raft_log.h"
+#include "floyd/src/log_storage.h"
 #include "floyd/src/floyd_peer_thread.h"
 #include "floyd/src/floyd_primary_thread.h"
 #include "floyd/src/floyd_client_pool.h"
 #include "floyd/src/logger.h"
 #include "floyd/src/floyd.pb.h"
 #include "floyd/src/raft_meta.h"
+#include "floyd/src/raft_snapshot.h"
+#include "floyd/src/rocksdb_state_machine.h"
+#include "floyd/src/memory_state_machine.h"
 
 namespace floyd {
 
@@ -109,6 +114,32 @@ static void BuildAppendEntriesResponse(bool succ, uint64_t term,
   append_entries_res->set_success(succ);
 }
 
+// the response to an AppendEntries whose prev_log_index doesn't match
+static void BuildConflictResponse(uint64_t term, uint64_t log_index,
+                                  uint64_t conflict_term, uint64_t conflict_index,
+                                  CmdResponse* response) {
+  BuildAppendEntriesResponse(false, term, log_index, response);
+  CmdResponse_AppendEntriesResponse* append_entries_res = response->mutable_append_entries_res();
+  append_entries_res->set_conflict_term(conflict_term);
+  append_entries_res->set_conflict_index(conflict_index);
+}
+
+static void BuildLeaderHeartbeatResponse(bool succ, uint64_t term,
+                                         CmdResponse* response) {
+  response->set_type(Type::kLeaderHeartbeat);
+  CmdResponse_LeaderHeartbeatResponse* leader_heartbeat_res = response->mutable_leader_heartbeat_res();
+  leader_heartbeat_res->set_term(term);
+  leader_heartbeat_res->set_success(succ);
+}
+
+static void BuildInstallSnapshotResponse(bool succ, uint64_t term,
+                                         CmdResponse* response) {
+  response->set_type(Type::kInstallSnapshot);
+  CmdResponse_InstallSnapshotResponse* install_snapshot_res = response->mutable_install_snapshot_res();
+  install_snapshot_res->set_term(term);
+  install_snapshot_res->set_success(succ);
+}
+
 static void BuildLogEntry(const CmdRequest& cmd, uint64_t current_term, Entry* entry) {
   entry->set_term(current_term);
   entry->set_key(cmd.kv_request().key());
@@ -139,6 +170,10 @@ static void BuildLogEntry(const CmdRequest& cmd, uint64_t current_term, Entry* e
   }
 }
 
+static void NotifyNewCommand(void* arg) {
+  reinterpret_cast<FloydPrimary*>(arg)->AddTask(kNewCommand);
+}
+
 static void BuildMembership(const std::vector<std::string>& opt_members,
     Membership* members) {
   members->Clear();
@@ -147,9 +182,48 @@ static void BuildMembership(const std::vector<std::string>& opt_members,
   }
 }
 
+/*
+ * check the entries of append_entries and get the term of every one, the
+ * raw entries are only read in place, the crc32c of them is verified unless
+ * the leader says they are unchecked
+ */
+static Status ParseAppendEntries(const CmdRequest_AppendEntries& append_entries,
+    std::vector<uint64_t>* terms) {
+  terms->clear();
+  if (append_entries.raw_entries_size() > 0) {
+    EntryView view;
+    for (int i = 0; i < append_entries.raw_entries_size(); i++) {
+      const std::string& buf = append_entries.raw_entries(i);
+      if (!IsCompactEntry(buf)) {
+        return Status::Corruption("raw entry " + std::to_string(i) + " is not in the compact format");
+      }
+      Status s = view.Parse(buf, !append_entries.raw_entries_unchecked());
+      if (!s.ok()) {
+        return Status::Corruption("raw entry " + std::to_string(i) + ": " + s.ToString());
+      }
+      terms->push_back(view.term());
+    }
+    return Status::OK();
+  }
+  if (!append_entries.checksums().empty()) {
+    Status s = VerifyEntries(append_entries.entries(), append_entries.checksums());
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  for (int i = 0; i < append_entries.entries_size(); i++) {
+    terms->push_back(append_entries.entries(i).term());
+  }
+  return Status::OK();
+}
+
 FloydImpl::FloydImpl(const Options& options)
-  : db_(NULL),
+  : state_machine_(NULL),
+    default_state_machine_(NULL),
     log_and_meta_(NULL),
+    log_cf_(NULL),
+    meta_cf_(NULL),
+    snapshot_writer_(NULL),
     options_(options),
     info_log_(NULL) {
 }
@@ -170,8 +244,13 @@ FloydImpl::~FloydImpl() {
   delete context_;
   delete raft_meta_;
   delete raft_log_;
+  delete snapshot_writer_;
+  delete snapshot_;
+  delete default_state_machine_;
   delete info_log_;
-  delete db_;
+  // column family handles must be released before the db
+  delete log_cf_;
+  delete meta_cf_;
   delete log_and_meta_;
 }
 
@@ -217,6 +296,8 @@ void FloydImpl::set_log_level(const int log_level) {
 }
 
 void FloydImpl::AddNewPeer(const std::string& server) {
+  slash::MutexLock l(&context_->global_mu);
+  context_->members.insert(server);
   if (IsSelf(server)) {
     return;
   }
@@ -226,25 +307,34 @@ void FloydImpl::AddNewPeer(const std::string& server) {
     LOGV(INFO_LEVEL, info_log_, "FloydImpl::ApplyAddMember server %s:%d add new peer thread %s",
         options_.local_ip.c_str(), options_.local_port, server.c_str());
     Peer* pt = new Peer(server, &peers_, context_, primary_, raft_meta_, raft_log_,
-        worker_client_pool_, apply_, options_, info_log_);
+        snapshot_, worker_client_pool_, apply_, options_, info_log_);
     peers_.insert(std::pair<std::string, Peer*>(server, pt));
     pt->Start();
   }
 }
 
 void FloydImpl::RemoveOutPeer(const std::string& server) {
+  Peer* peer = NULL;
+  {
+  slash::MutexLock l(&context_->global_mu);
+  context_->members.erase(server);
   if (IsSelf(server)) {
     return; 
   }
-  // Stop and remove peer
   auto peers_iter = peers_.find(server);
   if (peers_iter != peers_.end()) {
     LOGV(INFO_LEVEL, info_log_, "FloydImpl::ApplyRemoveMember server %s:%d remove peer thread %s",
         options_.local_ip.c_str(), options_.local_port, server.c_str());
-    peers_iter->second->Stop();
-    delete peers_iter->second;
+    peer = peers_iter->second;
     peers_.erase(peers_iter);
   }
+  }
+  // Stop and remove peer, its tasks lock global_mu, so it is stopped
+  // without holding it
+  if (peer != NULL) {
+    peer->Stop();
+    delete peer;
+  }
 }
 
 int FloydImpl::InitPeers() {
@@ -253,7 +343,7 @@ int FloydImpl::InitPeers() {
   for (auto iter = context_->members.begin(); iter != context_->members.end(); iter++) {
     if (!IsSelf(*iter)) {
       Peer* pt = new Peer(*iter, &peers_, context_, primary_, raft_meta_, raft_log_,
-          worker_client_pool_, apply_, options_, info_log_);
+          snapshot_, worker_client_pool_, apply_, options_, info_log_);
       peers_.insert(std::pair<std::string, Peer*>(*iter, pt));
     }
   }
@@ -267,7 +357,7 @@ int FloydImpl::InitPeers() {
       return ret;
     }
   }
-  LOGV(INFO_LEVEL, info_log_, "FloydImpl::InitPeers Floyd start %d peer thread", peers_.size());
+  LOGV(INFO_LEVEL, info_log_, "FloydImpl::InitPeers Floyd start %zu peer thread", peers_.size());
   return 0;
 }
 
@@ -280,35 +370,57 @@ Status FloydImpl::Init() {
   // TODO(anan) set timeout and retry
   worker_client_pool_ = new ClientPool(info_log_);
 
-  // Create DB
-  rocksdb::Options options;
-  options.create_if_missing = true;
-  options.write_buffer_size = 1024 * 1024 * 1024;
-  options.max_background_flushes = 8;
-  rocksdb::Status s = rocksdb::DB::Open(options, options_.path + "/db/", &db_);
-  if (!s.ok()) {
-    LOGV(ERROR_LEVEL, info_log_, "Open db failed! path: %s", options_.path.c_str());
-    return Status::Corruption("Open DB failed, " + s.ToString());
+  // Create state machine, a rocksdb by default
+  Status result;
+  if (options_.state_machine != NULL) {
+    state_machine_ = options_.state_machine;
+  } else if (options_.state_machine_engine == kMemoryStateMachine) {
+    default_state_machine_ = new MemoryStateMachine(info_log_);
+    state_machine_ = default_state_machine_;
+  } else {
+    RocksdbStateMachine* db;
+    result = RocksdbStateMachine::Open(options_.path + "/db/", info_log_, &db);
+    if (!result.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "Open db failed! path: %s", options_.path.c_str());
+      return Status::Corruption("Open DB failed, " + result.ToString());
+    }
+    default_state_machine_ = db;
+    state_machine_ = db;
   }
 
-  s = rocksdb::DB::Open(options, options_.path + "/log/", &log_and_meta_);
-  if (!s.ok()) {
+  result = OpenLogAndMetaDB(options_.path + "/log/", info_log_, &log_and_meta_,
+      &log_cf_, &meta_cf_);
+  if (!result.ok()) {
     LOGV(ERROR_LEVEL, info_log_, "Open DB log_and_meta failed! path: %s", options_.path.c_str());
-    return Status::Corruption("Open DB log_and_meta failed, " + s.ToString());
+    return Status::Corruption("Open DB log_and_meta failed, " + result.ToString());
+  }
+
+  LogStorage* log_storage;
+  result = OpenLogStorage(options_, log_and_meta_, log_cf_, info_log_, &log_storage);
+  if (!result.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "Open log storage failed! path: %s", options_.path.c_str());
+    return Status::Corruption("Open log storage failed, " + result.ToString());
   }
 
   // Recover Context
-  raft_log_ = new RaftLog(log_and_meta_, info_log_);
-  raft_meta_ = new RaftMeta(log_and_meta_, info_log_);
+  raft_log_ = new RaftLog(log_storage, info_log_, options_.log_cache_size, options_.log_sync_mode);
+  raft_meta_ = new RaftMeta(log_and_meta_, meta_cf_, info_log_, options_.commit_index_persist_us,
+      options_.log_sync_mode != kLogSyncNone);
   raft_meta_->Init();
+  snapshot_ = new RaftSnapshot(options_.path + "/snapshot", info_log_);
+  result = RecoverSnapshot();
+  if (!result.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "Recover snapshot failed! path: %s", options_.path.c_str());
+    return Status::Corruption("Recover snapshot failed, " + result.ToString());
+  }
   context_ = new FloydContext(options_);
   context_->RecoverInit(raft_meta_);
 
   // Recover Members when exist
   std::string mval;
   Membership db_members;
-  s = db_->Get(rocksdb::ReadOptions(), kMemberConfigKey, &mval);
-  if (s.ok()
+  result = state_machine_->Read(kMemberConfigKey, &mval);
+  if (result.ok()
       && db_members.ParseFromString(mval)) {
     // Prefer persistent membership than config
     LOGV(INFO_LEVEL, info_log_, "FloydImpl::Init: Load Membership from db, count: %d", db_members.nodes_size());
@@ -321,12 +433,14 @@ Status FloydImpl::Init() {
       LOGV(ERROR_LEVEL, info_log_, "Serialize Membership failed!");
       return Status::Corruption("Serialize Membership failed");
     }
-    s = db_->Put(rocksdb::WriteOptions(), kMemberConfigKey, mval);
-    if (!s.ok()) {
-      LOGV(ERROR_LEVEL, info_log_, "Record membership in db failed! error: %s", s.ToString().c_str());
-      return Status::Corruption("Record membership in db failed! error: " + s.ToString());
+    StateMachineBatch batch;
+    batch.Put(kMemberConfigKey, mval);
+    result = state_machine_->Apply(batch);
+    if (!result.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "Record membership in db failed! error: %s", result.ToString().c_str());
+      return Status::Corruption("Record membership in db failed! error: " + result.ToString());
     }
-    LOGV(INFO_LEVEL, info_log_, "FloydImpl::Init: Load Membership from option, count: %d", options_.members.size());
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::Init: Load Membership from option, count: %zu", options_.members.size());
     for (const auto& m : options_.members) {
       context_->members.insert(m);
     }
@@ -334,7 +448,7 @@ Status FloydImpl::Init() {
 
   // peers and primary refer to each other
   // Create PrimaryThread before Peers
-  primary_ = new FloydPrimary(context_, &peers_, raft_meta_, options_, info_log_);
+  primary_ = new FloydPrimary(context_, &peers_, raft_meta_, raft_log_, options_, info_log_);
 
   // Start worker thread after Peers, because WorkerHandle will check peers
   worker_ = new FloydWorker(options_.local_port, 1000, this);
@@ -344,7 +458,7 @@ Status FloydImpl::Init() {
     return Status::Corruption("failed to start worker, return " + std::to_string(ret));
   }
   // Apply thread should start at the last
-  apply_ = new FloydApply(context_, db_, raft_meta_, raft_log_, this, info_log_);
+  apply_ = new FloydApply(context_, state_machine_, raft_meta_, raft_log_, snapshot_, this, info_log_);
 
   InitPeers();
 
@@ -365,6 +479,68 @@ Status FloydImpl::Init() {
   return Status::OK();
 }
 
+/*
+ * the snapshot may be created but the meta is not updated before crash,
+ * the meta in the snapshot directory is always the newer one;
+ * a snapshot installed from leader is restored to db before it is
+ * recorded as applied, restore it again if interrupted
+ */
+Status FloydImpl::RecoverSnapshot() {
+  Status s = snapshot_->Recover();
+  if (!s.ok()) {
+    return s;
+  }
+  uint64_t index, term;
+  std::string members;
+  raft_meta_->GetSnapshotMeta(&index, &term, &members);
+  uint64_t snapshot_index, snapshot_term;
+  std::string snapshot_members;
+  s = snapshot_->LoadMeta(&snapshot_index, &snapshot_term, &snapshot_members);
+  if (s.ok() && snapshot_index > index) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::RecoverSnapshot: update snapshot meta from (%lu, %lu) to (%lu, %lu)",
+        index, term, snapshot_index, snapshot_term);
+    index = snapshot_index;
+    term = snapshot_term;
+    s = raft_meta_->SetSnapshotMeta(index, term, snapshot_members);
+    if (!s.ok()) {
+      return s;
+    }
+  } else if (!s.ok() && !s.IsNotFound()) {
+    return s;
+  }
+  if (index != 0 && raft_log_->TruncatePrefix(index, term) != 0) {
+    return Status::Corruption("truncate log prefix to " + std::to_string(index));
+  }
+  if (!state_machine_->Durable()) {
+    // the state machine is empty after restart, restore it from the snapshot
+    // and apply the log after the snapshot again
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::RecoverSnapshot: state machine is not durable, "
+        "restore it from snapshot %lu, last applied was %lu", index, raft_meta_->GetLastApplied());
+    if (index != 0) {
+      s = snapshot_->Restore(state_machine_, &index, &term, &members);
+      if (!s.ok()) {
+        return s;
+      }
+      if (raft_meta_->GetCommitIndex() < index) {
+        raft_meta_->SetCommitIndex(index);
+      }
+    }
+    raft_meta_->SetLastApplied(index);
+  } else if (raft_meta_->GetLastApplied() < index) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::RecoverSnapshot: last applied %lu is behind snapshot %lu, restore db",
+        raft_meta_->GetLastApplied(), index);
+    s = snapshot_->Restore(state_machine_, &index, &term, &members);
+    if (!s.ok()) {
+      return s;
+    }
+    if (raft_meta_->GetCommitIndex() < index) {
+      raft_meta_->SetCommitIndex(index);
+    }
+    raft_meta_->SetLastApplied(index);
+  }
+  return Status::OK();
+}
+
 Status Floyd::Open(const Options& options, Floyd** floyd) {
   *floyd = NULL;
   Status s;
@@ -428,7 +604,7 @@ Status FloydImpl::Read(const std::string& key, std::string* value) {
 }
 
 Status FloydImpl::DirtyRead(const std::string& key, std::string* value) {
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, value);
+  Status s = state_machine_->Read(key, value);
   if (s.ok()) {
     return Status::OK();
   } else if (s.IsNotFound()) {
@@ -517,9 +693,30 @@ Status FloydImpl::GetAllServers(std::set<std::string>* nodes) {
 bool FloydImpl::GetServerStatus(std::string* msg) {
   LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::GetServerStatus start");
   CmdResponse_ServerStatus server_status;
+  std::string peers_msg;
   {
   slash::MutexLock l(&context_->global_mu);
   DoGetServerStatus(&server_status);
+  if (context_->role == Role::kLeader) {
+    char peer_str[512];
+    for (auto& pt : peers_) {
+      BatchController* batch = pt.second->batch_controller();
+      snprintf (peer_str, sizeof(peer_str),
+                "Peer %s next_index: %lu, match_index: %lu, batch limit bytes: %lu, entries: %lu, "
+                "rtt: %lu us, apply lag: %lu, grows: %lu, shrinks: %lu, errors: %lu, last: %s\n",
+                pt.first.c_str(), pt.second->next_index(), pt.second->match_index(),
+                batch->size_limit(), batch->count_limit(), batch->rtt_us(), batch->apply_lag(),
+                batch->grows(), batch->shrinks(), batch->errors(),
+                BatchController::DecisionName(batch->decision()));
+      peers_msg.append(peer_str);
+      uint64_t count, total_us, max_us;
+      pt.second->GetApplyLatencyStats(&count, &total_us, &max_us);
+      snprintf (peer_str, sizeof(peer_str),
+                "Peer %s commit to apply count: %lu, avg: %lu us, max: %lu us\n",
+                pt.first.c_str(), count, count == 0 ? 0 : total_us / count, max_us);
+      peers_msg.append(peer_str);
+    }
+  }
   }
 
   char str[512];
@@ -534,6 +731,25 @@ bool FloydImpl::GetServerStatus(std::string* msg) {
 
   msg->clear();
   msg->append(str);
+
+  uint64_t hits, misses, count, bytes;
+  raft_log_->GetCacheStats(&hits, &misses, &count, &bytes);
+  snprintf (str, sizeof(str),
+            "LogCache hits: %lu, misses: %lu, entries: %lu, bytes: %lu\n",
+            hits, misses, count, bytes);
+  msg->append(str);
+  uint64_t groups, appends, syncs, sync_us, max_sync_us;
+  raft_log_->GetWriteStats(&groups, &appends, &syncs, &sync_us, &max_sync_us);
+  snprintf (str, sizeof(str),
+            "LogWrite groups: %lu, appends per group: %.2f, syncs: %lu, sync avg: %lu us, max: %lu us\n",
+            groups, groups == 0 ? 0.0 : static_cast<double>(appends) / groups,
+            syncs, syncs == 0 ? 0 : sync_us / syncs, max_sync_us);
+  msg->append(str);
+  snprintf (str, sizeof(str),
+            "Snapshot index: %lu, log bytes: %lu\n",
+            raft_log_->GetSnapshotIndex(), raft_log_->ApproximateBytes());
+  msg->append(str);
+  msg->append(peers_msg);
   return true;
 }
 
@@ -615,33 +831,47 @@ Status FloydImpl::ExecuteCommand(const CmdRequest& request,
   response->set_type(request.type());
   response->set_code(StatusCode::kError);
 
-  uint64_t last_log_index = raft_log_->Append(entries);
+  // the peers are notified as soon as the entry is written, so it is sent
+  // to them while my log is synced
+  uint64_t last_log_index = options_.single_mode ? raft_log_->Append(entries)
+    : raft_log_->Append(entries, &NotifyNewCommand, primary_);
   if (last_log_index <= 0) {
     return Status::IOError("Append Entry failed");
   }
 
-  // Notify primary then wait for apply
+  // my entry is persisted now, and counts toward the quorum, then wait
+  // for apply
   if (options_.single_mode) {
-    context_->commit_index = last_log_index;
-    raft_meta_->SetCommitIndex(context_->commit_index);
-    apply_->ScheduleApply();
+    // the writers of a group return in any order, the commit index never
+    // goes back
+    slash::MutexLock l(&context_->global_mu);
+    if (last_log_index > context_->commit_index) {
+      context_->commit_index = last_log_index;
+      raft_meta_->SetCommitIndex(context_->commit_index);
+      apply_->ScheduleApply();
+    }
   } else {
-    primary_->AddTask(kNewCommand);
+    slash::MutexLock l(&context_->global_mu);
+    if (context_->role == Role::kLeader && primary_->AdvanceLeaderCommitIndex()) {
+      apply_->ScheduleApply();
+    }
   }
 
-  {
-  slash::MutexLock l(&context_->apply_mu);
-  while (context_->last_applied < last_log_index) {
-    if (!context_->apply_cond.TimedWait(1000)) {
-      return Status::Timeout("FloydImpl::ExecuteCommand Timeout");
-    }
+  ApplyWaiters::Result result;
+  if (!context_->apply_waiters.Wait(last_log_index, 1000, &result)) {
+    return Status::Timeout("FloydImpl::ExecuteCommand Timeout");
+  }
+  if (result.term == 0) {
+    // the result is not known any more
+    return result.status;
   }
+  if (result.term != entry.term()) {
+    return Status::Incomplete("the entry is replaced by a new leader");
   }
 
   // Complete CmdRequest if needed
   std::string value;
-  rocksdb::Status rs;
-  Lock lock;
+  Status rs;
   switch (request.type()) {
     case Type::kWrite:
       response->set_code(StatusCode::kOk);
@@ -650,7 +880,7 @@ Status FloydImpl::ExecuteCommand(const CmdRequest& request,
       response->set_code(StatusCode::kOk);
       break;
     case Type::kRead:
-      rs = db_->Get(rocksdb::ReadOptions(), request.kv_request().key(), &value);
+      rs = state_machine_->Read(request.kv_request().key(), &value);
       if (rs.ok()) {
         BuildReadResponse(request.kv_request().key(), value, StatusCode::kOk, response);
       } else if (rs.IsNotFound()) {
@@ -663,23 +893,10 @@ Status FloydImpl::ExecuteCommand(const CmdRequest& request,
            rs.ToString().c_str(), request.kv_request().key().c_str(), value.c_str());
       break;
     case Type::kTryLock:
-      rs = db_->Get(rocksdb::ReadOptions(), request.lock_request().name(), &value);
-      if (rs.ok()) {
-        lock.ParseFromString(value);
-        if (lock.holder() == request.lock_request().holder() && lock.lease_end() == request.lock_request().lease_end()) {
-          response->set_code(StatusCode::kOk);
-        }
-      } else {
-        response->set_code(StatusCode::kLocked);
-      }
-      break;
     case Type::kUnLock:
-      rs = db_->Get(rocksdb::ReadOptions(), request.lock_request().name(), &value);
-      if (rs.IsNotFound()) {
-        response->set_code(StatusCode::kOk);
-      } else {
-        response->set_code(StatusCode::kLocked);
-      }
+      // the outcome when my entry is applied, the lock may have changed
+      // since then
+      response->set_code(result.status.ok() ? StatusCode::kOk : StatusCode::kLocked);
       break;
     case Type::kAddServer:
       response->set_code(StatusCode::kOk);
@@ -688,7 +905,7 @@ Status FloydImpl::ExecuteCommand(const CmdRequest& request,
       response->set_code(StatusCode::kOk);
       break;
     case Type::kGetAllServers:
-      rs = db_->Get(rocksdb::ReadOptions(), kMemberConfigKey, &value);
+      rs = state_machine_->Read(kMemberConfigKey, &value);
       if (!rs.ok()) {
         return Status::Corruption(rs.ToString());
       }
@@ -722,7 +939,8 @@ int FloydImpl::ReplyRequestVote(const CmdRequest& request, CmdResponse* response
    */
   if (request_vote.term() > context_->current_term) {
     context_->BecomeFollower(request_vote.term());
-    raft_meta_->SetCurrentTerm(context_->current_term);
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
   }
   // if caller's term smaller than my term, then I will notice him
   if (request_vote.term() < context_->current_term) {
@@ -762,9 +980,8 @@ int FloydImpl::ReplyRequestVote(const CmdRequest& request, CmdResponse* response
       " commit_index(%lu) last_applied(%lu)", request_vote.ip().c_str(), request_vote.port(),
       context_->current_term, request_vote.last_log_term(), my_last_log_index, context_->last_applied.load());
   context_->BecomeFollower(request_vote.term());
-  raft_meta_->SetCurrentTerm(context_->current_term);
-  raft_meta_->SetVotedForIp(context_->voted_for_ip);
-  raft_meta_->SetVotedForPort(context_->voted_for_port);
+  raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+      context_->voted_for_ip, context_->voted_for_port);
   // Got my vote
   GrantVote(request_vote.term(), request_vote.ip(), request_vote.port());
   granted = true;
@@ -781,14 +998,18 @@ bool FloydImpl::AdvanceFollowerCommitIndex(uint64_t leader_commit) {
    * If leaderCommit > commitIndex, set commitIndex =
    *   min(leaderCommit, index of last new entry)
    */
-  context_->commit_index = std::min(leader_commit, raft_log_->GetLastLogIndex());
+  uint64_t commit_index = std::min(leader_commit, raft_log_->GetLastLogIndex());
+  if (commit_index <= context_->commit_index) {
+    return false;
+  }
+  context_->commit_index = commit_index;
   raft_meta_->SetCommitIndex(context_->commit_index);
   return true;
 }
 
-int FloydImpl::ReplyAppendEntries(const CmdRequest& request, CmdResponse* response) {
+int FloydImpl::ReplyAppendEntries(CmdRequest* request, CmdResponse* response) {
   bool success = false;
-  CmdRequest_AppendEntries append_entries = request.append_entries();
+  const CmdRequest_AppendEntries& append_entries = request->append_entries();
   slash::MutexLock l(&context_->global_mu);
   // update last_op_time to avoid another leader election
   context_->last_op_time = slash::NowMicros();
@@ -809,67 +1030,121 @@ int FloydImpl::ReplyAppendEntries(const CmdRequest& request, CmdResponse* respon
         context_->current_term, context_->role, context_->leader_ip.c_str(), context_->leader_port);
     context_->BecomeFollower(append_entries.term(),
         append_entries.ip(), append_entries.port());
-    raft_meta_->SetCurrentTerm(context_->current_term);
-    raft_meta_->SetVotedForIp(context_->voted_for_ip);
-    raft_meta_->SetVotedForPort(context_->voted_for_port);
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
   }
 
-  if (append_entries.prev_log_index() > raft_log_->GetLastLogIndex()) {
-    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d prev_log_index %lu is larger than my %s:%d last_log_index %lu",
-        append_entries.ip().c_str(), append_entries.port(), append_entries.prev_log_index(), options_.local_ip.c_str(), options_.local_port,
-        raft_log_->GetLastLogIndex());
+  // the term of every entry sent
+  std::vector<uint64_t> terms;
+  Status s = ParseAppendEntries(append_entries, &terms);
+  if (!s.ok()) {
+    // the leader sends the entries again after the failure
+    LOGV(ERROR_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d sent broken entries after "
+        "prev_log_index %lu, error: %s", append_entries.ip().c_str(), append_entries.port(),
+        append_entries.prev_log_index(), s.ToString().c_str());
     BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
     return -1;
   }
 
-  // Append entry
-  if (append_entries.prev_log_index() < raft_log_->GetLastLogIndex()) {
-    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyAppendEtries: Leader %s:%d prev_log_index(%lu, %lu) is smaller than"
-        " my last_log_index %lu, truncate suffix from %lu", append_entries.ip().c_str(), append_entries.port(),
-        append_entries.prev_log_term(), append_entries.prev_log_index(), raft_log_->GetLastLogIndex(),
-        append_entries.prev_log_index() + 1);
-    raft_log_->TruncateSuffix(append_entries.prev_log_index() + 1);
+  /*
+   * the entries up to my snapshot index are committed, so they must be the
+   * same with leader's, skip them and start from the snapshot index
+   */
+  uint64_t prev_log_index = append_entries.prev_log_index();
+  uint64_t prev_log_term = append_entries.prev_log_term();
+  int skip_entries = 0;
+  uint64_t snapshot_index = raft_log_->GetSnapshotIndex();
+  if (prev_log_index < snapshot_index) {
+    skip_entries = std::min(snapshot_index - prev_log_index, (uint64_t)terms.size());
+    if (skip_entries > 0) {
+      prev_log_term = terms[skip_entries - 1];
+      prev_log_index += skip_entries;
+    }
+  }
+
+  if (prev_log_index > raft_log_->GetLastLogIndex()) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d prev_log_index %lu is larger than my %s:%d last_log_index %lu",
+        append_entries.ip().c_str(), append_entries.port(), prev_log_index, options_.local_ip.c_str(), options_.local_port,
+        raft_log_->GetLastLogIndex());
+    BuildConflictResponse(context_->current_term, raft_log_->GetLastLogIndex(),
+        0, raft_log_->GetLastLogIndex() + 1, response);
+    return -1;
   }
 
   // we compare peer's prev index and term with my last log index and term
   uint64_t my_last_log_term = 0;
-  Entry entry;
   LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries "
-      "prev_log_index: %lu\n", append_entries.prev_log_index());
-  if (append_entries.prev_log_index() == 0) {
-    my_last_log_term = 0;
-  } else if (raft_log_->GetEntry(append_entries.prev_log_index(), &entry) == 0) {
-    my_last_log_term = entry.term();
-  } else {
-    LOGV(WARN_LEVEL, info_log_, "FloydImple::ReplyAppentries: can't "
-        "get Entry from raft_log prev_log_index %llu", append_entries.prev_log_index());
-    BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
-    return -1;
+      "prev_log_index: %lu\n", prev_log_index);
+  if (prev_log_index != 0 && prev_log_index >= snapshot_index) {
+    // the term is answered from memory, no need to read the entry
+    my_last_log_term = raft_log_->GetTerm(prev_log_index);
+    if (my_last_log_term == 0) {
+      LOGV(WARN_LEVEL, info_log_, "FloydImple::ReplyAppentries: can't "
+          "get Entry from raft_log prev_log_index %lu", prev_log_index);
+      BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
+      return -1;
+    }
   }
 
-  if (append_entries.prev_log_term() != my_last_log_term) {
+  if (prev_log_index >= snapshot_index && prev_log_term != my_last_log_term) {
     LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyAppentries: leader %s:%d pre_log(%lu, %lu)'s term don't match with"
          " my log(%lu, %lu) term, truncate my log from %lu", append_entries.ip().c_str(), append_entries.port(),
-         append_entries.prev_log_term(), append_entries.prev_log_index(), my_last_log_term, raft_log_->GetLastLogIndex(),
-         append_entries.prev_log_index());
+         prev_log_term, prev_log_index, my_last_log_term, raft_log_->GetLastLogIndex(),
+         prev_log_index);
+    // tell leader the whole conflicting term, so it skips the term at once
+    uint64_t conflict_term, conflict_index;
+    raft_log_->GetConflictHint(prev_log_index, &conflict_term, &conflict_index);
     // TruncateSuffix [prev_log_index, last_log_index)
-    raft_log_->TruncateSuffix(append_entries.prev_log_index());
-    BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
+    raft_log_->TruncateSuffix(prev_log_index);
+    context_->leader_match_index = std::min(context_->leader_match_index, prev_log_index - 1);
+    BuildConflictResponse(context_->current_term, raft_log_->GetLastLogIndex(),
+        conflict_term, conflict_index, response);
     return -1;
   }
 
-  std::vector<const Entry*> entries;
-  for (int i = 0; i < append_entries.entries().size(); i++) {
-    entries.push_back(&append_entries.entries(i));
+  /*
+   * a pipelined or resent AppendEntries may carry the entries I already
+   * have, skip them and truncate my log only from the first conflict, so
+   * the entries acked to the leader are never dropped
+   */
+  uint64_t last_log_index = raft_log_->GetLastLogIndex();
+  uint64_t index = prev_log_index + 1;
+  size_t first_new = skip_entries;
+  while (first_new < terms.size() && index <= last_log_index
+      && raft_log_->GetTerm(index) == terms[first_new]) {
+    first_new++;
+    index++;
+  }
+  if (first_new < terms.size() && index <= last_log_index) {
+    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyAppendEtries: Leader %s:%d entry %lu conflicts with"
+        " my log, truncate suffix from %lu, my last_log_index %lu", append_entries.ip().c_str(),
+        append_entries.port(), index, index, last_log_index);
+    raft_log_->TruncateSuffix(index);
+    context_->leader_match_index = std::min(context_->leader_match_index, index - 1);
   }
-  if (append_entries.entries().size() > 0) {
-    LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d will append %u entries from "
+  // the index of the last entry sent by leader, my log after it is not
+  // verified yet and can't be committed
+  uint64_t last_new_index = prev_log_index + terms.size() - skip_entries;
+
+  if (first_new < terms.size()) {
+    // the raw entries are moved out of the request and stored as they
+    // are, only the old entries are encoded here
+    std::vector<std::string> bufs(terms.size() - first_new);
+    for (size_t i = first_new; i < terms.size(); i++) {
+      if (append_entries.raw_entries_size() > 0) {
+        bufs[i - first_new].swap(*request->mutable_append_entries()->mutable_raw_entries(i));
+      } else {
+        EncodeEntry(append_entries.entries(i), &bufs[i - first_new]);
+      }
+    }
+    std::vector<uint64_t> new_terms(terms.begin() + first_new, terms.end());
+    LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d will append %zu entries from "
          " prev_log_index %lu", append_entries.ip().c_str(), append_entries.port(),
-         append_entries.entries().size(), append_entries.prev_log_index());
-    if (raft_log_->Append(entries) <= 0) {
-      LOGV(ERROR_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d ppend %u entries from "
+         bufs.size(), prev_log_index);
+    if (raft_log_->AppendEncoded(&bufs, new_terms) <= 0) {
+      LOGV(ERROR_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Leader %s:%d ppend %zu entries from "
           " prev_log_index %lu error at term %lu", append_entries.ip().c_str(), append_entries.port(),
-          append_entries.entries().size(), append_entries.prev_log_index(), append_entries.term());
+          new_terms.size(), prev_log_index, append_entries.term());
       BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
       return -1;
     }
@@ -877,18 +1152,215 @@ int FloydImpl::ReplyAppendEntries(const CmdRequest& request, CmdResponse* respon
     LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries: Receive PingPong AppendEntries from %s:%d at term %lu",
         append_entries.ip().c_str(), append_entries.port(), append_entries.term());
   }
-  if (append_entries.leader_commit() != context_->commit_index) {
-    AdvanceFollowerCommitIndex(append_entries.leader_commit());
+  // never ack the entries I have but not persisted yet, the leader asks
+  // again for them instead of sending them again
+  uint64_t match_index = std::min(raft_log_->GetPersistedIndex(), last_new_index);
+  // the committed entries are persisted on a majority, I can apply them
+  // before mine are synced
+  if (append_entries.leader_commit() > context_->commit_index
+      && AdvanceFollowerCommitIndex(std::min(append_entries.leader_commit(), last_new_index))) {
     apply_->ScheduleApply();
   }
   success = true;
   // only when follower successfully do appendentries, we will update commit index
-  LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries server %s:%d Apply %d entries from Leader %s:%d"
+  LOGV(DEBUG_LEVEL, info_log_, "FloydImpl::ReplyAppendEntries server %s:%d Apply %zu entries from Leader %s:%d"
       " prev_log_index %lu, leader commit %lu at term %lu", options_.local_ip.c_str(),
-      options_.local_port, append_entries.entries().size(), append_entries.ip().c_str(),
-      append_entries.port(), append_entries.prev_log_index(), append_entries.leader_commit(),
+      options_.local_port, terms.size(), append_entries.ip().c_str(),
+      append_entries.port(), prev_log_index, append_entries.leader_commit(),
       append_entries.term());
   BuildAppendEntriesResponse(success, context_->current_term, raft_log_->GetLastLogIndex(), response);
+  response->mutable_append_entries_res()->set_match_index(match_index);
+  // my log up to the last entry sent matches the leader's log now
+  if (last_new_index > context_->leader_match_index) {
+    context_->leader_match_index = last_new_index;
+  }
+  // the leader shrinks the batches when I fall behind in applying
+  response->mutable_append_entries_res()->set_last_applied(context_->last_applied);
+  return 0;
+}
+
+int FloydImpl::ReplyLeaderHeartbeat(const CmdRequest& request, CmdResponse* response) {
+  const CmdRequest_LeaderHeartbeat& leader_heartbeat = request.leader_heartbeat();
+  slash::MutexLock l(&context_->global_mu);
+  if (leader_heartbeat.term() < context_->current_term) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyLeaderHeartbeat: Leader %s:%d term %lu is smaller than my %s:%d current term %lu",
+        leader_heartbeat.ip().c_str(), leader_heartbeat.port(), leader_heartbeat.term(), options_.local_ip.c_str(),
+        options_.local_port, context_->current_term);
+    BuildLeaderHeartbeatResponse(false, context_->current_term, response);
+    return -1;
+  } else if ((leader_heartbeat.term() > context_->current_term)
+      || (leader_heartbeat.term() == context_->current_term &&
+        (context_->role == kCandidate || (context_->role == kFollower && context_->leader_ip == "")))) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyLeaderHeartbeat: Leader %s:%d term %lu is larger than my %s:%d current term %lu, "
+        "or leader term is equal to my current term, my role is %d, leader is [%s:%d]",
+        leader_heartbeat.ip().c_str(), leader_heartbeat.port(), leader_heartbeat.term(), options_.local_ip.c_str(),
+        options_.local_port, context_->current_term, context_->role, context_->leader_ip.c_str(), context_->leader_port);
+    context_->BecomeFollower(leader_heartbeat.term(),
+        leader_heartbeat.ip(), leader_heartbeat.port());
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
+  }
+  // update last_op_time to avoid another leader election
+  context_->last_op_time = slash::NowMicros();
+
+  // without prev_log_index, only the entries an AppendEntries of this
+  // leader has verified can be committed
+  if (leader_heartbeat.leader_commit() > context_->commit_index
+      && AdvanceFollowerCommitIndex(std::min(leader_heartbeat.leader_commit(), context_->leader_match_index))) {
+    apply_->ScheduleApply();
+  }
+  BuildLeaderHeartbeatResponse(true, context_->current_term, response);
+  response->mutable_leader_heartbeat_res()->set_last_applied(context_->last_applied);
+  return 0;
+}
+
+int FloydImpl::ReplyInstallSnapshot(const CmdRequest& request, CmdResponse* response) {
+  const CmdRequest_InstallSnapshot& install_snapshot = request.install_snapshot();
+  uint64_t index = install_snapshot.last_included_index();
+  uint64_t term = install_snapshot.last_included_term();
+  // the chunks are written and synced without global_mu, so the other
+  // rpcs and the apply thread are not blocked by the disk
+  slash::MutexLock sl(&snapshot_mu_);
+  uint64_t current_term;
+  {
+  slash::MutexLock l(&context_->global_mu);
+  // update last_op_time to avoid another leader election
+  context_->last_op_time = slash::NowMicros();
+  if (install_snapshot.term() < context_->current_term) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: Leader %s:%d term %lu is smaller than my %s:%d current term %lu",
+        install_snapshot.ip().c_str(), install_snapshot.port(), install_snapshot.term(), options_.local_ip.c_str(),
+        options_.local_port, context_->current_term);
+    BuildInstallSnapshotResponse(false, context_->current_term, response);
+    return -1;
+  } else if ((install_snapshot.term() > context_->current_term)
+      || (install_snapshot.term() == context_->current_term &&
+        (context_->role == kCandidate || (context_->role == kFollower && context_->leader_ip == "")))) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: Leader %s:%d term %lu is larger than my %s:%d current term %lu, "
+        "or leader term is equal to my current term, my role is %d, leader is [%s:%d]",
+        install_snapshot.ip().c_str(), install_snapshot.port(), install_snapshot.term(), options_.local_ip.c_str(),
+        options_.local_port, context_->current_term, context_->role, context_->leader_ip.c_str(), context_->leader_port);
+    context_->BecomeFollower(install_snapshot.term(),
+        install_snapshot.ip(), install_snapshot.port());
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
+  }
+  current_term = context_->current_term;
+  }
+
+  if (install_snapshot.done() && index <= raft_log_->GetSnapshotIndex()) {
+    // installed already, the ack of the last chunk may be lost
+    BuildInstallSnapshotResponse(true, current_term, response);
+    return 0;
+  }
+
+  std::string leader = slash::IpPortString(install_snapshot.ip(), install_snapshot.port());
+  uint64_t seq = install_snapshot.seq();
+  if (seq == 0) {
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: receive snapshot (%lu, %lu) from Leader %s",
+        index, term, leader.c_str());
+    delete snapshot_writer_;
+    snapshot_writer_ = new SnapshotWriter(snapshot_->RecvPath(), leader, index, term);
+    Status s = snapshot_writer_->Open();
+    if (!s.ok()) {
+      LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: open snapshot writer failed, error: %s",
+          s.ToString().c_str());
+      delete snapshot_writer_;
+      snapshot_writer_ = NULL;
+      BuildInstallSnapshotResponse(false, current_term, response);
+      return -1;
+    }
+  } else if (snapshot_writer_ == NULL || snapshot_writer_->leader() != leader
+      || snapshot_writer_->index() != index || snapshot_writer_->term() != term
+      || seq > snapshot_writer_->next_seq()) {
+    // the chunks before are lost, let the leader start over
+    LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: unexpected chunk %lu of snapshot (%lu, %lu) "
+        "from Leader %s", seq, index, term, leader.c_str());
+    BuildInstallSnapshotResponse(false, current_term, response);
+    return -1;
+  } else if (seq < snapshot_writer_->next_seq()) {
+    // the ack is lost and the leader sends the chunk again
+    BuildInstallSnapshotResponse(true, current_term, response);
+    return 0;
+  }
+
+  Status s = snapshot_writer_->Write(install_snapshot.filename(), install_snapshot.offset(),
+      install_snapshot.data());
+  if (s.ok() && install_snapshot.done()) {
+    s = snapshot_writer_->Sync();
+    if (s.ok()) {
+      s = snapshot_->Install(index, term);
+    }
+    delete snapshot_writer_;
+    snapshot_writer_ = NULL;
+    if (s.IsIncomplete() && raft_log_->GetSnapshotIndex() >= index) {
+      // I have a newer snapshot myself
+      BuildInstallSnapshotResponse(true, current_term, response);
+      return 0;
+    } else if (s.IsIncomplete()) {
+      // installed by a former request, whose switch of the meta and log failed
+      s = Status::OK();
+    }
+  }
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: receive chunk %lu of snapshot (%lu, %lu) failed, "
+        "error: %s", seq, index, term, s.ToString().c_str());
+    delete snapshot_writer_;
+    snapshot_writer_ = NULL;
+    BuildInstallSnapshotResponse(false, current_term, response);
+    return -1;
+  }
+  if (!install_snapshot.done()) {
+    BuildInstallSnapshotResponse(true, current_term, response);
+    return 0;
+  }
+
+  uint64_t snapshot_index, snapshot_term;
+  std::string members;
+  s = snapshot_->LoadMeta(&snapshot_index, &snapshot_term, &members);
+  if (s.ok() && snapshot_index > index) {
+    // the apply thread has created a newer one, and switches to it itself
+    BuildInstallSnapshotResponse(true, current_term, response);
+    return 0;
+  }
+  if (!s.ok()) {
+    // my log and meta are untouched, the leader sends the snapshot again
+    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: load meta of snapshot (%lu, %lu) failed, "
+        "error: %s", index, term, s.ToString().c_str());
+    BuildInstallSnapshotResponse(false, current_term, response);
+    return -1;
+  }
+
+  /*
+   * the snapshot replaces my log, keep the entries after it only if the
+   * entry at index matches, the apply thread restores db from the snapshot
+   * since the entries before are dropped
+   * the entries in the snapshot are committed, so it is installed even if
+   * the term changed while the chunks were written
+   */
+  slash::MutexLock l(&context_->global_mu);
+  s = raft_meta_->SetSnapshotMeta(index, term, members);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: update snapshot meta to (%lu, %lu) failed, "
+        "error: %s", index, term, s.ToString().c_str());
+    BuildInstallSnapshotResponse(false, context_->current_term, response);
+    return -1;
+  }
+  if (raft_log_->GetTerm(index) != term) {
+    raft_log_->TruncateSuffix(raft_log_->GetSnapshotIndex() + 1);
+  }
+  if (raft_log_->TruncatePrefix(index, term) != 0) {
+    LOGV(WARN_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: truncate log prefix to %lu failed", index);
+    BuildInstallSnapshotResponse(false, context_->current_term, response);
+    return -1;
+  }
+  if (context_->commit_index < index) {
+    context_->commit_index = index;
+    raft_meta_->SetCommitIndex(index);
+  }
+  apply_->ScheduleApply();
+  LOGV(INFO_LEVEL, info_log_, "FloydImpl::ReplyInstallSnapshot: install snapshot (%lu, %lu) from Leader %s, "
+      "last_log_index %lu", index, term, leader.c_str(), raft_log_->GetLastLogIndex());
+  BuildInstallSnapshotResponse(true, context_->current_term, response);
   return 0;
 }
 
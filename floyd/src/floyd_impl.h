@@ -17,6 +17,7 @@
 
 #include "floyd/include/floyd.h"
 #include "floyd/include/floyd_options.h"
+#include "floyd/include/floyd_state_machine.h"
 #include "floyd/src/raft_log.h"
 
 namespace floyd {
@@ -25,6 +26,8 @@ using slash::Status;
 class Log;
 class ClientPool;
 class RaftMeta;
+class RaftSnapshot;
+class SnapshotWriter;
 class Peer;
 class FloydPrimary;
 class FloydApply;
@@ -73,7 +76,8 @@ class FloydImpl : public Floyd {
   virtual bool GetServerStatus(std::string* msg);
   // log level can be modified
   void set_log_level(const int log_level);
-  // used when membership changed
+  // used when membership changed, context_->members and peers_ are
+  // updated with context_->global_mu held
   void AddNewPeer(const std::string& server);
   void RemoveOutPeer(const std::string& server);
 
@@ -83,12 +87,24 @@ class FloydImpl : public Floyd {
   friend class FloydWorkerHandle;
   friend class Peer;
 
-  rocksdb::DB* db_;
-  // state machine db point
+  // where the committed entries are applied, options_.state_machine or
+  // default_state_machine_
+  StateMachine* state_machine_;
+  // the rocksdb state machine opened when options_.state_machine is NULL
+  StateMachine* default_state_machine_;
   // raft log
   rocksdb::DB* log_and_meta_;  // used to store logs and meta data
+  rocksdb::ColumnFamilyHandle* log_cf_;
+  rocksdb::ColumnFamilyHandle* meta_cf_;
   RaftLog* raft_log_;
   RaftMeta* raft_meta_;
+  // snapshot of the state machine db
+  RaftSnapshot* snapshot_;
+  // the snapshot being received from leader, NULL if none, the chunks are
+  // written with snapshot_mu_ held but not context_->global_mu, if both are
+  // needed, snapshot_mu_ is locked first
+  slash::Mutex snapshot_mu_;
+  SnapshotWriter* snapshot_writer_;
 
   Options options_;
   // debug log used for ouput to file
@@ -112,14 +128,19 @@ class FloydImpl : public Floyd {
   void GrantVote(uint64_t term, const std::string ip, int port);
 
   /*
-   * these two are the response to the request vote and appendentries
+   * these are the response to the request vote, appendentries
+   * and installsnapshot
    */
   int ReplyRequestVote(const CmdRequest& cmd, CmdResponse* cmd_res);
-  int ReplyAppendEntries(const CmdRequest& cmd, CmdResponse* cmd_res);
+  // the raw entries of cmd are taken
+  int ReplyAppendEntries(CmdRequest* cmd, CmdResponse* cmd_res);
+  int ReplyInstallSnapshot(const CmdRequest& cmd, CmdResponse* cmd_res);
+  int ReplyLeaderHeartbeat(const CmdRequest& cmd, CmdResponse* cmd_res);
 
   bool AdvanceFollowerCommitIndex(uint64_t new_commit_index);
 
   int InitPeers();
+  Status RecoverSnapshot();
 
   // No coping allowed
   FloydImpl(const FloydImpl&);
@@ -43,41 +43,121 @@ void Options::Dump() {
           "                     path : %s\n"
           "          check_leader_us : %ld\n"
           "             heartbeat_us : %ld\n"
+          "       light_heartbeat_us : %lu\n"
           " append_entries_size_once : %ld\n"
           "append_entries_count_once : %lu\n"
-          "              single_mode : %s\n",
+          "    append_entries_window : %d\n"
+          "           adaptive_batch : %s\n"
+          "  append_entries_size_min : %lu\n"
+          " append_entries_count_min : %lu\n"
+          "append_entries_target_rtt_us : %lu\n"
+          "append_entries_apply_lag_limit : %lu\n"
+          "              single_mode : %s\n"
+          "               log_engine : %s\n"
+          "         log_segment_size : %lu\n"
+          "            log_sync_mode : %s\n"
+          "           log_cache_size : %lu\n"
+          "         snapshot_entries : %lu\n"
+          "        snapshot_log_size : %lu\n"
+          "     snapshot_interval_us : %lu\n"
+          "      snapshot_chunk_size : %lu\n"
+          "            lazy_checksum : %s\n"
+          "  commit_index_persist_us : %lu\n"
+          "            apply_threads : %d\n"
+          "            state_machine : %s\n",
             local_ip.c_str(),
             local_port,
             path.c_str(),
             check_leader_us,
             heartbeat_us,
+            light_heartbeat_us,
             append_entries_size_once,
             append_entries_count_once,
-            single_mode ? "true" : "false");
+            append_entries_window,
+            adaptive_batch ? "true" : "false",
+            append_entries_size_min,
+            append_entries_count_min,
+            append_entries_target_rtt_us,
+            append_entries_apply_lag_limit,
+            single_mode ? "true" : "false",
+            log_engine == kSegmentLog ? "segment" : "rocksdb",
+            log_segment_size,
+            log_sync_mode == kLogSyncNone ? "none" :
+              (log_sync_mode == kLogSyncGroup ? "group" : "every_write"),
+            log_cache_size,
+            snapshot_entries,
+            snapshot_log_size,
+            snapshot_interval_us,
+            snapshot_chunk_size,
+            lazy_checksum ? "true" : "false",
+            commit_index_persist_us,
+            apply_threads,
+            state_machine != NULL ? "custom" :
+              (state_machine_engine == kMemoryStateMachine ? "memory" : "rocksdb"));
 }
 
 std::string Options::ToString() {
-  char str[1024];
+  char str[2048];
   int len = 0;
   for (size_t i = 0; i < members.size(); i++) {
-    len += snprintf(str + len, sizeof(str), "                 member %lu : %s\n", i, members[i].c_str());
+    len += snprintf(str + len, sizeof(str) - len, "                 member %lu : %s\n", i, members[i].c_str());
   }
-  snprintf(str + len, sizeof(str), "                 local_ip : %s\n"
+  snprintf(str + len, sizeof(str) - len, "                 local_ip : %s\n"
           "               local_port : %d\n"
           "                     path : %s\n"
           "          check_leader_us : %ld\n"
           "             heartbeat_us : %ld\n"
+          "       light_heartbeat_us : %lu\n"
           " append_entries_size_once : %ld\n"
           "append_entries_count_once : %lu\n"
-          "              single_mode : %s\n",
+          "    append_entries_window : %d\n"
+          "           adaptive_batch : %s\n"
+          "  append_entries_size_min : %lu\n"
+          " append_entries_count_min : %lu\n"
+          "append_entries_target_rtt_us : %lu\n"
+          "append_entries_apply_lag_limit : %lu\n"
+          "              single_mode : %s\n"
+          "               log_engine : %s\n"
+          "         log_segment_size : %lu\n"
+          "            log_sync_mode : %s\n"
+          "           log_cache_size : %lu\n"
+          "         snapshot_entries : %lu\n"
+          "        snapshot_log_size : %lu\n"
+          "     snapshot_interval_us : %lu\n"
+          "      snapshot_chunk_size : %lu\n"
+          "            lazy_checksum : %s\n"
+          "  commit_index_persist_us : %lu\n"
+          "            apply_threads : %d\n"
+          "            state_machine : %s\n",
             local_ip.c_str(),
             local_port,
             path.c_str(),
             check_leader_us,
             heartbeat_us,
+            light_heartbeat_us,
             append_entries_size_once,
             append_entries_count_once,
-            single_mode ? "true" : "false");
+            append_entries_window,
+            adaptive_batch ? "true" : "false",
+            append_entries_size_min,
+            append_entries_count_min,
+            append_entries_target_rtt_us,
+            append_entries_apply_lag_limit,
+            single_mode ? "true" : "false",
+            log_engine == kSegmentLog ? "segment" : "rocksdb",
+            log_segment_size,
+            log_sync_mode == kLogSyncNone ? "none" :
+              (log_sync_mode == kLogSyncGroup ? "group" : "every_write"),
+            log_cache_size,
+            snapshot_entries,
+            snapshot_log_size,
+            snapshot_interval_us,
+            snapshot_chunk_size,
+            lazy_checksum ? "true" : "false",
+            commit_index_persist_us,
+            apply_threads,
+            state_machine != NULL ? "custom" :
+              (state_machine_engine == kMemoryStateMachine ? "memory" : "rocksdb"));
   return str;
 }
 
@@ -87,9 +167,29 @@ Options::Options()
     path("/data/floyd"),
     check_leader_us(6000000),
     heartbeat_us(3000000),
+    light_heartbeat_us(0),
     append_entries_size_once(10240000),
     append_entries_count_once(102400),
-    single_mode(false) {
+    append_entries_window(1),
+    adaptive_batch(false),
+    append_entries_size_min(64 * 1024),
+    append_entries_count_min(64),
+    append_entries_target_rtt_us(20000),
+    append_entries_apply_lag_limit(100000),
+    single_mode(false),
+    log_engine(kRocksdbLog),
+    log_segment_size(64 * 1024 * 1024),
+    log_sync_mode(kLogSyncGroup),
+    log_cache_size(16 * 1024 * 1024),
+    snapshot_entries(1000000),
+    snapshot_log_size(1024 * 1024 * 1024),
+    snapshot_interval_us(0),
+    snapshot_chunk_size(1024 * 1024),
+    lazy_checksum(false),
+    commit_index_persist_us(0),
+    apply_threads(1),
+    state_machine(NULL),
+    state_machine_engine(kRocksdbStateMachine) {
     }
 
 Options::Options(const std::string& cluster_string,
@@ -100,9 +200,29 @@ Options::Options(const std::string& cluster_string,
     path(_path),
     check_leader_us(6000000),
     heartbeat_us(3000000),
+    light_heartbeat_us(0),
     append_entries_size_once(10240000),
     append_entries_count_once(102400),
-    single_mode(false) {
+    append_entries_window(1),
+    adaptive_batch(false),
+    append_entries_size_min(64 * 1024),
+    append_entries_count_min(64),
+    append_entries_target_rtt_us(20000),
+    append_entries_apply_lag_limit(100000),
+    single_mode(false),
+    log_engine(kRocksdbLog),
+    log_segment_size(64 * 1024 * 1024),
+    log_sync_mode(kLogSyncGroup),
+    log_cache_size(16 * 1024 * 1024),
+    snapshot_entries(1000000),
+    snapshot_log_size(1024 * 1024 * 1024),
+    snapshot_interval_us(0),
+    snapshot_chunk_size(1024 * 1024),
+    lazy_checksum(false),
+    commit_index_persist_us(0),
+    apply_threads(1),
+    state_machine(NULL),
+    state_machine_engine(kRocksdbStateMachine) {
   std::srand(slash::NowMicros());
   // the default check_leader is [3s, 5s)
   // the default heartbeat time is 1s
@@ -7,13 +7,17 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <sys/socket.h>
+
 #include <algorithm>
 #include <climits>
+#include <memory>
 #include <vector>
 #include <string>
 
 #include "slash/include/env.h"
 #include "slash/include/slash_mutex.h"
+#include "slash/include/slash_string.h"
 #include "slash/include/xdebug.h"
 
 #include "floyd/src/floyd_primary_thread.h"
@@ -23,18 +27,27 @@
 #include "floyd/src/floyd.pb.h"
 #include "floyd/src/logger.h"
 #include "floyd/src/raft_meta.h"
+#include "floyd/src/raft_snapshot.h"
 #include "floyd/src/floyd_apply.h"
 
 namespace floyd {
 
+// send and recv timeout of the pipelined AppendEntries
+static const int kPipelineTimeoutMs = 2000;
+// send and recv timeout of the LeaderHeartbeat, a heartbeat lost is sent
+// again soon
+static const int kHeartbeatTimeoutMs = 500;
+
 Peer::Peer(std::string server, PeersSet* peers, FloydContext* context, FloydPrimary* primary, RaftMeta* raft_meta,
-    RaftLog* raft_log, ClientPool* pool, FloydApply* apply, const Options& options, Logger* info_log)
+    RaftLog* raft_log, RaftSnapshot* snapshot, ClientPool* pool, FloydApply* apply,
+    const Options& options, Logger* info_log)
   : peer_addr_(server),
     peers_(peers),
     context_(context),
     primary_(primary),
     raft_meta_(raft_meta),
     raft_log_(raft_log),
+    snapshot_(snapshot),
     pool_(pool),
     apply_(apply),
     options_(options),
@@ -42,24 +55,75 @@ Peer::Peer(std::string server, PeersSet* peers, FloydContext* context, FloydPrim
     next_index_(1),
     match_index_(0),
     peer_last_op_time(0),
-    bg_thread_(1024 * 1024 * 256) {
+    snapshot_reader_(NULL),
+    batch_(options),
+    sent_commit_index_(0),
+    match_pending_(false),
+    commit_queued_(false),
+    measured_index_(0),
+    apply_latency_count_(0),
+    apply_latency_us_(0),
+    max_apply_latency_us_(0),
+    bg_thread_(1024 * 1024 * 256),
+    pipeline_cli_(NULL),
+    pipeline_epoch_(0),
+    recv_thread_(1024 * 1024 * 256),
+    heartbeat_cli_(NULL),
+    heartbeat_queued_(false),
+    heartbeat_thread_(16) {
       next_index_ = raft_log_->GetLastLogIndex() + 1;
       match_index_ = raft_meta_->GetLastApplied();
+      if (options_.append_entries_window > 1) {
+        std::string ip;
+        int port;
+        slash::ParseIpPortString(peer_addr_, ip, port);
+        pipeline_cli_ = pink::NewPbCli(ip, port);
+      }
+      if (options_.light_heartbeat_us > 0) {
+        std::string ip;
+        int port;
+        slash::ParseIpPortString(peer_addr_, ip, port);
+        heartbeat_cli_ = pink::NewPbCli(ip, port);
+      }
 }
 
 int Peer::Start() {
   std::string name = "P" + std::to_string(options_.local_port) + ":" + peer_addr_.substr(peer_addr_.find(':'));
   bg_thread_.set_thread_name(name);
   LOGV(INFO_LEVEL, info_log_, "Peer::Start Start a peer thread to %s", peer_addr_.c_str());
+  if (pipeline_cli_ != NULL) {
+    recv_thread_.set_thread_name("R" + name.substr(1));
+    int ret = recv_thread_.StartThread();
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  if (heartbeat_cli_ != NULL) {
+    heartbeat_thread_.set_thread_name("H" + name.substr(1));
+    int ret = heartbeat_thread_.StartThread();
+    if (ret != 0) {
+      return ret;
+    }
+  }
   return bg_thread_.StartThread();
 }
 
 Peer::~Peer() {
+  delete snapshot_reader_;
+  delete pipeline_cli_;
+  delete heartbeat_cli_;
   LOGV(INFO_LEVEL, info_log_, "Peer::~Peer peer thread %s exit", peer_addr_.c_str());
 }
 
 int Peer::Stop() {
-  return bg_thread_.StopThread();
+  int ret = bg_thread_.StopThread();
+  if (pipeline_cli_ != NULL) {
+    recv_thread_.StopThread();
+  }
+  if (heartbeat_cli_ != NULL) {
+    heartbeat_thread_.StopThread();
+  }
+  return ret;
 }
 
 bool Peer::CheckAndVote(uint64_t vote_term) {
@@ -105,7 +169,7 @@ void Peer::RequestVoteRPC() {
   request_vote->set_term(context_->current_term);
   request_vote->set_last_log_term(last_log_term);
   request_vote->set_last_log_index(last_log_index);
-  LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC server %s:%d Send RequestVoteRPC message to %s at term %d",
+  LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC server %s:%d Send RequestVoteRPC message to %s at term %lu",
       options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), context_->current_term);
   }
 
@@ -133,33 +197,34 @@ void Peer::RequestVoteRPC() {
         " request_vote_res.term()=%lu, current_term=%lu", options_.local_ip.c_str(), options_.local_port,
         peer_addr_.c_str(), res.request_vote_res().term(), context_->current_term);
     context_->BecomeFollower(res.request_vote_res().term());
-    raft_meta_->SetCurrentTerm(context_->current_term);
-    raft_meta_->SetVotedForIp(context_->voted_for_ip);
-    raft_meta_->SetVotedForPort(context_->voted_for_port);
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
     return;
   }
   if (context_->role == Role::kCandidate) {
     // kOk means RequestVote success, opposite vote for me
     if (res.request_vote_res().vote_granted() == true) {    // granted
-      LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: Candidate %s:%d get vote from node %s at term %d",
+      LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: Candidate %s:%d get vote from node %s at term %lu",
           options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), context_->current_term);
       // However, we need check whether this vote is vote for old term
       // we need ignore these type of vote
       if (CheckAndVote(res.request_vote_res().term())) {
         context_->BecomeLeader();
         UpdatePeerInfo();
-        LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: %s:%d become leader at term %d",
+        LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: %s:%d become leader at term %lu",
             options_.local_ip.c_str(), options_.local_port, context_->current_term);
         primary_->AddTask(kHeartBeat, false);
+        if (options_.light_heartbeat_us > 0) {
+          primary_->AddTask(kLightHeartBeat, false);
+        }
       }
     } else {
-      LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: Candidate %s:%d deny vote from node %s at term %d, "
+      LOGV(INFO_LEVEL, info_log_, "Peer::RequestVoteRPC: Candidate %s:%d deny vote from node %s at term %lu, "
           "transfer from candidate to follower",
           options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), context_->current_term);
       context_->BecomeFollower(res.request_vote_res().term());
-      raft_meta_->SetCurrentTerm(context_->current_term);
-      raft_meta_->SetVotedForIp(context_->voted_for_ip);
-      raft_meta_->SetVotedForPort(context_->voted_for_port);
+      raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+          context_->voted_for_ip, context_->voted_for_port);
     }
   } else if (context_->role == Role::kFollower) {
     LOGV(INFO_LEVEL, info_log_, "Peer::RequestVotePPC: Server %s:%d have transformed to follower when doing RequestVoteRPC, " 
@@ -167,7 +232,7 @@ void Peer::RequestVoteRPC() {
         context_->leader_port, context_->current_term);
   } else if (context_->role == Role::kLeader) {
     LOGV(INFO_LEVEL, info_log_, "Peer::RequestVotePPC: Server %s:%d is already a leader at term %lu, " 
-        "get vote from node %s at term %d", 
+        "get vote from node %s at term %lu", 
         options_.local_ip.c_str(), options_.local_port, context_->current_term, 
         peer_addr_.c_str(), res.request_vote_res().term());
   }
@@ -175,32 +240,24 @@ void Peer::RequestVoteRPC() {
   return;
 }
 
-uint64_t Peer::QuorumMatchIndex() {
-  std::vector<uint64_t> values;
-  std::map<std::string, Peer*>::iterator iter;
-  for (iter = peers_->begin(); iter != peers_->end(); iter++) {
-    if (iter->first == peer_addr_) {
-      values.push_back(match_index_);
-      continue;
-    }
-    values.push_back(iter->second->match_index());
+void Peer::ObserveApplied(uint64_t last_applied) {
+  // the latest commit index the peer has applied
+  std::deque<std::pair<uint64_t, uint64_t> >& commit_times = context_->commit_times;
+  std::deque<std::pair<uint64_t, uint64_t> >::iterator iter = std::upper_bound(
+      commit_times.begin(), commit_times.end(), std::make_pair(last_applied, UINT64_MAX));
+  if (iter == commit_times.begin()) {
+    return;
   }
-  LOGV(DEBUG_LEVEL, info_log_, "Peer::QuorumMatchIndex: Get peers match_index %d %d %d %d",
-      values[0], values[1], values[2], values[3]);
-  std::sort(values.begin(), values.end());
-  return values.at(values.size() / 2);
-}
-
-// only leader will call AdvanceCommitIndex
-// follower only need set commit as leader's
-void Peer::AdvanceLeaderCommitIndex() {
-  Entry entry;
-  uint64_t new_commit_index = QuorumMatchIndex();
-  if (context_->commit_index < new_commit_index) {
-    context_->commit_index = new_commit_index;
-    raft_meta_->SetCommitIndex(context_->commit_index);
+  --iter;
+  if (iter->first <= measured_index_) {
+    return;
   }
-  return;
+  uint64_t now = slash::NowMicros();
+  uint64_t latency_us = now > iter->second ? now - iter->second : 0;
+  measured_index_ = iter->first;
+  apply_latency_count_++;
+  apply_latency_us_ += latency_us;
+  max_apply_latency_us_ = std::max(max_apply_latency_us_, latency_us);
 }
 
 void Peer::AddAppendEntriesTask() {
@@ -213,18 +270,47 @@ void Peer::AddAppendEntriesTask() {
   bg_thread_.Schedule(&AppendEntriesRPCWrapper, this);
 }
 
+void Peer::AddCommitTask() {
+  if (heartbeat_cli_ != NULL) {
+    AddLeaderHeartbeatTask();
+    return;
+  }
+  if (!commit_queued_.exchange(true)) {
+    bg_thread_.Schedule(&CommitRPCWrapper, this);
+  }
+}
+
+void Peer::CommitRPCWrapper(void *arg) {
+  Peer* peer = reinterpret_cast<Peer*>(arg);
+  // the commit index advanced from now on is pushed again
+  peer->commit_queued_ = false;
+  peer->AppendEntriesRPC();
+}
+
 void Peer::AppendEntriesRPCWrapper(void *arg) {
   reinterpret_cast<Peer*>(arg)->AppendEntriesRPC();
 }
 
 void Peer::AppendEntriesRPC() {
+  if (pipeline_cli_ != NULL) {
+    PipelineAppendEntriesRPC();
+    return;
+  }
+  if (next_index_ <= raft_log_->GetSnapshotIndex()) {
+    // the entries have been dropped after snapshot
+    InstallSnapshotRPC();
+    return;
+  }
   uint64_t prev_log_index = 0;
   uint64_t num_entries = 0;
   uint64_t prev_log_term = 0;
   uint64_t last_log_index = 0;
   uint64_t current_term = 0;
+  uint64_t count_limit = 0;
+  uint64_t size_limit = 0;
   CmdRequest req;
   CmdRequest_AppendEntries* append_entries = req.mutable_append_entries();
+  RawEntries raw_entries(append_entries);
   {
   slash::MutexLock l(&context_->global_mu);
   prev_log_index = next_index_ - 1;
@@ -233,18 +319,19 @@ void Peer::AppendEntriesRPC() {
    * LOGV(INFO_LEVEL, info_log_, "Peer::AppendEntriesRPC: next_index_ %d last_log_index %d peer_last_op_time %lu nowmicros %lu",
    *     next_index_.load(), last_log_index, peer_last_op_time, slash::NowMicros());
    */
-  if (next_index_ > last_log_index && peer_last_op_time + options_.heartbeat_us > slash::NowMicros()) {
+  // send nothing if there is neither entry nor commit index to push, unless
+  // it is time for a heartbeat
+  if (next_index_ > last_log_index && sent_commit_index_ >= context_->commit_index
+      && !match_pending_ && peer_last_op_time + options_.heartbeat_us > slash::NowMicros()) {
     return;
   }
   peer_last_op_time = slash::NowMicros();
 
   if (prev_log_index != 0) {
-    Entry entry;
-    if (raft_log_->GetEntry(prev_log_index, &entry) != 0) {
-      LOGV(WARN_LEVEL, info_log_, "Peer::AppendEntriesRPC: Get my(%s:%d) Entry index %llu "
+    prev_log_term = raft_log_->GetTerm(prev_log_index);
+    if (prev_log_term == 0) {
+      LOGV(WARN_LEVEL, info_log_, "Peer::AppendEntriesRPC: Get my(%s:%d) Entry index %lu "
           "not found", options_.local_ip.c_str(), options_.local_port, prev_log_index);
-    } else {
-      prev_log_term = entry.term();
     }
   }
   current_term = context_->current_term;
@@ -256,36 +343,25 @@ void Peer::AppendEntriesRPC() {
   append_entries->set_prev_log_index(prev_log_index);
   append_entries->set_prev_log_term(prev_log_term);
   append_entries->set_leader_commit(context_->commit_index);
+  sent_commit_index_ = context_->commit_index;
+  match_pending_ = false;
+  count_limit = batch_.count_limit();
+  size_limit = batch_.size_limit();
   }
 
-  Entry *tmp_entry = new Entry();
-  for (uint64_t index = next_index_; index <= last_log_index; index++) {
-    if (raft_log_->GetEntry(index, tmp_entry) == 0) {
-      // TODO(ba0tiao) how to avoid memory copy here
-      Entry *entry = append_entries->add_entries();
-      *entry = *tmp_entry;
-    } else {
-      LOGV(WARN_LEVEL, info_log_, "Peer::AppendEntriesRPC: peer_addr %s can't get Entry "
-          "from raft_log, index %lld", peer_addr_.c_str(), index);
-      break;
-    }
-
-    num_entries++;
-    if (num_entries >= options_.append_entries_count_once
-        || (uint64_t)append_entries->ByteSize() >= options_.append_entries_size_once) {
-      break;
-    }
+  if (prev_log_index + 1 <= last_log_index) {
+    num_entries = AddEntries(prev_log_index + 1, last_log_index, count_limit, size_limit, &raw_entries);
   }
-  delete tmp_entry;
-  LOGV(DEBUG_LEVEL, info_log_, "Peer::AppendEntriesRPC: peer_addr(%s)'s next_index_ %llu, my last_log_index %llu"
-      " AppendEntriesRPC will send %d iterm", peer_addr_.c_str(), next_index_.load(), last_log_index, num_entries);
+  LOGV(DEBUG_LEVEL, info_log_, "Peer::AppendEntriesRPC: peer_addr(%s)'s next_index_ %lu, my last_log_index %lu"
+      " AppendEntriesRPC will send %lu iterm", peer_addr_.c_str(), next_index_.load(), last_log_index, num_entries);
   // if the AppendEntries don't contain any log item
   if (num_entries == 0) {
-    LOGV(INFO_LEVEL, info_log_, "Peer::AppendEntryRpc server %s:%d Send pingpong appendEntries message to %s at term %d",
+    LOGV(INFO_LEVEL, info_log_, "Peer::AppendEntryRpc server %s:%d Send pingpong appendEntries message to %s at term %lu",
         options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), current_term);
   }
 
   CmdResponse res;
+  uint64_t send_us = slash::NowMicros();
   Status result = pool_->SendAndRecv(peer_addr_, req, &res);
 
   {
@@ -293,9 +369,78 @@ void Peer::AppendEntriesRPC() {
   if (!result.ok()) {
     LOGV(WARN_LEVEL, info_log_, "Peer::AppendEntries: Leader %s:%d SendAndRecv to %s failed, result is %s\n",
          options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), result.ToString().c_str());
+    batch_.OnError();
     return;
   }
 
+  UpdateBatch(prev_log_index, num_entries, send_us,
+      prev_log_index + num_entries < last_log_index, res);
+  HandleAppendEntriesResponse(prev_log_index, num_entries, res, false);
+  }
+  return;
+}
+
+Peer::RawEntries::~RawEntries() {
+  // the strings are owned by bufs_, not the request
+  for (size_t i = 0; i < bufs_.size(); i++) {
+    append_entries_->mutable_raw_entries()->ReleaseLast();
+  }
+}
+
+void Peer::RawEntries::Add(const std::shared_ptr<const std::string>& buf) {
+  bufs_.push_back(buf);
+  // the request is only serialized, which never modifies the string
+  append_entries_->mutable_raw_entries()->AddAllocated(const_cast<std::string*>(buf.get()));
+}
+
+uint64_t Peer::AddEntries(uint64_t begin, uint64_t last_log_index, uint64_t count_limit,
+    uint64_t size_limit, RawEntries* raw_entries) {
+  // read the entries in one scan, stop by either count or size limit, they
+  // are sent in the compact format of the log without being parsed
+  std::vector<std::shared_ptr<const std::string> > bufs;
+  uint64_t end_index = std::min(last_log_index, begin + count_limit - 1);
+  if (raft_log_->GetEncodedEntries(begin, end_index, size_limit, &bufs) != 0) {
+    LOGV(WARN_LEVEL, info_log_, "Peer::AddEntries: peer_addr %s can't get Entry "
+        "from raft_log, index %lu", peer_addr_.c_str(), begin);
+    return 0;
+  }
+  for (size_t i = 0; i < bufs.size(); i++) {
+    raw_entries->Add(bufs[i]);
+  }
+  // with lazy_checksum, only the entries of a lagging follower, which
+  // are read from the log storage, are checked
+  if (options_.lazy_checksum && raft_log_->IsCached(begin)) {
+    raw_entries->append_entries()->set_raw_entries_unchecked(true);
+  }
+  return bufs.size();
+}
+
+void Peer::UpdateBatch(uint64_t prev_log_index, uint64_t num_entries, uint64_t send_us,
+    bool full, const CmdResponse& res) {
+  const CmdResponse_AppendEntriesResponse& append_entries_res = res.append_entries_res();
+  if (!append_entries_res.success()) {
+    return;
+  }
+  // the committed entries the follower has but not applied yet
+  uint64_t apply_lag = 0;
+  if (append_entries_res.has_last_applied()) {
+    uint64_t committed = std::min(prev_log_index + num_entries, context_->commit_index);
+    if (committed > append_entries_res.last_applied()) {
+      apply_lag = committed - append_entries_res.last_applied();
+    }
+  }
+  uint64_t now = slash::NowMicros();
+  batch_.OnSuccess(num_entries, now > send_us ? now - send_us : 0, apply_lag, full);
+  BatchController::Decision decision = batch_.decision();
+  if (decision != BatchController::kHold) {
+    LOGV(DEBUG_LEVEL, info_log_, "Peer::UpdateBatch: peer_addr %s %s, batch limits %lu bytes %lu entries, "
+        "rtt %lu us, apply lag %lu", peer_addr_.c_str(), BatchController::DecisionName(decision),
+        batch_.size_limit(), batch_.count_limit(), batch_.rtt_us(), apply_lag);
+  }
+}
+
+void Peer::HandleAppendEntriesResponse(uint64_t prev_log_index, uint64_t num_entries,
+    const CmdResponse& res, bool pipelined) {
   // here we may get a larger term, and transfer to follower
   // so we need to judge the role here
   if (context_->role == Role::kLeader) {
@@ -304,33 +449,55 @@ void Peer::AppendEntriesRPC() {
      */
     if (res.append_entries_res().term() > context_->current_term) {
       LOGV(INFO_LEVEL, info_log_, "Peer::AppendEntriesRPC: %s:%d Transfer from Leader to Follower since get A larger term"
-          "from peer %s, local term is %d, peer term is %d", options_.local_ip.c_str(), options_.local_port,
+          "from peer %s, local term is %lu, peer term is %lu", options_.local_ip.c_str(), options_.local_port,
           peer_addr_.c_str(), context_->current_term, res.append_entries_res().term());
       context_->BecomeFollower(res.append_entries_res().term());
-      raft_meta_->SetCurrentTerm(context_->current_term);
-      raft_meta_->SetVotedForIp(context_->voted_for_ip);
-      raft_meta_->SetVotedForPort(context_->voted_for_port);
+      raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+          context_->voted_for_ip, context_->voted_for_port);
     } else if (res.append_entries_res().success() == true) {
-      if (num_entries > 0) {
-        match_index_ = prev_log_index + num_entries;
-        // only log entries from the leader's current term are committed
-        // by counting replicas
-        if (append_entries->entries(num_entries - 1).term() == context_->current_term) {
-          AdvanceLeaderCommitIndex();
+      if (res.append_entries_res().has_last_applied()) {
+        ObserveApplied(res.append_entries_res().last_applied());
+      }
+      // the follower has the entries sent, but acks only the persisted ones
+      uint64_t match_index = prev_log_index + num_entries;
+      if (res.append_entries_res().has_match_index()
+          && res.append_entries_res().match_index() < match_index) {
+        match_index = res.append_entries_res().match_index();
+        // ask again instead of sending them again
+        match_pending_ = true;
+        AddAppendEntriesTask();
+      }
+      // the pipelined responses come back in order, but the match index
+      // never goes back
+      if ((num_entries > 0 || res.append_entries_res().has_match_index())
+          && match_index > match_index_) {
+        match_index_ = match_index;
+        if (primary_->AdvanceLeaderCommitIndex()) {
           apply_->ScheduleApply();
         }
+      }
+      // the pipelined next_index_ has advanced on send
+      if (num_entries > 0 && !pipelined) {
         next_index_ = prev_log_index + num_entries + 1;
       }
     } else {
       LOGV(INFO_LEVEL, info_log_, "Peer::AppEntriesRPC: peer_addr %s Send AppEntriesRPC failed,"
           "peer's last_log_index %lu, peer's next_index_ %lu",
           peer_addr_.c_str(), res.append_entries_res().last_log_index(), next_index_.load());
-      uint64_t adjust_index = std::min(res.append_entries_res().last_log_index() + 1,
-                                       next_index_ - 1);
+      uint64_t adjust_index = 0;
+      if (res.append_entries_res().has_conflict_index()) {
+        // skip the whole conflicting term according to the hint
+        adjust_index = raft_log_->NextIndexAfterConflict(prev_log_index,
+            res.append_entries_res().conflict_term(), res.append_entries_res().conflict_index());
+      } else {
+        adjust_index = std::min(res.append_entries_res().last_log_index() + 1,
+                                prev_log_index);
+      }
       if (adjust_index > 0) {
         // Prev log don't match, so we retry with more prev one according to
-        // response
+        // response, the requests in flight after this one are rejected too
         next_index_ = adjust_index;
+        pipeline_epoch_++;
         LOGV(INFO_LEVEL, info_log_, "Peer::AppEntriesRPC: peer_addr %s Adjust peer next_index_, Now next_index_ is %lu",
             peer_addr_.c_str(), next_index_.load());
         AddAppendEntriesTask();
@@ -344,8 +511,322 @@ void Peer::AppendEntriesRPC() {
     LOGV(INFO_LEVEL, info_log_, "Peer::AppEntriesRPC: Server %s:%d have transformed to candidate when doing AppEntriesRPC, "
         "new term is %lu", options_.local_ip.c_str(), options_.local_port, context_->current_term);
   }
+}
+
+void Peer::PipelineAppendEntriesRPC() {
+  while (true) {
+    uint64_t prev_log_index = 0;
+    uint64_t prev_log_term = 0;
+    uint64_t last_log_index = 0;
+    uint64_t epoch = 0;
+    uint64_t count_limit = 0;
+    uint64_t size_limit = 0;
+    bool idle = false;
+    CmdRequest req;
+    CmdRequest_AppendEntries* append_entries = req.mutable_append_entries();
+    RawEntries raw_entries(append_entries);
+    {
+    slash::MutexLock l(&context_->global_mu);
+    if (in_flight_.size() >= static_cast<size_t>(options_.append_entries_window)) {
+      // sent again when a response comes back
+      return;
+    }
+    idle = in_flight_.empty();
+    if (next_index_ <= raft_log_->GetSnapshotIndex()) {
+      // wait for the requests in flight before sending the snapshot
+      if (!idle) {
+        return;
+      }
+      break;
+    }
+    prev_log_index = next_index_ - 1;
+    last_log_index = raft_log_->GetLastLogIndex();
+    // heartbeat or push the commit index only if there is no request in
+    // flight, the responses schedule this again
+    if (next_index_ > last_log_index
+        && (!idle || (sent_commit_index_ >= context_->commit_index && !match_pending_
+            && peer_last_op_time + options_.heartbeat_us > slash::NowMicros()))) {
+      return;
+    }
+    peer_last_op_time = slash::NowMicros();
+    if (prev_log_index != 0) {
+      prev_log_term = raft_log_->GetTerm(prev_log_index);
+    }
+    epoch = pipeline_epoch_;
+    req.set_type(Type::kAppendEntries);
+    append_entries->set_ip(options_.local_ip);
+    append_entries->set_port(options_.local_port);
+    append_entries->set_term(context_->current_term);
+    append_entries->set_prev_log_index(prev_log_index);
+    append_entries->set_prev_log_term(prev_log_term);
+    append_entries->set_leader_commit(context_->commit_index);
+    sent_commit_index_ = context_->commit_index;
+    match_pending_ = false;
+    count_limit = batch_.count_limit();
+    size_limit = batch_.size_limit();
+    }
+
+    uint64_t num_entries = 0;
+    if (prev_log_index + 1 <= last_log_index) {
+      num_entries = AddEntries(prev_log_index + 1, last_log_index, count_limit, size_limit, &raw_entries);
+      if (num_entries == 0) {
+        return;
+      }
+    }
+
+    // the connection is only set up with no request in flight, so
+    // recv_thread_ is not reading from it
+    {
+    slash::MutexLock l(&pipeline_mu_);
+    if (!pipeline_cli_->Available()) {
+      if (!idle) {
+        return;
+      }
+      Status s = pipeline_cli_->Connect();
+      if (!s.ok()) {
+        LOGV(WARN_LEVEL, info_log_, "Peer::PipelineAppendEntriesRPC: connect to %s failed, error: %s",
+            peer_addr_.c_str(), s.ToString().c_str());
+        return;
+      }
+      pipeline_cli_->set_send_timeout(kPipelineTimeoutMs);
+      pipeline_cli_->set_recv_timeout(kPipelineTimeoutMs);
+    }
+    }
+
+    {
+    slash::MutexLock l(&context_->global_mu);
+    if (epoch != pipeline_epoch_) {
+      // next_index_ is rolled back in the meantime, build it again
+      continue;
+    }
+    InFlightAppend in_flight;
+    in_flight.epoch = epoch;
+    in_flight.prev_log_index = prev_log_index;
+    in_flight.num_entries = num_entries;
+    in_flight.send_us = slash::NowMicros();
+    in_flight.full = prev_log_index + num_entries < last_log_index;
+    in_flight_.push_back(in_flight);
+    next_index_ = prev_log_index + num_entries + 1;
+    }
+
+    Status s;
+    {
+    slash::MutexLock l(&pipeline_mu_);
+    s = pipeline_cli_->Send(&req);
+    if (!s.ok() && pipeline_cli_->Available()) {
+      // fail the receive too, which closes the connection and rolls
+      // next_index_ back, the connection is only closed by the receive
+      // with pipeline_mu_ held, so the fd is still ours here
+      shutdown(pipeline_cli_->fd(), SHUT_RDWR);
+    }
+    }
+    recv_thread_.Schedule(&ReceiveAppendEntriesWrapper, this);
+    if (!s.ok()) {
+      LOGV(WARN_LEVEL, info_log_, "Peer::PipelineAppendEntriesRPC: send to %s failed, error: %s",
+          peer_addr_.c_str(), s.ToString().c_str());
+      return;
+    }
+    LOGV(DEBUG_LEVEL, info_log_, "Peer::PipelineAppendEntriesRPC: send %lu entries after %lu to %s",
+        num_entries, prev_log_index, peer_addr_.c_str());
+    if (num_entries == 0) {
+      return;
+    }
+  }
+  InstallSnapshotRPC();
+}
+
+void Peer::ReceiveAppendEntriesWrapper(void* arg) {
+  reinterpret_cast<Peer*>(arg)->ReceiveAppendEntries();
+}
+
+void Peer::ReceiveAppendEntries() {
+  {
+  slash::MutexLock l(&context_->global_mu);
+  // the requests are dropped with the connection
+  if (in_flight_.empty()) {
+    return;
+  }
+  }
+  CmdResponse res;
+  Status s = pipeline_cli_->Recv(&res);
+
+  slash::MutexLock l(&context_->global_mu);
+  InFlightAppend in_flight = in_flight_.front();
+  in_flight_.pop_front();
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "Peer::ReceiveAppendEntries: Leader %s:%d Recv from %s failed, %lu requests "
+        "in flight are dropped, error: %s", options_.local_ip.c_str(), options_.local_port,
+        peer_addr_.c_str(), in_flight_.size() + 1, s.ToString().c_str());
+    {
+    slash::MutexLock pl(&pipeline_mu_);
+    pipeline_cli_->Close();
+    }
+    batch_.OnError();
+    in_flight_.clear();
+    if (in_flight.epoch == pipeline_epoch_) {
+      next_index_ = in_flight.prev_log_index + 1;
+    }
+    pipeline_epoch_++;
+    // sent again by the next heartbeat
+    return;
+  }
+  if (in_flight.epoch != pipeline_epoch_) {
+    AddAppendEntriesTask();
+    return;
+  }
+  UpdateBatch(in_flight.prev_log_index, in_flight.num_entries, in_flight.send_us,
+      in_flight.full, res);
+  HandleAppendEntriesResponse(in_flight.prev_log_index, in_flight.num_entries, res, true);
+  // there is room in the window now
+  AddAppendEntriesTask();
+}
+
+void Peer::AddLeaderHeartbeatTask() {
+  if (heartbeat_cli_ == NULL || heartbeat_queued_.exchange(true)) {
+    return;
+  }
+  heartbeat_thread_.Schedule(&LeaderHeartbeatRPCWrapper, this);
+}
+
+void Peer::LeaderHeartbeatRPCWrapper(void *arg) {
+  reinterpret_cast<Peer*>(arg)->LeaderHeartbeatRPC();
+}
+
+void Peer::LeaderHeartbeatRPC() {
+  // the heartbeats added from now on are sent after this one
+  heartbeat_queued_ = false;
+  CmdRequest req;
+  req.set_type(Type::kLeaderHeartbeat);
+  CmdRequest_LeaderHeartbeat* leader_heartbeat = req.mutable_leader_heartbeat();
+  {
+  slash::MutexLock l(&context_->global_mu);
+  if (context_->role != Role::kLeader) {
+    return;
+  }
+  leader_heartbeat->set_term(context_->current_term);
+  leader_heartbeat->set_ip(options_.local_ip);
+  leader_heartbeat->set_port(options_.local_port);
+  leader_heartbeat->set_leader_commit(context_->commit_index);
+  }
+
+  if (!heartbeat_cli_->Available()) {
+    Status s = heartbeat_cli_->Connect();
+    if (!s.ok()) {
+      LOGV(DEBUG_LEVEL, info_log_, "Peer::LeaderHeartbeatRPC: connect to %s failed, error: %s",
+          peer_addr_.c_str(), s.ToString().c_str());
+      return;
+    }
+    heartbeat_cli_->set_send_timeout(kHeartbeatTimeoutMs);
+    heartbeat_cli_->set_recv_timeout(kHeartbeatTimeoutMs);
+  }
+  CmdResponse res;
+  Status s = heartbeat_cli_->Send(&req);
+  if (s.ok()) {
+    s = heartbeat_cli_->Recv(&res);
+  }
+  if (!s.ok()) {
+    LOGV(DEBUG_LEVEL, info_log_, "Peer::LeaderHeartbeatRPC: heartbeat to %s failed, error: %s",
+        peer_addr_.c_str(), s.ToString().c_str());
+    heartbeat_cli_->Close();
+    return;
+  }
+
+  slash::MutexLock l(&context_->global_mu);
+  if (context_->role == Role::kLeader
+      && res.leader_heartbeat_res().term() > context_->current_term) {
+    LOGV(INFO_LEVEL, info_log_, "Peer::LeaderHeartbeatRPC: %s:%d Transfer from Leader to Follower since get A larger term"
+        "from peer %s, local term is %lu, peer term is %lu", options_.local_ip.c_str(), options_.local_port,
+        peer_addr_.c_str(), context_->current_term, res.leader_heartbeat_res().term());
+    context_->BecomeFollower(res.leader_heartbeat_res().term());
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
+  } else if (context_->role == Role::kLeader && res.leader_heartbeat_res().has_last_applied()) {
+    ObserveApplied(res.leader_heartbeat_res().last_applied());
+  }
+}
+
+void Peer::InstallSnapshotRPC() {
+  if (snapshot_reader_ == NULL) {
+    Status s = snapshot_->OpenReader(&snapshot_reader_);
+    if (!s.ok()) {
+      LOGV(WARN_LEVEL, info_log_, "Peer::InstallSnapshotRPC: open snapshot for %s failed, error: %s",
+          peer_addr_.c_str(), s.ToString().c_str());
+      snapshot_reader_ = NULL;
+      return;
+    }
+    LOGV(INFO_LEVEL, info_log_, "Peer::InstallSnapshotRPC: peer_addr %s next_index_ %lu is included in my "
+        "snapshot, send the snapshot (%lu, %lu)", peer_addr_.c_str(), next_index_.load(),
+        snapshot_reader_->index(), snapshot_reader_->term());
+  }
+
+  CmdRequest req;
+  req.set_type(Type::kInstallSnapshot);
+  CmdRequest_InstallSnapshot* install_snapshot = req.mutable_install_snapshot();
+  std::string filename;
+  uint64_t offset;
+  bool done;
+  Status s = snapshot_reader_->ReadChunk(options_.snapshot_chunk_size, &filename, &offset,
+      install_snapshot->mutable_data(), &done);
+  if (!s.ok()) {
+    LOGV(WARN_LEVEL, info_log_, "Peer::InstallSnapshotRPC: read snapshot for %s failed, error: %s",
+        peer_addr_.c_str(), s.ToString().c_str());
+    delete snapshot_reader_;
+    snapshot_reader_ = NULL;
+    return;
+  }
+  uint64_t seq = snapshot_reader_->seq();
+  install_snapshot->set_ip(options_.local_ip);
+  install_snapshot->set_port(options_.local_port);
+  install_snapshot->set_last_included_index(snapshot_reader_->index());
+  install_snapshot->set_last_included_term(snapshot_reader_->term());
+  install_snapshot->set_seq(seq);
+  install_snapshot->set_filename(filename);
+  install_snapshot->set_offset(offset);
+  install_snapshot->set_done(done);
+  {
+  slash::MutexLock l(&context_->global_mu);
+  install_snapshot->set_term(context_->current_term);
+  peer_last_op_time = slash::NowMicros();
+  }
+
+  CmdResponse res;
+  Status result = pool_->SendAndRecv(peer_addr_, req, &res);
+
+  slash::MutexLock l(&context_->global_mu);
+  if (!result.ok()) {
+    // the same chunk is sent again by the next heartbeat
+    LOGV(WARN_LEVEL, info_log_, "Peer::InstallSnapshotRPC: Leader %s:%d SendAndRecv to %s failed, result is %s",
+         options_.local_ip.c_str(), options_.local_port, peer_addr_.c_str(), result.ToString().c_str());
+    return;
+  }
+  if (context_->role != Role::kLeader) {
+    return;
+  }
+  if (res.install_snapshot_res().term() > context_->current_term) {
+    LOGV(INFO_LEVEL, info_log_, "Peer::InstallSnapshotRPC: %s:%d Transfer from Leader to Follower since get A larger term"
+        "from peer %s, local term is %lu, peer term is %lu", options_.local_ip.c_str(), options_.local_port,
+        peer_addr_.c_str(), context_->current_term, res.install_snapshot_res().term());
+    context_->BecomeFollower(res.install_snapshot_res().term());
+    raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+        context_->voted_for_ip, context_->voted_for_port);
+  } else if (res.install_snapshot_res().success() == true) {
+    if (done) {
+      LOGV(INFO_LEVEL, info_log_, "Peer::InstallSnapshotRPC: peer_addr %s installed snapshot (%lu, %lu) in %lu chunks",
+          peer_addr_.c_str(), snapshot_reader_->index(), snapshot_reader_->term(), seq + 1);
+      match_index_ = snapshot_reader_->index();
+      next_index_ = snapshot_reader_->index() + 1;
+      delete snapshot_reader_;
+      snapshot_reader_ = NULL;
+    } else {
+      snapshot_reader_->Advance();
+    }
+    AddAppendEntriesTask();
+  } else {
+    // the peer lost the chunks received, start over by the next heartbeat
+    LOGV(INFO_LEVEL, info_log_, "Peer::InstallSnapshotRPC: peer_addr %s reject chunk %lu of snapshot (%lu, %lu), "
+        "send from the first chunk", peer_addr_.c_str(), seq, snapshot_reader_->index(), snapshot_reader_->term());
+    snapshot_reader_->Rewind();
   }
-  return;
 }
 
 }  // namespace floyd
@@ -6,13 +6,18 @@
 #ifndef FLOYD_SRC_FLOYD_PEER_THREAD_H_
 #define FLOYD_SRC_FLOYD_PEER_THREAD_H_
 
+#include <deque>
+#include <memory>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "slash/include/slash_status.h"
 #include "pink/include/bg_thread.h"
+#include "pink/include/pink_cli.h"
 
 #include "floyd/src/floyd_context.h"
+#include "floyd/src/batch_controller.h"
 
 namespace floyd {
 
@@ -21,15 +26,20 @@ using slash::Status;
 class RaftMeta;
 class FloydPrimary;
 class RaftLog;
+class RaftSnapshot;
+class SnapshotReader;
 class ClientPool;
 class FloydApply;
+class CmdResponse;
+class CmdRequest_AppendEntries;
 class Peer;
 typedef std::map<std::string, Peer*> PeersSet;
 
 class Peer {
  public:
   Peer(std::string server, PeersSet *peers, FloydContext* context, FloydPrimary* primary, RaftMeta* raft_meta,
-      RaftLog* raft_log, ClientPool* pool, FloydApply* apply, const Options& options, Logger* info_log);
+      RaftLog* raft_log, RaftSnapshot* snapshot, ClientPool* pool, FloydApply* apply,
+      const Options& options, Logger* info_log);
   ~Peer();
 
   int Start();
@@ -39,6 +49,12 @@ class Peer {
   // call by other thread, put job to peer_thread's bg_thread_
   void AddAppendEntriesTask();
   void AddRequestVoteTask();
+  // the heartbeat is sent by heartbeat_thread_, a heartbeat still queued
+  // is not queued again
+  void AddLeaderHeartbeatTask();
+  // push the new commit index to the peer, by the LeaderHeartbeat if it is
+  // enabled, or an AppendEntries, a push still queued is not queued again
+  void AddCommitTask();
 
   /*
    * the two main RPC call in raft consensus protocol is here
@@ -51,11 +67,22 @@ class Peer {
   // Request Vote
   static void RequestVoteRPCWrapper(void *arg);
   void RequestVoteRPC();
+  /*
+   * send the snapshot in place of the entries dropped, one chunk per call,
+   * the next chunk is sent after the peer acknowledges the current one
+   */
+  void InstallSnapshotRPC();
+  static void LeaderHeartbeatRPCWrapper(void *arg);
+  void LeaderHeartbeatRPC();
+  static void CommitRPCWrapper(void *arg);
 
   uint64_t GetMatchIndex();
 
+  // called with context_->global_mu held
   void set_next_index(const uint64_t next_index) {
     next_index_ = next_index;
+    // the responses of the pipelined requests are meaningless now
+    pipeline_epoch_++;
   }
   uint64_t next_index() {
     return next_index_;
@@ -72,18 +99,88 @@ class Peer {
     return peer_addr_;
   }
 
+  // the limits of the AppendEntries sent to the peer, and how they are
+  // tuned, called with context_->global_mu held
+  BatchController* batch_controller() {
+    return &batch_;
+  }
+
+  /*
+   * the latency from a commit index being reached to the peer reporting it
+   * has applied the entries, as observed by the leader, so it includes the
+   * delay until the next response of the peer
+   * called with context_->global_mu held
+   */
+  void GetApplyLatencyStats(uint64_t* count, uint64_t* total_us, uint64_t* max_us) {
+    *count = apply_latency_count_;
+    *total_us = apply_latency_us_;
+    *max_us = max_apply_latency_us_;
+  }
+
  private:
   bool CheckAndVote(uint64_t vote_term);
-  uint64_t QuorumMatchIndex();
-  void AdvanceLeaderCommitIndex();
   void UpdatePeerInfo();
 
+  // an AppendEntries sent on pipeline_cli_ and waiting for its response
+  struct InFlightAppend {
+    uint64_t epoch;
+    uint64_t prev_log_index;
+    uint64_t num_entries;
+    uint64_t send_us;
+    bool full;
+  };
+  /*
+   * the raw entries of an AppendEntries, they are shared with the cache of
+   * the log and added to the request without being copied, then released
+   * from it before it is destroyed, so RawEntries must be declared after
+   * the request
+   */
+  class RawEntries {
+   public:
+    explicit RawEntries(CmdRequest_AppendEntries* append_entries)
+      : append_entries_(append_entries) {
+    }
+    ~RawEntries();
+
+    CmdRequest_AppendEntries* append_entries() {
+      return append_entries_;
+    }
+    void Add(const std::shared_ptr<const std::string>& buf);
+
+   private:
+    CmdRequest_AppendEntries* const append_entries_;
+    std::vector<std::shared_ptr<const std::string> > bufs_;
+
+    // No copying allowed
+    RawEntries(const RawEntries&);
+    void operator=(const RawEntries&);
+  };
+  // add the entries from begin to raw_entries, up to count_limit entries
+  // and about size_limit bytes, return the number of them
+  uint64_t AddEntries(uint64_t begin, uint64_t last_log_index, uint64_t count_limit,
+      uint64_t size_limit, RawEntries* raw_entries);
+  void PipelineAppendEntriesRPC();
+  static void ReceiveAppendEntriesWrapper(void* arg);
+  void ReceiveAppendEntries();
+  // handle the response of the AppendEntries with num_entries entries after
+  // prev_log_index, called with context_->global_mu held
+  void HandleAppendEntriesResponse(uint64_t prev_log_index, uint64_t num_entries,
+      const CmdResponse& res, bool pipelined);
+  // feed batch_ with an acknowledged AppendEntries sent at send_us, full
+  // is true if it was cut by the limits, called with context_->global_mu held
+  void UpdateBatch(uint64_t prev_log_index, uint64_t num_entries, uint64_t send_us,
+      bool full, const CmdResponse& res);
+  // the peer reports it has applied the entries up to last_applied,
+  // called with context_->global_mu held
+  void ObserveApplied(uint64_t last_applied);
+
   std::string peer_addr_;
   PeersSet* const peers_;
   FloydContext* const context_;
   FloydPrimary* const primary_;
   RaftMeta* const raft_meta_;
   RaftLog* const raft_log_;
+  RaftSnapshot* const snapshot_;
   ClientPool* const pool_;
   FloydApply* const apply_;
   Options options_;
@@ -93,9 +190,51 @@ class Peer {
   std::atomic<uint64_t> next_index_;
   std::atomic<uint64_t> match_index_;
   uint64_t peer_last_op_time;
+  // the snapshot being sent to the peer, NULL if none
+  SnapshotReader* snapshot_reader_;
+  // protected by context_->global_mu
+  BatchController batch_;
+  // the commit index sent to the peer in the last AppendEntries, protected
+  // by context_->global_mu
+  uint64_t sent_commit_index_;
+  // the peer acked entries it has not persisted yet, so an AppendEntries is
+  // sent even with nothing to push, to learn its match index, protected by
+  // context_->global_mu
+  bool match_pending_;
+  std::atomic<bool> commit_queued_;
+  // the last commit index whose apply latency is measured, and the stats,
+  // protected by context_->global_mu
+  uint64_t measured_index_;
+  uint64_t apply_latency_count_;
+  uint64_t apply_latency_us_;
+  uint64_t max_apply_latency_us_;
 
   pink::BGThread bg_thread_;
 
+  /*
+   * with options_.append_entries_window > 1, up to window AppendEntries are
+   * sent on pipeline_cli_ without waiting for the responses, next_index_
+   * advances on send. The responses come back in order and are received in
+   * recv_thread_, a rejection or a failure rolls next_index_ back and bumps
+   * pipeline_epoch_, so the responses to the requests sent before are ignored
+   */
+  pink::PinkCli* pipeline_cli_;
+  // protect the connect, send and close of pipeline_cli_
+  slash::Mutex pipeline_mu_;
+  // protected by context_->global_mu
+  std::deque<InFlightAppend> in_flight_;
+  uint64_t pipeline_epoch_;
+  pink::BGThread recv_thread_;
+
+  /*
+   * with options_.light_heartbeat_us > 0, the LeaderHeartbeat carrying only
+   * the term and the commit index is sent on heartbeat_cli_ by
+   * heartbeat_thread_, so it doesn't wait for the AppendEntries in bg_thread_
+   */
+  pink::PinkCli* heartbeat_cli_;
+  std::atomic<bool> heartbeat_queued_;
+  pink::BGThread heartbeat_thread_;
+
   // No copying allowed
   Peer(const Peer&);
   void operator=(const Peer&);
@@ -21,17 +21,22 @@
 #include "floyd/src/floyd_context.h"
 #include "floyd/src/floyd_client_pool.h"
 #include "floyd/src/raft_meta.h"
+#include "floyd/src/raft_log.h"
 #include "floyd/src/floyd.pb.h"
 #include "floyd/src/logger.h"
 #include "floyd/include/floyd_options.h"
 
 namespace floyd {
 
+// the commit times kept for the apply latency
+static const size_t kMaxCommitTimes = 1024;
+
 FloydPrimary::FloydPrimary(FloydContext* context, PeersSet* peers, RaftMeta* raft_meta,
-    const Options& options, Logger* info_log)
+    RaftLog* raft_log, const Options& options, Logger* info_log)
   : context_(context),
     peers_(peers),
     raft_meta_(raft_meta),
+    raft_log_(raft_log),
     options_(options),
     info_log_(info_log) {
 }
@@ -76,6 +81,14 @@ void FloydPrimary::AddTask(TaskType type, bool is_delay) {
     case kNewCommand:
       bg_thread_.Schedule(LaunchNewCommandWrapper, this);
       break;
+    case kLightHeartBeat:
+      if (is_delay) {
+        uint64_t timeout = options_.light_heartbeat_us;
+        bg_thread_.DelaySchedule(timeout / 1000LL, LaunchLightHeartBeatWrapper, this);
+      } else {
+        bg_thread_.Schedule(LaunchLightHeartBeatWrapper, this);
+      }
+      break;
     default:
       LOGV(WARN_LEVEL, info_log_, "FloydPrimary:: unknown task type %d", type);
       break;
@@ -94,6 +107,18 @@ void FloydPrimary::LaunchHeartBeat() {
   }
 }
 
+void FloydPrimary::LaunchLightHeartBeatWrapper(void *arg) {
+  reinterpret_cast<FloydPrimary *>(arg)->LaunchLightHeartBeat();
+}
+
+void FloydPrimary::LaunchLightHeartBeat() {
+  slash::MutexLock l(&context_->global_mu);
+  if (context_->role == Role::kLeader) {
+    NoticePeerTask(kLightHeartBeat);
+    AddTask(kLightHeartBeat);
+  }
+}
+
 void FloydPrimary::LaunchCheckLeaderWrapper(void *arg) {
   reinterpret_cast<FloydPrimary *>(arg)->LaunchCheckLeader();
 }
@@ -105,17 +130,15 @@ void FloydPrimary::LaunchCheckLeader() {
       context_->BecomeLeader();
       context_->voted_for_ip = options_.local_ip;
       context_->voted_for_port = options_.local_port;
-      raft_meta_->SetCurrentTerm(context_->current_term);
-      raft_meta_->SetVotedForIp(context_->voted_for_ip);
-      raft_meta_->SetVotedForPort(context_->voted_for_port);
+      raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+          context_->voted_for_ip, context_->voted_for_port);
     } else if (context_->last_op_time + options_.check_leader_us < slash::NowMicros()) {
       context_->BecomeCandidate();
-      LOGV(INFO_LEVEL, info_log_, "FloydPrimary::LaunchCheckLeader: %s:%d Become Candidate because of timeout, new term is %d"
+      LOGV(INFO_LEVEL, info_log_, "FloydPrimary::LaunchCheckLeader: %s:%d Become Candidate because of timeout, new term is %lu"
          " voted for %s:%d", options_.local_ip.c_str(), options_.local_port, context_->current_term,
          context_->voted_for_ip.c_str(), context_->voted_for_port);
-      raft_meta_->SetCurrentTerm(context_->current_term);
-      raft_meta_->SetVotedForIp(context_->voted_for_ip);
-      raft_meta_->SetVotedForPort(context_->voted_for_port);
+      raft_meta_->SetCurrentTermAndVotedFor(context_->current_term,
+          context_->voted_for_ip, context_->voted_for_port);
       NoticePeerTask(kHeartBeat);
     }
   }
@@ -141,15 +164,18 @@ void FloydPrimary::NoticePeerTask(TaskType type) {
   for (auto& peer : (*peers_)) {
     switch (type) {
     case kHeartBeat:
-      LOGV(INFO_LEVEL, info_log_, "FloydPrimary::NoticePeerTask server %s:%d Add request Task to queue to %s at term %d",
+      LOGV(INFO_LEVEL, info_log_, "FloydPrimary::NoticePeerTask server %s:%d Add request Task to queue to %s at term %lu",
           options_.local_ip.c_str(), options_.local_port, peer.second->peer_addr().c_str(), context_->current_term);
       peer.second->AddRequestVoteTask();
       break;
     case kNewCommand:
-      LOGV(DEBUG_LEVEL, info_log_, "FloydPrimary::NoticePeerTask server %s:%d Add appendEntries Task to queue to %s at term %d",
+      LOGV(DEBUG_LEVEL, info_log_, "FloydPrimary::NoticePeerTask server %s:%d Add appendEntries Task to queue to %s at term %lu",
           options_.local_ip.c_str(), options_.local_port, peer.second->peer_addr().c_str(), context_->current_term);
       peer.second->AddAppendEntriesTask();
       break;
+    case kLightHeartBeat:
+      peer.second->AddLeaderHeartbeatTask();
+      break;
     default:
       LOGV(WARN_LEVEL, info_log_, "FloydPrimary::NoticePeerTask server %s:%d Error TaskType to notice peer",
           options_.local_ip.c_str(), options_.local_port);
@@ -157,4 +183,45 @@ void FloydPrimary::NoticePeerTask(TaskType type) {
   }
 }
 
+uint64_t FloydPrimary::QuorumMatchIndex() {
+  std::vector<uint64_t> values;
+  std::map<std::string, Peer*>::iterator iter;
+  for (iter = peers_->begin(); iter != peers_->end(); iter++) {
+    values.push_back(iter->second->match_index());
+  }
+  // the leader's entries are sent before they are synced, so the leader
+  // only counts the ones it has persisted
+  values.push_back(raft_log_->GetPersistedIndex());
+  std::sort(values.begin(), values.end());
+  // a majority has the entries up to it
+  uint64_t quorum_index = values.at((values.size() - 1) / 2);
+  LOGV(DEBUG_LEVEL, info_log_, "FloydPrimary::QuorumMatchIndex: %lu members, quorum match_index %lu",
+      values.size(), quorum_index);
+  return quorum_index;
+}
+
+// only leader will call AdvanceCommitIndex
+// follower only need set commit as leader's
+bool FloydPrimary::AdvanceLeaderCommitIndex() {
+  uint64_t new_commit_index = QuorumMatchIndex();
+  // only log entries from the leader's current term are committed by
+  // counting replicas
+  if (context_->commit_index < new_commit_index
+      && raft_log_->GetTerm(new_commit_index) == context_->current_term) {
+    context_->commit_index = new_commit_index;
+    raft_meta_->SetCommitIndex(context_->commit_index);
+    context_->commit_times.push_back(std::make_pair(new_commit_index, slash::NowMicros()));
+    if (context_->commit_times.size() > kMaxCommitTimes) {
+      context_->commit_times.pop_front();
+    }
+    // the followers needn't wait for the next AppendEntries or heartbeat
+    // to learn it, the pushes of one peer are coalesced
+    for (auto& pt : (*peers_)) {
+      pt.second->AddCommitTask();
+    }
+    return true;
+  }
+  return false;
+}
+
 }  // namespace floyd
@@ -28,28 +28,38 @@ class FloydPrimary;
 class FloydContext;
 class FloydApply;
 class RaftMeta;
+class RaftLog;
 class Peer;
 class Options;
 
 enum TaskType {
   kHeartBeat = 0,
   kCheckLeader = 1,
-  kNewCommand = 2
+  kNewCommand = 2,
+  kLightHeartBeat = 3
 };
 
 class FloydPrimary {
  public:
   FloydPrimary(FloydContext* context, PeersSet* peers, RaftMeta* raft_meta,
-      const Options& options, Logger* info_log);
+      RaftLog* raft_log, const Options& options, Logger* info_log);
   virtual ~FloydPrimary();
 
   int Start();
   int Stop();
   void AddTask(TaskType type, bool is_delay = true);
+
+  /*
+   * advance the commit index to what a majority has, including the entries
+   * the leader itself has persisted, return true if it advances
+   * called with context_->global_mu held
+   */
+  bool AdvanceLeaderCommitIndex();
  private:
   FloydContext* const context_;
   PeersSet* const peers_;
   RaftMeta* const raft_meta_;
+  RaftLog* const raft_log_;
   Options options_;
   Logger* const info_log_;
 
@@ -65,8 +75,11 @@ class FloydPrimary {
   void LaunchCheckLeader();
   static void LaunchNewCommandWrapper(void *arg);
   void LaunchNewCommand();
+  static void LaunchLightHeartBeatWrapper(void *arg);
+  void LaunchLightHeartBeat();
 
   void NoticePeerTask(TaskType type);
+  uint64_t QuorumMatchIndex();
 
   // No copying allowed
   FloydPrimary(const FloydPrimary&);
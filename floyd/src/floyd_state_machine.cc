@@ -0,0 +1,48 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/include/floyd_state_machine.h"
+
+namespace floyd {
+
+StateMachineBatch::StateMachineBatch()
+  : data_size_(0) {
+}
+
+StateMachineBatch::~StateMachineBatch() {
+}
+
+void StateMachineBatch::Put(const std::string& key, const std::string& value) {
+  latest_[key] = ops_.size();
+  ops_.push_back(Op());
+  ops_.back().type = kPut;
+  ops_.back().key = key;
+  ops_.back().value = value;
+  data_size_ += key.size() + value.size();
+}
+
+void StateMachineBatch::Delete(const std::string& key) {
+  latest_[key] = ops_.size();
+  ops_.push_back(Op());
+  ops_.back().type = kDelete;
+  ops_.back().key = key;
+  data_size_ += key.size();
+}
+
+void StateMachineBatch::Clear() {
+  ops_.clear();
+  latest_.clear();
+  data_size_ = 0;
+}
+
+const StateMachineBatch::Op* StateMachineBatch::Find(const std::string& key) const {
+  std::unordered_map<std::string, size_t>::const_iterator iter = latest_.find(key);
+  if (iter == latest_.end()) {
+    return NULL;
+  }
+  return &ops_[iter->second];
+}
+
+}  // namespace floyd
@@ -93,7 +93,17 @@ int FloydWorkerConn::DealMessage() {
       break;
     case Type::kAppendEntries:
       response_.set_type(Type::kAppendEntries);
-      floyd_->ReplyAppendEntries(request_, &response_);
+      floyd_->ReplyAppendEntries(&request_, &response_);
+      response_.set_code(StatusCode::kOk);
+      break;
+    case Type::kInstallSnapshot:
+      response_.set_type(Type::kInstallSnapshot);
+      floyd_->ReplyInstallSnapshot(request_, &response_);
+      response_.set_code(StatusCode::kOk);
+      break;
+    case Type::kLeaderHeartbeat:
+      response_.set_type(Type::kLeaderHeartbeat);
+      floyd_->ReplyLeaderHeartbeat(request_, &response_);
       response_.set_code(StatusCode::kOk);
       break;
     default:
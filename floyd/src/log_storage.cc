@@ -0,0 +1,396 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/log_storage.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "rocksdb/iterator.h"
+#include "rocksdb/write_batch.h"
+#include "slash/include/env.h"
+
+#include "floyd/src/logger.h"
+#include "floyd/src/segment_log_storage.h"
+
+namespace floyd {
+
+// max entries moved in one batch when converting log storage
+static const uint64_t kConvertBatchCount = 1024;
+// the readahead of the iterator in Scan, since we always read forward
+static const size_t kScanReadaheadSize = 2 * 1024 * 1024;
+static const std::string kLogColumnFamily = "log";
+static const std::string kMetaColumnFamily = "meta";
+// bytes moved in one batch when moving keys out of the default column family
+static const size_t kMoveBatchBytes = 4 * 1024 * 1024;
+
+extern std::string UintToBitStr(const uint64_t num) {
+  char buf[8];
+  uint64_t num1 = htobe64(num);
+  memcpy(buf, &num1, sizeof(uint64_t));
+  return std::string(buf, 8);
+}
+
+extern uint64_t BitStrToUint(const std::string &str) {
+  uint64_t num;
+  memcpy(&num, str.c_str(), sizeof(uint64_t));
+  return be64toh(num);
+}
+
+RocksdbLogStorage::RocksdbLogStorage(rocksdb::DB* db, Logger* info_log)
+  : db_(db),
+    cf_(db->DefaultColumnFamily()),
+    info_log_(info_log),
+    first_index_(0),
+    last_index_(0) {
+}
+
+RocksdbLogStorage::RocksdbLogStorage(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf,
+    Logger* info_log)
+  : db_(db),
+    cf_(cf),
+    info_log_(info_log),
+    first_index_(0),
+    last_index_(0) {
+}
+
+RocksdbLogStorage::~RocksdbLogStorage() {
+}
+
+Status RocksdbLogStorage::Open() {
+  // in the default column family of an old db, the raft meta keys share the
+  // keyspace with the log, all of them are longer than the 8 bytes index key,
+  // so we skip them here, the log column family only has the index keys
+  rocksdb::Iterator *it = db_->NewIterator(rocksdb::ReadOptions(), cf_);
+  it->SeekToFirst();
+  if (it->Valid() && it->key().size() == sizeof(uint64_t)) {
+    first_index_ = BitStrToUint(it->key().ToString());
+  }
+  it->SeekToLast();
+  while (it->Valid() && it->key().size() != sizeof(uint64_t)) {
+    it->Prev();
+  }
+  if (it->Valid()) {
+    last_index_ = BitStrToUint(it->key().ToString());
+  }
+  rocksdb::Status s = it->status();
+  delete it;
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RocksdbLogStorage::Open seek log failed, error: %s", s.ToString().c_str());
+    return Status::Corruption(s.ToString());
+  }
+  if (last_index_ == 0) {
+    first_index_ = 0;
+  }
+  return Status::OK();
+}
+
+uint64_t RocksdbLogStorage::FirstIndex() {
+  return first_index_;
+}
+
+uint64_t RocksdbLogStorage::LastIndex() {
+  return last_index_;
+}
+
+Status RocksdbLogStorage::Append(uint64_t index, const std::vector<std::string>& bufs) {
+  if (bufs.empty()) {
+    return Status::OK();
+  }
+  rocksdb::WriteBatch wb;
+  for (size_t i = 0; i < bufs.size(); i++) {
+    wb.Put(cf_, UintToBitStr(index + i), bufs[i]);
+  }
+  rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &wb);
+  if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  if (last_index_ == 0) {
+    first_index_ = index;
+  }
+  last_index_ = index + bufs.size() - 1;
+  return Status::OK();
+}
+
+Status RocksdbLogStorage::Sync() {
+  rocksdb::Status s = db_->SyncWAL();
+  if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  return Status::OK();
+}
+
+Status RocksdbLogStorage::Get(uint64_t index, std::string* buf) {
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), cf_, UintToBitStr(index), buf);
+  if (s.IsNotFound()) {
+    return Status::NotFound("index " + std::to_string(index));
+  } else if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  return Status::OK();
+}
+
+Status RocksdbLogStorage::Scan(uint64_t begin, uint64_t end, uint64_t max_bytes,
+    std::vector<std::string>* bufs) {
+  bufs->clear();
+  if (begin > end) {
+    return Status::OK();
+  }
+  std::string upper_bound = UintToBitStr(end + 1);
+  rocksdb::Slice upper_bound_slice(upper_bound);
+  rocksdb::ReadOptions read_options;
+  read_options.readahead_size = kScanReadaheadSize;
+  read_options.iterate_upper_bound = &upper_bound_slice;
+  rocksdb::Iterator *it = db_->NewIterator(read_options, cf_);
+  uint64_t bytes = 0;
+  uint64_t index = begin;
+  for (it->Seek(UintToBitStr(begin)); it->Valid() && bytes < max_bytes; it->Next(), index++) {
+    // stop at the first hole, the entries returned should be continuous
+    if (it->key().size() != sizeof(uint64_t) || BitStrToUint(it->key().ToString()) != index) {
+      break;
+    }
+    bufs->push_back(it->value().ToString());
+    bytes += it->value().size();
+  }
+  rocksdb::Status s = it->status();
+  delete it;
+  if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  if (bufs->empty()) {
+    return Status::NotFound("index " + std::to_string(begin));
+  }
+  return Status::OK();
+}
+
+Status RocksdbLogStorage::TruncateSuffix(uint64_t index) {
+  uint64_t last_index = last_index_;
+  if (last_index == 0 || index > last_index) {
+    return Status::OK();
+  }
+  // one range tombstone instead of one tombstone for every entry, which
+  // slows down the reads after a large truncation
+  rocksdb::WriteBatch batch;
+  batch.DeleteRange(cf_, UintToBitStr(std::max(index, first_index_.load())),
+      UintToBitStr(last_index + 1));
+  rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  if (index <= first_index_) {
+    first_index_ = 0;
+    last_index_ = 0;
+  } else {
+    last_index_ = index - 1;
+  }
+  return Status::OK();
+}
+
+Status RocksdbLogStorage::TruncatePrefix(uint64_t index) {
+  uint64_t first_index = first_index_;
+  if (first_index == 0 || index < first_index) {
+    return Status::OK();
+  }
+  rocksdb::WriteBatch batch;
+  batch.DeleteRange(cf_, UintToBitStr(first_index),
+      UintToBitStr(std::min(index, last_index_.load()) + 1));
+  rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    return Status::IOError(s.ToString());
+  }
+  if (index >= last_index_) {
+    first_index_ = 0;
+    last_index_ = 0;
+  } else {
+    first_index_ = index + 1;
+  }
+  return Status::OK();
+}
+
+uint64_t RocksdbLogStorage::ApproximateBytes() {
+  uint64_t sst_bytes = 0, memtable_bytes = 0;
+  db_->GetIntProperty(cf_, "rocksdb.estimate-live-data-size", &sst_bytes);
+  db_->GetIntProperty(cf_, "rocksdb.cur-size-all-mem-tables", &memtable_bytes);
+  return sst_bytes + memtable_bytes;
+}
+
+Status ConvertLogStorage(LogStorage* src, LogStorage* dst, Logger* info_log) {
+  uint64_t first_index = src->FirstIndex();
+  uint64_t last_index = src->LastIndex();
+  if (last_index == 0) {
+    return Status::OK();
+  }
+  LOGV(INFO_LEVEL, info_log, "ConvertLogStorage: convert log entries [%lu, %lu]", first_index, last_index);
+
+  Status s;
+  std::string buf;
+  std::vector<std::string> bufs;
+  for (uint64_t index = first_index; index <= last_index; index++) {
+    s = src->Get(index, &buf);
+    if (!s.ok()) {
+      LOGV(ERROR_LEVEL, info_log, "ConvertLogStorage: get entry %lu failed, error: %s",
+          index, s.ToString().c_str());
+      return s;
+    }
+    bufs.push_back(buf);
+    if (bufs.size() >= kConvertBatchCount || index == last_index) {
+      s = dst->Append(index - bufs.size() + 1, bufs);
+      if (!s.ok()) {
+        LOGV(ERROR_LEVEL, info_log, "ConvertLogStorage: append entries before %lu failed, error: %s",
+            index, s.ToString().c_str());
+        return s;
+      }
+      bufs.clear();
+    }
+  }
+  // the entries should be durable in dst before they are removed from src
+  s = dst->Sync();
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log, "ConvertLogStorage: sync entries failed, error: %s", s.ToString().c_str());
+    return s;
+  }
+  return src->TruncateSuffix(first_index);
+}
+
+// move the keys in the default column family to log_cf or meta_cf
+static Status MoveDefaultColumnFamily(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* log_cf,
+    rocksdb::ColumnFamilyHandle* meta_cf, Logger* info_log) {
+  rocksdb::Iterator* it = db->NewIterator(rocksdb::ReadOptions());
+  it->SeekToFirst();
+  if (!it->Valid()) {
+    delete it;
+    return Status::OK();
+  }
+  std::string first_key = it->key().ToString();
+  std::string last_key;
+  uint64_t count = 0;
+  rocksdb::Status s;
+  rocksdb::WriteBatch batch;
+  // the keys are only removed from the default column family after all of
+  // them are copied, so an interrupted move is done again at the next open
+  for (; s.ok() && it->Valid(); it->Next()) {
+    rocksdb::ColumnFamilyHandle* cf = it->key().size() == sizeof(uint64_t) ? log_cf : meta_cf;
+    batch.Put(cf, it->key(), it->value());
+    last_key = it->key().ToString();
+    count++;
+    if (batch.GetDataSize() >= kMoveBatchBytes) {
+      s = db->Write(rocksdb::WriteOptions(), &batch);
+      batch.Clear();
+    }
+  }
+  if (s.ok()) {
+    s = it->status();
+  }
+  delete it;
+  if (s.ok()) {
+    s = db->Write(rocksdb::WriteOptions(), &batch);
+  }
+  if (s.ok()) {
+    batch.Clear();
+    batch.DeleteRange(first_key, last_key);
+    batch.Delete(last_key);
+    rocksdb::WriteOptions write_options;
+    write_options.sync = true;
+    s = db->Write(write_options, &batch);
+  }
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log, "MoveDefaultColumnFamily: move keys failed, error: %s", s.ToString().c_str());
+    return Status::IOError(s.ToString());
+  }
+  LOGV(INFO_LEVEL, info_log, "MoveDefaultColumnFamily: move %lu keys to column family %s and %s",
+      count, kLogColumnFamily.c_str(), kMetaColumnFamily.c_str());
+  return Status::OK();
+}
+
+Status OpenLogAndMetaDB(const std::string& path, Logger* info_log, rocksdb::DB** db,
+    rocksdb::ColumnFamilyHandle** log_cf, rocksdb::ColumnFamilyHandle** meta_cf) {
+  rocksdb::DBOptions db_options;
+  db_options.create_if_missing = true;
+  db_options.create_missing_column_families = true;
+  db_options.max_background_flushes = 8;
+
+  // the entries are written once and read by range, compression
+  // only costs cpu for the short lived entries
+  rocksdb::ColumnFamilyOptions log_options;
+  log_options.write_buffer_size = 1024 * 1024 * 1024;
+  log_options.compression = rocksdb::kNoCompression;
+  // a few small keys updated in place
+  rocksdb::ColumnFamilyOptions meta_options;
+  meta_options.write_buffer_size = 1024 * 1024;
+
+  std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
+  column_families.push_back(rocksdb::ColumnFamilyDescriptor(
+        rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions()));
+  column_families.push_back(rocksdb::ColumnFamilyDescriptor(kLogColumnFamily, log_options));
+  column_families.push_back(rocksdb::ColumnFamilyDescriptor(kMetaColumnFamily, meta_options));
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  rocksdb::Status s = rocksdb::DB::Open(db_options, path, column_families, &handles, db);
+  if (!s.ok()) {
+    return Status::Corruption("open " + path, s.ToString());
+  }
+  // the default column family is only used by an old db
+  delete handles[0];
+  *log_cf = handles[1];
+  *meta_cf = handles[2];
+  Status result = MoveDefaultColumnFamily(*db, *log_cf, *meta_cf, info_log);
+  if (!result.ok()) {
+    delete *log_cf;
+    delete *meta_cf;
+    delete *db;
+    *db = NULL;
+    return result;
+  }
+  return Status::OK();
+}
+
+Status OpenLogStorage(const Options& options, rocksdb::DB* db,
+    rocksdb::ColumnFamilyHandle* log_cf, Logger* info_log, LogStorage** storage) {
+  *storage = NULL;
+  std::string segment_path = options.path + "/segment/";
+  LogStorage* rocksdb_storage = new RocksdbLogStorage(db, log_cf, info_log);
+  LogStorage* segment_storage = NULL;
+  Status s = rocksdb_storage->Open();
+  if (s.ok() && (options.log_engine == kSegmentLog || slash::FileExists(segment_path))) {
+    segment_storage = new SegmentLogStorage(segment_path, options.log_segment_size, info_log);
+    s = segment_storage->Open();
+  }
+  if (!s.ok()) {
+    delete rocksdb_storage;
+    delete segment_storage;
+    return s;
+  }
+
+  LogStorage* from = segment_storage;
+  LogStorage* to = rocksdb_storage;
+  if (options.log_engine == kSegmentLog) {
+    from = rocksdb_storage;
+    to = segment_storage;
+  }
+  if (from != NULL && from->LastIndex() != 0) {
+    if (to->LastIndex() >= from->LastIndex()) {
+      // the last convert is finished, but interrupted before the source is truncated
+      s = from->TruncateSuffix(from->FirstIndex());
+    } else {
+      // drop the entries of an unfinished convert and do it again
+      s = to->TruncateSuffix(to->FirstIndex());
+      if (s.ok()) {
+        s = ConvertLogStorage(from, to, info_log);
+      }
+    }
+  }
+  delete from;
+  if (!s.ok()) {
+    delete to;
+    return s;
+  }
+  *storage = to;
+  return Status::OK();
+}
+
+}  // namespace floyd
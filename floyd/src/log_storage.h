@@ -0,0 +1,131 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_LOG_STORAGE_H_
+#define FLOYD_SRC_LOG_STORAGE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "slash/include/slash_status.h"
+
+#include "floyd/include/floyd_options.h"
+
+namespace floyd {
+
+using slash::Status;
+
+class Logger;
+
+// the big endian index is used as the key of the log entry in rocksdb
+extern std::string UintToBitStr(const uint64_t num);
+extern uint64_t BitStrToUint(const std::string &str);
+
+/*
+ * LogStorage is where RaftLog keeps its entries.
+ * Every entry is stored as a serialized buffer addressed by its log index,
+ * the indexes in the storage are always continuous [FirstIndex(), LastIndex()].
+ * RaftLog is responsible for the serialization, the storage only need to
+ * keep the bytes, and it should be safe to be called from different threads
+ */
+class LogStorage {
+ public:
+  LogStorage() { }
+  virtual ~LogStorage() { }
+
+  virtual Status Open() = 0;
+
+  // return 0 when the storage is empty
+  virtual uint64_t FirstIndex() = 0;
+  virtual uint64_t LastIndex() = 0;
+
+  // store bufs as entry [index, index + bufs.size())
+  // index should be LastIndex() + 1 unless the storage is empty
+  virtual Status Append(uint64_t index, const std::vector<std::string>& bufs) = 0;
+  // make the entries appended before durable
+  virtual Status Sync() = 0;
+  virtual Status Get(uint64_t index, std::string* buf) = 0;
+  // read entries [begin, end] into bufs in order, stop after the total size
+  // reaches max_bytes, at least one entry is returned if begin exists
+  virtual Status Scan(uint64_t begin, uint64_t end, uint64_t max_bytes,
+      std::vector<std::string>* bufs) = 0;
+
+  // remove entries [index, LastIndex()]
+  virtual Status TruncateSuffix(uint64_t index) = 0;
+  // remove entries [FirstIndex(), index], the storage may keep some of
+  // these entries if it can only drop them in a larger granularity
+  virtual Status TruncatePrefix(uint64_t index) = 0;
+
+  // the approximate bytes used by the storage on disk
+  virtual uint64_t ApproximateBytes() = 0;
+
+ private:
+  // No copying allowed
+  LogStorage(const LogStorage&);
+  void operator=(const LogStorage&);
+};
+
+/*
+ * RocksdbLogStorage store every entry as a key in rocksdb, the key is the
+ * big endian log index, so the entries are sorted by index
+ * the entries are kept in their own column family of the db shared with
+ * RaftMeta, or in the default column family together with the meta keys
+ * in an old db
+ */
+class RocksdbLogStorage : public LogStorage {
+ public:
+  RocksdbLogStorage(rocksdb::DB* db, Logger* info_log);
+  RocksdbLogStorage(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf, Logger* info_log);
+  virtual ~RocksdbLogStorage();
+
+  virtual Status Open();
+  virtual uint64_t FirstIndex();
+  virtual uint64_t LastIndex();
+  virtual Status Append(uint64_t index, const std::vector<std::string>& bufs);
+  // sync the wal of db
+  virtual Status Sync();
+  virtual Status Get(uint64_t index, std::string* buf);
+  // read by one iterator with readahead
+  virtual Status Scan(uint64_t begin, uint64_t end, uint64_t max_bytes,
+      std::vector<std::string>* bufs);
+  virtual Status TruncateSuffix(uint64_t index);
+  virtual Status TruncatePrefix(uint64_t index);
+  virtual uint64_t ApproximateBytes();
+
+ private:
+  rocksdb::DB* const db_;
+  rocksdb::ColumnFamilyHandle* const cf_;
+  Logger* const info_log_;
+  std::atomic<uint64_t> first_index_;
+  std::atomic<uint64_t> last_index_;
+};
+
+/*
+ * Open the db in path which keeps the raft log and meta in two column
+ * families, so each of them is tuned for its own access pattern, and they
+ * can still be updated in one WriteBatch. The log and meta keys of an old db
+ * in the default column family are moved to the new ones
+ */
+extern Status OpenLogAndMetaDB(const std::string& path, Logger* info_log, rocksdb::DB** db,
+    rocksdb::ColumnFamilyHandle** log_cf, rocksdb::ColumnFamilyHandle** meta_cf);
+
+/*
+ * Create the log storage selected by options.log_engine, if the other engine
+ * still has entries, such as an old floyd data directory that store the log
+ * in rocksdb, the entries will be moved to the selected engine
+ */
+extern Status OpenLogStorage(const Options& options, rocksdb::DB* db,
+    rocksdb::ColumnFamilyHandle* log_cf, Logger* info_log, LogStorage** storage);
+
+// copy all entries from src to dst, then remove them from src
+extern Status ConvertLogStorage(LogStorage* src, LogStorage* dst, Logger* info_log);
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_LOG_STORAGE_H_
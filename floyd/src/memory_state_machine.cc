@@ -0,0 +1,379 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/memory_state_machine.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "slash/include/env.h"
+
+#include "floyd/src/logger.h"
+#include "floyd/src/crc32c.h"
+#include "floyd/include/floyd_options.h"
+
+namespace floyd {
+
+static const std::string kDataFile = "MEMORY_STATE";
+static const size_t kRecordHeaderSize = 8;
+// count (8 bytes) + crc32c of the records (4 bytes)
+static const size_t kDataTrailerSize = 12;
+static const size_t kInitialSlots = 1024;
+static const size_t kBlockSize = 1024 * 1024;
+// the arena is compacted when more than half of it is garbage
+static const uint64_t kMinCompactBytes = 64 * 1024 * 1024;
+// buffer size when writing the snapshot file
+static const size_t kSnapshotWriteBytes = 1024 * 1024;
+
+static inline uint32_t RecordKeySize(const char* record) {
+  uint32_t size;
+  memcpy(&size, record, sizeof(uint32_t));
+  return size;
+}
+
+static inline uint32_t RecordValueSize(const char* record) {
+  uint32_t size;
+  memcpy(&size, record + sizeof(uint32_t), sizeof(uint32_t));
+  return size;
+}
+
+static inline const char* RecordKey(const char* record) {
+  return record + kRecordHeaderSize;
+}
+
+static inline const char* RecordValue(const char* record) {
+  return record + kRecordHeaderSize + RecordKeySize(record);
+}
+
+static inline size_t RecordSize(const char* record) {
+  return kRecordHeaderSize + RecordKeySize(record) + RecordValueSize(record);
+}
+
+// 64-bit FNV-1a
+static inline uint64_t Hash(const char* data, size_t n) {
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < n; i++) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static Status WriteFull(int fd, const char* buf, size_t n) {
+  while (n > 0) {
+    ssize_t r = write(fd, buf, n);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Status::IOError("write " + kDataFile, strerror(errno));
+    }
+    buf += r;
+    n -= r;
+  }
+  return Status::OK();
+}
+
+MemoryStateMachine::MemoryStateMachine(Logger* info_log)
+  : info_log_(info_log),
+    count_(0),
+    alloc_ptr_(NULL),
+    alloc_remaining_(0),
+    arena_bytes_(0),
+    garbage_bytes_(0) {
+  Slot empty = {0, NULL};
+  slots_.assign(kInitialSlots, empty);
+}
+
+MemoryStateMachine::~MemoryStateMachine() {
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  }
+}
+
+char* MemoryStateMachine::Allocate(size_t bytes) {
+  if (bytes <= alloc_remaining_) {
+    char* result = alloc_ptr_;
+    alloc_ptr_ += bytes;
+    alloc_remaining_ -= bytes;
+    return result;
+  }
+  // a large record takes a block of its own, so the space left in the
+  // current block is not wasted
+  if (bytes > kBlockSize / 4) {
+    char* block = new char[bytes];
+    blocks_.push_back(block);
+    return block;
+  }
+  alloc_ptr_ = new char[kBlockSize];
+  blocks_.push_back(alloc_ptr_);
+  alloc_remaining_ = kBlockSize;
+  char* result = alloc_ptr_;
+  alloc_ptr_ += bytes;
+  alloc_remaining_ -= bytes;
+  return result;
+}
+
+char* MemoryStateMachine::NewRecord(const char* key, size_t key_size,
+    const char* value, size_t value_size) {
+  size_t size = kRecordHeaderSize + key_size + value_size;
+  char* record = Allocate(size);
+  uint32_t n = key_size;
+  memcpy(record, &n, sizeof(uint32_t));
+  n = value_size;
+  memcpy(record + sizeof(uint32_t), &n, sizeof(uint32_t));
+  memcpy(record + kRecordHeaderSize, key, key_size);
+  memcpy(record + kRecordHeaderSize + key_size, value, value_size);
+  arena_bytes_ += size;
+  return record;
+}
+
+size_t MemoryStateMachine::FindSlot(const char* key, size_t key_size, uint64_t hash) const {
+  size_t mask = slots_.size() - 1;
+  size_t pos = hash & mask;
+  while (slots_[pos].record != NULL) {
+    const char* record = slots_[pos].record;
+    if (slots_[pos].hash == hash && RecordKeySize(record) == key_size
+        && memcmp(RecordKey(record), key, key_size) == 0) {
+      break;
+    }
+    pos = (pos + 1) & mask;
+  }
+  return pos;
+}
+
+void MemoryStateMachine::PutLocked(const std::string& key, const std::string& value) {
+  uint64_t hash = Hash(key.data(), key.size());
+  size_t pos = FindSlot(key.data(), key.size(), hash);
+  char* record = NewRecord(key.data(), key.size(), value.data(), value.size());
+  if (slots_[pos].record != NULL) {
+    garbage_bytes_ += RecordSize(slots_[pos].record);
+    slots_[pos].record = record;
+    return;
+  }
+  slots_[pos].hash = hash;
+  slots_[pos].record = record;
+  count_++;
+  // keep the load factor under 0.7
+  if (count_ * 10 > slots_.size() * 7) {
+    Grow();
+  }
+}
+
+void MemoryStateMachine::DeleteLocked(const std::string& key) {
+  uint64_t hash = Hash(key.data(), key.size());
+  size_t pos = FindSlot(key.data(), key.size(), hash);
+  if (slots_[pos].record == NULL) {
+    return;
+  }
+  garbage_bytes_ += RecordSize(slots_[pos].record);
+  slots_[pos].record = NULL;
+  count_--;
+
+  // shift the following records of the probe sequence backward, so the
+  // lookups never need tombstones
+  size_t mask = slots_.size() - 1;
+  size_t hole = pos;
+  size_t next = (pos + 1) & mask;
+  while (slots_[next].record != NULL) {
+    size_t home = slots_[next].hash & mask;
+    // the record can fill the hole if its home is not in (hole, next]
+    bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+    if (movable) {
+      slots_[hole] = slots_[next];
+      slots_[next].record = NULL;
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+}
+
+void MemoryStateMachine::Grow() {
+  std::vector<Slot> old;
+  old.swap(slots_);
+  Slot empty = {0, NULL};
+  slots_.assign(old.size() * 2, empty);
+  size_t mask = slots_.size() - 1;
+  for (size_t i = 0; i < old.size(); i++) {
+    if (old[i].record == NULL) {
+      continue;
+    }
+    size_t pos = old[i].hash & mask;
+    while (slots_[pos].record != NULL) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos] = old[i];
+  }
+}
+
+void MemoryStateMachine::Compact() {
+  uint64_t start_us = slash::NowMicros();
+  uint64_t old_bytes = arena_bytes_;
+  std::vector<char*> old_blocks;
+  old_blocks.swap(blocks_);
+  alloc_ptr_ = NULL;
+  alloc_remaining_ = 0;
+  arena_bytes_ = 0;
+  garbage_bytes_ = 0;
+  for (size_t i = 0; i < slots_.size(); i++) {
+    const char* record = slots_[i].record;
+    if (record != NULL) {
+      slots_[i].record = NewRecord(RecordKey(record), RecordKeySize(record),
+          RecordValue(record), RecordValueSize(record));
+    }
+  }
+  for (size_t i = 0; i < old_blocks.size(); i++) {
+    delete [] old_blocks[i];
+  }
+  LOGV(INFO_LEVEL, info_log_, "MemoryStateMachine::Compact compact arena from %lu bytes to %lu bytes, "
+      "cost %lu us", old_bytes, arena_bytes_, slash::NowMicros() - start_us);
+}
+
+void MemoryStateMachine::ClearLocked() {
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  }
+  blocks_.clear();
+  alloc_ptr_ = NULL;
+  alloc_remaining_ = 0;
+  arena_bytes_ = 0;
+  garbage_bytes_ = 0;
+  Slot empty = {0, NULL};
+  slots_.assign(kInitialSlots, empty);
+  count_ = 0;
+}
+
+Status MemoryStateMachine::Apply(const StateMachineBatch& batch) {
+  slash::WriteLock l(&rw_);
+  const std::vector<StateMachineBatch::Op>& ops = batch.ops();
+  for (size_t i = 0; i < ops.size(); i++) {
+    if (ops[i].type == StateMachineBatch::kPut) {
+      PutLocked(ops[i].key, ops[i].value);
+    } else {
+      DeleteLocked(ops[i].key);
+    }
+  }
+  if (garbage_bytes_ >= kMinCompactBytes && garbage_bytes_ * 2 > arena_bytes_) {
+    Compact();
+  }
+  return Status::OK();
+}
+
+Status MemoryStateMachine::Read(const std::string& key, std::string* value) {
+  slash::ReadLock l(&rw_);
+  size_t pos = FindSlot(key.data(), key.size(), Hash(key.data(), key.size()));
+  const char* record = slots_[pos].record;
+  if (record == NULL) {
+    return Status::NotFound(key);
+  }
+  value->assign(RecordValue(record), RecordValueSize(record));
+  return Status::OK();
+}
+
+Status MemoryStateMachine::Snapshot(const std::string& dir) {
+  slash::ReadLock l(&rw_);
+  uint64_t start_us = slash::NowMicros();
+  if (slash::CreatePath(dir) != 0 && !slash::FileExists(dir)) {
+    return Status::IOError("create " + dir, strerror(errno));
+  }
+  std::string filename = dir + "/" + kDataFile;
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  Status s;
+  std::string buf;
+  uint32_t crc = 0;
+  for (size_t i = 0; i < slots_.size() && s.ok(); i++) {
+    const char* record = slots_[i].record;
+    if (record == NULL) {
+      continue;
+    }
+    buf.append(record, RecordSize(record));
+    if (buf.size() >= kSnapshotWriteBytes) {
+      crc = crc32c::Extend(crc, buf.data(), buf.size());
+      s = WriteFull(fd, buf.data(), buf.size());
+      buf.clear();
+    }
+  }
+  if (s.ok()) {
+    crc = crc32c::Extend(crc, buf.data(), buf.size());
+    uint64_t count = count_;
+    char trailer[kDataTrailerSize];
+    memcpy(trailer, &count, sizeof(uint64_t));
+    memcpy(trailer + sizeof(uint64_t), &crc, sizeof(uint32_t));
+    buf.append(trailer, kDataTrailerSize);
+    s = WriteFull(fd, buf.data(), buf.size());
+  }
+  if (s.ok() && fsync(fd) != 0) {
+    s = Status::IOError("fsync " + filename, strerror(errno));
+  }
+  close(fd);
+  if (s.ok()) {
+    LOGV(INFO_LEVEL, info_log_, "MemoryStateMachine::Snapshot write %lu keys to %s, cost %lu us",
+        count_, dir.c_str(), slash::NowMicros() - start_us);
+  }
+  return s;
+}
+
+Status MemoryStateMachine::Restore(const std::string& dir) {
+  uint64_t start_us = slash::NowMicros();
+  std::string filename = dir + "/" + kDataFile;
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  std::string data;
+  char tmp[64 * 1024];
+  ssize_t n;
+  while ((n = read(fd, tmp, sizeof(tmp))) != 0) {
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0) {
+      close(fd);
+      return Status::IOError("read " + filename, strerror(errno));
+    }
+    data.append(tmp, n);
+  }
+  close(fd);
+  if (data.size() < kDataTrailerSize) {
+    return Status::Corruption("memory state " + filename, "truncated");
+  }
+  size_t size = data.size() - kDataTrailerSize;
+  uint64_t count;
+  uint32_t crc;
+  memcpy(&count, data.data() + size, sizeof(uint64_t));
+  memcpy(&crc, data.data() + size + sizeof(uint64_t), sizeof(uint32_t));
+  if (crc32c::Value(data.data(), size) != crc) {
+    return Status::Corruption("memory state " + filename, "checksum mismatch");
+  }
+
+  slash::WriteLock l(&rw_);
+  ClearLocked();
+  const char* p = data.data();
+  const char* limit = p + size;
+  uint64_t restored = 0;
+  while (p + kRecordHeaderSize <= limit) {
+    size_t record_size = RecordSize(p);
+    if (p + record_size > limit) {
+      break;
+    }
+    PutLocked(std::string(RecordKey(p), RecordKeySize(p)),
+        std::string(RecordValue(p), RecordValueSize(p)));
+    p += record_size;
+    restored++;
+  }
+  if (p != limit || restored != count) {
+    ClearLocked();
+    return Status::Corruption("memory state " + filename, "bad record");
+  }
+  LOGV(INFO_LEVEL, info_log_, "MemoryStateMachine::Restore restore %lu keys from %s, cost %lu us",
+      restored, dir.c_str(), slash::NowMicros() - start_us);
+  return Status::OK();
+}
+
+}  // namespace floyd
@@ -0,0 +1,82 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_MEMORY_STATE_MACHINE_H_
+#define FLOYD_SRC_MEMORY_STATE_MACHINE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "slash/include/slash_mutex.h"
+
+#include "floyd/include/floyd_state_machine.h"
+
+namespace floyd {
+
+class Logger;
+
+/*
+ * MemoryStateMachine keeps all the keys in an open addressing hash table
+ * with linear probing, the keys and values are allocated in an arena as
+ * | key size (4 bytes) | value size (4 bytes) | key | value |
+ *
+ * an overwritten or deleted record stays in the arena as garbage until
+ * the arena is compacted. The state is lost after restart, floyd restores
+ * it from the latest snapshot and replays the log after it
+ */
+class MemoryStateMachine : public StateMachine {
+ public:
+  explicit MemoryStateMachine(Logger* info_log);
+  virtual ~MemoryStateMachine();
+
+  virtual Status Apply(const StateMachineBatch& batch) override;
+  virtual Status Read(const std::string& key, std::string* value) override;
+  virtual Status Snapshot(const std::string& dir) override;
+  virtual Status Restore(const std::string& dir) override;
+  virtual bool Durable() const override { return false; }
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    // NULL if the slot is empty
+    char* record;
+  };
+
+  Logger* const info_log_;
+
+  slash::RWMutex rw_;
+  // the size is always a power of 2
+  std::vector<Slot> slots_;
+  size_t count_;
+
+  std::vector<char*> blocks_;
+  char* alloc_ptr_;
+  size_t alloc_remaining_;
+  // bytes of all the records in arena, and of the dead ones in them
+  uint64_t arena_bytes_;
+  uint64_t garbage_bytes_;
+
+  // return the slot of key, or the empty slot where key should be inserted
+  size_t FindSlot(const char* key, size_t key_size, uint64_t hash) const;
+  void PutLocked(const std::string& key, const std::string& value);
+  void DeleteLocked(const std::string& key);
+  char* NewRecord(const char* key, size_t key_size, const char* value, size_t value_size);
+  char* Allocate(size_t bytes);
+  // double the slots when the load factor is too high
+  void Grow();
+  // copy the live records to a new arena
+  void Compact();
+  void ClearLocked();
+
+  // No copying allowed
+  MemoryStateMachine(const MemoryStateMachine&);
+  void operator=(const MemoryStateMachine&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_MEMORY_STATE_MACHINE_H_
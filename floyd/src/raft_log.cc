@@ -5,134 +5,623 @@
 
 #include "floyd/src/raft_log.h"
 
+#include <stdlib.h>
 #include <google/protobuf/text_format.h>
 
+#include <limits>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <utility>
 
 #include "rocksdb/db.h"
 #include "rocksdb/iterator.h"
+#include "slash/include/env.h"
 #include "slash/include/xdebug.h"
 
 #include "floyd/src/floyd.pb.h"
+#include "floyd/src/entry_codec.h"
 #include "floyd/src/logger.h"
+#include "floyd/src/log_storage.h"
 #include "floyd/include/floyd_options.h"
 
 namespace floyd {
-extern std::string UintToBitStr(const uint64_t num) {
-  char buf[8];
-  uint64_t num1 = htobe64(num);
-  memcpy(buf, &num1, sizeof(uint64_t));
-  return std::string(buf, 8);
-}
 
-extern uint64_t BitStrToUint(const std::string &str) {
-  uint64_t num;
-  memcpy(&num, str.c_str(), sizeof(uint64_t));
-  return be64toh(num);
+// the bytes read at one time when rebuilding the term runs
+static const uint64_t kRebuildScanBytes = 4 * 1024 * 1024;
+// the max entries written in one group, an Append is never split
+static const size_t kMaxGroupEntries = 4096;
+
+RaftLog::RaftLog(LogStorage* storage, Logger* info_log, uint64_t cache_size,
+    LogSyncMode sync_mode) :
+  storage_(storage),
+  info_log_(info_log),
+  sync_mode_(sync_mode),
+  last_log_index_(0),
+  persisted_index_(0),
+  snapshot_index_(0),
+  cache_(cache_size),
+  write_groups_(0),
+  write_appends_(0),
+  syncs_(0),
+  sync_us_(0),
+  max_sync_us_(0) {
+  last_log_index_ = storage_->LastIndex();
+  persisted_index_ = last_log_index_;
+  RebuildTermRuns();
 }
 
-RaftLog::RaftLog(rocksdb::DB *db, Logger *info_log) :
-  db_(db),
+RaftLog::RaftLog(rocksdb::DB *db, Logger *info_log, uint64_t cache_size) :
+  storage_(new RocksdbLogStorage(db, info_log)),
   info_log_(info_log),
-  last_log_index_(0) {
-  rocksdb::Iterator *it = db_->NewIterator(rocksdb::ReadOptions());
-  it->SeekToLast();
-  if (it->Valid()) {
-    it->Prev();
-    it->Prev();
-    it->Prev();
-    it->Prev();
-    it->Prev();
-    if (it->Valid()) {
-      last_log_index_ = BitStrToUint(it->key().ToString());
-    }
+  sync_mode_(kLogSyncNone),
+  last_log_index_(0),
+  persisted_index_(0),
+  snapshot_index_(0),
+  cache_(cache_size),
+  write_groups_(0),
+  write_appends_(0),
+  syncs_(0),
+  sync_us_(0),
+  max_sync_us_(0) {
+  Status s = storage_->Open();
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::RaftLog open log storage failed, error: %s", s.ToString().c_str());
   }
-  delete it;
+  last_log_index_ = storage_->LastIndex();
+  persisted_index_ = last_log_index_;
+  RebuildTermRuns();
 }
 
 RaftLog::~RaftLog() {
+  delete storage_;
 }
 
-uint64_t RaftLog::Append(const std::vector<const Entry *> &entries) {
-  slash::MutexLock l(&lli_mutex_);
-  rocksdb::WriteBatch wb;
-  LOGV(DEBUG_LEVEL, info_log_, "RaftLog::Append: entries.size %lld", entries.size());
-  // try to commit entries in one batch
+uint64_t RaftLog::Append(const std::vector<const Entry *> &entries,
+    void (*on_written)(void*), void* arg) {
+  // encode the entries before joining the group, so it is done in parallel
+  std::vector<std::string> bufs(entries.size());
+  std::vector<uint64_t> terms(entries.size());
   for (size_t i = 0; i < entries.size(); i++) {
-    std::string buf;
-    entries[i]->SerializeToString(&buf);
-    last_log_index_++;
-    wb.Put(UintToBitStr(last_log_index_), buf);
+    EncodeEntry(*entries[i], &bufs[i]);
+    terms[i] = entries[i]->term();
+  }
+  return AppendEncoded(&bufs, terms, on_written, arg);
+}
+
+uint64_t RaftLog::AppendEncoded(std::vector<std::string>* bufs, const std::vector<uint64_t>& terms,
+    void (*on_written)(void*), void* arg) {
+  Writer w(&writers_mu_);
+  w.bufs = bufs;
+  w.terms = &terms;
+  w.on_written = on_written;
+  w.arg = arg;
+  writers_mu_.Lock();
+  writers_.push_back(&w);
+  while (!w.done && &w != writers_.front()) {
+    w.cv.Wait();
+  }
+  if (w.done) {
+    writers_mu_.Unlock();
+    return w.last_index;
+  }
+
+  // I am the first one, write the Appends queued after me together
+  std::vector<Writer*> group;
+  size_t count = 0;
+  for (std::deque<Writer*>::iterator iter = writers_.begin(); iter != writers_.end(); iter++) {
+    if (!group.empty() && (sync_mode_ == kLogSyncEveryWrite
+          || count + (*iter)->bufs->size() > kMaxGroupEntries)) {
+      break;
+    }
+    group.push_back(*iter);
+    count += (*iter)->bufs->size();
+  }
+  writers_mu_.Unlock();
+
+  WriteGroup(group);
+
+  writers_mu_.Lock();
+  for (size_t i = 0; i < group.size(); i++) {
+    writers_.pop_front();
+    if (group[i] != &w) {
+      group[i]->done = true;
+      group[i]->cv.Signal();
+    }
+  }
+  // the next group
+  if (!writers_.empty()) {
+    writers_.front()->cv.Signal();
   }
-  rocksdb::Status s;
-  s = db_->Write(rocksdb::WriteOptions(), &wb);
+  writers_mu_.Unlock();
+  return w.last_index;
+}
+
+void RaftLog::WriteGroup(const std::vector<Writer*>& group) {
+  slash::MutexLock wl(&write_mu_);
+  // move the entries of the group together, no copy of the bytes
+  std::vector<std::string> bufs;
+  if (group.size() == 1) {
+    bufs.swap(*group[0]->bufs);
+  } else {
+    for (size_t i = 0; i < group.size(); i++) {
+      std::vector<std::string>& writer_bufs = *group[i]->bufs;
+      for (size_t j = 0; j < writer_bufs.size(); j++) {
+        bufs.push_back(std::string());
+        bufs.back().swap(writer_bufs[j]);
+      }
+    }
+  }
+  LOGV(DEBUG_LEVEL, info_log_, "RaftLog::WriteGroup: %zu appends, entries.size %zu", group.size(), bufs.size());
+
+  // last_log_index_ is only modified with write_mu_ held
+  uint64_t index = last_log_index_ + 1;
+  uint64_t count = bufs.size();
+  Status s = storage_->Append(index, bufs);
   if (!s.ok()) {
-    last_log_index_ -= entries.size();
-    LOGV(ERROR_LEVEL, info_log_, "RaftLog::Append append entries failed, entries size %u, last_log_index_ is %lu",
-        entries.size(), last_log_index_);
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::WriteGroup append entries failed, entries size %lu, last_log_index_ is %lu, "
+        "error: %s", count, last_log_index_, s.ToString().c_str());
+    for (size_t i = 0; i < group.size(); i++) {
+      group[i]->last_index = 0;
+    }
+    return;
   }
-  return last_log_index_;
+
+  // the entries can be read now, before they are synced
+  {
+  slash::MutexLock l(&lli_mutex_);
+  size_t k = 0;
+  for (size_t i = 0; i < group.size(); i++) {
+    const std::vector<uint64_t>& terms = *group[i]->terms;
+    for (size_t j = 0; j < terms.size(); j++, k++) {
+      cache_.Append(index + k, &bufs[k]);
+      AppendTermRun(index + k, terms[j]);
+    }
+    group[i]->last_index = index + k - 1;
+  }
+  last_log_index_ += count;
+  if (sync_mode_ == kLogSyncNone) {
+    persisted_index_ = last_log_index_;
+  }
+  write_groups_++;
+  write_appends_ += group.size();
+  }
+  for (size_t i = 0; i < group.size(); i++) {
+    if (group[i]->on_written != NULL
+        && (i == 0 || group[i]->on_written != group[i - 1]->on_written
+          || group[i]->arg != group[i - 1]->arg)) {
+      group[i]->on_written(group[i]->arg);
+    }
+  }
+
+  if (sync_mode_ == kLogSyncNone) {
+    return;
+  }
+  uint64_t start_us = slash::NowMicros();
+  s = storage_->Sync();
+  uint64_t sync_us = slash::NowMicros() - start_us;
+  slash::MutexLock l(&lli_mutex_);
+  if (!s.ok()) {
+    /*
+     * the kernel may have dropped the dirty pages of the failed sync, and a
+     * later sync succeeds without writing them, so the entries, which are
+     * readable and may have been sent to the followers, can never be known
+     * persisted, stop before anything acks them
+     */
+    LOGV(FATAL_LEVEL, info_log_, "RaftLog::WriteGroup sync entries [%lu, %lu] failed, error: %s",
+        index, index + count - 1, s.ToString().c_str());
+    if (info_log_ != NULL) {
+      info_log_->Flush();
+    }
+    abort();
+  }
+  persisted_index_ = last_log_index_;
+  syncs_++;
+  sync_us_ += sync_us;
+  max_sync_us_ = std::max(max_sync_us_, sync_us);
+}
+
+bool RaftLog::IsCached(uint64_t index) {
+  slash::MutexLock l(&lli_mutex_);
+  return cache_.count() != 0 && index >= cache_.FirstIndex() && index <= cache_.LastIndex();
 }
 
 uint64_t RaftLog::GetLastLogIndex() {
+  slash::MutexLock l(&lli_mutex_);
   return last_log_index_;
 }
 
+uint64_t RaftLog::GetPersistedIndex() {
+  slash::MutexLock l(&lli_mutex_);
+  return persisted_index_;
+}
+
 int RaftLog::GetEntry(const uint64_t index, Entry *entry) {
   slash::MutexLock l(&lli_mutex_);
-  std::string buf = UintToBitStr(index);
+  if (cache_.Get(index, entry)) {
+    return 0;
+  }
   std::string res;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), buf, &res);
+  Status s = storage_->Get(index, &res);
   if (s.IsNotFound()) {
-    LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntry: GetEntry not found, index is %lld", index);
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntry: GetEntry not found, index is %lu", index);
     entry = NULL;
     return 1;
+  } else if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntry: GetEntry failed, index is %lu, error: %s",
+        index, s.ToString().c_str());
+    return 1;
+  }
+  s = DecodeEntry(res, entry);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntry: decode entry %lu failed, error: %s",
+        index, s.ToString().c_str());
+    return 1;
   }
-  entry->ParseFromString(res);
   return 0;
 }
 
-bool RaftLog::GetLastLogTermAndIndex(uint64_t* last_log_term, uint64_t* last_log_index) {
+int RaftLog::GetEntries(uint64_t begin, uint64_t end, uint64_t max_bytes, std::vector<Entry>* entries,
+    std::vector<uint32_t>* checksums) {
   slash::MutexLock l(&lli_mutex_);
-  if (last_log_index_ == 0) {
-    *last_log_index = 0;
-    *last_log_term = 0;
-    return true;
+  entries->clear();
+  if (checksums != NULL) {
+    checksums->clear();
+  }
+  if (end > last_log_index_) {
+    end = last_log_index_;
+  }
+  if (begin > end) {
+    return 1;
+  }
+  uint64_t bytes = 0;
+  uint64_t index = begin;
+  // the entries before the cache are read from the storage in one scan
+  uint64_t cache_first = cache_.count() == 0 ? end + 1 : cache_.FirstIndex();
+  if (index < cache_first) {
+    std::vector<std::string> bufs;
+    Status s = storage_->Scan(index, std::min(end, cache_first - 1), max_bytes, &bufs);
+    if (!s.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntries: Scan from %lu to %lu failed, error: %s",
+          index, end, s.ToString().c_str());
+      return 1;
+    }
+    entries->resize(bufs.size());
+    if (checksums != NULL) {
+      checksums->resize(bufs.size());
+    }
+    for (size_t i = 0; i < bufs.size(); i++) {
+      s = DecodeEntry(bufs[i], &(*entries)[i], checksums != NULL ? &(*checksums)[i] : NULL);
+      if (!s.ok()) {
+        LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEntries: decode entry %lu failed, error: %s",
+            index + i, s.ToString().c_str());
+        // return the entries before the broken one
+        entries->resize(i);
+        if (checksums != NULL) {
+          checksums->resize(i);
+        }
+        return entries->empty() ? 1 : 0;
+      }
+      bytes += bufs[i].size();
+    }
+    index += bufs.size();
+    if (index < cache_first) {
+      return 0;
+    }
+  }
+  size_t size;
+  uint32_t checksum;
+  for (; index <= end && bytes < max_bytes; index++) {
+    entries->push_back(Entry());
+    if (!cache_.Get(index, &entries->back(), &size, &checksum)) {
+      entries->pop_back();
+      break;
+    }
+    if (checksums != NULL) {
+      checksums->push_back(checksum);
+    }
+    bytes += size;
+  }
+  return entries->empty() ? 1 : 0;
+}
+
+int RaftLog::GetEncodedEntries(uint64_t begin, uint64_t end, uint64_t max_bytes,
+    std::vector<std::shared_ptr<const std::string> >* bufs, uint64_t* bytes) {
+  slash::MutexLock l(&lli_mutex_);
+  bufs->clear();
+  uint64_t total = 0;
+  if (end > last_log_index_) {
+    end = last_log_index_;
+  }
+  if (begin > end) {
+    return 1;
+  }
+  uint64_t index = begin;
+  uint64_t cache_first = cache_.count() == 0 ? end + 1 : cache_.FirstIndex();
+  if (index < cache_first) {
+    std::vector<std::string> scanned;
+    Status s = storage_->Scan(index, std::min(end, cache_first - 1), max_bytes, &scanned);
+    if (!s.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEncodedEntries: Scan from %lu to %lu failed, error: %s",
+          index, end, s.ToString().c_str());
+      return 1;
+    }
+    EntryView view;
+    Entry entry;
+    for (size_t i = 0; i < scanned.size(); i++) {
+      std::string& buf = scanned[i];
+      // the entries read from the storage are always verified, the ones
+      // written by the old floyd are converted to the compact format
+      if (IsCompactEntry(buf)) {
+        s = view.Parse(buf);
+      } else {
+        s = DecodeEntry(buf, &entry);
+        if (s.ok()) {
+          buf.clear();
+          EncodeEntry(entry, &buf);
+        }
+      }
+      if (!s.ok()) {
+        LOGV(ERROR_LEVEL, info_log_, "RaftLog::GetEncodedEntries: decode entry %lu failed, error: %s",
+            index + i, s.ToString().c_str());
+        // return the entries before the broken one
+        break;
+      }
+      total += buf.size();
+      std::shared_ptr<std::string> shared(new std::string());
+      shared->swap(buf);
+      bufs->push_back(shared);
+    }
+    index += bufs->size();
+    if (index < cache_first || !s.ok()) {
+      if (bytes != NULL) {
+        *bytes = total;
+      }
+      return bufs->empty() ? 1 : 0;
+    }
   }
-  std::string buf;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), UintToBitStr(last_log_index_), &buf);
-  if (!s.ok() || s.IsNotFound()) {
+  for (; index <= end && total < max_bytes; index++) {
+    if (!cache_.GetEncoded(index, bufs)) {
+      break;
+    }
+    total += bufs->back()->size();
+  }
+  if (bytes != NULL) {
+    *bytes = total;
+  }
+  return bufs->empty() ? 1 : 0;
+}
+
+bool RaftLog::GetLastLogTermAndIndex(uint64_t* last_log_term, uint64_t* last_log_index) {
+  slash::MutexLock l(&lli_mutex_);
+  if (last_log_index_ == 0 || term_runs_.empty()) {
     *last_log_index = 0;
     *last_log_term = 0;
     return true;
   }
-  Entry entry;
-  entry.ParseFromString(buf);
   *last_log_index = last_log_index_;
-  *last_log_term = entry.term();
+  *last_log_term = term_runs_.back().second;
   return true;
 }
 
+uint64_t RaftLog::GetTerm(uint64_t index) {
+  slash::MutexLock l(&lli_mutex_);
+  if (index == 0 || index > last_log_index_
+      || term_runs_.empty() || index < term_runs_.front().first) {
+    return 0;
+  }
+  // find the last run whose first index <= index
+  std::vector<std::pair<uint64_t, uint64_t> >::iterator iter = std::upper_bound(
+      term_runs_.begin(), term_runs_.end(), std::make_pair(index, std::numeric_limits<uint64_t>::max()));
+  return (--iter)->second;
+}
+
+void RaftLog::GetConflictHint(uint64_t prev_log_index, uint64_t* conflict_term,
+    uint64_t* conflict_index) {
+  slash::MutexLock l(&lli_mutex_);
+  if (prev_log_index > last_log_index_ || term_runs_.empty()
+      || prev_log_index < term_runs_.front().first) {
+    *conflict_term = 0;
+    *conflict_index = last_log_index_ + 1;
+    return;
+  }
+  std::vector<std::pair<uint64_t, uint64_t> >::iterator iter = std::upper_bound(
+      term_runs_.begin(), term_runs_.end(), std::make_pair(prev_log_index, std::numeric_limits<uint64_t>::max()));
+  --iter;
+  *conflict_term = iter->second;
+  // the entries up to the snapshot index are committed, never conflict
+  *conflict_index = std::max(iter->first, snapshot_index_ + 1);
+}
+
+uint64_t RaftLog::NextIndexAfterConflict(uint64_t prev_log_index, uint64_t conflict_term,
+    uint64_t conflict_index) {
+  slash::MutexLock l(&lli_mutex_);
+  uint64_t next_index = conflict_index;
+  if (conflict_term != 0) {
+    // if I have the conflicting term at or below prev_log_index, the
+    // follower's entries of it before my last one may match, start after
+    // my last one of the term, otherwise none of the follower's entries of
+    // the term match, start from its first one
+    for (size_t i = 0; i < term_runs_.size() && term_runs_[i].first <= prev_log_index; i++) {
+      if (term_runs_[i].second == conflict_term) {
+        uint64_t last = i + 1 < term_runs_.size() ? term_runs_[i + 1].first - 1 : last_log_index_;
+        if (last < prev_log_index) {
+          next_index = last + 1;
+        }
+        break;
+      } else if (term_runs_[i].second > conflict_term) {
+        break;
+      }
+    }
+  }
+  // never beyond the entry rejected
+  next_index = std::min(next_index, prev_log_index);
+  return std::max(next_index, static_cast<uint64_t>(1));
+}
+
+void RaftLog::AppendTermRun(uint64_t index, uint64_t term) {
+  if (term_runs_.empty() || term_runs_.back().second != term) {
+    term_runs_.push_back(std::make_pair(index, term));
+  }
+}
+
+void RaftLog::RebuildTermRuns() {
+  term_runs_.clear();
+  uint64_t index = storage_->FirstIndex();
+  if (index == 0) {
+    return;
+  }
+  std::vector<std::string> bufs;
+  EntryView view;
+  bool broken = false;
+  while (index <= last_log_index_ && !broken) {
+    Status s = storage_->Scan(index, last_log_index_, kRebuildScanBytes, &bufs);
+    if (!s.ok() && !s.IsCorruption()) {
+      LOGV(ERROR_LEVEL, info_log_, "RaftLog::RebuildTermRuns scan from %lu failed, error: %s",
+          index, s.ToString().c_str());
+      break;
+    }
+    if (!s.ok() || bufs.empty()) {
+      LOGV(ERROR_LEVEL, info_log_, "RaftLog::RebuildTermRuns entry %lu is missing or broken, error: %s",
+          index, s.ToString().c_str());
+      broken = true;
+      break;
+    }
+    for (size_t i = 0; i < bufs.size(); i++, index++) {
+      s = view.Parse(bufs[i]);
+      if (!s.ok()) {
+        LOGV(ERROR_LEVEL, info_log_, "RaftLog::RebuildTermRuns decode entry %lu failed, error: %s",
+            index, s.ToString().c_str());
+        broken = true;
+        break;
+      }
+      AppendTermRun(index, view.term());
+    }
+  }
+  if (broken) {
+    // a torn tail, the entries from the broken one have no reliable term,
+    // drop them, the leader sends them again
+    LOGV(WARN_LEVEL, info_log_, "RaftLog::RebuildTermRuns truncate the log from %lu, last_log_index was %lu",
+        index, last_log_index_);
+    Status s = storage_->TruncateSuffix(index);
+    if (!s.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "RaftLog::RebuildTermRuns truncate from %lu failed, error: %s",
+          index, s.ToString().c_str());
+    }
+    last_log_index_ = index - 1;
+    persisted_index_ = std::min(persisted_index_, last_log_index_);
+  }
+  LOGV(INFO_LEVEL, info_log_, "RaftLog::RebuildTermRuns %lu term runs for entries [%lu, %lu]",
+      term_runs_.size(), storage_->FirstIndex(), last_log_index_);
+}
+
 /*
  * truncate suffix from index
  */
 int RaftLog::TruncateSuffix(uint64_t index) {
   // we need to delete the unnecessary entry, since we don't store
   // last_log_index in rocksdb
-  rocksdb::WriteBatch batch;
-  for (; last_log_index_ >= index; last_log_index_--) {
-    batch.Delete(UintToBitStr(last_log_index_));
+  slash::MutexLock wl(&write_mu_);
+  slash::MutexLock l(&lli_mutex_);
+  if (index > last_log_index_) {
+    return 0;
   }
-  if (batch.Count() > 0) {
-    rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
-    if (!s.ok()) {
-      LOGV(ERROR_LEVEL, info_log_, "RaftLog::TruncateSuffix Error last_log_index %lu "
-          "truncate from %lu", last_log_index_, index);
-      return -1;
+  // the entries in snapshot are committed, they should never be truncated
+  if (index <= snapshot_index_) {
+    LOGV(WARN_LEVEL, info_log_, "RaftLog::TruncateSuffix truncate from %lu, but the snapshot index is %lu",
+        index, snapshot_index_);
+    index = snapshot_index_ + 1;
+    if (index > last_log_index_) {
+      return 0;
+    }
+  }
+  Status s = storage_->TruncateSuffix(index);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::TruncateSuffix Error last_log_index %lu "
+        "truncate from %lu, error: %s", last_log_index_, index, s.ToString().c_str());
+    return -1;
+  }
+  cache_.TruncateSuffix(index);
+  while (!term_runs_.empty() && term_runs_.back().first >= index) {
+    term_runs_.pop_back();
+  }
+  last_log_index_ = index - 1;
+  persisted_index_ = std::min(persisted_index_, last_log_index_);
+  return 0;
+}
+
+int RaftLog::TruncatePrefix(uint64_t index, uint64_t term) {
+  slash::MutexLock wl(&write_mu_);
+  slash::MutexLock l(&lli_mutex_);
+  if (index <= snapshot_index_) {
+    return 0;
+  }
+  Status s = storage_->TruncatePrefix(index);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftLog::TruncatePrefix Error truncate to %lu, error: %s",
+        index, s.ToString().c_str());
+    return -1;
+  }
+  cache_.TruncatePrefix(index);
+  if (index >= last_log_index_) {
+    // the storage is empty now, the next entry appended will be index + 1
+    if (storage_->LastIndex() != 0) {
+      s = storage_->TruncateSuffix(storage_->FirstIndex());
+      if (!s.ok()) {
+        LOGV(ERROR_LEVEL, info_log_, "RaftLog::TruncatePrefix Error truncate from %lu, error: %s",
+            storage_->FirstIndex(), s.ToString().c_str());
+        return -1;
+      }
+    }
+    cache_.Clear();
+    term_runs_.clear();
+    last_log_index_ = index;
+  } else {
+    // keep the run of index, so the term of index is still known
+    std::vector<std::pair<uint64_t, uint64_t> >::iterator iter = std::upper_bound(
+        term_runs_.begin(), term_runs_.end(), std::make_pair(index, std::numeric_limits<uint64_t>::max()));
+    if (iter != term_runs_.begin()) {
+      term_runs_.erase(term_runs_.begin(), iter - 1);
     }
   }
+  if (term_runs_.empty() || term_runs_.front().first > index) {
+    term_runs_.insert(term_runs_.begin(), std::make_pair(index, term));
+  } else {
+    term_runs_.front().first = index;
+  }
+  snapshot_index_ = index;
+  // the entries in the snapshot are durable with it
+  persisted_index_ = std::max(persisted_index_, index);
+  LOGV(INFO_LEVEL, info_log_, "RaftLog::TruncatePrefix truncate to (%lu, %lu), last_log_index %lu",
+      index, term, last_log_index_);
   return 0;
 }
 
+uint64_t RaftLog::GetSnapshotIndex() {
+  slash::MutexLock l(&lli_mutex_);
+  return snapshot_index_;
+}
+
+uint64_t RaftLog::ApproximateBytes() {
+  return storage_->ApproximateBytes();
+}
+
+void RaftLog::GetCacheStats(uint64_t* hits, uint64_t* misses, uint64_t* count, uint64_t* bytes) {
+  slash::MutexLock l(&lli_mutex_);
+  *hits = cache_.hits();
+  *misses = cache_.misses();
+  *count = cache_.count();
+  *bytes = cache_.bytes();
+}
+
+void RaftLog::GetWriteStats(uint64_t* groups, uint64_t* appends, uint64_t* syncs,
+    uint64_t* sync_us, uint64_t* max_sync_us) {
+  slash::MutexLock l(&lli_mutex_);
+  *groups = write_groups_;
+  *appends = write_appends_;
+  *syncs = syncs_;
+  *sync_us = sync_us_;
+  *max_sync_us = max_sync_us_;
+}
+
 }  // namespace floyd
@@ -9,38 +9,169 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
+#include <utility>
 
 #include "rocksdb/db.h"
 #include "slash/include/slash_mutex.h"
+#include "slash/include/slash_status.h"
+
+#include "floyd/include/floyd_options.h"
+#include "floyd/src/entry_cache.h"
 
 namespace floyd {
 
+using slash::Status;
+
 class Logger;
 class Entry;
+class LogStorage;
 
 class RaftLog {
  public:
-  RaftLog(rocksdb::DB* db, Logger* info_log);
+  // RaftLog takes the ownership of the storage, which should have been opened
+  // the recent entries up to cache_size bytes are cached in memory
+  RaftLog(LogStorage* storage, Logger* info_log, uint64_t cache_size = 0,
+      LogSyncMode sync_mode = kLogSyncNone);
+  // store the log in rocksdb db
+  RaftLog(rocksdb::DB* db, Logger* info_log, uint64_t cache_size = 0);
   ~RaftLog();
 
-  uint64_t Append(const std::vector<const Entry *> &entries);
+  /*
+   * the concurrent Appends are merged into one write to the storage with
+   * a single sync according to sync_mode, return the last index of entries
+   * after they are persisted, or 0 if they can't be written, a failed sync
+   * aborts the process
+   * the entries can be read as soon as they are written, before the sync,
+   * then on_written(arg) is called if it is not NULL, so the leader sends
+   * them to the followers while they are synced, the same on_written is
+   * called only once for a group
+   */
+  uint64_t Append(const std::vector<const Entry *> &entries,
+      void (*on_written)(void*) = NULL, void* arg = NULL);
+  /*
+   * append the entries encoded by EncodeEntry as they are, terms[i] is the
+   * term of (*bufs)[i], the content of bufs is taken by the log
+   */
+  uint64_t AppendEncoded(std::vector<std::string>* bufs, const std::vector<uint64_t>& terms,
+      void (*on_written)(void*) = NULL, void* arg = NULL);
 
   int GetEntry(uint64_t index, Entry *entry);
+  /*
+   * get entries [begin, end] in order, stop after the encoded size of the
+   * entries reaches max_bytes, so the last entry may exceed the budget
+   * the stored checksum of every entry is returned in checksums if it is
+   * not NULL, the entries read from the storage are always verified
+   * return 1 if we can't get entry begin
+   */
+  int GetEntries(uint64_t begin, uint64_t end, uint64_t max_bytes, std::vector<Entry>* entries,
+      std::vector<uint32_t>* checksums = NULL);
+  /*
+   * like GetEntries, but the entries are returned in the compact format of
+   * entry_codec.h without being parsed, bytes is their total size, the
+   * cached entries are shared with the cache instead of being copied, they
+   * must not be modified
+   */
+  int GetEncodedEntries(uint64_t begin, uint64_t end, uint64_t max_bytes,
+      std::vector<std::shared_ptr<const std::string> >* bufs, uint64_t* bytes = NULL);
+  // whether entry index is served from memory
+  bool IsCached(uint64_t index);
 
+  // the last entry which can be read, it may have not been persisted yet
   uint64_t GetLastLogIndex();
+  // the last entry which has been persisted according to sync_mode
+  uint64_t GetPersistedIndex();
   bool GetLastLogTermAndIndex(uint64_t* last_log_term, uint64_t* last_log_index);
+  // the term of entry index from memory, return 0 if index is not in the log
+  uint64_t GetTerm(uint64_t index);
+  /*
+   * the hint returned by follower when its entry prev_log_index doesn't
+   * match the leader's, conflict_term is the term of the entry and
+   * conflict_index is the first index of that term, if the entry is not in
+   * the log, conflict_term is 0 and conflict_index is last_log_index + 1
+   */
+  void GetConflictHint(uint64_t prev_log_index, uint64_t* conflict_term, uint64_t* conflict_index);
+  /*
+   * the next index the leader sends from after the follower rejects
+   * prev_log_index with the hint, so all the entries of the conflicting
+   * term are skipped in one round
+   */
+  uint64_t NextIndexAfterConflict(uint64_t prev_log_index, uint64_t conflict_term,
+      uint64_t conflict_index);
   int TruncateSuffix(uint64_t index);
+  /*
+   * drop entries [1, index] which have been included in a snapshot whose last
+   * entry is (index, term), GetTerm(index) still return term after that
+   * if index is beyond the last entry, the log restarts from index + 1
+   */
+  int TruncatePrefix(uint64_t index, uint64_t term);
+  // entries after it are always available
+  uint64_t GetSnapshotIndex();
+  uint64_t ApproximateBytes();
+
+  void GetCacheStats(uint64_t* hits, uint64_t* misses, uint64_t* count, uint64_t* bytes);
+  // the number of groups and Appends written, the syncs and their total
+  // and max latency
+  void GetWriteStats(uint64_t* groups, uint64_t* appends, uint64_t* syncs,
+      uint64_t* sync_us, uint64_t* max_sync_us);
 
  private:
-  rocksdb::DB* const db_;
+  // an Append waiting to be written
+  struct Writer {
+    std::vector<std::string>* bufs;
+    const std::vector<uint64_t>* terms;
+    void (*on_written)(void*);
+    void* arg;
+    uint64_t last_index;
+    bool done;
+    slash::CondVar cv;
+    explicit Writer(slash::Mutex* mu)
+      : bufs(NULL), terms(NULL), on_written(NULL), arg(NULL),
+        last_index(0), done(false), cv(mu) { }
+  };
+
+  LogStorage* const storage_;
   Logger* const info_log_;
+  const LogSyncMode sync_mode_;
+
+  /*
+   * the Appends are queued in writers_, the first one writes the whole
+   * group for the others, write_mu_ serializes the modification of storage,
+   * so the storage is written and synced without holding lli_mutex_
+   */
+  slash::Mutex writers_mu_;
+  std::deque<Writer*> writers_;
+  slash::Mutex write_mu_;
   /*
    * mutex for last_log_index_
    */
   slash::Mutex lli_mutex_;
   uint64_t last_log_index_;
+  // the entries after it have been written but not synced
+  uint64_t persisted_index_;
+  uint64_t snapshot_index_;
+  // the tail of the log, so replication and apply don't need to read the storage
+  EntryCache cache_;
+  /*
+   * the term of every entry, kept as runs of (first index, term) since the
+   * term only changes when a new leader is elected
+   * it is rebuilt from the storage at open
+   */
+  std::vector<std::pair<uint64_t, uint64_t> > term_runs_;
+
+  // write stats, protected by lli_mutex_
+  uint64_t write_groups_;
+  uint64_t write_appends_;
+  uint64_t syncs_;
+  uint64_t sync_us_;
+  uint64_t max_sync_us_;
+
+  void WriteGroup(const std::vector<Writer*>& group);
+  void RebuildTermRuns();
+  void AppendTermRun(uint64_t index, uint64_t term);
 
   /*
    * we don't store last_log_index_ in rocksdb, since if we store it in rocksdb
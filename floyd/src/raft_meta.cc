@@ -8,6 +8,7 @@
 #include <stdlib.h>
 
 #include "rocksdb/status.h"
+#include "rocksdb/write_batch.h"
 
 #include "floyd/src/logger.h"
 #include "floyd/src/floyd.pb.h"
@@ -16,6 +17,9 @@
 
 namespace floyd {
 
+// the state of raft in one record
+static const std::string kRaftState = "RAFTSTATE";
+// the keys of the old floyd, which stores every field of the state alone
 static const std::string kCurrentTerm = "CURRENTTERM";
 static const std::string kVoteForIp = "VOTEFORIP";
 static const std::string kVoteForPort = "VOTEFORPORT";
@@ -25,130 +29,253 @@ static const std::string kLastApplied = "APPLYINDEX";
  * fencing token is not part of raft, fencing token is used for implementing distributed lock
  */
 static const std::string kFencingToken = "FENCINGTOKEN";
+static const std::string kSnapshotIndex = "SNAPSHOTINDEX";
+static const std::string kSnapshotTerm = "SNAPSHOTTERM";
+static const std::string kSnapshotMembers = "SNAPSHOTMEMBERS";
+
+// current term, commit index, last applied, voted for port, then voted for ip
+static const size_t kStateFixedSize = 3 * sizeof(uint64_t) + sizeof(int);
+
+static uint64_t GetUint64(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf, const std::string& key) {
+  std::string buf;
+  uint64_t ans = 0;
+  rocksdb::Status s = db->Get(rocksdb::ReadOptions(), cf, key, &buf);
+  if (s.ok() && buf.size() >= sizeof(uint64_t)) {
+    memcpy(&ans, buf.data(), sizeof(uint64_t));
+  }
+  return ans;
+}
+
+static std::string Uint64ToStr(uint64_t num) {
+  return std::string(reinterpret_cast<const char*>(&num), sizeof(uint64_t));
+}
 
 RaftMeta::RaftMeta(rocksdb::DB* db, Logger* info_log)
   : db_(db),
-    info_log_(info_log) {
+    cf_(db->DefaultColumnFamily()),
+    info_log_(info_log),
+    commit_index_persist_us_(0),
+    sync_vote_(false),
+    current_term_(0),
+    voted_for_port_(0),
+    commit_index_(0),
+    commit_index_dirty_(false),
+    persist_time_us_(0),
+    last_applied_(0),
+    fencing_token_(0),
+    snapshot_index_(0),
+    snapshot_term_(0) {
+}
+
+RaftMeta::RaftMeta(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* cf, Logger* info_log,
+    uint64_t commit_index_persist_us, bool sync_vote)
+  : db_(db),
+    cf_(cf),
+    info_log_(info_log),
+    commit_index_persist_us_(commit_index_persist_us),
+    sync_vote_(sync_vote),
+    current_term_(0),
+    voted_for_port_(0),
+    commit_index_(0),
+    commit_index_dirty_(false),
+    persist_time_us_(0),
+    last_applied_(0),
+    fencing_token_(0),
+    snapshot_index_(0),
+    snapshot_term_(0) {
 }
 
 RaftMeta::~RaftMeta() {
+  slash::MutexLock l(&mu_);
+  if (commit_index_dirty_) {
+    PersistState();
+  }
 }
 
 void RaftMeta::Init() {
-  if (GetCurrentTerm() == 0) {
-    SetCurrentTerm(0);
-  }
-  if (GetVotedForIp() == "") {
-    SetVotedForIp("");
+  slash::MutexLock l(&mu_);
+  std::string buf;
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), cf_, kRaftState, &buf);
+  if (s.ok() && buf.size() >= kStateFixedSize) {
+    const char* p = buf.data();
+    memcpy(&current_term_, p, sizeof(uint64_t));
+    memcpy(&commit_index_, p + 8, sizeof(uint64_t));
+    memcpy(&last_applied_, p + 16, sizeof(uint64_t));
+    memcpy(&voted_for_port_, p + 24, sizeof(int));
+    voted_for_ip_.assign(p + kStateFixedSize, buf.size() - kStateFixedSize);
+  } else {
+    LoadLegacyState();
   }
-  if (GetVotedForPort() == 0) {
-    SetVotedForPort(0);
+
+  fencing_token_ = GetUint64(db_, cf_, kFencingToken);
+  snapshot_index_ = GetUint64(db_, cf_, kSnapshotIndex);
+  snapshot_term_ = GetUint64(db_, cf_, kSnapshotTerm);
+  snapshot_members_.clear();
+  if (snapshot_index_ != 0) {
+    db_->Get(rocksdb::ReadOptions(), cf_, kSnapshotMembers, &snapshot_members_);
   }
-  if (GetCommitIndex() == 0) {
-    SetCommitIndex(0);
+  LOGV(INFO_LEVEL, info_log_, "RaftMeta::Init current_term %lu voted_for %s:%d commit_index %lu "
+      "last_applied %lu", current_term_, voted_for_ip_.c_str(), voted_for_port_, commit_index_, last_applied_);
+}
+
+void RaftMeta::LoadLegacyState() {
+  current_term_ = GetUint64(db_, cf_, kCurrentTerm);
+  commit_index_ = GetUint64(db_, cf_, kCommitIndex);
+  last_applied_ = GetUint64(db_, cf_, kLastApplied);
+  voted_for_ip_.clear();
+  db_->Get(rocksdb::ReadOptions(), cf_, kVoteForIp, &voted_for_ip_);
+  std::string buf;
+  voted_for_port_ = 0;
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), cf_, kVoteForPort, &buf);
+  if (s.ok() && buf.size() >= sizeof(int)) {
+    memcpy(&voted_for_port_, buf.data(), sizeof(int));
   }
-  if (GetLastApplied() == 0) {
-    SetLastApplied(0);
+
+  // replace the old keys with the record
+  rocksdb::WriteBatch batch;
+  EncodeState(&buf);
+  batch.Put(cf_, kRaftState, buf);
+  batch.Delete(cf_, kCurrentTerm);
+  batch.Delete(cf_, kCommitIndex);
+  batch.Delete(cf_, kLastApplied);
+  batch.Delete(cf_, kVoteForIp);
+  batch.Delete(cf_, kVoteForPort);
+  s = db_->Write(rocksdb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftMeta::LoadLegacyState write raft state failed, error: %s",
+        s.ToString().c_str());
   }
 }
 
-uint64_t RaftMeta::GetCurrentTerm() {
+void RaftMeta::EncodeState(std::string* buf) {
+  buf->resize(kStateFixedSize + voted_for_ip_.size());
+  char* p = &(*buf)[0];
+  memcpy(p, &current_term_, sizeof(uint64_t));
+  memcpy(p + 8, &commit_index_, sizeof(uint64_t));
+  memcpy(p + 16, &last_applied_, sizeof(uint64_t));
+  memcpy(p + 24, &voted_for_port_, sizeof(int));
+  memcpy(p + kStateFixedSize, voted_for_ip_.data(), voted_for_ip_.size());
+}
+
+void RaftMeta::PersistState(bool sync) {
   std::string buf;
-  uint64_t ans;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kCurrentTerm, &buf);
-  if (s.IsNotFound()) {
-    return 0;
+  EncodeState(&buf);
+  rocksdb::WriteOptions write_options;
+  write_options.sync = sync;
+  rocksdb::Status s = db_->Put(write_options, cf_, kRaftState, buf);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftMeta::PersistState write raft state failed, error: %s",
+        s.ToString().c_str());
+    return;
   }
-  memcpy(&ans, buf.data(), sizeof(uint64_t));
-  return ans;
+  commit_index_dirty_ = false;
+  persist_time_us_ = slash::NowMicros();
+}
+
+uint64_t RaftMeta::GetCurrentTerm() {
+  slash::MutexLock l(&mu_);
+  return current_term_;
 }
 
 void RaftMeta::SetCurrentTerm(const uint64_t current_term) {
-  char buf[8];
-  memcpy(buf, &current_term, sizeof(uint64_t));
-  db_->Put(rocksdb::WriteOptions(), kCurrentTerm, std::string(buf, 8));
-  return;
+  slash::MutexLock l(&mu_);
+  current_term_ = current_term;
+  PersistState(sync_vote_);
 }
 
 std::string RaftMeta::GetVotedForIp() {
-  std::string buf;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kVoteForIp, &buf);
-  if (s.IsNotFound()) {
-    return std::string("");
-  }
-  return buf;
+  slash::MutexLock l(&mu_);
+  return voted_for_ip_;
 }
 
 void RaftMeta::SetVotedForIp(const std::string ip) {
-  db_->Put(rocksdb::WriteOptions(), kVoteForIp, ip);
-  return;
+  slash::MutexLock l(&mu_);
+  voted_for_ip_ = ip;
+  PersistState(sync_vote_);
 }
 
 int RaftMeta::GetVotedForPort() {
-  std::string buf;
-  int ans;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kVoteForPort, &buf);
-  if (s.IsNotFound()) {
-    return 0;
-  }
-  memcpy(&ans, buf.data(), sizeof(int));
-  return ans;
+  slash::MutexLock l(&mu_);
+  return voted_for_port_;
 }
 
 void RaftMeta::SetVotedForPort(const int port) {
-  char buf[4];
-  memcpy(buf, &port, sizeof(int));
-  db_->Put(rocksdb::WriteOptions(), kVoteForPort, std::string(buf, sizeof(int)));
-  return;
+  slash::MutexLock l(&mu_);
+  voted_for_port_ = port;
+  PersistState(sync_vote_);
+}
+
+void RaftMeta::SetCurrentTermAndVotedFor(uint64_t current_term, const std::string& ip, int port) {
+  slash::MutexLock l(&mu_);
+  current_term_ = current_term;
+  voted_for_ip_ = ip;
+  voted_for_port_ = port;
+  PersistState(sync_vote_);
 }
 
 uint64_t RaftMeta::GetCommitIndex() {
-  std::string buf;
-  uint64_t ans;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kCommitIndex, &buf);
-  if (s.IsNotFound()) {
-    return 0;
-  }
-  memcpy(&ans, buf.data(), sizeof(uint64_t));
-  return ans;
+  slash::MutexLock l(&mu_);
+  return commit_index_;
 }
 
+/*
+ * the commit index is not part of the persistent state in raft paper, a
+ * commit index behind the real one is safe, it is advanced again by the
+ * leader after restart, but it never falls behind the last applied, since
+ * they are in the same record
+ */
 void RaftMeta::SetCommitIndex(uint64_t commit_index) {
-  char buf[8];
-  memcpy(buf, &commit_index, sizeof(uint64_t));
-  db_->Put(rocksdb::WriteOptions(), kCommitIndex, std::string(buf, 8));
+  slash::MutexLock l(&mu_);
+  commit_index_ = commit_index;
+  if (commit_index_persist_us_ != 0
+      && slash::NowMicros() < persist_time_us_ + commit_index_persist_us_) {
+    commit_index_dirty_ = true;
+    return;
+  }
+  PersistState();
 }
 
 uint64_t RaftMeta::GetLastApplied() {
-  std::string buf;
-  uint64_t ans;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kLastApplied, &buf);
-  if (s.IsNotFound()) {
-    return 0;
-  }
-  memcpy(&ans, buf.data(), sizeof(uint64_t));
-  return ans;
+  slash::MutexLock l(&mu_);
+  return last_applied_;
 }
 
 void RaftMeta::SetLastApplied(uint64_t last_applied) {
-  char buf[8];
-  memcpy(buf, &last_applied, sizeof(uint64_t));
-  db_->Put(rocksdb::WriteOptions(), kLastApplied, std::string(buf, 8));
+  slash::MutexLock l(&mu_);
+  last_applied_ = last_applied;
+  PersistState();
 }
 
 uint64_t RaftMeta::GetNewFencingToken() {
-  std::string buf;
-  uint64_t ans;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), kFencingToken, &buf);
-  if (s.IsNotFound()) {
-    ans = 0;
+  slash::MutexLock l(&mu_);
+  fencing_token_++;
+  db_->Put(rocksdb::WriteOptions(), cf_, kFencingToken, Uint64ToStr(fencing_token_));
+  return fencing_token_;
+}
+
+void RaftMeta::GetSnapshotMeta(uint64_t* index, uint64_t* term, std::string* members) {
+  slash::MutexLock l(&mu_);
+  *index = snapshot_index_;
+  *term = snapshot_term_;
+  *members = snapshot_members_;
+}
+
+Status RaftMeta::SetSnapshotMeta(uint64_t index, uint64_t term, const std::string& members) {
+  slash::MutexLock l(&mu_);
+  rocksdb::WriteBatch batch;
+  batch.Put(cf_, kSnapshotIndex, Uint64ToStr(index));
+  batch.Put(cf_, kSnapshotTerm, Uint64ToStr(term));
+  batch.Put(cf_, kSnapshotMembers, members);
+  rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &batch);
+  if (!s.ok()) {
+    LOGV(ERROR_LEVEL, info_log_, "RaftMeta::SetSnapshotMeta write snapshot meta (%lu, %lu) failed, error: %s",
+        index, term, s.ToString().c_str());
+    return Status::IOError("write snapshot meta", s.ToString());
   }
-  memcpy(&ans, buf.data(), sizeof(uint64_t));
-  ans++;
-  char wbuf[8];
-  memcpy(wbuf, &ans, sizeof(uint64_t));
-  db_->Put(rocksdb::WriteOptions(), kFencingToken, std::string(wbuf, 8));
-  return ans;
+  snapshot_index_ = index;
+  snapshot_term_ = term;
+  snapshot_members_ = members;
+  return Status::OK();
 }
 
 }  // namespace floyd
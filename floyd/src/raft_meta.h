@@ -25,20 +25,36 @@ class Logger;
  * we use RaftMeta to avoid passing the floyd_impl's this point to other thread
  */
 /*
- * main data stored in raftmeta
- * static const std::string kcurrentterm = "currentterm";
- * static const std::string kvoteforip = "voteforip";
- * static const std::string kvoteforport = "voteforport";
- * static const std::string kcommitindex = "commitindex";
- * static const std::string klastapplied = "applyindex";
+ * RaftMeta keeps a copy of the meta in memory, so the getters never read
+ * the db, current term, voted for, commit index and last applied are
+ * persisted together as one record, so each update is a single Put
+ * static const std::string kRaftState = "RAFTSTATE";
+ * the old floyd store them as separate keys, which are moved to the
+ * record in Init
  * fencing token is not part of raft, fencing token is used for implementing distributed lock
  * static const std::string kFencingToken = "FENCINGTOKEN";
+ * snapshot meta, which are updated together after a snapshot is created
+ * static const std::string kSnapshotIndex = "SNAPSHOTINDEX";
+ * static const std::string kSnapshotTerm = "SNAPSHOTTERM";
+ * static const std::string kSnapshotMembers = "SNAPSHOTMEMBERS";
  */
 class RaftMeta {
  public:
   RaftMeta(rocksdb::DB *db, Logger* info_log);
+  /*
+   * keep the meta in column family cf of db
+   * if commit_index_persist_us is not 0, a new commit index is persisted at
+   * most once every commit_index_persist_us, the others go to the db with
+   * the next update of the raft state, such as the last applied
+   * if sync_vote is true, the current term and voted for are synced to
+   * disk before their setters return, so a node never votes twice in a
+   * term after a power loss
+   */
+  RaftMeta(rocksdb::DB *db, rocksdb::ColumnFamilyHandle* cf, Logger* info_log,
+      uint64_t commit_index_persist_us = 0, bool sync_vote = false);
   ~RaftMeta();
 
+  // load the meta from db, should be called before the others
   void Init();
 
   // return persistent state from zeppelin
@@ -50,6 +66,9 @@ class RaftMeta {
   void SetVotedForIp(const std::string ip);
   void SetVotedForPort(const int port);
 
+  // the term and vote always change together, persist them in one write
+  void SetCurrentTermAndVotedFor(uint64_t current_term, const std::string& ip, int port);
+
   uint64_t GetCommitIndex();
   void SetCommitIndex(const uint64_t commit_index);
 
@@ -57,12 +76,44 @@ class RaftMeta {
   void SetLastApplied(uint64_t last_applied);
 
   uint64_t GetNewFencingToken();
+
+  // the last entry included in the snapshot, and the membership at that time
+  void GetSnapshotMeta(uint64_t* index, uint64_t* term, std::string* members);
+  // the copy in memory is kept if the write fails
+  Status SetSnapshotMeta(uint64_t index, uint64_t term, const std::string& members);
  private:
   // db used to data that need to be persistent
   rocksdb::DB * const db_;
+  rocksdb::ColumnFamilyHandle* const cf_;
   // used to debug
   Logger* info_log_;
-
+  const uint64_t commit_index_persist_us_;
+  const bool sync_vote_;
+
+  // protect the copy of the meta, the record is written with it held, so
+  // the db always has the latest state
+  slash::Mutex mu_;
+  uint64_t current_term_;
+  std::string voted_for_ip_;
+  int voted_for_port_;
+  uint64_t commit_index_;
+  // the commit index in memory is newer than the one in db
+  bool commit_index_dirty_;
+  uint64_t persist_time_us_;
+  uint64_t last_applied_;
+  uint64_t fencing_token_;
+  uint64_t snapshot_index_;
+  uint64_t snapshot_term_;
+  std::string snapshot_members_;
+
+  void LoadLegacyState();
+  void EncodeState(std::string* buf);
+  // write the record, synced if sync is true, mu_ should be held
+  void PersistState(bool sync = false);
+
+  // No copying allowed
+  RaftMeta(const RaftMeta&);
+  void operator=(const RaftMeta&);
 };
 
 } // namespace floyd
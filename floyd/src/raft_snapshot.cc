@@ -0,0 +1,426 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/raft_snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "slash/include/env.h"
+
+#include "floyd/src/logger.h"
+#include "floyd/include/floyd_options.h"
+
+namespace floyd {
+
+static const std::string kSnapshotMetaFile = "SNAPSHOT_META";
+static const size_t kSnapshotMetaHeaderSize = 16;
+
+static std::string TmpPath(const std::string& path) {
+  return path + ".tmp";
+}
+
+static std::string OldPath(const std::string& path) {
+  return path + ".old";
+}
+
+static Status SyncFile(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  if (fsync(fd) != 0) {
+    close(fd);
+    return Status::IOError("fsync " + filename, strerror(errno));
+  }
+  close(fd);
+  return Status::OK();
+}
+
+// the directory holding path, path may end with '/'
+static std::string ParentDir(const std::string& path) {
+  size_t end = path.find_last_not_of('/');
+  if (end == std::string::npos) {
+    return "/";
+  }
+  size_t pos = path.rfind('/', end);
+  if (pos == std::string::npos) {
+    return ".";
+  }
+  return pos == 0 ? "/" : path.substr(0, pos);
+}
+
+static Status ReadMeta(const std::string& dir, uint64_t* index, uint64_t* term,
+    std::string* members) {
+  std::string filename = dir + "/" + kSnapshotMetaFile;
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return Status::NotFound(filename);
+    }
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  std::string buf;
+  char tmp[4096];
+  ssize_t n;
+  while ((n = read(fd, tmp, sizeof(tmp))) != 0) {
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0) {
+      close(fd);
+      return Status::IOError("read " + filename, strerror(errno));
+    }
+    buf.append(tmp, n);
+  }
+  close(fd);
+  if (buf.size() < kSnapshotMetaHeaderSize) {
+    return Status::Corruption("snapshot meta " + filename);
+  }
+  memcpy(index, buf.data(), sizeof(uint64_t));
+  memcpy(term, buf.data() + sizeof(uint64_t), sizeof(uint64_t));
+  members->assign(buf.data() + kSnapshotMetaHeaderSize, buf.size() - kSnapshotMetaHeaderSize);
+  return Status::OK();
+}
+
+RaftSnapshot::RaftSnapshot(const std::string& path, Logger* info_log)
+  : path_(path),
+    info_log_(info_log),
+    index_(0) {
+}
+
+RaftSnapshot::~RaftSnapshot() {
+}
+
+Status RaftSnapshot::Recover() {
+  // the swap is interrupted after the current snapshot is moved away
+  if (!slash::FileExists(path_) && slash::FileExists(OldPath(path_))) {
+    if (slash::RenameFile(OldPath(path_), path_) != 0) {
+      return Status::IOError("rename " + OldPath(path_), strerror(errno));
+    }
+    LOGV(INFO_LEVEL, info_log_, "RaftSnapshot::Recover restore snapshot from %s", OldPath(path_).c_str());
+  }
+  slash::DeleteDirIfExist(OldPath(path_));
+  slash::DeleteDirIfExist(TmpPath(path_));
+  // a snapshot is received again from the first chunk after restart
+  slash::DeleteDirIfExist(RecvPath());
+
+  uint64_t term;
+  std::string members;
+  Status s = LoadMeta(&index_, &term, &members);
+  if (s.IsNotFound()) {
+    index_ = 0;
+  } else if (!s.ok()) {
+    return s;
+  }
+  return Status::OK();
+}
+
+Status RaftSnapshot::Create(StateMachine* state_machine, uint64_t index, uint64_t term,
+    const std::string& members) {
+  std::string tmp_path = TmpPath(path_);
+  slash::DeleteDirIfExist(tmp_path);
+
+  uint64_t start_us = slash::NowMicros();
+  Status s = state_machine->Snapshot(tmp_path);
+  if (!s.ok()) {
+    slash::DeleteDirIfExist(tmp_path);
+    return s;
+  }
+  s = WriteMeta(tmp_path, index, term, members);
+  if (!s.ok()) {
+    slash::DeleteDirIfExist(tmp_path);
+    return s;
+  }
+
+  slash::MutexLock l(&mu_);
+  // a newer snapshot is installed from the leader in the meantime
+  if (index <= index_) {
+    slash::DeleteDirIfExist(tmp_path);
+    return Status::Incomplete("snapshot " + std::to_string(index_) + " is newer");
+  }
+  s = SwapIn(tmp_path, index);
+  if (!s.ok()) {
+    return s;
+  }
+  LOGV(INFO_LEVEL, info_log_, "RaftSnapshot::Create snapshot at index %lu term %lu in %s, cost %lu us",
+      index, term, path_.c_str(), slash::NowMicros() - start_us);
+  return Status::OK();
+}
+
+Status RaftSnapshot::Install(uint64_t index, uint64_t term) {
+  uint64_t recv_index, recv_term;
+  std::string members;
+  std::string recv_path = RecvPath();
+  Status s = ReadMeta(recv_path, &recv_index, &recv_term, &members);
+  if (!s.ok()) {
+    return s;
+  }
+  if (recv_index != index || recv_term != term) {
+    return Status::Corruption("received snapshot (" + std::to_string(recv_index) + ", "
+        + std::to_string(recv_term) + ") mismatch");
+  }
+
+  slash::MutexLock l(&mu_);
+  if (index <= index_) {
+    return Status::Incomplete("snapshot " + std::to_string(index_) + " is newer");
+  }
+  s = SwapIn(recv_path, index);
+  if (!s.ok()) {
+    return s;
+  }
+  LOGV(INFO_LEVEL, info_log_, "RaftSnapshot::Install snapshot at index %lu term %lu in %s",
+      index, term, path_.c_str());
+  return Status::OK();
+}
+
+// called with mu_ held
+Status RaftSnapshot::SwapIn(const std::string& dir, uint64_t index) {
+  if (slash::FileExists(path_) && slash::RenameFile(path_, OldPath(path_)) != 0) {
+    return Status::IOError("rename " + path_, strerror(errno));
+  }
+  if (slash::RenameFile(dir, path_) != 0) {
+    return Status::IOError("rename " + dir, strerror(errno));
+  }
+  index_ = index;
+  // the renames must be durable before the caller drops the log entries
+  // in the snapshot
+  Status s = SyncFile(ParentDir(path_));
+  if (!s.ok()) {
+    return s;
+  }
+  slash::DeleteDirIfExist(OldPath(path_));
+  return Status::OK();
+}
+
+/*
+ * db is cleared and refilled in place, so the pointer of db held by others
+ * stays valid, the caller should persist the snapshot index as applied
+ * only after Restore succeeds, so an interrupted Restore is done again
+ */
+Status RaftSnapshot::Restore(StateMachine* state_machine, uint64_t* index, uint64_t* term,
+    std::string* members) {
+  slash::MutexLock l(&mu_);
+  Status s = LoadMeta(index, term, members);
+  if (!s.ok()) {
+    return s;
+  }
+  s = state_machine->Restore(path_);
+  if (!s.ok()) {
+    return s;
+  }
+  LOGV(INFO_LEVEL, info_log_, "RaftSnapshot::Restore restore from snapshot (%lu, %lu)",
+      *index, *term);
+  return Status::OK();
+}
+
+Status RaftSnapshot::OpenReader(SnapshotReader** reader) {
+  slash::MutexLock l(&mu_);
+  uint64_t index, term;
+  std::string members;
+  Status s = LoadMeta(&index, &term, &members);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> filenames;
+  if (slash::GetChildren(path_, filenames) != 0) {
+    return Status::IOError("list " + path_, strerror(errno));
+  }
+  std::sort(filenames.begin(), filenames.end());
+  SnapshotReader* r = new SnapshotReader(index, term);
+  for (size_t i = 0; i < filenames.size(); i++) {
+    if (filenames[i] == "." || filenames[i] == "..") {
+      continue;
+    }
+    s = r->AddFile(path_ + "/" + filenames[i]);
+    if (!s.ok()) {
+      delete r;
+      return s;
+    }
+  }
+  *reader = r;
+  return Status::OK();
+}
+
+Status RaftSnapshot::WriteMeta(const std::string& dir, uint64_t index, uint64_t term,
+    const std::string& members) {
+  std::string buf;
+  char header[kSnapshotMetaHeaderSize];
+  memcpy(header, &index, sizeof(uint64_t));
+  memcpy(header + sizeof(uint64_t), &term, sizeof(uint64_t));
+  buf.append(header, kSnapshotMetaHeaderSize);
+  buf.append(members);
+
+  std::string filename = dir + "/" + kSnapshotMetaFile;
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  const char* data = buf.data();
+  size_t left = buf.size();
+  while (left > 0) {
+    ssize_t n = write(fd, data, left);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0) {
+      close(fd);
+      return Status::IOError("write " + filename, strerror(errno));
+    }
+    data += n;
+    left -= n;
+  }
+  if (fsync(fd) != 0) {
+    close(fd);
+    return Status::IOError("fsync " + filename, strerror(errno));
+  }
+  close(fd);
+  return Status::OK();
+}
+
+Status RaftSnapshot::LoadMeta(uint64_t* index, uint64_t* term, std::string* members) {
+  return ReadMeta(path_, index, term, members);
+}
+
+SnapshotReader::SnapshotReader(uint64_t index, uint64_t term)
+  : index_(index),
+    term_(term),
+    seq_(0),
+    file_(0),
+    offset_(0),
+    chunk_size_(0) {
+}
+
+SnapshotReader::~SnapshotReader() {
+  for (size_t i = 0; i < fds_.size(); i++) {
+    close(fds_[i]);
+  }
+}
+
+Status SnapshotReader::AddFile(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status::IOError("open " + filename, strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return Status::IOError("stat " + filename, strerror(errno));
+  }
+  filenames_.push_back(filename.substr(filename.rfind('/') + 1));
+  fds_.push_back(fd);
+  sizes_.push_back(st.st_size);
+  return Status::OK();
+}
+
+Status SnapshotReader::ReadChunk(size_t max_bytes, std::string* filename,
+    uint64_t* offset, std::string* data, bool* done) {
+  if (file_ >= fds_.size()) {
+    return Status::EndFile("no more chunk");
+  }
+  size_t len = std::min(static_cast<uint64_t>(max_bytes), sizes_[file_] - offset_);
+  data->resize(len);
+  size_t read_bytes = 0;
+  while (read_bytes < len) {
+    ssize_t n = pread(fds_[file_], &(*data)[read_bytes], len - read_bytes, offset_ + read_bytes);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return Status::IOError("read " + filenames_[file_], n < 0 ? strerror(errno) : "unexpected eof");
+    }
+    read_bytes += n;
+  }
+  chunk_size_ = len;
+  *filename = filenames_[file_];
+  *offset = offset_;
+  *done = (file_ == fds_.size() - 1 && offset_ + len == sizes_[file_]);
+  return Status::OK();
+}
+
+void SnapshotReader::Advance() {
+  seq_++;
+  offset_ += chunk_size_;
+  chunk_size_ = 0;
+  if (offset_ >= sizes_[file_]) {
+    file_++;
+    offset_ = 0;
+  }
+}
+
+void SnapshotReader::Rewind() {
+  seq_ = 0;
+  file_ = 0;
+  offset_ = 0;
+  chunk_size_ = 0;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& dir, const std::string& leader,
+    uint64_t index, uint64_t term)
+  : dir_(dir),
+    leader_(leader),
+    index_(index),
+    term_(term),
+    next_seq_(0) {
+}
+
+Status SnapshotWriter::Open() {
+  slash::DeleteDirIfExist(dir_);
+  if (slash::CreatePath(dir_) != 0) {
+    return Status::IOError("create " + dir_, strerror(errno));
+  }
+  next_seq_ = 0;
+  return Status::OK();
+}
+
+Status SnapshotWriter::Write(const std::string& filename, uint64_t offset,
+    const std::string& data) {
+  if (filename.empty() || filename == "." || filename == ".."
+      || filename.find('/') != std::string::npos) {
+    return Status::InvalidArgument("bad snapshot file " + filename);
+  }
+  std::string path = dir_ + "/" + filename;
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (fd < 0) {
+    return Status::IOError("open " + path, strerror(errno));
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = pwrite(fd, data.data() + written, data.size() - written, offset + written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0) {
+      close(fd);
+      return Status::IOError("write " + path, strerror(errno));
+    }
+    written += n;
+  }
+  close(fd);
+  next_seq_++;
+  return Status::OK();
+}
+
+Status SnapshotWriter::Sync() {
+  std::vector<std::string> filenames;
+  if (slash::GetChildren(dir_, filenames) != 0) {
+    return Status::IOError("list " + dir_, strerror(errno));
+  }
+  for (size_t i = 0; i < filenames.size(); i++) {
+    if (filenames[i] == "." || filenames[i] == "..") {
+      continue;
+    }
+    Status s = SyncFile(dir_ + "/" + filenames[i]);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return SyncFile(dir_);
+}
+
+}  // namespace floyd
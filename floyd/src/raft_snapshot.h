@@ -0,0 +1,153 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_RAFT_SNAPSHOT_H_
+#define FLOYD_SRC_RAFT_SNAPSHOT_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "slash/include/slash_status.h"
+#include "slash/include/slash_mutex.h"
+
+#include "floyd/include/floyd_state_machine.h"
+
+namespace floyd {
+
+using slash::Status;
+
+class Logger;
+class SnapshotReader;
+
+/*
+ * RaftSnapshot manages the snapshot of the state machine in path,
+ * a snapshot is the files written by StateMachine::Snapshot after the
+ * entries [1, index] have been applied, with a SNAPSHOT_META file recording
+ * | index (8 bytes) | term (8 bytes) | serialized Membership |
+ *
+ * a new snapshot is created in path.tmp, or received from the leader in
+ * path.recv, and swapped with the current one by renaming, Recover cleans up
+ * a swap interrupted by crash. A snapshot never replaces a newer one
+ */
+class RaftSnapshot {
+ public:
+  RaftSnapshot(const std::string& path, Logger* info_log);
+  ~RaftSnapshot();
+
+  Status Recover();
+
+  // the caller should make sure state_machine won't be modified during
+  // Create, Incomplete if there is a newer snapshot already
+  Status Create(StateMachine* state_machine, uint64_t index, uint64_t term,
+      const std::string& members);
+  // swap the snapshot received in RecvPath() in
+  Status Install(uint64_t index, uint64_t term);
+  // replace the content of state_machine with the snapshot, return the
+  // snapshot meta
+  Status Restore(StateMachine* state_machine, uint64_t* index, uint64_t* term,
+      std::string* members);
+  // NotFound if there is no snapshot
+  Status LoadMeta(uint64_t* index, uint64_t* term, std::string* members);
+  // open the files of the current snapshot to send them to a follower,
+  // the files stay readable after the snapshot is replaced
+  Status OpenReader(SnapshotReader** reader);
+
+  const std::string& path() const { return path_; }
+  std::string RecvPath() const { return path_ + ".recv"; }
+
+ private:
+  const std::string path_;
+  Logger* const info_log_;
+
+  // protect the swap of the snapshot directory
+  slash::Mutex mu_;
+  // index of the current snapshot, 0 if none
+  uint64_t index_;
+
+  Status WriteMeta(const std::string& dir, uint64_t index, uint64_t term, const std::string& members);
+  Status SwapIn(const std::string& dir, uint64_t index);
+
+  // No copying allowed
+  RaftSnapshot(const RaftSnapshot&);
+  void operator=(const RaftSnapshot&);
+};
+
+/*
+ * SnapshotReader reads the snapshot files in chunks for the leader,
+ * the chunk at the current position is read again until Advance
+ */
+class SnapshotReader {
+ public:
+  SnapshotReader(uint64_t index, uint64_t term);
+  ~SnapshotReader();
+
+  Status AddFile(const std::string& filename);
+  // read the chunk at current position, done is set for the last chunk
+  Status ReadChunk(size_t max_bytes, std::string* filename,
+      uint64_t* offset, std::string* data, bool* done);
+  void Advance();
+  // start over from the first chunk
+  void Rewind();
+
+  uint64_t index() const { return index_; }
+  uint64_t term() const { return term_; }
+  uint64_t seq() const { return seq_; }
+
+ private:
+  const uint64_t index_;
+  const uint64_t term_;
+  std::vector<std::string> filenames_;
+  std::vector<int> fds_;
+  std::vector<uint64_t> sizes_;
+
+  // the current position
+  uint64_t seq_;
+  size_t file_;
+  uint64_t offset_;
+  size_t chunk_size_;
+
+  // No copying allowed
+  SnapshotReader(const SnapshotReader&);
+  void operator=(const SnapshotReader&);
+};
+
+/*
+ * SnapshotWriter writes the chunks received from the leader in dir,
+ * the chunks must arrive in sequence
+ */
+class SnapshotWriter {
+ public:
+  SnapshotWriter(const std::string& dir, const std::string& leader,
+      uint64_t index, uint64_t term);
+
+  // clear dir and get ready for the first chunk
+  Status Open();
+  Status Write(const std::string& filename, uint64_t offset, const std::string& data);
+  // make the received files durable
+  Status Sync();
+
+  const std::string& leader() const { return leader_; }
+  uint64_t index() const { return index_; }
+  uint64_t term() const { return term_; }
+  // the seq of the next chunk expected
+  uint64_t next_seq() const { return next_seq_; }
+
+ private:
+  const std::string dir_;
+  const std::string leader_;
+  const uint64_t index_;
+  const uint64_t term_;
+  uint64_t next_seq_;
+
+  // No copying allowed
+  SnapshotWriter(const SnapshotWriter&);
+  void operator=(const SnapshotWriter&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_RAFT_SNAPSHOT_H_
@@ -0,0 +1,140 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/rocksdb_state_machine.h"
+
+#include "rocksdb/utilities/checkpoint.h"
+#include "rocksdb/write_batch.h"
+#include "slash/include/env.h"
+
+#include "floyd/src/logger.h"
+#include "floyd/include/floyd_options.h"
+
+namespace floyd {
+
+// bytes written to db in one batch when restoring from snapshot
+static const size_t kRestoreBatchBytes = 4 * 1024 * 1024;
+
+Status RocksdbStateMachine::Open(const std::string& path, Logger* info_log,
+    RocksdbStateMachine** result) {
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  options.write_buffer_size = 1024 * 1024 * 1024;
+  options.max_background_flushes = 8;
+  rocksdb::DB* db;
+  rocksdb::Status s = rocksdb::DB::Open(options, path, &db);
+  if (!s.ok()) {
+    return Status::Corruption("open db " + path, s.ToString());
+  }
+  *result = new RocksdbStateMachine(db, info_log);
+  return Status::OK();
+}
+
+RocksdbStateMachine::RocksdbStateMachine(rocksdb::DB* db, Logger* info_log)
+  : db_(db),
+    info_log_(info_log) {
+}
+
+RocksdbStateMachine::~RocksdbStateMachine() {
+  delete db_;
+}
+
+Status RocksdbStateMachine::Apply(const StateMachineBatch& batch) {
+  rocksdb::WriteBatch wb;
+  const std::vector<StateMachineBatch::Op>& ops = batch.ops();
+  for (size_t i = 0; i < ops.size(); i++) {
+    if (ops[i].type == StateMachineBatch::kPut) {
+      wb.Put(ops[i].key, ops[i].value);
+    } else {
+      wb.Delete(ops[i].key);
+    }
+  }
+  rocksdb::Status s = db_->Write(rocksdb::WriteOptions(), &wb);
+  if (!s.ok()) {
+    return Status::IOError("write db", s.ToString());
+  }
+  return Status::OK();
+}
+
+Status RocksdbStateMachine::Read(const std::string& key, std::string* value) {
+  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, value);
+  if (s.IsNotFound()) {
+    return Status::NotFound(key);
+  } else if (!s.ok()) {
+    return Status::IOError("read db", s.ToString());
+  }
+  return Status::OK();
+}
+
+Status RocksdbStateMachine::Snapshot(const std::string& dir) {
+  rocksdb::Checkpoint* checkpoint;
+  rocksdb::Status rs = rocksdb::Checkpoint::Create(db_, &checkpoint);
+  if (!rs.ok()) {
+    return Status::IOError("create checkpoint", rs.ToString());
+  }
+  rs = checkpoint->CreateCheckpoint(dir);
+  delete checkpoint;
+  if (!rs.ok()) {
+    return Status::IOError("create checkpoint in " + dir, rs.ToString());
+  }
+  return Status::OK();
+}
+
+Status RocksdbStateMachine::Restore(const std::string& dir) {
+  uint64_t start_us = slash::NowMicros();
+  rocksdb::DB* snapshot_db;
+  rocksdb::Status rs = rocksdb::DB::OpenForReadOnly(rocksdb::Options(), dir, &snapshot_db);
+  if (!rs.ok()) {
+    return Status::IOError("open snapshot " + dir, rs.ToString());
+  }
+
+  // drop all the keys in db
+  rocksdb::WriteBatch batch;
+  rocksdb::Iterator* iter = db_->NewIterator(rocksdb::ReadOptions());
+  iter->SeekToFirst();
+  if (iter->Valid()) {
+    std::string first = iter->key().ToString();
+    iter->SeekToLast();
+    batch.DeleteRange(first, iter->key());
+    batch.Delete(iter->key());
+  }
+  rs = iter->status();
+  delete iter;
+  if (rs.ok()) {
+    rs = db_->Write(rocksdb::WriteOptions(), &batch);
+    batch.Clear();
+  }
+
+  // copy the keys in snapshot
+  uint64_t count = 0;
+  iter = snapshot_db->NewIterator(rocksdb::ReadOptions());
+  for (iter->SeekToFirst(); rs.ok() && iter->Valid(); iter->Next()) {
+    if (batch.GetDataSize() >= kRestoreBatchBytes) {
+      rs = db_->Write(rocksdb::WriteOptions(), &batch);
+      batch.Clear();
+    }
+    batch.Put(iter->key(), iter->value());
+    count++;
+  }
+  if (rs.ok()) {
+    rs = iter->status();
+  }
+  delete iter;
+  delete snapshot_db;
+  if (rs.ok()) {
+    // sync the wal, which makes the writes before durable too
+    rocksdb::WriteOptions write_options;
+    write_options.sync = true;
+    rs = db_->Write(write_options, &batch);
+  }
+  if (!rs.ok()) {
+    return Status::IOError("restore from snapshot " + dir, rs.ToString());
+  }
+  LOGV(INFO_LEVEL, info_log_, "RocksdbStateMachine::Restore restore %lu keys from %s, cost %lu us",
+      count, dir.c_str(), slash::NowMicros() - start_us);
+  return Status::OK();
+}
+
+}  // namespace floyd
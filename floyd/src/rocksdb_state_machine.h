@@ -0,0 +1,43 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_ROCKSDB_STATE_MACHINE_H_
+#define FLOYD_SRC_ROCKSDB_STATE_MACHINE_H_
+
+#include <string>
+
+#include "rocksdb/db.h"
+
+#include "floyd/include/floyd_state_machine.h"
+
+namespace floyd {
+
+class Logger;
+
+/*
+ * RocksdbStateMachine is the default state machine, every key is stored
+ * in a rocksdb, and the snapshot is a checkpoint of it
+ */
+class RocksdbStateMachine : public StateMachine {
+ public:
+  // open or create the rocksdb in path
+  static Status Open(const std::string& path, Logger* info_log, RocksdbStateMachine** result);
+  virtual ~RocksdbStateMachine();
+
+  virtual Status Apply(const StateMachineBatch& batch) override;
+  virtual Status Read(const std::string& key, std::string* value) override;
+  virtual Status Snapshot(const std::string& dir) override;
+  virtual Status Restore(const std::string& dir) override;
+
+ private:
+  RocksdbStateMachine(rocksdb::DB* db, Logger* info_log);
+
+  rocksdb::DB* const db_;
+  Logger* const info_log_;
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_ROCKSDB_STATE_MACHINE_H_
@@ -0,0 +1,625 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include "floyd/src/segment_log_storage.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "slash/include/env.h"
+
+#include "floyd/src/logger.h"
+#include "floyd/src/crc32c.h"
+
+namespace floyd {
+
+static const std::string kSegmentSuffix = ".seg";
+// index (8 bytes) + length (4 bytes) + crc32c (4 bytes)
+static const uint64_t kRecordHeaderSize = 16;
+// the crc32c starts from the index and the length
+static const uint64_t kRecordCrcOffset = 12;
+static const uint64_t kIndexInterval = 16;
+
+static std::string SegmentFileName(uint64_t first_index) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%020lu", first_index);
+  return std::string(buf) + kSegmentSuffix;
+}
+
+static Status IOError(const std::string& context) {
+  return Status::IOError(context, strerror(errno));
+}
+
+static Status Preallocate(int fd, uint64_t size) {
+  if (fallocate(fd, 0, 0, size) == 0) {
+    return Status::OK();
+  }
+  // the filesystem don't support fallocate, extend the file as a sparse one
+  if (errno == EOPNOTSUPP && ftruncate(fd, size) == 0) {
+    return Status::OK();
+  }
+  return IOError("preallocate segment");
+}
+
+static Status ReadFull(int fd, char* buf, uint64_t n, uint64_t offset) {
+  while (n > 0) {
+    ssize_t r = pread(fd, buf, n, offset);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOError("read segment");
+    } else if (r == 0) {
+      return Status::Corruption("read segment", "unexpected end of file");
+    }
+    buf += r;
+    n -= r;
+    offset += r;
+  }
+  return Status::OK();
+}
+
+static Status WriteFull(int fd, const char* buf, uint64_t n, uint64_t offset) {
+  while (n > 0) {
+    ssize_t r = pwrite(fd, buf, n, offset);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOError("write segment");
+    }
+    buf += r;
+    n -= r;
+    offset += r;
+  }
+  return Status::OK();
+}
+
+static void DecodeHeader(const char* p, uint64_t* index, uint32_t* length) {
+  memcpy(index, p, sizeof(uint64_t));
+  memcpy(length, p + sizeof(uint64_t), sizeof(uint32_t));
+}
+
+static uint32_t RecordCrc(const char* header, const char* data, uint32_t length) {
+  return crc32c::Extend(crc32c::Value(header, kRecordCrcOffset), data, length);
+}
+
+static bool CheckRecord(const char* header, const char* data, uint32_t length) {
+  uint32_t crc;
+  memcpy(&crc, header + kRecordCrcOffset, sizeof(uint32_t));
+  return crc == RecordCrc(header, data, length);
+}
+
+static void EncodeRecord(uint64_t index, const std::string& data, std::string* dst) {
+  char buf[kRecordHeaderSize];
+  uint32_t length = data.size();
+  memcpy(buf, &index, sizeof(uint64_t));
+  memcpy(buf + sizeof(uint64_t), &length, sizeof(uint32_t));
+  uint32_t crc = RecordCrc(buf, data.data(), length);
+  memcpy(buf + kRecordCrcOffset, &crc, sizeof(uint32_t));
+  dst->append(buf, kRecordHeaderSize);
+  dst->append(data);
+}
+
+SegmentLogStorage::SegmentLogStorage(const std::string& path, uint64_t segment_size,
+    Logger* info_log)
+  : path_(path.empty() || path[path.size() - 1] != '/' ? path + "/" : path),
+    segment_size_(segment_size),
+    info_log_(info_log),
+    cursor_index_(0),
+    cursor_segment_(0),
+    cursor_offset_(0),
+    dir_unsynced_(false) {
+}
+
+SegmentLogStorage::~SegmentLogStorage() {
+  for (auto& iter : segments_) {
+    close(iter.second->fd);
+    delete iter.second;
+  }
+}
+
+Status SegmentLogStorage::Open() {
+  slash::MutexLock l(&mu_);
+  if (slash::CreatePath(path_) != 0 && !slash::FileExists(path_)) {
+    return IOError("create segment path " + path_);
+  }
+  std::vector<std::string> children;
+  if (slash::GetChildren(path_, children) != 0) {
+    return IOError("list segment path " + path_);
+  }
+  std::vector<uint64_t> first_indexes;
+  for (const auto& name : children) {
+    if (name.size() <= kSegmentSuffix.size()
+        || name.compare(name.size() - kSegmentSuffix.size(), kSegmentSuffix.size(), kSegmentSuffix) != 0) {
+      continue;
+    }
+    first_indexes.push_back(strtoull(name.c_str(), NULL, 10));
+  }
+  std::sort(first_indexes.begin(), first_indexes.end());
+
+  Status s;
+  Segment* prev = NULL;
+  for (size_t i = 0; i < first_indexes.size(); i++) {
+    Segment* seg = NULL;
+    bool torn = false;
+    s = LoadSegment(first_indexes[i], &torn, &seg);
+    if (!s.ok()) {
+      return s;
+    }
+    segments_[seg->first_index] = seg;
+    if (prev != NULL && prev->last_index + 1 != seg->first_index) {
+      LOGV(ERROR_LEVEL, info_log_, "SegmentLogStorage::Open segment %s ends at %lu, but the next segment %s "
+          "starts at %lu", prev->filename.c_str(), prev->last_index, seg->filename.c_str(), seg->first_index);
+      return Status::Corruption("log segments are not continuous");
+    }
+    prev = seg;
+    if (torn && i != first_indexes.size() - 1) {
+      // the records after a torn write are not acknowledged, drop them
+      LOGV(WARN_LEVEL, info_log_, "SegmentLogStorage::Open segment %s is torn after entry %lu, "
+          "remove the %lu segments after it", seg->filename.c_str(), seg->last_index,
+          first_indexes.size() - 1 - i);
+      for (size_t j = i + 1; j < first_indexes.size(); j++) {
+        std::string filename = path_ + SegmentFileName(first_indexes[j]);
+        if (unlink(filename.c_str()) != 0) {
+          return IOError("remove segment " + filename);
+        }
+      }
+      dir_unsynced_ = true;
+      break;
+    }
+  }
+  // the tail of the last segment may be a partial record, clean it
+  // and keep the segment preallocated for the following append
+  if (prev != NULL) {
+    s = ResetTail(prev);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  LOGV(INFO_LEVEL, info_log_, "SegmentLogStorage::Open load %lu segments from %s, entries [%lu, %lu]",
+      segments_.size(), path_.c_str(), FirstIndexLocked(), LastIndexLocked());
+  return Status::OK();
+}
+
+Status SegmentLogStorage::LoadSegment(uint64_t first_index, bool* torn, Segment** result) {
+  std::string filename = SegmentFileName(first_index);
+  int fd = open((path_ + filename).c_str(), O_RDWR);
+  if (fd < 0) {
+    return IOError("open segment " + filename);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return IOError("stat segment " + filename);
+  }
+
+  Segment* seg = new Segment();
+  seg->first_index = first_index;
+  seg->last_index = first_index - 1;
+  seg->size = 0;
+  seg->fd = fd;
+  seg->filename = filename;
+
+  uint64_t file_size = st.st_size;
+  if (file_size > 0) {
+    void* base = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      close(fd);
+      delete seg;
+      return IOError("mmap segment " + filename);
+    }
+    const char* data = reinterpret_cast<const char*>(base);
+    uint64_t offset = 0;
+    uint64_t index;
+    uint32_t length;
+    while (offset + kRecordHeaderSize <= file_size) {
+      DecodeHeader(data + offset, &index, &length);
+      if (index != seg->last_index + 1) {
+        // the preallocated space, or a torn header
+        *torn = index != 0;
+        break;
+      }
+      if (offset + kRecordHeaderSize + length > file_size
+          || !CheckRecord(data + offset, data + offset + kRecordHeaderSize, length)) {
+        LOGV(WARN_LEVEL, info_log_, "SegmentLogStorage::LoadSegment record of entry %lu at offset %lu "
+            "in %s is broken", index, offset, filename.c_str());
+        *torn = true;
+        break;
+      }
+      if ((index - first_index) % kIndexInterval == 0) {
+        seg->offsets.push_back(offset);
+      }
+      seg->last_index = index;
+      offset += kRecordHeaderSize + length;
+    }
+    munmap(base, file_size);
+    seg->size = offset;
+  }
+  *result = seg;
+  return Status::OK();
+}
+
+Status SegmentLogStorage::ResetTail(Segment* seg) {
+  if (ftruncate(seg->fd, seg->size) != 0) {
+    return IOError("truncate segment " + seg->filename);
+  }
+  Status s = Preallocate(seg->fd, std::max(segment_size_, seg->size));
+  if (!s.ok()) {
+    return s;
+  }
+  // the broken records cut should not come back after crash
+  MarkUnsynced(seg);
+  return Status::OK();
+}
+
+Status SegmentLogStorage::NewSegment(uint64_t first_index, Segment** result) {
+  std::string filename = SegmentFileName(first_index);
+  int fd = open((path_ + filename).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return IOError("create segment " + filename);
+  }
+  Status s = Preallocate(fd, segment_size_);
+  if (!s.ok()) {
+    close(fd);
+    unlink((path_ + filename).c_str());
+    return s;
+  }
+  Segment* seg = new Segment();
+  seg->first_index = first_index;
+  seg->last_index = first_index - 1;
+  seg->size = 0;
+  seg->fd = fd;
+  seg->filename = filename;
+  segments_[first_index] = seg;
+  dir_unsynced_ = true;
+  *result = seg;
+  return Status::OK();
+}
+
+// give back the preallocated space that is not used
+Status SegmentLogStorage::SealSegment(Segment* seg) {
+  if (ftruncate(seg->fd, seg->size) != 0) {
+    return IOError("seal segment " + seg->filename);
+  }
+  MarkUnsynced(seg);
+  return Status::OK();
+}
+
+void SegmentLogStorage::RemoveSegment(Segment* seg) {
+  close(seg->fd);
+  if (unlink((path_ + seg->filename).c_str()) != 0) {
+    LOGV(WARN_LEVEL, info_log_, "SegmentLogStorage::RemoveSegment unlink %s failed, error: %s",
+        seg->filename.c_str(), strerror(errno));
+  }
+  segments_.erase(seg->first_index);
+  dir_unsynced_ = true;
+  delete seg;
+}
+
+void SegmentLogStorage::MarkUnsynced(Segment* seg) {
+  if (unsynced_.empty() || unsynced_.back() != seg->first_index) {
+    unsynced_.push_back(seg->first_index);
+  }
+}
+
+uint64_t SegmentLogStorage::FirstIndexLocked() {
+  if (segments_.empty()) {
+    return 0;
+  }
+  Segment* seg = segments_.begin()->second;
+  return seg->last_index >= seg->first_index ? seg->first_index : 0;
+}
+
+uint64_t SegmentLogStorage::LastIndexLocked() {
+  if (FirstIndexLocked() == 0) {
+    return 0;
+  }
+  return segments_.rbegin()->second->last_index;
+}
+
+uint64_t SegmentLogStorage::FirstIndex() {
+  slash::MutexLock l(&mu_);
+  return FirstIndexLocked();
+}
+
+uint64_t SegmentLogStorage::LastIndex() {
+  slash::MutexLock l(&mu_);
+  return LastIndexLocked();
+}
+
+SegmentLogStorage::Segment* SegmentLogStorage::FindSegment(uint64_t index) {
+  auto iter = segments_.upper_bound(index);
+  if (iter == segments_.begin()) {
+    return NULL;
+  }
+  iter--;
+  if (index > iter->second->last_index) {
+    return NULL;
+  }
+  return iter->second;
+}
+
+Status SegmentLogStorage::Locate(Segment* seg, uint64_t index, uint64_t* offset) {
+  if (index == cursor_index_ && seg->first_index == cursor_segment_) {
+    *offset = cursor_offset_;
+    return Status::OK();
+  }
+  uint64_t pos = seg->offsets[(index - seg->first_index) / kIndexInterval];
+  uint64_t record_index;
+  uint32_t length;
+  char header[kRecordHeaderSize];
+  while (true) {
+    Status s = ReadFull(seg->fd, header, kRecordHeaderSize, pos);
+    if (!s.ok()) {
+      return s;
+    }
+    DecodeHeader(header, &record_index, &length);
+    if (record_index == index) {
+      break;
+    } else if (record_index > index || pos + kRecordHeaderSize + length > seg->size) {
+      return Status::Corruption("locate entry " + std::to_string(index) + " in " + seg->filename);
+    }
+    pos += kRecordHeaderSize + length;
+  }
+  *offset = pos;
+  return Status::OK();
+}
+
+Status SegmentLogStorage::WriteRecords(Segment* seg, uint64_t index,
+    const std::vector<std::string>& bufs, size_t begin, size_t end) {
+  std::string records;
+  std::vector<uint64_t> offsets;
+  uint64_t offset = seg->size;
+  for (size_t i = begin; i < end; i++, index++) {
+    if ((index - seg->first_index) % kIndexInterval == 0) {
+      offsets.push_back(offset + records.size());
+    }
+    EncodeRecord(index, bufs[i], &records);
+  }
+  Status s = WriteFull(seg->fd, records.data(), records.size(), offset);
+  if (!s.ok()) {
+    return s;
+  }
+  seg->offsets.insert(seg->offsets.end(), offsets.begin(), offsets.end());
+  seg->size += records.size();
+  seg->last_index = index - 1;
+  MarkUnsynced(seg);
+  return Status::OK();
+}
+
+Status SegmentLogStorage::Append(uint64_t index, const std::vector<std::string>& bufs) {
+  slash::MutexLock l(&mu_);
+  if (bufs.empty()) {
+    return Status::OK();
+  }
+  uint64_t last_index = LastIndexLocked();
+  if (last_index != 0 && index != last_index + 1) {
+    return Status::InvalidArgument("append entry " + std::to_string(index)
+        + " after " + std::to_string(last_index));
+  }
+
+  Status s;
+  Segment* seg = NULL;
+  if (last_index == 0) {
+    while (!segments_.empty()) {
+      RemoveSegment(segments_.begin()->second);
+    }
+    s = NewSegment(index, &seg);
+    if (!s.ok()) {
+      return s;
+    }
+  } else {
+    seg = segments_.rbegin()->second;
+  }
+
+  size_t begin = 0;
+  while (begin < bufs.size()) {
+    // a large entry still take a whole segment if the segment is empty
+    uint64_t size = seg->size;
+    size_t end = begin;
+    while (end < bufs.size()
+        && (size + kRecordHeaderSize + bufs[end].size() <= segment_size_ || size == 0)) {
+      size += kRecordHeaderSize + bufs[end].size();
+      end++;
+    }
+    if (end == begin) {
+      s = SealSegment(seg);
+      if (s.ok()) {
+        s = NewSegment(seg->last_index + 1, &seg);
+      }
+    } else {
+      s = WriteRecords(seg, index + begin, bufs, begin, end);
+      begin = end;
+    }
+    if (!s.ok()) {
+      LOGV(ERROR_LEVEL, info_log_, "SegmentLogStorage::Append append entries from %lu failed, error: %s",
+          index, s.ToString().c_str());
+      // don't leave part of the entries in the log
+      TruncateSuffixLocked(index);
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+Status SegmentLogStorage::Sync() {
+  // fdatasync on the dup fds without holding mu_, so the reads are not
+  // blocked, and the segment may be removed in the meantime
+  std::vector<int> fds;
+  bool sync_dir;
+  {
+  slash::MutexLock l(&mu_);
+  for (size_t i = 0; i < unsynced_.size(); i++) {
+    std::map<uint64_t, Segment*>::iterator iter = segments_.find(unsynced_[i]);
+    if (iter == segments_.end()) {
+      continue;
+    }
+    int fd = dup(iter->second->fd);
+    if (fd < 0) {
+      Status s = IOError("dup segment " + iter->second->filename);
+      for (size_t j = 0; j < fds.size(); j++) {
+        close(fds[j]);
+      }
+      return s;
+    }
+    fds.push_back(fd);
+  }
+  unsynced_.clear();
+  sync_dir = dir_unsynced_;
+  dir_unsynced_ = false;
+  }
+
+  Status s;
+  for (size_t i = 0; i < fds.size(); i++) {
+    if (s.ok() && fdatasync(fds[i]) != 0) {
+      s = IOError("sync segment");
+    }
+    close(fds[i]);
+  }
+  if (s.ok() && sync_dir) {
+    int fd = open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return IOError("open " + path_);
+    }
+    if (fsync(fd) != 0) {
+      s = IOError("sync " + path_);
+    }
+    close(fd);
+  }
+  return s;
+}
+
+Status SegmentLogStorage::Get(uint64_t index, std::string* buf) {
+  slash::MutexLock l(&mu_);
+  return GetLocked(index, buf);
+}
+
+Status SegmentLogStorage::Scan(uint64_t begin, uint64_t end, uint64_t max_bytes,
+    std::vector<std::string>* bufs) {
+  slash::MutexLock l(&mu_);
+  bufs->clear();
+  uint64_t bytes = 0;
+  // every GetLocked after the first one starts from the cursor,
+  // so the records are read sequentially
+  for (uint64_t index = begin; index <= end && bytes < max_bytes; index++) {
+    std::string buf;
+    Status s = GetLocked(index, &buf);
+    if (s.IsNotFound() && !bufs->empty()) {
+      break;
+    } else if (!s.ok()) {
+      return s;
+    }
+    bytes += buf.size();
+    bufs->push_back(std::string());
+    bufs->back().swap(buf);
+  }
+  return Status::OK();
+}
+
+Status SegmentLogStorage::GetLocked(uint64_t index, std::string* buf) {
+  Segment* seg = FindSegment(index);
+  if (seg == NULL) {
+    return Status::NotFound("index " + std::to_string(index));
+  }
+  uint64_t offset;
+  Status s = Locate(seg, index, &offset);
+  if (!s.ok()) {
+    return s;
+  }
+  char header[kRecordHeaderSize];
+  uint64_t record_index;
+  uint32_t length;
+  s = ReadFull(seg->fd, header, kRecordHeaderSize, offset);
+  if (!s.ok()) {
+    return s;
+  }
+  DecodeHeader(header, &record_index, &length);
+  if (record_index != index) {
+    return Status::Corruption("entry " + std::to_string(index) + " in " + seg->filename);
+  }
+  buf->resize(length);
+  s = ReadFull(seg->fd, &(*buf)[0], length, offset + kRecordHeaderSize);
+  if (!s.ok()) {
+    return s;
+  }
+  if (!CheckRecord(header, buf->data(), length)) {
+    return Status::Corruption("checksum mismatch of entry " + std::to_string(index) + " in " + seg->filename);
+  }
+  cursor_index_ = index + 1;
+  cursor_segment_ = seg->first_index;
+  cursor_offset_ = offset + kRecordHeaderSize + length;
+  return Status::OK();
+}
+
+Status SegmentLogStorage::TruncateSuffix(uint64_t index) {
+  slash::MutexLock l(&mu_);
+  return TruncateSuffixLocked(index);
+}
+
+Status SegmentLogStorage::TruncateSuffixLocked(uint64_t index) {
+  cursor_index_ = 0;
+  while (!segments_.empty() && segments_.rbegin()->second->first_index >= index) {
+    RemoveSegment(segments_.rbegin()->second);
+  }
+  if (segments_.empty()) {
+    return Status::OK();
+  }
+  Segment* seg = segments_.rbegin()->second;
+  if (index > seg->last_index) {
+    return Status::OK();
+  }
+  uint64_t offset;
+  Status s = Locate(seg, index, &offset);
+  if (!s.ok()) {
+    return s;
+  }
+  // cut the segment at the record, the space after it is filled with zero
+  // again, so it will not be taken as records when recovering
+  if (ftruncate(seg->fd, offset) != 0) {
+    return IOError("truncate segment " + seg->filename);
+  }
+  s = Preallocate(seg->fd, std::max(segment_size_, offset));
+  if (!s.ok()) {
+    return s;
+  }
+  // the truncated records should not come back after crash
+  MarkUnsynced(seg);
+  uint64_t count = index - seg->first_index;
+  seg->offsets.resize((count + kIndexInterval - 1) / kIndexInterval);
+  seg->size = offset;
+  seg->last_index = index - 1;
+  return Status::OK();
+}
+
+Status SegmentLogStorage::TruncatePrefix(uint64_t index) {
+  slash::MutexLock l(&mu_);
+  cursor_index_ = 0;
+  while (!segments_.empty() && segments_.begin()->second->last_index <= index) {
+    RemoveSegment(segments_.begin()->second);
+  }
+  return Status::OK();
+}
+
+uint64_t SegmentLogStorage::ApproximateBytes() {
+  slash::MutexLock l(&mu_);
+  uint64_t bytes = 0;
+  for (auto& iter : segments_) {
+    bytes += iter.second->size;
+  }
+  return bytes;
+}
+
+}  // namespace floyd
@@ -0,0 +1,122 @@
+// Copyright (c) 2015-present, Qihoo, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef FLOYD_SRC_SEGMENT_LOG_STORAGE_H_
+#define FLOYD_SRC_SEGMENT_LOG_STORAGE_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "slash/include/slash_status.h"
+#include "slash/include/slash_mutex.h"
+
+#include "floyd/src/log_storage.h"
+
+namespace floyd {
+
+using slash::Status;
+
+class Logger;
+
+/*
+ * SegmentLogStorage store the entries in append only segment files,
+ * every segment is named by the index of its first entry, and it is
+ * preallocated to segment_size when created, so appending an entry
+ * don't need to extend the file.
+ *
+ * the record in segment is
+ * | index (8 bytes) | length (4 bytes) | crc32c (4 bytes) | data (length bytes) |
+ * crc32c covers the index, the length and the data. The preallocated space
+ * is filled with zero, so the recovery stops at the first record whose
+ * index is not the expected one, a record whose crc32c doesn't match is a
+ * torn write, the segment is cut there and the segments after it are
+ * removed
+ *
+ * we only keep the offset of one every kIndexInterval entries in memory,
+ * Get will scan the record headers from the nearest one
+ */
+class SegmentLogStorage : public LogStorage {
+ public:
+  SegmentLogStorage(const std::string& path, uint64_t segment_size, Logger* info_log);
+  virtual ~SegmentLogStorage();
+
+  virtual Status Open();
+  virtual uint64_t FirstIndex();
+  virtual uint64_t LastIndex();
+  virtual Status Append(uint64_t index, const std::vector<std::string>& bufs);
+  // fdatasync the segments written since the last Sync, the segments are
+  // preallocated, so the metadata don't need to be flushed for an append
+  virtual Status Sync();
+  virtual Status Get(uint64_t index, std::string* buf);
+  virtual Status Scan(uint64_t begin, uint64_t end, uint64_t max_bytes,
+      std::vector<std::string>* bufs);
+  // O(1) for the last segment, the whole segments after index are removed
+  virtual Status TruncateSuffix(uint64_t index);
+  // only the segments whose entries are all in the prefix will be removed
+  virtual Status TruncatePrefix(uint64_t index);
+  virtual uint64_t ApproximateBytes();
+
+ private:
+  struct Segment {
+    uint64_t first_index;
+    // first_index - 1 when the segment is empty
+    uint64_t last_index;
+    // bytes of the records written
+    uint64_t size;
+    int fd;
+    std::string filename;
+    // offsets[i] is the offset of entry first_index + i * kIndexInterval
+    std::vector<uint64_t> offsets;
+  };
+
+  const std::string path_;
+  const uint64_t segment_size_;
+  Logger* const info_log_;
+
+  slash::Mutex mu_;
+  // key is the first index of the segment
+  std::map<uint64_t, Segment*> segments_;
+
+  /*
+   * the position of the entry after the last one we read,
+   * so the sequential Get don't need to scan from the sparse index
+   */
+  uint64_t cursor_index_;
+  uint64_t cursor_segment_;
+  uint64_t cursor_offset_;
+
+  // first index of the segments written since the last Sync
+  std::vector<uint64_t> unsynced_;
+  // a segment is created or removed since the last Sync
+  bool dir_unsynced_;
+
+  uint64_t FirstIndexLocked();
+  uint64_t LastIndexLocked();
+  Segment* FindSegment(uint64_t index);
+  Status Locate(Segment* seg, uint64_t index, uint64_t* offset);
+  Status GetLocked(uint64_t index, std::string* buf);
+  // torn is set if the records stop at a broken one
+  Status LoadSegment(uint64_t first_index, bool* torn, Segment** result);
+  // cut the unused tail of the last segment and preallocate it again
+  Status ResetTail(Segment* seg);
+  Status NewSegment(uint64_t first_index, Segment** result);
+  Status SealSegment(Segment* seg);
+  void RemoveSegment(Segment* seg);
+  void MarkUnsynced(Segment* seg);
+  Status WriteRecords(Segment* seg, uint64_t index, const std::vector<std::string>& bufs,
+      size_t begin, size_t end);
+  Status TruncateSuffixLocked(uint64_t index);
+
+  // No copying allowed
+  SegmentLogStorage(const SegmentLogStorage&);
+  void operator=(const SegmentLogStorage&);
+};
+
+}  // namespace floyd
+
+#endif  // FLOYD_SRC_SEGMENT_LOG_STORAGE_H_
@@ -0,0 +1,230 @@
+/**
+ * @file conflict_bench.cc
+ * @brief replay the raft paper's Figure 7 logs constructed by cl1 and one
+ * more follower, count the AppendEntries rounds and time until every
+ * follower converges with the leader, backtracking one entry at a time or
+ * with the conflict term hints of AppendEntriesResponse
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "slash/include/env.h"
+
+#include "floyd/include/floyd_options.h"
+#include "floyd/src/raft_log.h"
+#include "floyd/src/entry_codec.h"
+#include "floyd/src/floyd.pb.h"
+#include "floyd/src/logger.h"
+
+using namespace floyd;
+
+struct Layout {
+  std::string name;
+  // the term of every entry in Figure 7
+  std::vector<uint64_t> terms;
+};
+
+// the leader and the followers (a) - (f) of Figure 7, and (g), longer than
+// the leader with a term the leader does not have at the rejected index
+static const std::vector<uint64_t> kLeaderTerms = {1, 1, 1, 4, 4, 5, 5, 6, 6, 6};
+static const std::vector<Layout> kFollowers = {
+  {"a", {1, 1, 1, 4, 4, 5, 5, 6, 6}},
+  {"b", {1, 1, 1, 4}},
+  {"c", {1, 1, 1, 4, 4, 5, 5, 6, 6, 6, 6}},
+  {"d", {1, 1, 1, 4, 4, 5, 5, 6, 6, 6, 7, 7}},
+  {"e", {1, 1, 1, 4, 4, 4, 4}},
+  {"f", {1, 1, 1, 2, 2, 2, 3, 3, 3, 3, 3}},
+  {"g", {1, 1, 1, 4, 4, 4, 4, 7, 7, 7, 7, 7, 7}},
+};
+
+// the rounds a follower should converge in, or it is a bug
+static const uint64_t kMaxRounds = 100000000;
+
+struct Node {
+  rocksdb::DB* db;
+  RaftLog* raft_log;
+};
+
+static int OpenNode(const std::string& path, Logger* logger, Node* node) {
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  rocksdb::Status s = rocksdb::DB::Open(options, path, &node->db);
+  if (!s.ok()) {
+    printf("open %s failed, error: %s\n", path.c_str(), s.ToString().c_str());
+    return -1;
+  }
+  node->raft_log = new RaftLog(node->db, logger);
+  return 0;
+}
+
+static void CloseNode(Node* node) {
+  delete node->raft_log;
+  delete node->db;
+}
+
+// every entry of Figure 7 becomes scale entries
+static void FillLog(RaftLog* raft_log, const std::vector<uint64_t>& terms, int scale) {
+  std::vector<Entry> entries(terms.size() * scale);
+  std::vector<const Entry*> ptrs;
+  for (size_t i = 0; i < entries.size(); i++) {
+    entries[i].set_term(terms[i / scale]);
+    entries[i].set_key("key" + std::to_string(i));
+    entries[i].set_value(std::string(100, 'v'));
+    entries[i].set_optype(Entry_OpType_kWrite);
+    ptrs.push_back(&entries[i]);
+    if (ptrs.size() == 1024 || i + 1 == entries.size()) {
+      raft_log->Append(ptrs);
+      ptrs.clear();
+    }
+  }
+}
+
+/*
+ * one AppendEntries from leader to follower, the follower side does what
+ * FloydImpl::ReplyAppendEntries does to its log, return true if the
+ * follower accepts it
+ */
+static bool AppendEntries(RaftLog* leader, RaftLog* follower, bool use_hint,
+    const Options& options, uint64_t* next_index) {
+  uint64_t prev_log_index = *next_index - 1;
+  uint64_t prev_log_term = leader->GetTerm(prev_log_index);
+  std::vector<std::shared_ptr<const std::string> > shared;
+  uint64_t last_log_index = leader->GetLastLogIndex();
+  if (*next_index <= last_log_index) {
+    leader->GetEncodedEntries(*next_index,
+        std::min(last_log_index, *next_index + options.append_entries_count_once - 1),
+        options.append_entries_size_once, &shared);
+  }
+  // the follower gets its own copy, as it does from the request
+  std::vector<std::string> bufs;
+  for (size_t i = 0; i < shared.size(); i++) {
+    bufs.push_back(*shared[i]);
+  }
+
+  bool success = true;
+  uint64_t conflict_term = 0;
+  uint64_t conflict_index = 0;
+  if (prev_log_index > follower->GetLastLogIndex()) {
+    conflict_index = follower->GetLastLogIndex() + 1;
+    success = false;
+  } else if (prev_log_index != 0 && follower->GetTerm(prev_log_index) != prev_log_term) {
+    follower->GetConflictHint(prev_log_index, &conflict_term, &conflict_index);
+    follower->TruncateSuffix(prev_log_index);
+    success = false;
+  }
+  if (!success) {
+    if (use_hint) {
+      *next_index = leader->NextIndexAfterConflict(prev_log_index, conflict_term, conflict_index);
+    } else {
+      *next_index = std::min(follower->GetLastLogIndex() + 1, prev_log_index);
+    }
+    return false;
+  }
+
+  // skip the entries the follower has, and truncate from the first conflict
+  std::vector<uint64_t> terms;
+  EntryView view;
+  for (size_t i = 0; i < bufs.size(); i++) {
+    view.Parse(bufs[i], false);
+    terms.push_back(view.term());
+  }
+  uint64_t follower_last = follower->GetLastLogIndex();
+  uint64_t index = *next_index;
+  size_t first_new = 0;
+  while (first_new < terms.size() && index <= follower_last
+      && follower->GetTerm(index) == terms[first_new]) {
+    first_new++;
+    index++;
+  }
+  if (first_new < terms.size() && index <= follower_last) {
+    follower->TruncateSuffix(index);
+  }
+  *next_index += terms.size();
+  bufs.erase(bufs.begin(), bufs.begin() + first_new);
+  terms.erase(terms.begin(), terms.begin() + first_new);
+  if (!bufs.empty()) {
+    follower->AppendEncoded(&bufs, terms);
+  }
+  return true;
+}
+
+static int Run(const std::string& path, Logger* logger, const Layout& layout,
+    int scale, bool use_hint) {
+  std::string dir = path + layout.name + (use_hint ? "_hint/" : "_step/");
+  Node leader, follower;
+  if (OpenNode(dir + "leader", logger, &leader) != 0
+      || OpenNode(dir + "follower", logger, &follower) != 0) {
+    return -1;
+  }
+  FillLog(leader.raft_log, kLeaderTerms, scale);
+  FillLog(follower.raft_log, layout.terms, scale);
+
+  Options options;
+  uint64_t last_log_index = leader.raft_log->GetLastLogIndex();
+  // a new leader starts from its last entry
+  uint64_t next_index = last_log_index + 1;
+  uint64_t rounds = 0;
+  uint64_t rejected = 0;
+  uint64_t start_us = slash::NowMicros();
+  while (rounds < kMaxRounds) {
+    rounds++;
+    if (!AppendEntries(leader.raft_log, follower.raft_log, use_hint, options, &next_index)) {
+      rejected++;
+    } else if (next_index > last_log_index) {
+      break;
+    }
+  }
+  uint64_t cost_us = slash::NowMicros() - start_us;
+
+  bool match = true;
+  for (uint64_t i = 1; i <= last_log_index; i++) {
+    if (follower.raft_log->GetTerm(i) != leader.raft_log->GetTerm(i)) {
+      match = false;
+      break;
+    }
+  }
+  printf("  (%s) %-4s rounds %8lu rejected %8lu cost %10lu us%s\n", layout.name.c_str(),
+      use_hint ? "hint" : "step", rounds, rejected, cost_us, match ? "" : "  NOT CONVERGED");
+  CloseNode(&leader);
+  CloseNode(&follower);
+  return match ? 0 : -1;
+}
+
+int main(int argc, char* argv[]) {
+  // the entries each entry of Figure 7 stands for, so the divergent
+  // suffix is long
+  int scale = argc > 1 ? atoi(argv[1]) : 100;
+  std::string path = argc > 2 ? argv[2] : "./conflict_data/";
+  if (scale <= 0) {
+    printf("Usage: %s [scale] [path]\n", argv[0]);
+    return -1;
+  }
+  if (path[path.size() - 1] != '/') {
+    path += "/";
+  }
+  slash::DeleteDirIfExist(path);
+  slash::CreatePath(path);
+  Logger* logger;
+  if (NewLogger(path + "LOG", &logger) != 0) {
+    return -1;
+  }
+
+  printf("Figure 7 logs with %d entries for each entry, leader last_log_index %lu\n",
+      scale, kLeaderTerms.size() * scale);
+  int ret = 0;
+  for (size_t i = 0; i < kFollowers.size(); i++) {
+    if (Run(path, logger, kFollowers[i], scale, false) != 0
+        || Run(path, logger, kFollowers[i], scale, true) != 0) {
+      ret = -1;
+    }
+  }
+  delete logger;
+  return ret;
+}
@@ -2,9 +2,12 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <algorithm>
+#include <vector>
 
 #include "rocksdb/db.h"
 #include "floyd/src/floyd.pb.h"
+#include "floyd/src/entry_codec.h"
 #include <google/protobuf/text_format.h>
 
 using namespace rocksdb;
@@ -26,8 +29,30 @@ int main(int argc, char** argv)
   rocksdb::DB* db;
   rocksdb::Options options;
   std::cout << argv[1] << std::endl;
-  rocksdb::Status s = rocksdb::DB::OpenForReadOnly(options, argv[1], &db);
-  rocksdb::Iterator* iter = db->NewIterator(rocksdb::ReadOptions());
+  // the log and meta are kept in the "log" and "meta" column families,
+  // an old db keeps all of them in the default one
+  std::vector<std::string> names;
+  rocksdb::DB::ListColumnFamilies(options, argv[1], &names);
+  std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
+  for (size_t i = 0; i < names.size(); i++) {
+    column_families.push_back(rocksdb::ColumnFamilyDescriptor(names[i], rocksdb::ColumnFamilyOptions()));
+  }
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  rocksdb::Status s = rocksdb::DB::OpenForReadOnly(options, argv[1], column_families, &handles, &db);
+  if (!s.ok()) {
+    printf("open %s failed: %s\n", argv[1], s.ToString().c_str());
+    return 1;
+  }
+  rocksdb::ColumnFamilyHandle* log_cf = db->DefaultColumnFamily();
+  rocksdb::ColumnFamilyHandle* meta_cf = db->DefaultColumnFamily();
+  for (size_t i = 0; i < handles.size(); i++) {
+    if (names[i] == "log") {
+      log_cf = handles[i];
+    } else if (names[i] == "meta") {
+      meta_cf = handles[i];
+    }
+  }
+  rocksdb::Iterator* iter = db->NewIterator(rocksdb::ReadOptions(), log_cf);
   char c;
   bool is_meta = false;
   int index = 0;
@@ -42,26 +67,40 @@ int main(int argc, char** argv)
     }
   }
   if (is_meta) {
-    iter->SeekToLast();
-    for (int i = 0; i < 5; i++) {
-      if (iter->key().ToString() == "VOTEFORIP") {
-        printf("key %s, value %s\n", iter->key().ToString().c_str(), iter->value().ToString().c_str());
+    rocksdb::Iterator* meta_iter = db->NewIterator(rocksdb::ReadOptions(), meta_cf);
+    for (meta_iter->SeekToFirst(); meta_iter->Valid(); meta_iter->Next()) {
+      if (meta_iter->key().size() == sizeof(uint64_t)) {
+        // log entry of an old db
+        continue;
+      }
+      if (meta_iter->key().ToString() == "RAFTSTATE" && meta_iter->value().size() >= 28) {
+        // current term, commit index, last applied, voted for port and ip
+        const char* p = meta_iter->value().data();
+        uint64_t term, commit_index, last_applied;
+        int port;
+        memcpy(&term, p, sizeof(uint64_t));
+        memcpy(&commit_index, p + 8, sizeof(uint64_t));
+        memcpy(&last_applied, p + 16, sizeof(uint64_t));
+        memcpy(&port, p + 24, sizeof(int));
+        printf("key RAFTSTATE, current term %lu, voted for %s:%d, commit index %lu, last applied %lu\n",
+            term, std::string(p + 28, meta_iter->value().size() - 28).c_str(), port, commit_index, last_applied);
+      } else if (meta_iter->key().ToString() == "VOTEFORIP" || meta_iter->key().ToString() == "SNAPSHOTMEMBERS") {
+        printf("key %s, value %s\n", meta_iter->key().ToString().c_str(), meta_iter->value().ToString().c_str());
       } else {
-        uint64_t ans;
-        memcpy(&ans, iter->value().data(), sizeof(uint64_t));
-        printf("key %s, value %lu\n", iter->key().ToString().c_str(), ans);
+        uint64_t ans = 0;
+        memcpy(&ans, meta_iter->value().data(), std::min(meta_iter->value().size(), sizeof(uint64_t)));
+        printf("key %s, value %lu\n", meta_iter->key().ToString().c_str(), ans);
       }
-      iter->Prev();
     }
     return 0;
   }
   if (index) {
     std::string val;
-    rocksdb::Status s = db->Get(rocksdb::ReadOptions(), UintToBitStr(uint64_t(index)), &val);
+    rocksdb::Status s = db->Get(rocksdb::ReadOptions(), log_cf, UintToBitStr(uint64_t(index)), &val);
     if (s.IsNotFound()) {
       printf("key %d not found\n", index);
     } else {
-      entry.ParseFromString(val);
+      floyd::DecodeEntry(val, &entry);
       printf("index %d entry term: %lu key %s value %s\n", index, entry.term(), entry.key().c_str(), entry.value().c_str());
     }
     return 0;
@@ -78,14 +117,14 @@ int main(int argc, char** argv)
         printf("key %s, value %lu\n", iter->key().ToString().c_str(), ans);
       }
     } else {
-      entry.ParseFromString(iter->value().ToString());
+      floyd::DecodeEntry(iter->value(), &entry);
       uint64_t num = BitStrToUint(iter->key().ToString());
       if (entry.optype() == floyd::Entry_OpType_kTryLock) {
         printf("index %lu entry type: trylock term: %lu name: %s holder %s\n", num, entry.term(), entry.key().c_str(), entry.holder().c_str());
       } else if (entry.optype() == floyd::Entry_OpType_kUnLock) {
         printf("index %lu entry type: unlock term: %lu name: %s holder %s\n", num, entry.term(), entry.key().c_str(), entry.holder().c_str());
       } else if (entry.optype() == floyd::Entry_OpType_kAddServer) {
-        printf("index %lu entry type: addserver new_server: %s\n", num, entry.new_server().c_str());
+        printf("index %lu entry type: addserver new_server: %s\n", num, entry.server().c_str());
       } else {
         printf("index %lu entry type: %d term: %lu key %s value %s\n", num, entry.optype(), entry.term(), entry.key().c_str(), entry.value().c_str());
       }